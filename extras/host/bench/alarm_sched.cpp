@@ -0,0 +1,567 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+/*
+ * Many logical alarms on the two hardware alarms, RTCAlarmScheduler.
+ *
+ * A day of a sensor node is simulated on MAX31328 (monthly ALARM1 match,
+ * flags cleared by a write), MAX31329 and MAX31343 (one-time match). It
+ * has 200 one-shot alarms at random times, 20 of which are removed before
+ * they are due, periodic alarms of 60 s (on ALARM2), 17 s, 300 s and
+ * 3600 s, and a chain alarm whose callback adds it again 123 s later. The
+ * MCU "sleeps" in 1 s steps and only wakes when the simulated INT output
+ * is asserted. Every callback must run in the second it is due, exactly
+ * the expected number of times. The table compares the wakes and the bus
+ * traffic with a loop that polls the time once a second.
+ *
+ * An alarm 40 days ahead shows the early wake of the monthly match on
+ * MAX31328: one wake with nothing due, then the alarm on time. A bus
+ * error on the first ALARM1 write must not turn MAX31343 to the monthly
+ * match.
+ *
+ * ALARM2 then matches right after the status read of service(). Its flag
+ * must stay set for the next service(), so that no callback is lost.
+ *
+ * Last, the CPU cost of add(), remove() and of a fire in service() is
+ * measured on a scheduler with no RTC behind it for 16 to 1024 alarms,
+ * next to a linear scan for the earliest of n alarms, in TSC cycles per
+ * call on x86, in ns elsewhere.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define COST_UNIT   "cycles"
+#else
+#define COST_UNIT   "ns"
+#endif
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+
+#define START_EPOCH     1717977600UL    /* 2024-06-10 00:00:00 */
+#define DAY_SECS        86400UL
+#define NUM_ONESHOT     200
+#define NUM_REMOVED     20
+#define CHAIN_STEP      123
+#define CAPACITY        256
+#define COST_CAPACITY   1024
+#define COST_LOOPS      2000
+
+typedef struct {
+    rtc_epoch_t next;       /* Expected next fire */
+    uint32_t period;
+    uint32_t fires;
+    uint32_t expected;
+    bool removed;
+} logical_t;
+
+static int failures;
+static RTCSim *cur_sim;
+static RTCAlarmScheduler *cur_sched;
+static uint32_t late;
+static uint32_t wrong;
+
+static logical_t oneshot[NUM_ONESHOT];
+static logical_t periodic[4];
+static logical_t chain;
+
+static uint64_t now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+static rtc_epoch_t sim_epoch(RTCSim &sim)
+{
+    struct tm t;
+
+    sim.get_calendar(&t);
+    return (rtc_epoch_t)mktime(&t);
+}
+
+static void on_alarm(uint16_t id, rtc_epoch_t when, void *arg)
+{
+    logical_t *l = (logical_t *)arg;
+
+    (void)id;
+
+    if (l->removed || (when != l->next)) {
+        wrong++;
+    }
+    if (sim_epoch(*cur_sim) != when) {
+        late++;
+    }
+
+    l->fires++;
+    l->next = when + l->period;
+}
+
+static void on_chain(uint16_t id, rtc_epoch_t when, void *arg)
+{
+    on_alarm(id, when, arg);
+
+    if (when + CHAIN_STEP < START_EPOCH + DAY_SECS) {
+        chain.next = when + CHAIN_STEP;
+        cur_sched->add(chain.next, 0, on_chain, &chain);
+    }
+}
+
+static uint32_t expected_fires(rtc_epoch_t first, uint32_t period, rtc_epoch_t end)
+{
+    if (first > end) {
+        return 0;
+    }
+    return period ? (end - first) / period + 1 : 1;
+}
+
+/* Sleep to the next tick of the simulator, where its INT output can change */
+static void next_second(RTCSim &sim)
+{
+    sim.sync();
+    host_clock_advance(1000000 - sim.phase_us());
+}
+
+/* Align the simulator to a second boundary, at START_EPOCH */
+template <class RTC>
+static void start_day(RTC &rtc, RTCSim &sim)
+{
+    rtc.set_epoch(START_EPOCH);
+    sim.sync();
+    host_clock_advance(1000000 - sim.phase_us());
+    rtc.set_epoch(START_EPOCH);
+    sim.sync();
+}
+
+template <class RTC>
+static void day(const char *part, RTC &rtc, RTCSim &sim)
+{
+    static const uint32_t periods[4] = { 60, 17, 300, 3600 };
+    static const uint32_t offsets[4] = { 60, 5, 307, 1800 };
+    RTCAlarmSchedulerT<RTC, CAPACITY> sched(&rtc);
+    rtc_alarm_sched_stats_t stats;
+    rtc_epoch_t end = START_EPOCH + DAY_SECS - 1;
+    uint16_t ids[NUM_ONESHOT];
+    uint16_t fired;
+    uint32_t wakes = 0, fires = 0;
+    uint32_t missing = 0;
+    int i;
+
+    cur_sim = &sim;
+    cur_sched = &sched;
+    late = 0;
+    wrong = 0;
+
+    Wire.attach(&sim);
+    rtc.begin();
+    start_day(rtc, sim);
+    srand(1);
+
+    if (sched.begin()) {
+        printf("%s: begin() failed\n", part);
+        failures++;
+    }
+
+    for (i = 0; i < 4; i++) {
+        memset(&periodic[i], 0, sizeof(periodic[i]));
+        periodic[i].next = START_EPOCH + offsets[i];
+        periodic[i].period = periods[i];
+        periodic[i].expected = expected_fires(periodic[i].next, periods[i], end);
+        sched.add(periodic[i].next, periods[i], on_alarm, &periodic[i]);
+    }
+
+    for (i = 0; i < NUM_ONESHOT; i++) {
+        memset(&oneshot[i], 0, sizeof(oneshot[i]));
+        oneshot[i].next = START_EPOCH + 1 + rand() % (DAY_SECS - 1);
+        oneshot[i].expected = 1;
+        if (sched.add(oneshot[i].next, 0, on_alarm, &oneshot[i], &ids[i])) {
+            printf("%s: add() failed\n", part);
+            failures++;
+        }
+    }
+
+    for (i = 0; i < NUM_REMOVED; i++) {
+        oneshot[i * 7].removed = true;
+        oneshot[i * 7].expected = 0;
+        if (sched.remove(ids[i * 7])) {
+            printf("%s: remove() failed\n", part);
+            failures++;
+        }
+    }
+
+    memset(&chain, 0, sizeof(chain));
+    chain.next = START_EPOCH + 10;
+    chain.expected = expected_fires(chain.next, CHAIN_STEP, end);
+    sched.add(chain.next, 0, on_chain, &chain);
+
+    sched.reset_stats();
+    Wire.reset_stats();
+
+    for (uint32_t s = 0; s < DAY_SECS - 1; s++) {
+        next_second(sim);
+        if (sim.int_asserted()) {
+            sched.irq();
+        }
+        if (sched.pending()) {
+            wakes++;
+            if (sched.service(&fired)) {
+                printf("%s: service() failed\n", part);
+                failures++;
+            }
+            fires += fired;
+        }
+    }
+
+    const host_i2c_stats_t &bs = Wire.stats();
+    sched.get_stats(stats);
+
+    for (i = 0; i < NUM_ONESHOT; i++) {
+        missing += (oneshot[i].fires != oneshot[i].expected);
+    }
+    for (i = 0; i < 4; i++) {
+        missing += (periodic[i].fires != periodic[i].expected);
+    }
+    missing += (chain.fires != chain.expected);
+
+    printf("%-9s %-11s %6u %6u %5u %5u %5u %7u %8.1f %4u\n", part, "scheduler",
+           (unsigned)wakes, (unsigned)fires, (unsigned)stats.fired_a2, (unsigned)stats.arms,
+           (unsigned)stats.early, (unsigned)bs.transfers, bs.bus_time_us / 1000.0, (unsigned)late);
+
+    if (late || wrong || missing || stats.errors || sim.int_asserted()) {
+        printf("%s: %u late, %u unexpected, %u alarms with a wrong count, %u errors\n", part,
+               (unsigned)late, (unsigned)wrong, (unsigned)missing, (unsigned)stats.errors);
+        failures++;
+    }
+
+    /* The same day, polling the time once a second */
+    {
+        rtc_epoch_t e;
+
+        start_day(rtc, sim);
+        Wire.reset_stats();
+        for (uint32_t s = 0; s < DAY_SECS - 1; s++) {
+            next_second(sim);
+            rtc.get_epoch(&e);
+        }
+
+        const host_i2c_stats_t &ps = Wire.stats();
+        printf("%-9s %-11s %6u %6s %5s %5s %5s %7u %8.1f %4s\n", part, "poll 1 Hz",
+               (unsigned)(DAY_SECS - 1), "", "", "", "", (unsigned)ps.transfers,
+               ps.bus_time_us / 1000.0, "");
+    }
+
+    Wire.detach(&sim);
+}
+
+static void on_far(uint16_t id, rtc_epoch_t when, void *arg)
+{
+    (void)id;
+    (void)when;
+    *(rtc_epoch_t *)arg = sim_epoch(*cur_sim);
+}
+
+template <class RTC>
+static void far(const char *part, RTC &rtc, RTCSim &sim, uint32_t early, bool nack = false)
+{
+    RTCAlarmSchedulerT<RTC, 4> sched(&rtc);
+    rtc_alarm_sched_stats_t stats;
+    rtc_epoch_t target = START_EPOCH + 40 * DAY_SECS;
+    rtc_epoch_t seen = 0;
+    uint32_t wakes = 0;
+
+    cur_sim = &sim;
+
+    Wire.attach(&sim);
+    rtc.begin();
+    start_day(rtc, sim);
+    sched.begin();
+    if (nack) {
+        /* The ALARM1 write of add() fails past the transport retries, begin() arms it again */
+        Wire.inject_error(2, 3);
+        if (!sched.add(target, 0, on_far, &seen)) {
+            printf("%s: add() succeeded on a NACK\n", part);
+            failures++;
+        }
+        sched.begin();
+    } else {
+        sched.add(target, 0, on_far, &seen);
+    }
+
+    for (uint32_t h = 0; (h < 50 * 24) && !seen; h++) {
+        host_clock_advance(3600ULL * 1000000);
+        if (sim.int_asserted()) {
+            sched.irq();
+        }
+        if (sched.pending()) {
+            wakes++;
+            sched.service();
+        }
+    }
+
+    sched.get_stats(stats);
+    printf("%-9s alarm in 40 days%s: %u wakes, %u early, fired %+ld s from due\n", part,
+           nack ? ", NACK on the first arm" : "", (unsigned)wakes, (unsigned)stats.early, seen ? (long)(seen - target) : 0L);
+
+    if ((seen != target) || (stats.early != early) || sched.count()) {
+        printf("%s: 40-day alarm expected on time with %u early wakes\n", part, (unsigned)early);
+        failures++;
+    }
+
+    Wire.detach(&sim);
+}
+
+/* Ticks to the next second right after the status read, inside take_flags() */
+template <class SIM>
+class LateTickSim : public SIM
+{
+public:
+    LateTickSim() : tick_after_status(false) {}
+
+    bool tick_after_status;
+
+protected:
+    void after_read(uint8_t reg)
+    {
+        SIM::after_read(reg);
+        if (tick_after_status && (reg == this->m_layout->status)) {
+            tick_after_status = false;
+            host_clock_advance(1000000 - this->m_phase_us);
+            this->sync();
+        }
+    }
+};
+
+static void on_count(uint16_t id, rtc_epoch_t when, void *arg)
+{
+    (void)id;
+    (void)when;
+    (*(uint32_t *)arg)++;
+}
+
+/* ALARM2 matches between the status read and any clearing: its flag must survive */
+template <class RTC, class SIM>
+static void a2_window(const char *part)
+{
+    LateTickSim<SIM> sim;
+    RTC rtc(&Wire);
+    RTCAlarmSchedulerT<RTC, 4> sched(&rtc);
+    uint32_t a1 = 0;
+    uint32_t a2 = 0;
+
+    Wire.attach(&sim);
+    rtc.begin();
+    start_day(rtc, sim);
+    sched.begin();
+    sched.add(START_EPOCH + 59, 0, on_count, &a1);
+    sched.add(START_EPOCH + 60, 60, on_count, &a2);
+
+    for (uint32_t s = 0; s < 150; s++) {
+        next_second(sim);
+        sim.sync();
+        if (sim.int_asserted()) {
+            sched.irq();
+        }
+        if (sched.pending()) {
+            sim.tick_after_status = (sim_epoch(sim) == START_EPOCH + 59);
+            sched.service();
+        }
+    }
+
+    printf("%-9s ALARM2 during the status read: %u of 1 ALARM1, %u of 2 ALARM2 callbacks\n",
+           part, (unsigned)a1, (unsigned)a2);
+
+    if ((a1 != 1) || (a2 != 2)) {
+        printf("%s: alarm flag lost between the status read and its clearing\n", part);
+        failures++;
+    }
+
+    Wire.detach(&sim);
+}
+
+/* A scheduler with nothing behind it, for the CPU cost of the heap */
+class NullScheduler : public RTCAlarmScheduler
+{
+public:
+    NullScheduler() : RTCAlarmScheduler(m_slots, m_ids, COST_CAPACITY, true), time(0) {}
+
+    rtc_epoch_t time;
+
+protected:
+    int read_rtc(rtc_epoch_t *epoch) { *epoch = time; return 0; }
+    int write_alarm(bool, const struct tm *, int) { return 0; }
+    int enable_alarm(bool, bool) { return 0; }
+    int take_flags(uint8_t *flags) { *flags = RTC_ALARM_FLAG_A1; return 0; }
+
+private:
+    rtc_alarm_entry_t m_slots[COST_CAPACITY];
+    uint16_t m_ids[COST_CAPACITY];
+};
+
+static void on_null(uint16_t, rtc_epoch_t, void *) {}
+
+static void cost(void)
+{
+    static const uint16_t sizes[] = { 16, 64, 256, 1024 };
+    static rtc_epoch_t times[COST_CAPACITY];
+    volatile rtc_epoch_t sink;
+    rtc_epoch_t min;
+    uint64_t t0, t_add, t_remove, t_fire, t_scan;
+    uint16_t id;
+    uint16_t fired;
+
+    printf("\n%6s %10s %10s %10s %10s   (%s per call)\n", "alarms", "add", "remove", "fire",
+           "scan", COST_UNIT);
+
+    for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        NullScheduler *sched = new NullScheduler;
+        uint16_t n = sizes[s];
+
+        srand(2);
+        sched->time = 0;
+        for (uint16_t i = 0; i < n; i++) {
+            times[i] = 1000000 + rand() % 1000000;
+        }
+        for (uint16_t i = 0; i + 1 < n; i++) {
+            sched->add(times[i], 0, on_null, NULL);
+        }
+
+        /* An add and a remove at n alarms, at random places in the heap */
+        t_add = t_remove = 0;
+        for (int k = 0; k < COST_LOOPS; k++) {
+            rtc_epoch_t when = 1000000 + rand() % 1000000;
+
+            t0 = now();
+            sched->add(when, 0, on_null, NULL, &id);
+            t_add += now() - t0;
+            t0 = now();
+            sched->remove(id);
+            t_remove += now() - t0;
+        }
+
+        /* Linear search for the earliest of n alarms, the unsorted list a heap replaces */
+        t0 = now();
+        for (int k = 0; k < COST_LOOPS; k++) {
+            min = times[0];
+            for (uint16_t i = 1; i < n; i++) {
+                if (times[i] < min) {
+                    min = times[i];
+                }
+            }
+            sink = min + k;
+            (void)sink;
+        }
+        t_scan = now() - t0;
+
+        /* Each fire pops the root, sifts down and re-arms */
+        sched->add(times[n - 1], 0, on_null, NULL);
+        sched->time = 2000000;
+        t0 = now();
+        sched->service(&fired);
+        t_fire = now() - t0;
+
+        if ((fired != n) || sched->count()) {
+            printf("%u alarms: %u fired\n", (unsigned)n, (unsigned)fired);
+            failures++;
+        }
+
+        printf("%6u %10.1f %10.1f %10.1f %10.1f\n", (unsigned)n,
+               (double)t_add / COST_LOOPS, (double)t_remove / COST_LOOPS,
+               (double)t_fire / n, (double)t_scan / COST_LOOPS);
+
+        delete sched;
+    }
+}
+
+int main(void)
+{
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    host_serial_mute(true);
+
+    printf("%-9s %-11s %6s %6s %5s %5s %5s %7s %8s %4s\n", "part", "mode", "wakes", "fires",
+           "a2", "arms", "early", "xfers", "bus ms", "late");
+
+    {
+        MAX31328Sim sim;
+        MAX31328 rtc(&Wire);
+        day("MAX31328", rtc, sim);
+    }
+    {
+        MAX31329Sim sim;
+        MAX31329 rtc(&Wire);
+        day("MAX31329", rtc, sim);
+    }
+    {
+        MAX31343Sim sim;
+        MAX31343 rtc(&Wire);
+        day("MAX31343", rtc, sim);
+    }
+
+    printf("\n");
+    {
+        MAX31328Sim sim;
+        MAX31328 rtc(&Wire);
+        far("MAX31328", rtc, sim, 1);
+    }
+    {
+        MAX31343Sim sim;
+        MAX31343 rtc(&Wire);
+        far("MAX31343", rtc, sim, 0);
+    }
+    {
+        MAX31343Sim sim;
+        MAX31343 rtc(&Wire);
+        far("MAX31343", rtc, sim, 0, true);
+    }
+
+    printf("\n");
+    a2_window<MAX31328, MAX31328Sim>("MAX31328");
+    a2_window<MAX31329, MAX31329Sim>("MAX31329");
+    a2_window<MAX31343, MAX31343Sim>("MAX31343");
+
+    cost();
+
+    if (failures) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,349 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * CPU cost of BCD decoding.
+ *
+ * The first table decodes register blocks that are already in memory.
+ * "macro" is the decode the drivers had before RTCBcd.h: one BCD2BIN()
+ * macro per field, a multiplication by 10 each, hours through
+ * rtc_hours_from_reg(), and a double divide for the 1/128 s register.
+ * It is compared with the _arith, _lut and _swar variants of
+ * rtc_bcd_decode_time(), for the 7-byte block, and of
+ * rtc_bcd_decode_time_hr() plus rtc_hr_frac_to_ms(), for the 8-byte
+ * MAX3133X block. All of them are checked against "macro" on random
+ * bytes, invalid BCD and 12 hour mode included.
+ *
+ * The second table times the get_time(), get_alarm() and, on MAX31335,
+ * get_timestamp() driver calls, I2C mock and simulator included, with
+ * the variant the library was built with. To compare the variants there,
+ * rebuild with another one:
+ *
+ *   make clean && make bench DEFS=-DANALOG_RTC_BCD=RTC_BCD_ARITH
+ *
+ * Cost is in TSC cycles per call on x86, in ns elsewhere.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define COST_UNIT   "cycles"
+#else
+#define COST_UNIT   "ns"
+#endif
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+
+#define NUM_BLOCKS  256
+#define CONV_LOOPS  400
+#define CALL_LOOPS  2000
+
+#define BCD2BIN(val) (((val) & 15) + ((val) >> 4) * 10)
+
+static uint8_t blocks[NUM_BLOCKS][8];
+
+static int failures;
+
+static const char *variant_name[] = { "RTC_BCD_ARITH", "RTC_BCD_LUT", "RTC_BCD_SWAR" };
+
+static uint64_t now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+static void report(const char *part, const char *what, uint64_t cost, int calls, double base)
+{
+    double per_call = (double)cost / calls;
+
+    if (base > 0) {
+        printf("%-9s %-24s %10.1f %7.2f\n", part, what, per_call, base / per_call);
+    } else {
+        printf("%-9s %-24s %10.1f\n", part, what, per_call);
+    }
+}
+
+/* The field by field decode the drivers used before */
+static void decode_macro(const uint8_t *regs, rtc_bcd_time_t *time)
+{
+    time->sec = BCD2BIN(regs[0] & 0x7F);
+    time->min = BCD2BIN(regs[1] & 0x7F);
+    time->hour = rtc_hours_from_reg(regs[2]);
+    time->wday = BCD2BIN(regs[3] & 0x07);
+    time->mday = BCD2BIN(regs[4] & 0x3F);
+    time->mon = BCD2BIN(regs[5] & 0x1F);
+    if (regs[5] & 0x80) {
+        time->year = BCD2BIN(regs[6]) + 100;
+    } else {
+        time->year = BCD2BIN(regs[6]);
+    }
+}
+
+static uint16_t decode_macro_hr(const uint8_t *regs, rtc_bcd_time_t *time)
+{
+    decode_macro(&regs[1], time);
+    return (1000 * regs[0]) / 128.0;
+}
+
+static uint16_t decode_hr_arith(const uint8_t *regs, rtc_bcd_time_t *time)
+{
+    time->frac = regs[0] & 0x7F;
+    rtc_bcd_decode_time_arith(&regs[1], time);
+    return rtc_hr_frac_to_ms(time->frac);
+}
+
+static uint16_t decode_hr_lut(const uint8_t *regs, rtc_bcd_time_t *time)
+{
+    time->frac = regs[0] & 0x7F;
+    rtc_bcd_decode_time_lut(&regs[1], time);
+    return rtc_hr_frac_to_ms(time->frac);
+}
+
+static uint16_t decode_hr_swar(const uint8_t *regs, rtc_bcd_time_t *time)
+{
+    time->frac = regs[0] & 0x7F;
+    rtc_bcd_decode_time_swar(&regs[1], time);
+    return rtc_hr_frac_to_ms(time->frac);
+}
+
+static bool same(const rtc_bcd_time_t &a, const rtc_bcd_time_t &b)
+{
+    return (a.sec == b.sec) && (a.min == b.min) && (a.hour == b.hour) && (a.wday == b.wday)
+           && (a.mday == b.mday) && (a.mon == b.mon) && (a.year == b.year);
+}
+
+/* Random bytes: valid and invalid BCD, 12 and 24 hour mode, both centuries */
+static void make_blocks(void)
+{
+    uint32_t seed = 4321;
+
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        for (int j = 0; j < 8; j++) {
+            seed = seed * 1103515245 + 12345;
+            blocks[i][j] = seed >> 16;
+        }
+        blocks[i][0] &= 0x7F;
+    }
+}
+
+static void check(void)
+{
+    rtc_bcd_time_t want, got;
+    uint16_t want_ms;
+
+    for (int v = 0; v < 256; v++) {
+        if ((rtc_bcd2bin_arith(v) != BCD2BIN(v)) || (rtc_bcd2bin_lut(v) != BCD2BIN(v))) {
+            printf("rtc_bcd2bin(0x%02x) differs from BCD2BIN()\n", v);
+            failures++;
+        }
+        if ((v < 100) && (rtc_bcd2bin(rtc_bin2bcd(v)) != v)) {
+            printf("rtc_bin2bcd(%d) does not round trip\n", v);
+            failures++;
+        }
+    }
+
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        want_ms = decode_macro_hr(blocks[i], &want);
+        if (!same(want, (decode_hr_arith(blocks[i], &got), got)) || (got.frac * 1000 / 128 != want_ms)
+            || !same(want, (decode_hr_lut(blocks[i], &got), got))
+            || !same(want, (decode_hr_swar(blocks[i], &got), got))
+            || (decode_hr_swar(blocks[i], &got) != want_ms)) {
+            printf("block %d decodes differently\n", i);
+            failures++;
+        }
+    }
+}
+
+#define TIME_KERNEL(name, fn)                                       \
+    do {                                                            \
+        uint64_t start = now();                                     \
+        for (int n = 0; n < CONV_LOOPS; n++) {                      \
+            for (int i = 0; i < NUM_BLOCKS; i++) {                  \
+                fn(&blocks[i][1], &t);                              \
+                __asm__ volatile("" : : "r"(&t) : "memory");        \
+            }                                                       \
+        }                                                           \
+        uint64_t cost = now() - start;                              \
+        if (base == 0) {                                            \
+            base = (double)cost / (CONV_LOOPS * NUM_BLOCKS);        \
+        }                                                           \
+        report("-", name, cost, CONV_LOOPS * NUM_BLOCKS, base);     \
+    } while (0)
+
+#define TIME_KERNEL_HR(name, fn)                                    \
+    do {                                                            \
+        uint64_t start = now();                                     \
+        for (int n = 0; n < CONV_LOOPS; n++) {                      \
+            for (int i = 0; i < NUM_BLOCKS; i++) {                  \
+                uint16_t ms = fn(blocks[i], &t);                    \
+                __asm__ volatile("" : : "r"(&t), "r"(ms) : "memory"); \
+            }                                                       \
+        }                                                           \
+        uint64_t cost = now() - start;                              \
+        if (base == 0) {                                            \
+            base = (double)cost / (CONV_LOOPS * NUM_BLOCKS);        \
+        }                                                           \
+        report("-", name, cost, CONV_LOOPS * NUM_BLOCKS, base);     \
+    } while (0)
+
+static void kernels(void)
+{
+    rtc_bcd_time_t t;
+    double base = 0;
+
+    TIME_KERNEL("time7 macro", decode_macro);
+    TIME_KERNEL("time7 arith", rtc_bcd_decode_time_arith);
+    TIME_KERNEL("time7 lut", rtc_bcd_decode_time_lut);
+    TIME_KERNEL("time7 swar", rtc_bcd_decode_time_swar);
+
+    base = 0;
+    TIME_KERNEL_HR("time8+ms macro", decode_macro_hr);
+    TIME_KERNEL_HR("time8+ms arith", decode_hr_arith);
+    TIME_KERNEL_HR("time8+ms lut", decode_hr_lut);
+    TIME_KERNEL_HR("time8+ms swar", decode_hr_swar);
+}
+
+#define TIME_CALL(part, name, call)                                 \
+    do {                                                            \
+        uint64_t start = now();                                     \
+        for (int n = 0; n < CALL_LOOPS; n++) {                      \
+            call;                                                   \
+        }                                                           \
+        report(part, name, now() - start, CALL_LOOPS, 0);           \
+    } while (0)
+
+template <class RTC>
+static void calls(const char *part, RTC &rtc, RTCSim &sim)
+{
+    struct tm t;
+    typename RTC::alarm_period_t period;
+    bool enabled;
+
+    memset(&t, 0, sizeof(t));
+    t.tm_year = 124;
+    t.tm_mon = 5;
+    t.tm_mday = 10;
+    t.tm_hour = 7;
+
+    Wire.attach(&sim);
+    rtc.begin();
+    rtc.set_time(&t);
+    rtc.set_alarm(RTC::ALARM1, &t, RTC::ALARM_PERIOD_DAILY);
+
+    TIME_CALL(part, "get_time", rtc.get_time(&t));
+    TIME_CALL(part, "get_alarm", rtc.get_alarm(RTC::ALARM1, &t, &period, &enabled));
+
+    Wire.detach(&sim);
+}
+
+static void timestamp_call(void)
+{
+    MAX3133XSim sim(MAX3133XSim::VARIANT_MAX31335);
+    MAX31335 rtc(&Wire);
+    MAX31335::timestamp_t ts;
+    MAX31335::timestamp_hr_t ts_hr;
+
+    Wire.attach(&sim);
+    rtc.begin();
+
+    /* A DIN timestamp record */
+    for (int i = 0; i < 8; i++) {
+        sim.poke(MAX31335_TS0_SEC_1_128 + i, blocks[0][i]);
+    }
+    sim.poke(MAX31335_TS0_FLAGS, MAX31335::DINF);
+
+    TIME_CALL("MAX31335", "get_timestamp", rtc.get_timestamp(MAX31335::TS0, &ts));
+    TIME_CALL("MAX31335", "get_timestamp_hr", rtc.get_timestamp_hr(MAX31335::TS0, &ts_hr));
+
+    Wire.detach(&sim);
+}
+
+int main(void)
+{
+    host_serial_mute(true);
+
+    make_blocks();
+    check();
+
+    printf("%-9s %-24s %10s %7s\n", "part", "decode", COST_UNIT, "speedup");
+    kernels();
+
+    printf("\n%-9s %-24s %10s  (%s)\n", "part", "call", COST_UNIT, variant_name[ANALOG_RTC_BCD]);
+    {
+        MAX31328Sim sim;
+        MAX31328 rtc(&Wire);
+        calls("MAX31328", rtc, sim);
+    }
+    {
+        MAX31329Sim sim;
+        MAX31329 rtc(&Wire);
+        calls("MAX31329", rtc, sim);
+    }
+    {
+        MAX3134XSim sim(false);
+        MAX31341 rtc(&Wire, MAX31341_I2C_ADDRESS);
+        calls("MAX31341", rtc, sim);
+    }
+    {
+        MAX3134XSim sim(true);
+        MAX31342 rtc(&Wire, MAX31342_I2C_ADDRESS);
+        calls("MAX31342", rtc, sim);
+    }
+    {
+        MAX31343Sim sim;
+        MAX31343 rtc(&Wire);
+        calls("MAX31343", rtc, sim);
+    }
+    {
+        MAX3133XSim sim(MAX3133XSim::VARIANT_MAX31335);
+        MAX31335 rtc(&Wire);
+        calls("MAX31335", rtc, sim);
+    }
+    timestamp_call();
+
+    if (failures) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+
+    return 0;
+}
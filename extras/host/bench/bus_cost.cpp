@@ -0,0 +1,286 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * Bus cost of every public driver call, measured against the simulators.
+ *
+ * For each call the table lists I2C transfers (address phases), data bytes
+ * written and read and wire time at 100kHz as seen by the bus, then the
+ * transactions and time the driver's own instrumentation recorded, and the
+ * value the call returned.
+ */
+
+#include <stdio.h>
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+
+static void report(const char *part, const char *call, const rtc_bus_stats_t &drv, int ret)
+{
+    const host_i2c_stats_t &s = Wire.stats();
+
+    printf("%-9s %-64s %5lu %5lu %5lu %7llu %5lu %7lu %5d\n", part, call,
+           (unsigned long)s.transfers, (unsigned long)s.bytes_out, (unsigned long)s.bytes_in,
+           (unsigned long long)s.bus_time_us,
+           (unsigned long)drv.transactions, (unsigned long)drv.bus_time_us, ret);
+}
+
+/* 'rtc' is the driver under test in every bench function */
+#define MEASURE(part, call)             \
+    do {                                \
+        rtc_bus_stats_t _drv;           \
+        int _ret;                       \
+        Wire.reset_stats();             \
+        rtc.reset_bus_stats();          \
+        _ret = (call);                  \
+        rtc.get_bus_stats(_drv);        \
+        report(part, #call, _drv, _ret); \
+    } while (0)
+
+#define MEASURE_VOID(part, call)        \
+    do {                                \
+        rtc_bus_stats_t _drv;           \
+        Wire.reset_stats();             \
+        rtc.reset_bus_stats();          \
+        call;                           \
+        rtc.get_bus_stats(_drv);        \
+        report(part, #call, _drv, 0);   \
+    } while (0)
+
+static struct tm now_tm;
+static struct tm alarm_tm;
+static struct tm read_tm;
+
+static uint8_t ram[64];
+static bool enabled;
+
+static void header(void)
+{
+    printf("%-9s %-64s %5s %5s %5s %7s %5s %7s %5s\n", "part", "call",
+           "xfers", "out", "in", "bus_us", "drv", "drv_us", "ret");
+}
+
+static void bench_max31328(void)
+{
+    MAX31328Sim sim;
+    MAX31328 rtc(&Wire);
+    MAX31328::reg_status_t stat;
+    MAX31328::alarm_period_t period;
+    float temp;
+
+    Wire.attach(&sim);
+
+    MEASURE_VOID("MAX31328", rtc.begin());
+    MEASURE("MAX31328", rtc.set_time(&now_tm));
+    MEASURE("MAX31328", rtc.get_time(&read_tm));
+    MEASURE("MAX31328", rtc.get_status(stat));
+    MEASURE("MAX31328", rtc.set_alarm(MAX31328::ALARM1, &alarm_tm, MAX31328::ALARM_PERIOD_DAILY));
+    MEASURE("MAX31328", rtc.get_alarm(MAX31328::ALARM1, &read_tm, &period, &enabled));
+    MEASURE("MAX31328", rtc.irq_enable(MAX31328::INTR_ID_ALARM1));
+    MEASURE("MAX31328", rtc.irq_clear_flag());
+    MEASURE("MAX31328", rtc.start_temp_conversion());
+    MEASURE("MAX31328", rtc.get_temp(temp));
+
+    Wire.detach(&sim);
+}
+
+static void bench_max31329(void)
+{
+    MAX31329Sim sim;
+    MAX31329 rtc(&Wire);
+    MAX31329::reg_status_t stat;
+    MAX31329::alarm_period_t period;
+    uint8_t count;
+
+    Wire.attach(&sim);
+
+    MEASURE_VOID("MAX31329", rtc.begin());
+    MEASURE("MAX31329", rtc.set_time(&now_tm));
+    MEASURE("MAX31329", rtc.get_time(&read_tm));
+    MEASURE("MAX31329", rtc.get_status(stat));
+    MEASURE("MAX31329", rtc.set_alarm(MAX31329::ALARM1, &alarm_tm, MAX31329::ALARM_PERIOD_DAILY));
+    MEASURE("MAX31329", rtc.get_alarm(MAX31329::ALARM1, &read_tm, &period, &enabled));
+    MEASURE("MAX31329", rtc.irq_enable(MAX31329::INTR_ID_ALARM1));
+    MEASURE("MAX31329", rtc.timer_init(100, true, MAX31329::TIMER_FREQ_16HZ));
+    MEASURE("MAX31329", rtc.timer_start());
+    MEASURE("MAX31329", rtc.timer_get(count));
+    MEASURE("MAX31329", rtc.nvram_write(0, ram, 16));
+    MEASURE("MAX31329", rtc.nvram_read(0, ram, 16));
+    MEASURE("MAX31329", rtc.nvram_write(0, ram, rtc.nvram_size()));
+    MEASURE("MAX31329", rtc.nvram_read(0, ram, rtc.nvram_size()));
+
+    Wire.detach(&sim);
+}
+
+template <typename RTC>
+static void bench_max3134x_common(const char *part, RTC &rtc)
+{
+    typename RTC::reg_status_t stat;
+    typename RTC::alarm_period_t period;
+    uint8_t count;
+
+    MEASURE_VOID(part, rtc.begin());
+    MEASURE(part, rtc.set_time(&now_tm));
+    MEASURE(part, rtc.get_time(&read_tm));
+    MEASURE(part, rtc.get_status(stat));
+    MEASURE(part, rtc.set_alarm(RTC::ALARM1, &alarm_tm, RTC::ALARM_PERIOD_DAILY));
+    MEASURE(part, rtc.get_alarm(RTC::ALARM1, &read_tm, &period, &enabled));
+    MEASURE(part, rtc.irq_enable(RTC::INTR_ID_ALARM1));
+    MEASURE(part, rtc.timer_init(100, true, RTC::TIMER_FREQ_16HZ));
+    MEASURE(part, rtc.timer_start());
+    MEASURE(part, rtc.timer_get(count));
+}
+
+static void bench_max31341(void)
+{
+    MAX3134XSim sim(false);
+    MAX31341 rtc(&Wire, MAX31341_I2C_ADDRESS);
+
+    Wire.attach(&sim);
+
+    bench_max3134x_common("MAX31341", rtc);
+    MEASURE("MAX31341", rtc.nvram_write(ram, 0, 16));
+    MEASURE("MAX31341", rtc.nvram_read(ram, 0, 16));
+    MEASURE("MAX31341", rtc.nvram_write(ram, 0, rtc.nvram_size()));
+    MEASURE("MAX31341", rtc.nvram_read(ram, 0, rtc.nvram_size()));
+
+    Wire.detach(&sim);
+}
+
+static void bench_max31342(void)
+{
+    MAX3134XSim sim(true);
+    MAX31342 rtc(&Wire, MAX31342_I2C_ADDRESS);
+
+    Wire.attach(&sim);
+
+    bench_max3134x_common("MAX31342", rtc);
+
+    Wire.detach(&sim);
+}
+
+static void bench_max31343(void)
+{
+    MAX31343Sim sim;
+    MAX31343 rtc(&Wire);
+    MAX31343::reg_status_t stat;
+    MAX31343::alarm_period_t period;
+    MAX31343::reg_image_t img;
+    uint8_t count;
+    float temp;
+
+    Wire.attach(&sim);
+
+    MEASURE_VOID("MAX31343", rtc.begin());
+    MEASURE("MAX31343", rtc.set_time(&now_tm));
+    MEASURE("MAX31343", rtc.get_time(&read_tm));
+    MEASURE("MAX31343", rtc.get_status(stat));
+    MEASURE("MAX31343", rtc.set_alarm(MAX31343::ALARM1, &alarm_tm, MAX31343::ALARM_PERIOD_DAILY));
+    MEASURE("MAX31343", rtc.get_alarm(MAX31343::ALARM1, &read_tm, &period, &enabled));
+    MEASURE("MAX31343", rtc.irq_enable(MAX31343::INTR_ID_ALARM1));
+    MEASURE("MAX31343", rtc.timer_init(100, true, MAX31343::TIMER_FREQ_16HZ));
+    MEASURE("MAX31343", rtc.timer_start());
+    MEASURE("MAX31343", rtc.timer_get(count));
+    MEASURE("MAX31343", rtc.start_temp_conversion());
+    MEASURE("MAX31343", rtc.is_temp_ready());
+    MEASURE("MAX31343", rtc.get_temp(temp));
+    MEASURE("MAX31343", rtc.nvram_write(0, ram, 16));
+    MEASURE("MAX31343", rtc.nvram_read(0, ram, 16));
+    MEASURE("MAX31343", rtc.nvram_write(0, ram, rtc.nvram_size()));
+    MEASURE("MAX31343", rtc.nvram_read(0, ram, rtc.nvram_size()));
+    MEASURE("MAX31343", rtc.snapshot(img));
+    MEASURE("MAX31343", rtc.restore(img));
+
+    Wire.detach(&sim);
+}
+
+template <typename RTC>
+static void bench_max3133x(const char *part, MAX3133XSim::variant_t variant)
+{
+    MAX3133XSim sim(variant);
+    RTC rtc(&Wire);
+    max3133x_status_reg_t stat;
+    typename RTC::alarm_period_t period;
+    typename RTC::rtc_config_t config;
+    typename RTC::config_txn txn(&rtc);
+    uint16_t sub_sec;
+
+    Wire.attach(&sim);
+
+    MEASURE(part, rtc.begin());
+    MEASURE(part, rtc.set_time(&now_tm));
+    MEASURE(part, rtc.get_time(&read_tm, &sub_sec));
+    MEASURE(part, rtc.get_status_reg(&stat));
+    MEASURE(part, rtc.set_alarm(RTC::ALARM1, &alarm_tm, RTC::ALARM_PERIOD_DAILY));
+    MEASURE(part, rtc.get_alarm(RTC::ALARM1, &read_tm, &period, &enabled));
+    MEASURE(part, rtc.interrupt_enable(A1IE));
+    MEASURE(part, rtc.timer_init(100, true, RTC::TIMER_FREQ_16HZ));
+    MEASURE(part, rtc.timer_start());
+    MEASURE(part, rtc.timer_get());
+    MEASURE(part, rtc.get_rtc_config(&config));
+    config.enclko = RTC::CLOCK_OUTPUT;
+    config.clko_hz = RTC::CLKOUT_64HZ;
+    MEASURE(part, rtc.rtc_config(&config));
+    MEASURE(part, txn.load());
+    txn.set_din_polarity(RTC::RISING_EDGE)
+       .set_timestamp_function(true)
+       .set_timer(false, true, false, RTC::TIMER_FREQ_16HZ);
+    MEASURE(part, txn.commit());
+
+    Wire.detach(&sim);
+}
+
+int main(void)
+{
+    now_tm.tm_year = 124;
+    now_tm.tm_mon = 1;
+    now_tm.tm_mday = 29;
+    now_tm.tm_wday = 4;
+    now_tm.tm_hour = 23;
+    now_tm.tm_min = 59;
+    now_tm.tm_sec = 50;
+
+    alarm_tm = now_tm;
+    alarm_tm.tm_sec = 55;
+
+    header();
+    bench_max31328();
+    bench_max31329();
+    bench_max31341();
+    bench_max31342();
+    bench_max31343();
+    bench_max3133x<MAX31331>("MAX31331", MAX3133XSim::VARIANT_MAX31331);
+    bench_max3133x<MAX31334>("MAX31334", MAX3133XSim::VARIANT_MAX31334);
+    bench_max3133x<MAX31335>("MAX31335", MAX3133XSim::VARIANT_MAX31335);
+
+    return 0;
+}
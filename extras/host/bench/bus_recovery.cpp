@@ -0,0 +1,234 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * Bus recovery policies under injected bus errors.
+ *
+ * Each policy runs the same sequence of get_time() calls on a noisy bus:
+ * about one call in NOISE sees an address NACK, and every OUTAGE_EVERY
+ * calls the next OUTAGE_LEN transfers fail. Wire begin() is modelled as a
+ * 2ms peripheral re-init. The table lists the
+ * recovery counters, the calls that still failed, the Wire begin() calls
+ * and the mean and worst call latency in virtual time.
+ *
+ * "legacy" is what the drivers did before the policy existed: no retry,
+ * re-init on every error.
+ *
+ * Last, a call that fails every attempt must wait the sum of its backoffs,
+ * for a backoff too long for a 16-bit shift and for more retries than the
+ * doubling allows.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+
+#define CALLS           2000
+#define NOISE           20
+#define OUTAGE_EVERY    500
+#define OUTAGE_LEN      12
+#define BEGIN_TIME_US   2000
+#define BACKOFF_SLACK_US 30000
+
+#define SCL_PIN         21
+#define SDA_PIN         20
+
+static struct tm read_tm;
+
+static void header(void)
+{
+    printf("%-9s %-9s %6s %6s %8s %8s %7s %7s %7s %7s\n", "part", "policy",
+           "fail", "retry", "recover", "unstick", "reinit", "begins", "mean_us", "max_us");
+}
+
+template <class RTC>
+static void run(const char *part, RTC &rtc, const char *name, const rtc_bus_recovery_t &policy)
+{
+    rtc_bus_recovery_stats_t stats;
+    uint64_t total = 0;
+    uint64_t worst = 0;
+    int failed = 0;
+
+    rtc.get_transport()->set_recovery(policy);
+    rtc.get_transport()->reset_recovery_stats();
+    Wire.reset_stats();
+    srand(1);
+
+    for (int i = 0; i < CALLS; i++) {
+        uint64_t start;
+
+        if (i % OUTAGE_EVERY == OUTAGE_EVERY / 2) {
+            Wire.inject_error(2, OUTAGE_LEN);
+        } else if (rand() % NOISE == 0) {
+            Wire.inject_error(2, 1);
+        }
+
+        start = host_clock_us();
+        if (rtc.get_time(&read_tm) != 0) {
+            failed++;
+        }
+        start = host_clock_us() - start;
+
+        total += start;
+        if (start > worst) {
+            worst = start;
+        }
+    }
+
+    rtc.get_transport()->get_recovery_stats(stats);
+
+    printf("%-9s %-9s %6d %6lu %8lu %8lu %7lu %7lu %7llu %7llu\n", part, name, failed,
+           (unsigned long)stats.retries, (unsigned long)stats.recovered,
+           (unsigned long)stats.unsticks, (unsigned long)stats.reinits,
+           (unsigned long)Wire.stats().begins,
+           (unsigned long long)(total / CALLS), (unsigned long long)worst);
+}
+
+template <class RTC>
+static void run_policies(const char *part, RTC &rtc)
+{
+    const rtc_bus_recovery_t legacy = { 0, 0, 0, 1, -1, -1 };
+    const rtc_bus_recovery_t standard = RTC_BUS_RECOVERY_DEFAULT;
+    const rtc_bus_recovery_t patient = { 4, 50, 0, 5, -1, -1 };
+
+    run(part, rtc, "legacy", legacy);
+    run(part, rtc, "default", standard);
+    run(part, rtc, "patient", patient);
+}
+
+/* A target holding SDA low is freed by the unstick, then the call succeeds */
+static int check_unstick(void)
+{
+    MAX31343Sim sim;
+    MAX31343 rtc(&Wire);
+    rtc_bus_recovery_t policy = { 1, 50, 1, 3, SCL_PIN, SDA_PIN };
+    rtc_bus_recovery_stats_t stats;
+    int ret = 0;
+
+    Wire.attach(&sim);
+    rtc.get_transport()->set_recovery(policy);
+
+    /* SDA stays low: the unstick is tried but does not count */
+    host_pin_set(SDA_PIN, LOW);
+    Wire.inject_error(4, 2);
+    rtc.get_time(&read_tm);
+    rtc.get_transport()->get_recovery_stats(stats);
+    if (stats.failures != 1 || stats.unsticks != 0) {
+        printf("unstick: stuck SDA reported as released\n");
+        ret = 1;
+    }
+
+    host_pin_set(SDA_PIN, HIGH);
+    Wire.inject_error(4, 2);
+    rtc.get_time(&read_tm);
+    rtc.get_transport()->get_recovery_stats(stats);
+    if (stats.failures != 2 || stats.unsticks != 1) {
+        printf("unstick: released SDA not counted\n");
+        ret = 1;
+    }
+
+    if (rtc.get_time(&read_tm) != 0) {
+        printf("unstick: bus not usable afterwards\n");
+        ret = 1;
+    }
+
+    Wire.detach(&sim);
+    return ret;
+}
+
+/* Virtual time of one get_time() whose every attempt fails, against the sum of the backoffs */
+static int check_backoff(const char *name, const rtc_bus_recovery_t &policy, uint32_t want_us)
+{
+    MAX31343Sim sim;
+    MAX31343 rtc(&Wire);
+    uint64_t start;
+    int ret = 0;
+
+    Wire.attach(&sim);
+    rtc.get_transport()->set_recovery(policy);
+
+    Wire.inject_error(2, policy.retries + 1);
+    start = host_clock_us();
+    rtc.get_time(&read_tm);
+    start = host_clock_us() - start;
+
+    printf("backoff %-10s %3u retries: waited %.1f ms, backoffs %.1f ms\n", name,
+           (unsigned)policy.retries, start / 1000.0, want_us / 1000.0);
+
+    /* The failed transfers themselves take a little bus time */
+    if (start < want_us || start > want_us + BACKOFF_SLACK_US) {
+        printf("backoff %s: waited %llu us, %lu us expected\n", name,
+               (unsigned long long)start, (unsigned long)want_us);
+        ret = 1;
+    }
+
+    Wire.detach(&sim);
+    return ret;
+}
+
+int main(void)
+{
+    Wire.set_begin_time(BEGIN_TIME_US);
+    host_serial_mute(true);
+
+    header();
+    {
+        MAX31343Sim sim;
+        MAX31343 rtc(&Wire);
+
+        Wire.attach(&sim);
+        run_policies("MAX31343", rtc);
+        Wire.detach(&sim);
+    }
+    {
+        MAX3133XSim sim(MAX3133XSim::VARIANT_MAX31335);
+        MAX31335 rtc(&Wire);
+
+        Wire.attach(&sim);
+        run_policies("MAX31335", rtc);
+        Wire.detach(&sim);
+    }
+
+    int ret = check_unstick();
+
+    /* 20 + 40 + 80 ms, past what a 16-bit shift holds */
+    rtc_bus_recovery_t slow = { 3, 20000, 0, 0, -1, -1 };
+    ret |= check_backoff("slow", slow, 140000);
+
+    /* 1 us for the first retry, doubled up to 32768 us, held for the last 4 retries */
+    rtc_bus_recovery_t many = { 20, 1, 0, 0, -1, -1 };
+    ret |= check_backoff("many", many, 65535 + 4 * 32768);
+
+    return ret;
+}
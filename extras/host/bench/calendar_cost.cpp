@@ -0,0 +1,365 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * Calendar arithmetic on time register blocks.
+ *
+ * rtc_time_regs_add(), _add_days(), _diff() and _cmp() are checked
+ * against timegm()/gmtime_r() on random blocks from 2000 to 2199, 12 hour
+ * mode and the century bit included, and at both ends of the range,
+ * where they must fail and leave the block as is.
+ *
+ * The table compares "alarm in 90 s" and "seconds between two times"
+ * computed through struct tm (RTCCore::decode_time(), timegm(),
+ * RTCCore::encode_alarm_ext()) with the register block helpers, in TSC
+ * cycles per call on x86, in ns elsewhere. Last, a MAX31343 alarm is set
+ * 90 s ahead from the time registers alone and must fire 90 s later.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define COST_UNIT   "cycles"
+#else
+#define COST_UNIT   "ns"
+#endif
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+
+#define NUM_BLOCKS  1024
+#define LOOPS       200
+
+#define DAYS_Y2K    10957L  /* 2000-01-01 */
+#define DAYS_END    84006L  /* 2200-01-01 */
+
+static uint8_t blocks[NUM_BLOCKS][RTC_CORE_TIME_LEN];
+static int64_t secs[NUM_BLOCKS];
+static int32_t deltas[NUM_BLOCKS];
+
+static int failures;
+
+static uint64_t now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+static uint32_t rnd(void)
+{
+    static uint32_t seed = 2024;
+
+    seed = seed * 1103515245 + 12345;
+    return seed >> 1;
+}
+
+/* Time register block of Unix seconds through gmtime_r(), 12 hour mode if asked */
+static void to_block(int64_t t, uint8_t *regs, bool h12)
+{
+    time_t tt = t;
+    struct tm tm;
+    int hour;
+
+    gmtime_r(&tt, &tm);
+    regs[0] = rtc_bin2bcd(tm.tm_sec);
+    regs[1] = rtc_bin2bcd(tm.tm_min);
+    if (h12) {
+        hour = tm.tm_hour % 12;
+        regs[2] = 0x40 | ((tm.tm_hour >= 12) ? 0x20 : 0) | rtc_bin2bcd(hour ? hour : 12);
+    } else {
+        regs[2] = rtc_bin2bcd(tm.tm_hour);
+    }
+    regs[3] = tm.tm_wday + 1;
+    regs[4] = rtc_bin2bcd(tm.tm_mday);
+    regs[5] = rtc_bin2bcd(tm.tm_mon + 1) | ((tm.tm_year >= 200) ? 0x80 : 0);
+    regs[6] = rtc_bin2bcd(tm.tm_year % 100);
+}
+
+static bool same_block(const uint8_t *a, const uint8_t *b)
+{
+    uint8_t ha = rtc_bcd_hours(a[2]);
+    uint8_t hb = rtc_bcd_hours(b[2]);
+
+    return (a[0] == b[0]) && (a[1] == b[1]) && (ha == hb) && !memcmp(&a[3], &b[3], 4);
+}
+
+static void make_blocks(void)
+{
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        secs[i] = (DAYS_Y2K + (int64_t)(rnd() % (DAYS_END - DAYS_Y2K))) * 86400 + rnd() % 86400;
+        to_block(secs[i], blocks[i], i & 1);
+
+        switch (i % 4) {
+            case 0: deltas[i] = 90; break;
+            case 1: deltas[i] = -(int32_t)(rnd() % 100000); break;
+            case 2: deltas[i] = (int32_t)(rnd() % 400000000) - 200000000; break;
+            default: deltas[i] = (int32_t)(rnd() % 86400) * ((rnd() & 1) ? 1 : -1); break;
+        }
+    }
+}
+
+static void check_one(int i)
+{
+    uint8_t regs[RTC_CORE_TIME_LEN];
+    uint8_t want[RTC_CORE_TIME_LEN];
+    int64_t to = secs[i] + deltas[i];
+    int32_t days = deltas[i] / 86400;
+    int j = (i + 1) % NUM_BLOCKS;
+    bool in_range = (to >= DAYS_Y2K * 86400) && (to < DAYS_END * 86400);
+    int want_cmp;
+
+    memcpy(regs, blocks[i], sizeof(regs));
+    if (rtc_time_regs_add(regs, deltas[i]) != (in_range ? 0 : -1)) {
+        printf("block %d: rtc_time_regs_add(%ld) returns the wrong code\n", i, (long)deltas[i]);
+        failures++;
+    } else {
+        to_block(in_range ? to : secs[i], want, false);
+        if (!same_block(regs, in_range ? want : blocks[i])) {
+            printf("block %d: rtc_time_regs_add(%ld) is off\n", i, (long)deltas[i]);
+            failures++;
+        }
+    }
+
+    to = secs[i] + (int64_t)days * 86400;
+    in_range = (to >= DAYS_Y2K * 86400) && (to < DAYS_END * 86400);
+    memcpy(regs, blocks[i], sizeof(regs));
+    if (rtc_time_regs_add_days(regs, days) != (in_range ? 0 : -1)) {
+        printf("block %d: rtc_time_regs_add_days(%ld) returns the wrong code\n", i, (long)days);
+        failures++;
+    } else if (in_range) {
+        to_block(to, want, false);
+        if (!same_block(regs, want)) {
+            printf("block %d: rtc_time_regs_add_days(%ld) is off\n", i, (long)days);
+            failures++;
+        }
+    }
+
+    want_cmp = (secs[i] > secs[j]) - (secs[i] < secs[j]);
+    if (rtc_time_regs_cmp(blocks[i], blocks[j]) != want_cmp) {
+        printf("block %d: rtc_time_regs_cmp() is off\n", i);
+        failures++;
+    }
+    if ((secs[i] - secs[j] < 0x7FFFFFFFLL) && (secs[j] - secs[i] < 0x7FFFFFFFLL)
+        && (rtc_time_regs_diff(blocks[i], blocks[j]) != secs[i] - secs[j])) {
+        printf("block %d: rtc_time_regs_diff() is off\n", i);
+        failures++;
+    }
+}
+
+static void check_ends(void)
+{
+    uint8_t last[RTC_CORE_TIME_LEN];
+    uint8_t first[RTC_CORE_TIME_LEN];
+    uint8_t regs[RTC_CORE_TIME_LEN];
+
+    to_block(DAYS_END * 86400 - 1, last, false);
+    to_block(DAYS_Y2K * 86400, first, false);
+
+    memcpy(regs, last, sizeof(regs));
+    if ((rtc_time_regs_add(regs, 1) != -1) || memcmp(regs, last, sizeof(regs))) {
+        printf("2199-12-31 23:59:59 + 1 s does not fail cleanly\n");
+        failures++;
+    }
+    memcpy(regs, first, sizeof(regs));
+    if ((rtc_time_regs_add(regs, -1) != -1) || memcmp(regs, first, sizeof(regs))) {
+        printf("2000-01-01 00:00:00 - 1 s does not fail cleanly\n");
+        failures++;
+    }
+    /* 2099-12-31 23:59:59 + 1 s sets the century bit */
+    to_block(4102444799LL, regs, false);
+    if (rtc_time_regs_add(regs, 1) || (regs[5] != 0x81) || (regs[6] != 0x00) || (regs[4] != 0x01)) {
+        printf("2099 to 2100 does not set the century bit\n");
+        failures++;
+    }
+    /* 2100 is not a leap year, 2000 is */
+    to_block(4107456000LL, regs, false);    /* 2100-02-28 */
+    if (rtc_time_regs_add_days(regs, 1) || (regs[5] != 0x83) || (regs[4] != 0x01)) {
+        printf("2100-02-28 + 1 day is not March 1st\n");
+        failures++;
+    }
+    to_block(951696000LL, regs, false);     /* 2000-02-28 */
+    if (rtc_time_regs_add_days(regs, 1) || (regs[5] != 0x02) || (regs[4] != 0x29)) {
+        printf("2000-02-28 + 1 day is not February 29th\n");
+        failures++;
+    }
+}
+
+static void report(const char *what, uint64_t cost, double base)
+{
+    double per_call = (double)cost / (LOOPS * NUM_BLOCKS);
+
+    printf("%-34s %10.1f %7.2f\n", what, per_call, base / per_call);
+}
+
+static void cost(void)
+{
+    uint8_t regs[RTC_CORE_TIME_LEN];
+    uint8_t alarm[RTC_CORE_ALARM_EXT_LEN];
+    struct tm t;
+    struct tm u;
+    int64_t sum = 0;
+    uint64_t start;
+    uint64_t tm_cost;
+
+    start = now();
+    for (int n = 0; n < LOOPS; n++) {
+        for (int i = 0; i < NUM_BLOCKS; i++) {
+            time_t tt;
+
+            RTCCore::decode_time(blocks[i], &t);
+            tt = timegm(&t) + 90;
+            gmtime_r(&tt, &t);
+            RTCCore::encode_alarm_ext(true, &t, RTC_ALARM_PERIOD_ONETIME, alarm);
+            __asm__ volatile("" : : "r"(alarm) : "memory");
+        }
+    }
+    tm_cost = now() - start;
+    report("alarm in 90 s, struct tm", tm_cost, tm_cost / (double)(LOOPS * NUM_BLOCKS));
+
+    start = now();
+    for (int n = 0; n < LOOPS; n++) {
+        for (int i = 0; i < NUM_BLOCKS; i++) {
+            memcpy(regs, blocks[i], sizeof(regs));
+            rtc_time_regs_add(regs, 90);
+            rtc_time_regs_to_alarm(regs, alarm);
+            __asm__ volatile("" : : "r"(alarm) : "memory");
+        }
+    }
+    report("alarm in 90 s, register block", now() - start, tm_cost / (double)(LOOPS * NUM_BLOCKS));
+
+    start = now();
+    for (int n = 0; n < LOOPS; n++) {
+        for (int i = 0; i < NUM_BLOCKS; i++) {
+            RTCCore::decode_time(blocks[i], &t);
+            RTCCore::decode_time(blocks[(i + 1) % NUM_BLOCKS], &u);
+            sum += timegm(&t) - timegm(&u);
+        }
+    }
+    tm_cost = now() - start;
+    report("diff, struct tm", tm_cost, tm_cost / (double)(LOOPS * NUM_BLOCKS));
+
+    start = now();
+    for (int n = 0; n < LOOPS; n++) {
+        for (int i = 0; i < NUM_BLOCKS; i++) {
+            sum += rtc_time_regs_diff(blocks[i], blocks[(i + 1) % NUM_BLOCKS]);
+        }
+    }
+    report("diff, register block", now() - start, tm_cost / (double)(LOOPS * NUM_BLOCKS));
+
+    __asm__ volatile("" : : "r"(sum));
+}
+
+/* Alarm 1 of a MAX31343 90 s ahead, read, add, write: no struct tm */
+static void alarm_in_90s(void)
+{
+    MAX31343Sim sim;
+    MAX31343 rtc(&Wire);
+    uint8_t regs[RTC_CORE_TIME_LEN];
+    uint8_t alarm[RTC_CORE_ALARM_EXT_LEN];
+    struct tm t;
+    MAX31343::alarm_period_t period;
+    bool enabled;
+
+    Wire.attach(&sim);
+    rtc.begin();
+
+    memset(&t, 0, sizeof(t));
+    t.tm_year = 199;
+    t.tm_mon = 11;
+    t.tm_mday = 31;
+    t.tm_hour = 23;
+    t.tm_min = 59;
+    t.tm_sec = 10;
+    rtc.set_time(&t);
+
+    rtc.read_register(MAX31343_R_SECONDS, regs, sizeof(regs));
+    rtc_time_regs_add(regs, 90);
+    rtc_time_regs_to_alarm(regs, alarm);
+    rtc.write_register(MAX31343_R_ALM1_SEC, alarm, sizeof(alarm));
+
+    /* The alarm year register has no century bit: 2100 reads back as 2000 */
+    rtc.get_alarm(MAX31343::ALARM1, &t, &period, &enabled);
+    if ((period != MAX31343::ALARM_PERIOD_ONETIME) || (t.tm_year % 100 != 0) || (t.tm_min != 0) || (t.tm_sec != 40)) {
+        printf("MAX31343: alarm in 90 s reads back as %04d-%02d-%02d %02d:%02d:%02d period %d\n", t.tm_year + 1900,
+               t.tm_mon + 1, t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec, (int)period);
+        failures++;
+    }
+
+    delay(89000);
+    sim.sync();
+    if (sim.peek(MAX31343_R_STATUS) & SIM_FLAG_A1) {
+        printf("MAX31343: alarm in 90 s fired early\n");
+        failures++;
+    }
+    delay(2000);
+    sim.sync();
+    if (!(sim.peek(MAX31343_R_STATUS) & SIM_FLAG_A1)) {
+        printf("MAX31343: alarm in 90 s did not fire\n");
+        failures++;
+    }
+
+    Wire.detach(&sim);
+}
+
+int main(void)
+{
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    host_serial_mute(true);
+
+    make_blocks();
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        check_one(i);
+    }
+    check_ends();
+
+    printf("%-34s %10s %7s\n", "call", COST_UNIT, "speedup");
+    cost();
+
+    alarm_in_90s();
+
+    if (failures) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+
+    return 0;
+}
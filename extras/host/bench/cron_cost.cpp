@@ -0,0 +1,477 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+/*
+ * Cron schedules, RTCCron.h.
+ *
+ * rtc_cron_next() is checked against a reference that tests whole days
+ * with rtc_cron_match() and scans the seconds of the first one, for
+ * random specs of every field syntax from random start times, and the
+ * time it takes is compared with a minute by minute scan for a few
+ * typical specs, in TSC cycles per call on x86, in ns elsewhere.
+ *
+ * rtc_cron_to_alarm() must map the specs a hardware alarm can run to that
+ * alarm. Each mapped spec is set with set_alarm() on MAX31328 and
+ * MAX31343 and the simulated alarm flag must rise exactly at the next
+ * three times rtc_cron_next() gives, never before.
+ *
+ * Last, RTCAlarmScheduler::add_cron() runs a week with a daily spec,
+ * which goes on ALARM2, and a business hours spec, which is re-armed on
+ * ALARM1 after each fire. Every callback must run at its time.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define COST_UNIT   "cycles"
+#else
+#define COST_UNIT   "ns"
+#endif
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+
+#define START_EPOCH     1717977600UL    /* 2024-06-10 00:00:00, a Monday */
+#define DAY_SECS        86400UL
+#define WEEK_SECS       (7 * DAY_SECS)
+#define NUM_RANDOM      3000
+#define REF_DAYS        (9 * 366)
+#define COST_LOOPS      200
+
+static int failures;
+
+static uint64_t now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+/* Whole days first, then the seconds of the matching day */
+static int ref_next(const rtc_cron_t *cron, rtc_epoch_t after, rtc_epoch_t *next)
+{
+    rtc_epoch_t day = (after + 1) - (after + 1) % DAY_SECS;
+    rtc_epoch_t t;
+    struct tm tm;
+
+    for (int d = 0; d < REF_DAYS; d++, day += DAY_SECS) {
+        rtc_epoch_to_tm(day, &tm);
+        /* Any time of the day, only the day fields are looked at */
+        tm.tm_hour = __builtin_ctzl(cron->hour);
+        tm.tm_min = __builtin_ctzll(cron->min);
+        tm.tm_sec = __builtin_ctzll(cron->sec);
+        if (!rtc_cron_match(cron, &tm)) {
+            continue;
+        }
+
+        for (t = (day > after) ? day : after + 1; t < day + DAY_SECS; t++) {
+            rtc_epoch_to_tm(t, &tm);
+            if (rtc_cron_match(cron, &tm)) {
+                *next = t;
+                return 0;
+            }
+        }
+    }
+
+    return -1;
+}
+
+/* The scan rtc_cron_next() replaces, five field specs only */
+static int scan_next(const rtc_cron_t *cron, rtc_epoch_t after, rtc_epoch_t *next)
+{
+    struct tm tm;
+    rtc_epoch_t t = after - after % 60 + 60;
+
+    for (uint32_t i = 0; i < 9 * 366 * 1440UL; i++, t += 60) {
+        rtc_epoch_to_tm(t, &tm);
+        if (rtc_cron_match(cron, &tm)) {
+            *next = t;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+static void field(char *buf, int lo, int hi, bool names_ok, const char *const *names, int base)
+{
+    int a, b, kind = rand() % 8;
+
+    a = lo + rand() % (hi - lo + 1);
+    b = a + rand() % (hi - a + 1);
+
+    switch (kind) {
+        case 0: case 1: strcpy(buf, "*"); break;
+        case 2: sprintf(buf, "%d", a); break;
+        case 3: sprintf(buf, "%d-%d", a, b); break;
+        case 4: sprintf(buf, "*/%d", 1 + rand() % 12); break;
+        case 5: sprintf(buf, "%d-%d/%d", a, b, 1 + rand() % 5); break;
+        case 6: sprintf(buf, "%d,%d", a, b); break;
+        default:
+            if (names_ok) {
+                sprintf(buf, "%s-%s", names[a - base], names[b - base]);
+            } else {
+                sprintf(buf, "%d/%d", a, 1 + rand() % 20);
+            }
+            break;
+    }
+}
+
+static void check_random(void)
+{
+    static const char *const mons[] = { "Jan", "FEB", "mar", "Apr", "May", "Jun",
+                                        "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+    static const char *const wdays[] = { "Sun", "MON", "tue", "Wed", "Thu", "Fri", "Sat" };
+    char spec[256], f[6][32];
+    rtc_cron_t cron;
+    rtc_epoch_t after, got = 0, want = 0;
+    int r_got, r_want;
+    int mismatches = 0, never = 0;
+
+    srand(1);
+    for (int i = 0; i < NUM_RANDOM; i++) {
+        field(f[0], 0, 59, false, NULL, 0);
+        field(f[1], 0, 59, false, NULL, 0);
+        field(f[2], 0, 23, false, NULL, 0);
+        field(f[3], 1, 31, false, NULL, 1);
+        field(f[4], 1, 12, true, mons, 1);
+        field(f[5], 0, 6, true, wdays, 0);
+        if (rand() % 2) {
+            sprintf(spec, "%s %s %s %s %s %s", f[0], f[1], f[2], f[3], f[4], f[5]);
+        } else {
+            sprintf(spec, "%s %s %s %s %s", f[1], f[2], f[3], f[4], f[5]);
+        }
+
+        if (rtc_cron_parse(spec, &cron)) {
+            printf("\"%s\": parse failed\n", spec);
+            failures++;
+            continue;
+        }
+
+        after = 946684800UL + (rtc_epoch_t)(((uint64_t)rand() << 16 ^ rand()) % (3400UL * DAY_SECS));
+        r_got = rtc_cron_next(&cron, after, &got);
+        r_want = ref_next(&cron, after, &want);
+        never += (r_want != 0);
+
+        if ((r_got != r_want) || (!r_got && (got != want))) {
+            if (mismatches++ < 5) {
+                printf("\"%s\" after %lu: got %d/%lu, want %d/%lu\n", spec, (unsigned long)after,
+                       r_got, (unsigned long)got, r_want, (unsigned long)want);
+            }
+        }
+    }
+
+    printf("rtc_cron_next() on %d random specs: %d mismatches (%d never match within 9 years)\n",
+           NUM_RANDOM, mismatches, never);
+    failures += mismatches;
+
+    /* Syntax the parser must refuse */
+    static const char *const bad[] = { "", "* * * *", "* * * * * * *", "60 * * * *", "* 24 * * *",
+                                       "* * 0 * *", "* * * 13 *", "* * * * 8", "5-1 * * * *",
+                                       "*/0 * * * *", "x * * * *", "1,,2 * * * *", "@often" };
+    for (unsigned i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        if (rtc_cron_parse(bad[i], &cron) == 0) {
+            printf("\"%s\" parsed\n", bad[i]);
+            failures++;
+        }
+    }
+}
+
+static void cost(void)
+{
+    static const char *const specs[] = { "*/15 * * * *", "30 2 * * 1-5", "0 0 1 * *",
+                                         "0 9 13 * 5", "0 0 29 2 *", "59 23 31 12 *" };
+    rtc_cron_t cron;
+    rtc_epoch_t got = 0, want = 0;
+    uint64_t t0, t_next, t_scan;
+
+    printf("\n%-16s %12s %12s %8s\n", "spec", "next", "minute scan", "speedup");
+
+    for (unsigned i = 0; i < sizeof(specs) / sizeof(specs[0]); i++) {
+        rtc_cron_parse(specs[i], &cron);
+
+        t0 = now();
+        for (int k = 0; k < COST_LOOPS; k++) {
+            rtc_cron_next(&cron, START_EPOCH + k * 7919, &got);
+        }
+        t_next = now() - t0;
+
+        t0 = now();
+        for (int k = 0; k < COST_LOOPS / 20; k++) {
+            scan_next(&cron, START_EPOCH + k * 7919, &want);
+        }
+        t_scan = (now() - t0) * 20;
+
+        rtc_cron_next(&cron, START_EPOCH, &got);
+        scan_next(&cron, START_EPOCH, &want);
+        if (got != want) {
+            printf("\"%s\": next %lu, scan %lu\n", specs[i], (unsigned long)got, (unsigned long)want);
+            failures++;
+        }
+
+        printf("%-16s %12.0f %12.0f %8.0f\n", specs[i], (double)t_next / COST_LOOPS,
+               (double)t_scan / COST_LOOPS, (double)t_scan / t_next);
+    }
+}
+
+static const char *period_name(int period)
+{
+    static const char *const names[] = { "EVERYSECOND", "EVERYMINUTE", "HOURLY", "DAILY",
+                                         "WEEKLY", "MONTHLY", "YEARLY", "ONETIME" };
+
+    return (period >= 0) ? names[period] : "-";
+}
+
+/* The alarm flag must rise at each time rtc_cron_next() gives and not before */
+template <class RTC>
+static int alarm_follows(RTC &rtc, RTCSim &sim, const rtc_cron_t *cron, rtc_epoch_t start)
+{
+    typename RTC::reg_status_t stat;
+    rtc_epoch_t t = start, next;
+
+    for (int i = 0; i < 3; i++) {
+        if (rtc_cron_next(cron, t, &next)) {
+            return -1;
+        }
+        sim.sync();
+        host_clock_advance((uint64_t)(next - t - 1) * 1000000ULL);
+        if (sim.int_asserted()) {
+            return -1;
+        }
+        host_clock_advance(1000000ULL);
+        if (!sim.int_asserted()) {
+            return -1;
+        }
+        rtc.get_status(stat);
+        rtc.irq_clear_flag(RTC::INTR_ID_ALARM1);
+        t = next;
+    }
+
+    return 0;
+}
+
+template <class RTC>
+static void check_alarm(const char *part, RTC &rtc, RTCSim &sim, bool month_regs)
+{
+    static const char *const specs[] = { "* * * * * *", "15 * * * * *", "@hourly", "7 30 * * * *",
+                                         "@daily", "0 30 6 * * *", "0 45 21 * * sat", "@weekly",
+                                         "@monthly", "0 0 12 15 * *", "@yearly", "30 0 8 29 2 *",
+                                         "*/15 * * * *", "30 2 * * 1-5", "0 0 1 * 1", "0 12 * 6 *",
+                                         "0 0 * * 0-6" };
+    rtc_cron_t cron;
+    struct tm time;
+    int period, ret;
+    bool expect;
+
+    Wire.attach(&sim);
+    rtc.begin();
+    rtc.irq_enable(RTC::INTR_ID_ALARM1);
+
+    for (unsigned i = 0; i < sizeof(specs) / sizeof(specs[0]); i++) {
+        rtc_cron_parse(specs[i], &cron);
+        ret = rtc_cron_to_alarm(&cron, &time, &period);
+
+        /* The driver refuses YEARLY without month alarm registers */
+        expect = (ret == 0);
+        if (expect) {
+            ret = rtc.set_alarm(RTC::ALARM1, &time, (typename RTC::alarm_period_t)period);
+            expect = month_regs || (period != RTC_ALARM_PERIOD_YEARLY);
+            if ((ret == 0) != expect) {
+                printf("%s \"%s\": set_alarm(%s) returned %d\n", part, specs[i], period_name(period), ret);
+                failures++;
+                continue;
+            }
+        }
+
+        printf("%-9s %-18s %-12s %s\n", part, specs[i], (ret == 0) ? period_name(period) : "-",
+               (ret == 0) ? "hardware" : "re-armed one-shot");
+
+        if (ret == 0) {
+            rtc.set_epoch(START_EPOCH);
+            sim.sync();
+            host_clock_advance(1000000 - sim.phase_us());
+            rtc.set_epoch(START_EPOCH);
+            rtc.irq_clear_flag(RTC::INTR_ID_ALARM1);
+            if (alarm_follows(rtc, sim, &cron, START_EPOCH)) {
+                printf("%s \"%s\": the alarm does not follow rtc_cron_next()\n", part, specs[i]);
+                failures++;
+            }
+        }
+    }
+
+    Wire.detach(&sim);
+}
+
+typedef struct {
+    const rtc_cron_t *cron;
+    rtc_epoch_t next;
+    uint32_t fires;
+    uint32_t wrong;
+} cron_alarm_t;
+
+static RTCSim *cur_sim;
+
+static void on_cron(uint16_t id, rtc_epoch_t when, void *arg)
+{
+    cron_alarm_t *a = (cron_alarm_t *)arg;
+    struct tm t;
+
+    (void)id;
+    cur_sim->get_calendar(&t);
+
+    if ((when != a->next) || ((rtc_epoch_t)mktime(&t) != when)) {
+        a->wrong++;
+    }
+    a->fires++;
+    rtc_cron_next(a->cron, when, &a->next);
+}
+
+template <class RTC>
+static void check_scheduler(const char *part, RTC &rtc, RTCSim &sim)
+{
+    RTCAlarmSchedulerT<RTC, 8> sched(&rtc);
+    rtc_alarm_sched_stats_t stats;
+    rtc_cron_t daily, office;
+    cron_alarm_t a_daily, a_office;
+    rtc_epoch_t t;
+    uint32_t wakes = 0, want_daily = 0, want_office = 0;
+
+    rtc_cron_parse("0 3 * * *", &daily);
+    rtc_cron_parse("*/15 9-17 * * mon-fri", &office);
+
+    for (t = START_EPOCH; t < START_EPOCH + WEEK_SECS; t += 60) {
+        struct tm tm;
+        rtc_epoch_to_tm(t, &tm);
+        want_daily += rtc_cron_match(&daily, &tm);
+        want_office += rtc_cron_match(&office, &tm);
+    }
+
+    cur_sim = &sim;
+    Wire.attach(&sim);
+    rtc.begin();
+    rtc.set_epoch(START_EPOCH - 1);
+    sim.sync();
+    host_clock_advance(1000000 - sim.phase_us());
+    rtc.set_epoch(START_EPOCH - 1);
+
+    memset(&a_daily, 0, sizeof(a_daily));
+    memset(&a_office, 0, sizeof(a_office));
+    a_daily.cron = &daily;
+    a_office.cron = &office;
+    rtc_cron_next(&daily, START_EPOCH - 1, &a_daily.next);
+    rtc_cron_next(&office, START_EPOCH - 1, &a_office.next);
+
+    sched.begin();
+    if (sched.add_cron(&daily, on_cron, &a_daily) || sched.add_cron(&office, on_cron, &a_office)) {
+        printf("%s: add_cron() failed\n", part);
+        failures++;
+    }
+
+    sched.reset_stats();
+    Wire.reset_stats();
+
+    for (uint32_t s = 0; s < WEEK_SECS; s++) {
+        sim.sync();
+        host_clock_advance(1000000 - sim.phase_us());
+        if (sim.int_asserted()) {
+            sched.irq();
+        }
+        if (sched.pending()) {
+            wakes++;
+            sched.service();
+        }
+    }
+
+    sched.get_stats(stats);
+    const host_i2c_stats_t &bs = Wire.stats();
+
+    printf("%-9s a week: daily %u/%u fires on ALARM2, office hours %u/%u fires on ALARM1, "
+           "%u wakes, %u arms, %u transfers\n", part, (unsigned)a_daily.fires, (unsigned)want_daily,
+           (unsigned)a_office.fires, (unsigned)want_office, (unsigned)wakes, (unsigned)stats.arms,
+           (unsigned)bs.transfers);
+
+    if ((a_daily.fires != want_daily) || (a_office.fires != want_office) || a_daily.wrong ||
+        a_office.wrong || (stats.fired_a2 != want_daily)) {
+        printf("%s: %u/%u wrong fires\n", part, (unsigned)a_daily.wrong, (unsigned)a_office.wrong);
+        failures++;
+    }
+
+    Wire.detach(&sim);
+}
+
+int main(void)
+{
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    host_serial_mute(true);
+
+    check_random();
+    cost();
+
+    printf("\n%-9s %-18s %-12s %s\n", "part", "spec", "alarm", "runs as");
+    {
+        MAX31328Sim sim;
+        MAX31328 rtc(&Wire);
+        check_alarm("MAX31328", rtc, sim, false);
+    }
+    {
+        MAX31343Sim sim;
+        MAX31343 rtc(&Wire);
+        check_alarm("MAX31343", rtc, sim, true);
+    }
+
+    printf("\n");
+    {
+        MAX31328Sim sim;
+        MAX31328 rtc(&Wire);
+        check_scheduler("MAX31328", rtc, sim);
+    }
+    {
+        MAX31343Sim sim;
+        MAX31343 rtc(&Wire);
+        check_scheduler("MAX31343", rtc, sim);
+    }
+
+    if (failures) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,325 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * CPU cost of reading the time as Unix seconds.
+ *
+ * The first table converts register blocks that are already in memory:
+ * RTCCore::decode_time() followed by mktime(), as a logger does after
+ * get_time(), against rtc_time_regs_to_epoch(). The second one times the
+ * full driver calls, get_time() + mktime() against get_epoch(), on every
+ * part. There the I2C mock and the simulator are included, so the ratio
+ * is smaller than for the conversion alone.
+ *
+ * Cost is in TSC cycles per call on x86, in ns elsewhere. Every result is
+ * checked against mktime() in UTC, and so is tm_yday. rtc_yday() must
+ * give 0 for a month or date out of range. set_epoch() is checked by
+ * reading the time back with get_time().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define COST_UNIT   "cycles"
+#else
+#define COST_UNIT   "ns"
+#endif
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+
+#define NUM_BLOCKS  256
+#define CONV_LOOPS  200
+#define CALL_LOOPS  2000
+
+static uint8_t blocks[NUM_BLOCKS][RTC_CORE_TIME_LEN];
+static rtc_epoch_t epochs[NUM_BLOCKS];
+
+static int failures;
+
+static uint64_t now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+static void check(const char *what, const char *part, rtc_epoch_t got, rtc_epoch_t want)
+{
+    if (got != want) {
+        printf("%s/%s: %llu, expected %llu\n", part, what, (unsigned long long)got,
+               (unsigned long long)want);
+        failures++;
+    }
+}
+
+static void report(const char *part, const char *what, uint64_t cost, int calls, double base)
+{
+    double per_call = (double)cost / calls;
+
+    printf("%-9s %-24s %10.1f %7.2f\n", part, what, per_call, base / per_call);
+}
+
+/* Dates from 2000 up to 2105, so that they fit a 32-bit rtc_epoch_t */
+static void make_blocks(void)
+{
+    uint32_t seed = 12345;
+
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        seed = seed * 1103515245 + 12345;
+        epochs[i] = RTC_EPOCH_Y2K + (seed >> 1) % (106UL * 365 * 86400);
+        if (rtc_epoch_to_time_regs(epochs[i], blocks[i])) {
+            printf("rtc_epoch_to_time_regs(%llu) failed\n", (unsigned long long)epochs[i]);
+            failures++;
+        }
+    }
+}
+
+static void convert(void)
+{
+    struct tm t;
+    rtc_epoch_t e;
+    uint64_t start, tm_cost, epoch_cost;
+
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        RTCCore::decode_time(blocks[i], &t);
+        int yday = t.tm_yday;
+        check("mktime", "convert", (rtc_epoch_t)mktime(&t), epochs[i]);
+        check("tm_yday", "convert", yday, t.tm_yday);
+        rtc_time_regs_to_epoch(blocks[i], &e);
+        check("epoch", "convert", e, epochs[i]);
+    }
+
+    /* Out of range, as in a timestamp slot never written: month and date 0 */
+    check("yday mon 0", "convert", rtc_yday(2024, 0, 1), 0);
+    check("yday mon 13", "convert", rtc_yday(2024, 13, 1), 0);
+    check("yday mday 0", "convert", rtc_yday(2024, 1, 0), 0);
+
+    start = now();
+    for (int n = 0; n < CONV_LOOPS; n++) {
+        for (int i = 0; i < NUM_BLOCKS; i++) {
+            RTCCore::decode_time(blocks[i], &t);
+            e = mktime(&t);
+            __asm__ volatile("" : : "r"(e) : "memory");
+        }
+    }
+    tm_cost = now() - start;
+
+    start = now();
+    for (int n = 0; n < CONV_LOOPS; n++) {
+        for (int i = 0; i < NUM_BLOCKS; i++) {
+            rtc_time_regs_to_epoch(blocks[i], &e);
+            __asm__ volatile("" : : "r"(e) : "memory");
+        }
+    }
+    epoch_cost = now() - start;
+
+    double base = (double)tm_cost / (CONV_LOOPS * NUM_BLOCKS);
+    report("-", "decode_time+mktime", tm_cost, CONV_LOOPS * NUM_BLOCKS, base);
+    report("-", "rtc_time_regs_to_epoch", epoch_cost, CONV_LOOPS * NUM_BLOCKS, base);
+}
+
+template <class RTC>
+static void bench(const char *part, RTC &rtc, RTCSim &sim)
+{
+    struct tm t;
+    rtc_epoch_t e;
+    uint64_t start, tm_cost, epoch_cost;
+
+    Wire.attach(&sim);
+    rtc.begin();
+
+    /* set_epoch() then get_time() and get_epoch() give the same time back */
+    for (int i = 0; i < NUM_BLOCKS; i += 16) {
+        int ret = rtc.set_epoch(epochs[i]);
+        ret |= rtc.get_time(&t);
+        int yday = t.tm_yday;
+        check("get_time", part, (rtc_epoch_t)mktime(&t), epochs[i]);
+        check("tm_yday", part, yday, t.tm_yday);
+        ret |= rtc.get_epoch(&e);
+        check("get_epoch", part, e, epochs[i]);
+        if (ret) {
+            printf("%s: driver call failed\n", part);
+            failures++;
+        }
+    }
+
+    start = now();
+    for (int n = 0; n < CALL_LOOPS; n++) {
+        rtc.get_time(&t);
+        e = mktime(&t);
+        __asm__ volatile("" : : "r"(e) : "memory");
+    }
+    tm_cost = now() - start;
+
+    start = now();
+    for (int n = 0; n < CALL_LOOPS; n++) {
+        rtc.get_epoch(&e);
+        __asm__ volatile("" : : "r"(e) : "memory");
+    }
+    epoch_cost = now() - start;
+
+    double base = (double)tm_cost / CALL_LOOPS;
+    report(part, "get_time+mktime", tm_cost, CALL_LOOPS, base);
+    report(part, "get_epoch", epoch_cost, CALL_LOOPS, base);
+
+    Wire.detach(&sim);
+}
+
+/* Sub-second path of MAX3133X: get_time_hr()/get_timestamp_hr() against get_time()/get_timestamp() */
+static void bench_hr(void)
+{
+    MAX3133XSim sim(MAX3133XSim::VARIANT_MAX31335);
+    MAX31335 rtc(&Wire);
+    MAX31335::timestamp_t ts;
+    MAX31335::timestamp_hr_t ts_hr;
+    struct tm t;
+    rtc_time_hr_t hr1, hr2;
+    uint16_t ms;
+    uint64_t start, tm_cost, hr_cost, ms_now;
+    static const uint8_t ts_regs[8] = { 0x55, 0x42, 0x17, 0x23, 0x29, 0x02, 0x24, 0x01 };
+
+    /* Integer fraction conversions match the double ones they replace */
+    for (int frac = 0; frac < RTC_HR_TICKS_PER_SEC; frac++) {
+        check("frac_to_ms", "convert", rtc_hr_frac_to_ms(frac), (uint16_t)((1000 * frac) / 128.0));
+        check("frac_to_us", "convert", rtc_hr_frac_to_us(frac), (uint32_t)((1000000 * frac) / 128.0));
+    }
+
+    Wire.attach(&sim);
+    rtc.begin();
+    rtc.set_epoch(epochs[0]);
+
+    /* get_time() lies between the get_time_hr() calls around it */
+    for (int i = 0; i < 300; i++) {
+        int ret = rtc.get_time_hr(&hr1);
+        ret |= rtc.get_time(&t, &ms);
+        ret |= rtc.get_time_hr(&hr2);
+        ms_now = (uint64_t)mktime(&t) * 1000 + ms;
+        if (ret || (rtc_hr_to_ms(&hr1) > ms_now) || (ms_now > rtc_hr_to_ms(&hr2))) {
+            printf("MAX31335/get_time_hr: %llu.%03u, get_time() %llu\n", (unsigned long long)hr1.sec,
+                   rtc_hr_frac_to_ms(hr1.frac), (unsigned long long)ms_now);
+            failures++;
+        }
+        host_clock_advance(3700);
+    }
+
+    /* A timestamp record, 2024-02-29 23:17:42 and 85/128 s, triggered by DIN */
+    for (int i = 0; i < 8; i++) {
+        sim.poke(MAX31335_TS0_SEC_1_128 + i, ts_regs[i]);
+    }
+    int ret = rtc.get_timestamp(MAX31335::TS0, &ts);
+    ret |= rtc.get_timestamp_hr(MAX31335::TS0, &ts_hr);
+    if (ret || (ts_hr.ts_trigger != MAX31335::DINF) || (ts.ts_trigger != ts_hr.ts_trigger)) {
+        printf("MAX31335/get_timestamp_hr: trigger %d, expected %d\n", ts_hr.ts_trigger, ts.ts_trigger);
+        failures++;
+    }
+    check("get_timestamp_hr", "MAX31335", ts_hr.time.sec, (rtc_epoch_t)mktime(&ts.ctime));
+    check("get_timestamp_hr", "MAX31335", ts_hr.time.frac, 0x55);
+    check("get_timestamp_hr", "MAX31335", rtc_hr_frac_to_ms(ts_hr.time.frac), ts.sub_sec);
+
+    start = now();
+    for (int n = 0; n < CALL_LOOPS; n++) {
+        rtc.get_time(&t, &ms);
+        ms_now = (uint64_t)mktime(&t) * 1000 + ms;
+        __asm__ volatile("" : : "r"(ms_now) : "memory");
+    }
+    tm_cost = now() - start;
+
+    start = now();
+    for (int n = 0; n < CALL_LOOPS; n++) {
+        rtc.get_time_hr(&hr1);
+        ms_now = rtc_hr_to_ms(&hr1);
+        __asm__ volatile("" : : "r"(ms_now) : "memory");
+    }
+    hr_cost = now() - start;
+
+    double base = (double)tm_cost / CALL_LOOPS;
+    report("MAX31335", "get_time+mktime, ms", tm_cost, CALL_LOOPS, base);
+    report("MAX31335", "get_time_hr, ms", hr_cost, CALL_LOOPS, base);
+
+    Wire.detach(&sim);
+}
+
+int main(void)
+{
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    host_serial_mute(true);
+
+    make_blocks();
+
+    printf("%-9s %-24s %10s %7s\n", "part", "call", COST_UNIT, "speedup");
+    convert();
+
+    {
+        MAX31328Sim sim;
+        MAX31328 rtc(&Wire);
+        bench("MAX31328", rtc, sim);
+    }
+    {
+        MAX31329Sim sim;
+        MAX31329 rtc(&Wire);
+        bench("MAX31329", rtc, sim);
+    }
+    {
+        MAX3134XSim sim(false);
+        MAX31341 rtc(&Wire, MAX31341_I2C_ADDRESS);
+        bench("MAX31341", rtc, sim);
+    }
+    {
+        MAX3134XSim sim(true);
+        MAX31342 rtc(&Wire, MAX31342_I2C_ADDRESS);
+        bench("MAX31342", rtc, sim);
+    }
+    {
+        MAX31343Sim sim;
+        MAX31343 rtc(&Wire);
+        bench("MAX31343", rtc, sim);
+    }
+    {
+        MAX3133XSim sim(MAX3133XSim::VARIANT_MAX31335);
+        MAX31335 rtc(&Wire);
+        bench("MAX31335", rtc, sim);
+    }
+
+    bench_hr();
+
+    return failures ? 1 : 0;
+}
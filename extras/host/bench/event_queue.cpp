@@ -0,0 +1,428 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+/*
+ * ISR to main loop event ring, RTCEventQueue.
+ *
+ * Ten simulated minutes on MAX31328, MAX31329, MAX31343 and MAX31331 with
+ * ALARM1 every second and ALARM2 at minute 5 of the hour. The "ISR" pushes an event
+ * on each falling edge of the simulated INT output and the main loop
+ * services the queue a random 0 to 900 ms later. Every edge must be
+ * delivered once, with ALARM2 in the status once. The table shows the
+ * largest error of the push() stamps against the simulator: within 2/128 s
+ * plus a millisecond on MAX31331, the time base and the stamp are both
+ * truncated, within a second on the parts whose time has whole seconds.
+ *
+ * A burst of 20 pushes on a queue of 8 must deliver 8, count 12
+ * overflows and still carry the flags in the status. An edge pushed while
+ * service() reads the part must be left for the next service() and its
+ * status read, with ALARM1 in it, and INT must be released after it.
+ *
+ * A producer and a consumer thread then run a million events through a
+ * queue of 16 with no RTC behind it. Every event must arrive once, in
+ * order, and pushed + overflows must match the attempts.
+ *
+ * Last, the CPU cost of push(), in TSC cycles per call on x86, in ns
+ * elsewhere.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define COST_UNIT   "cycles"
+#else
+#define COST_UNIT   "ns"
+#endif
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+
+#define START_EPOCH     1717977600UL    /* 2024-06-10 00:00:00 */
+#define RUN_SECS        600UL
+#define BURST           20
+#define STRESS_EVENTS   1000000UL
+#define COST_LOOPS      1000000
+
+static int failures;
+
+static uint64_t now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+/* Simulator time in microseconds since 1970 */
+static uint64_t sim_us(RTCSim &sim)
+{
+    struct tm t;
+
+    sim.sync();
+    sim.get_calendar(&t);
+    return (uint64_t)mktime(&t) * 1000000 + sim.phase_us();
+}
+
+typedef struct {
+    uint32_t events;
+    uint32_t a1;
+    uint32_t a2;
+    uint64_t edge_us;       /* Simulator time of the last edge */
+    int64_t  max_err_us;    /* Largest stamp error, absolute */
+} run_ctx_t;
+
+static void on_event(const rtc_event_t *event, void *arg)
+{
+    run_ctx_t *ctx = (run_ctx_t *)arg;
+    int64_t err = (int64_t)rtc_hr_to_us(&event->time) - (int64_t)ctx->edge_us;
+
+    if (err < 0) {
+        err = -err;
+    }
+    if (err > ctx->max_err_us) {
+        ctx->max_err_us = err;
+    }
+
+    ctx->events++;
+    ctx->a1 += (event->status & 0x01) != 0;
+    ctx->a2 += (event->status & 0x02) != 0;
+}
+
+template <class RTC>
+static int enable_alarms(RTC &rtc)
+{
+    return rtc.irq_enable((typename RTC::intr_id_t)(RTC::INTR_ID_ALARM1 | RTC::INTR_ID_ALARM2));
+}
+
+static int enable_alarms(MAX31331 &rtc)
+{
+    return rtc.interrupt_enable(A1IE | A2IE);
+}
+
+template <class RTC>
+static void setup(RTC &rtc, RTCSim &sim)
+{
+    struct tm t;
+    time_t start = START_EPOCH;
+
+    rtc.begin();
+    rtc.set_epoch(START_EPOCH);
+    sim.sync();
+    host_clock_advance(1000000 - sim.phase_us());
+    rtc.set_epoch(START_EPOCH);
+    sim.sync();
+
+    gmtime_r(&start, &t);
+    rtc.set_alarm(RTC::ALARM1, &t, RTC::ALARM_PERIOD_EVERYSECOND);
+    t.tm_min = 5;
+    rtc.set_alarm(RTC::ALARM2, &t, RTC::ALARM_PERIOD_HOURLY);
+    enable_alarms(rtc);
+}
+
+/* Lets the next ALARM1 match land after its status read, and pushes its edge */
+template <class RTC>
+class RacingEventQueue : public RTCEventQueueT<RTC, 8>
+{
+public:
+    RacingEventQueue(RTC *rtc, RTCSim *sim) : RTCEventQueueT<RTC, 8>(rtc), m_sim(sim), m_race(false) {}
+
+    void race(void) { m_race = true; }
+
+protected:
+    int read_status(uint8_t *status)
+    {
+        int ret = RTCEventQueueT<RTC, 8>::read_status(status);
+
+        if (m_race) {
+            m_race = false;
+            m_sim->sync();
+            host_clock_advance(1000000 - m_sim->phase_us());
+            m_sim->sync();
+            if (m_sim->int_asserted()) {
+                this->push();
+            }
+        }
+        return ret;
+    }
+
+private:
+    RTCSim *m_sim;
+    bool m_race;
+};
+
+template <class RTC>
+static void run(const char *part, RTC &rtc, RTCSim &sim, int64_t max_err_us)
+{
+    RTCEventQueueT<RTC, 16> queue(&rtc);
+    rtc_event_stats_t stats;
+    run_ctx_t ctx;
+    bool level;
+
+    memset(&ctx, 0, sizeof(ctx));
+    srand(1);
+
+    Wire.attach(&sim);
+    setup(rtc, sim);
+    queue.set_callback(on_event, &ctx);
+
+    /* Clears the flags of the setup and takes the first time base */
+    queue.push();
+    queue.service();
+    memset(&ctx, 0, sizeof(ctx));
+    queue.reset_stats();
+    Wire.reset_stats();
+    level = sim.int_asserted();
+
+    for (uint32_t s = 0; s < RUN_SECS; s++) {
+        sim.sync();
+        host_clock_advance(1000000 - sim.phase_us());
+        sim.sync();
+
+        if (sim.int_asserted() && !level) {
+            ctx.edge_us = sim_us(sim);
+            queue.push();
+        }
+
+        host_clock_advance((rand() % 900) * 1000);
+        if (queue.pending() && queue.service()) {
+            printf("%s: service() failed\n", part);
+            failures++;
+        }
+        level = sim.int_asserted();
+    }
+
+    const host_i2c_stats_t &bs = Wire.stats();
+    queue.get_stats(stats);
+
+    printf("%-9s %6u %6u %5u %5u %9u %7u %8.1f %9.2f\n", part, (unsigned)stats.pushed,
+           (unsigned)stats.delivered, (unsigned)ctx.a2, (unsigned)stats.overflows,
+           (unsigned)stats.status_reads, (unsigned)bs.transfers, bs.bus_time_us / 1000.0,
+           ctx.max_err_us / 1000.0);
+
+    if (ctx.events != RUN_SECS || ctx.a1 != RUN_SECS || ctx.a2 != 1 ||
+        stats.overflows || stats.errors || ctx.max_err_us > max_err_us) {
+        printf("%s: %u events, %u with A1F, %u with A2F, stamp error %.2f ms\n", part,
+               (unsigned)ctx.events, (unsigned)ctx.a1, (unsigned)ctx.a2, ctx.max_err_us / 1000.0);
+        failures++;
+    }
+
+    /* A burst: more edges than the queue holds before the main loop runs */
+    {
+        RTCEventQueueT<RTC, 8> small(&rtc);
+        run_ctx_t burst;
+        uint16_t delivered;
+
+        memset(&burst, 0, sizeof(burst));
+        small.set_callback(on_event, &burst);
+        sim.sync();
+        host_clock_advance(1000000 - sim.phase_us());
+        for (int i = 0; i < BURST; i++) {
+            small.push((uint8_t)i);
+        }
+        small.service(&delivered);
+        small.get_stats(stats);
+
+        if (delivered != 8 || stats.overflows != BURST - 8 || stats.high_water != 8 ||
+            burst.a1 != 8) {
+            printf("%s: burst delivered %u, %u overflows, high water %u, %u with A1F\n", part,
+                   (unsigned)delivered, (unsigned)stats.overflows, (unsigned)stats.high_water,
+                   (unsigned)burst.a1);
+            failures++;
+        }
+    }
+
+    /* An edge during service(): it must wait for the next status read */
+    {
+        RacingEventQueue<RTC> racing(&rtc, &sim);
+        run_ctx_t race;
+        uint16_t first, second;
+
+        memset(&race, 0, sizeof(race));
+        racing.set_callback(on_event, &race);
+        sim.sync();
+        host_clock_advance(1000000 - sim.phase_us());
+        sim.sync();
+        racing.push();
+        racing.race();
+        racing.service(&first);
+        bool left = racing.pending();
+        racing.service(&second);
+
+        if (first != 1 || !left || second != 1 || race.a1 != 2 || sim.int_asserted()) {
+            printf("%s: edge during service(): %u then %u delivered, %u with A1F, INT %s\n",
+                   part, (unsigned)first, (unsigned)second, (unsigned)race.a1,
+                   sim.int_asserted() ? "stuck" : "released");
+            failures++;
+        }
+    }
+
+    Wire.detach(&sim);
+}
+
+/* No RTC behind it, for the threads and the cost */
+class NullEventQueue : public RTCEventQueueT<MAX31343, 16>
+{
+public:
+    NullEventQueue() : RTCEventQueueT<MAX31343, 16>(NULL) {}
+
+protected:
+    int read_status(uint8_t *status) { *status = 0; return 0; }
+    int read_rtc(rtc_time_hr_t *time) { time->sec = START_EPOCH; time->frac = 0; return 0; }
+};
+
+typedef struct {
+    uint8_t  next;
+    uint32_t received;
+    uint32_t out_of_order;
+} stress_ctx_t;
+
+static void on_stress(const rtc_event_t *event, void *arg)
+{
+    stress_ctx_t *ctx = (stress_ctx_t *)arg;
+
+    if (event->source != ctx->next) {
+        ctx->out_of_order++;
+    }
+    ctx->next = event->source + 1;
+    ctx->received++;
+}
+
+static void stress(void)
+{
+    NullEventQueue queue;
+    stress_ctx_t ctx;
+    rtc_event_stats_t stats;
+    uint32_t attempts = 0;
+    volatile bool done = false;
+
+    memset(&ctx, 0, sizeof(ctx));
+    queue.set_callback(on_stress, &ctx);
+
+    std::thread consumer([&]() {
+        while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE) || queue.pending()) {
+            if (!queue.pending()) {
+                std::this_thread::yield();
+            }
+            queue.service();
+        }
+    });
+
+    /* The source is the sequence number, a dropped event is pushed again after a yield */
+    uint8_t seq = 0;
+    for (uint32_t sent = 0; sent < STRESS_EVENTS; attempts++) {
+        if (queue.push(seq)) {
+            seq++;
+            sent++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    __atomic_store_n(&done, true, __ATOMIC_RELEASE);
+    consumer.join();
+
+    queue.get_stats(stats);
+    printf("\n2 threads: %u events, %u attempts, %u overflows, %u received, %u out of order, high water %u\n",
+           (unsigned)STRESS_EVENTS, (unsigned)attempts, (unsigned)stats.overflows,
+           (unsigned)ctx.received, (unsigned)ctx.out_of_order, (unsigned)stats.high_water);
+
+    if (ctx.received != STRESS_EVENTS || ctx.out_of_order ||
+        stats.pushed != STRESS_EVENTS || stats.pushed + stats.overflows != attempts) {
+        printf("event queue lost or reordered events\n");
+        failures++;
+    }
+}
+
+static void cost(void)
+{
+    NullEventQueue queue;
+    uint64_t t0, t1;
+    uint64_t total = 0;
+
+    /* Anchored, so push() stamps from millis() as it does after the first service() */
+    queue.push();
+    queue.service();
+
+    for (int i = 0; i < COST_LOOPS / 8; i++) {
+        t0 = now();
+        for (int j = 0; j < 8; j++) {
+            queue.push();
+        }
+        t1 = now();
+        total += t1 - t0;
+        queue.service();
+    }
+
+    printf("push(): %.2f %s per call\n", (double)total / COST_LOOPS, COST_UNIT);
+}
+
+int main(void)
+{
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    host_serial_mute(true);
+
+    printf("%-9s %6s %6s %5s %5s %9s %7s %8s %9s\n", "part", "pushed", "deliv", "a2",
+           "ovfl", "st reads", "xfers", "bus ms", "stamp ms");
+
+    {
+        MAX31328Sim sim;
+        MAX31328 rtc(&Wire);
+        run("MAX31328", rtc, sim, 1000000);
+    }
+    {
+        MAX31329Sim sim;
+        MAX31329 rtc(&Wire);
+        run("MAX31329", rtc, sim, 1000000);
+    }
+    {
+        MAX31343Sim sim;
+        MAX31343 rtc(&Wire);
+        run("MAX31343", rtc, sim, 1000000);
+    }
+    {
+        MAX3133XSim sim(MAX3133XSim::VARIANT_MAX31331);
+        MAX31331 rtc(&Wire);
+        run("MAX31331", rtc, sim, 2 * 1000000 / 128 + 1000);
+    }
+
+    stress();
+    cost();
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,291 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+/*
+ * MAX3133X interrupt dispatcher, interrupt_attach() and post_interrupt_work().
+ *
+ * Two simulated hours on MAX31331 and MAX31335 with three sources on the
+ * INTA output: ALARM1 once a minute, ALARM2 once an hour and the timer in
+ * repeat mode every 5 s. The "ISR" only calls interrupt_handler() when the
+ * simulated output is asserted, the main loop calls post_interrupt_work()
+ * every second. Every handler must run the expected number of times. The
+ * table compares the bus traffic with a loop that reads STATUS every
+ * second and counts the flags itself.
+ *
+ * On MAX31335, a STATUS2 handler is attached and a temperature ready flag
+ * injected: STATUS2 must be read only while a STATUS2 handler is attached.
+ *
+ * Last, the CPU cost of post_interrupt_work() with nothing pending, the
+ * main loop overhead, in TSC cycles per call on x86, in ns elsewhere.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define COST_UNIT   "cycles"
+#else
+#define COST_UNIT   "ns"
+#endif
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+
+#define START_EPOCH     1717977600UL    /* 2024-06-10 00:00:00 */
+#define RUN_SECS        7200UL
+#define TIMER_SECS      5
+#define TIMER_HZ        16
+#define COST_LOOPS      1000000
+
+static int failures;
+
+static uint64_t now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+static void on_count(void *cb)
+{
+    (*(uint32_t *)cb)++;
+}
+
+/* Sleep to the next tick of the simulator, where its INT output can change */
+static void next_second(RTCSim &sim)
+{
+    sim.sync();
+    host_clock_advance(1000000 - sim.phase_us());
+}
+
+template <class RTC>
+static void setup(RTC &rtc, RTCSim &sim)
+{
+    struct tm t;
+    time_t start = START_EPOCH;
+
+    rtc.begin();
+    rtc.set_epoch(START_EPOCH);
+    next_second(sim);
+    rtc.set_epoch(START_EPOCH);
+    sim.sync();
+
+    gmtime_r(&start, &t);
+    t.tm_sec = 10;
+    rtc.set_alarm(MAX3133X::ALARM1, &t, MAX3133X::ALARM_PERIOD_EVERYMINUTE);
+    t.tm_sec = 0;
+    rtc.set_alarm(MAX3133X::ALARM2, &t, MAX3133X::ALARM_PERIOD_HOURLY);
+    rtc.timer_init(TIMER_SECS * TIMER_HZ, true, MAX3133X::TIMER_FREQ_16HZ);
+}
+
+template <class RTC>
+static void run(const char *part, RTC &rtc, RTCSim &sim)
+{
+    uint32_t count[3] = { 0, 0, 0 };
+    /* The timer starts a few transfers after the second, its last fire is after the run */
+    uint32_t expected[3] = { RUN_SECS / 60, RUN_SECS / 3600, (RUN_SECS - 1) / TIMER_SECS };
+    uint32_t wakes = 0;
+    max3133x_status_reg_t status;
+
+    Wire.attach(&sim);
+    setup(rtc, sim);
+
+    if (rtc.interrupt_attach(MAX3133X::INTR_ID_ALARM1, on_count, &count[0]) ||
+        rtc.interrupt_attach(MAX3133X::INTR_ID_ALARM2, on_count, &count[1]) ||
+        rtc.interrupt_attach(MAX3133X::INTR_ID_TIMER, on_count, &count[2])) {
+        printf("%s: interrupt_attach() failed\n", part);
+        failures++;
+    }
+    rtc.timer_start();
+    rtc.get_status_reg(&status);
+    Wire.reset_stats();
+
+    for (uint32_t s = 0; s < RUN_SECS; s++) {
+        next_second(sim);
+        if (sim.int_asserted()) {
+            rtc.interrupt_handler();
+        }
+        if (rtc.interrupt_pending()) {
+            wakes++;
+        }
+        if (rtc.post_interrupt_work()) {
+            printf("%s: post_interrupt_work() failed\n", part);
+            failures++;
+        }
+    }
+
+    const host_i2c_stats_t &bs = Wire.stats();
+    printf("%-9s %-11s %6u %5u %5u %5u %7u %8.1f\n", part, "dispatcher", (unsigned)wakes,
+           (unsigned)count[0], (unsigned)count[1], (unsigned)count[2],
+           (unsigned)bs.transfers, bs.bus_time_us / 1000.0);
+
+    for (int i = 0; i < 3; i++) {
+        if (count[i] != expected[i]) {
+            printf("%s: source %d ran %u times, %u expected\n", part, i,
+                   (unsigned)count[i], (unsigned)expected[i]);
+            failures++;
+        }
+    }
+    if (sim.int_asserted() || rtc.interrupt_pending()) {
+        printf("%s: interrupt left asserted\n", part);
+        failures++;
+    }
+
+    /* The same two hours, reading STATUS every second */
+    memset(count, 0, sizeof(count));
+    rtc.interrupt_detach(MAX3133X::INTR_ID_ALARM1);
+    rtc.interrupt_detach(MAX3133X::INTR_ID_ALARM2);
+    rtc.interrupt_detach(MAX3133X::INTR_ID_TIMER);
+    setup(rtc, sim);
+    rtc.interrupt_enable(A1IE | A2IE | TIE);
+    rtc.timer_start();
+    rtc.get_status_reg(&status);
+    Wire.reset_stats();
+
+    for (uint32_t s = 0; s < RUN_SECS; s++) {
+        next_second(sim);
+        rtc.get_status_reg(&status);
+        count[0] += status.bits.a1f;
+        count[1] += status.bits.a2f;
+        count[2] += status.bits.tif;
+    }
+
+    const host_i2c_stats_t &ps = Wire.stats();
+    printf("%-9s %-11s %6u %5u %5u %5u %7u %8.1f\n", part, "poll 1 Hz", (unsigned)RUN_SECS,
+           (unsigned)count[0], (unsigned)count[1], (unsigned)count[2],
+           (unsigned)ps.transfers, ps.bus_time_us / 1000.0);
+
+    rtc.interrupt_disable(INT_ALL);
+    rtc.timer_stop();
+    Wire.detach(&sim);
+}
+
+static void status2(void)
+{
+    MAX3133XSim sim(MAX3133XSim::VARIANT_MAX31335);
+    MAX31335 rtc(&Wire);
+    max31335_status2_reg_t flags;
+    uint32_t temp_rdy = 0;
+    uint32_t xfers[2];
+
+    Wire.attach(&sim);
+    rtc.begin();
+
+    flags.raw = 0;
+    flags.bits.temp_rdy = 1;
+
+    if (rtc.interrupt2_attach(MAX31335::INTR2_ID_TEMP_READY, on_count, &temp_rdy)) {
+        printf("MAX31335: interrupt2_attach() failed\n");
+        failures++;
+    }
+    sim.poke(MAX31335_STATUS2, flags.raw);
+    Wire.reset_stats();
+    rtc.interrupt_handler();
+    rtc.post_interrupt_work();
+    xfers[0] = Wire.stats().transfers;
+
+    rtc.interrupt2_detach(MAX31335::INTR2_ID_TEMP_READY);
+    sim.poke(MAX31335_STATUS2, flags.raw);
+    Wire.reset_stats();
+    rtc.interrupt_handler();
+    rtc.post_interrupt_work();
+    xfers[1] = Wire.stats().transfers;
+
+    printf("MAX31335 STATUS2 handler: %u call, %u transfers attached, %u detached\n",
+           (unsigned)temp_rdy, (unsigned)xfers[0], (unsigned)xfers[1]);
+
+    if (temp_rdy != 1 || xfers[0] != 2 * xfers[1]) {
+        printf("MAX31335: STATUS2 dispatch wrong\n");
+        failures++;
+    }
+
+    Wire.detach(&sim);
+}
+
+static void cost(void)
+{
+    MAX3133XSim sim(MAX3133XSim::VARIANT_MAX31331);
+    MAX31331 rtc(&Wire);
+    uint64_t t0, t1;
+    int ret = 0;
+
+    Wire.attach(&sim);
+    rtc.begin();
+
+    t0 = now();
+    for (int i = 0; i < COST_LOOPS; i++) {
+        ret |= rtc.post_interrupt_work();
+    }
+    t1 = now();
+
+    printf("\npost_interrupt_work() with nothing pending: %.2f %s per call\n",
+           (double)(t1 - t0) / COST_LOOPS, COST_UNIT);
+
+    if (ret) {
+        failures++;
+    }
+
+    Wire.detach(&sim);
+}
+
+int main(void)
+{
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    host_serial_mute(true);
+
+    printf("%-9s %-11s %6s %5s %5s %5s %7s %8s\n", "part", "mode", "wakes", "a1",
+           "a2", "timer", "xfers", "bus ms");
+
+    {
+        MAX3133XSim sim(MAX3133XSim::VARIANT_MAX31331);
+        MAX31331 rtc(&Wire);
+        run("MAX31331", rtc, sim);
+    }
+    {
+        MAX3133XSim sim(MAX3133XSim::VARIANT_MAX31335);
+        MAX31335 rtc(&Wire);
+        run("MAX31335", rtc, sim);
+    }
+
+    printf("\n");
+    status2();
+    cost();
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,256 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+/*
+ * Long countdowns on the 8-bit hardware timers, RTCLongTimer.
+ *
+ * Countdowns of 5 s, 10 min, 1 h at 1 ms resolution and 1 day run on
+ * MAX31329, MAX31341, MAX31343, MAX31331 and, with its 16-bit timer,
+ * MAX31334. The MCU only wakes on the simulated INT output and services
+ * the TIF up to a quarter of a hardware period late, as a busy main loop
+ * would. The table shows the frequency picked, the ticks, the wakes and
+ * where the countdown ended against start() + ticks, to the millisecond.
+ * It must end no more than 4 ms after it, the 1 ms wake step plus the bus
+ * time of start() and of the status read, however late the wakes were
+ * serviced, after exactly the expected number of wakes.
+ *
+ * The last column is the same countdown chained from software, the timer
+ * loaded again in one-shot mode on each TIF: there the service latency
+ * of every wake adds up.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+
+#define START_EPOCH     1717977600UL    /* 2024-06-10 00:00:00 */
+#define FINE_STEP_US    1000ULL
+#define END_BOUND_US    4000ULL         /* wake step, start() and status read */
+
+typedef struct {
+    uint32_t duration_ms;
+    uint32_t resolution_ms;
+    const char *name;
+} countdown_t;
+
+static const countdown_t countdowns[] = {
+    { 5000,         100,    "5 s / 100 ms" },
+    { 600000,       1000,   "10 min / 1 s" },
+    { 3600000,      1,      "1 h / 1 ms" },
+    { 86400000,     1000,   "1 day / 1 s" },
+};
+
+static const uint16_t timer_hz[4] = { 1024, 256, 64, 16 };
+
+static int failures;
+static RTCSim *cur_sim;
+static uint64_t end_us;
+
+/* Simulator time in microseconds since 1970 */
+static uint64_t sim_us(RTCSim &sim)
+{
+    struct tm t;
+
+    sim.sync();
+    sim.get_calendar(&t);
+    return (uint64_t)mktime(&t) * 1000000 + sim.phase_us();
+}
+
+static void on_expired(void *arg)
+{
+    (void)arg;
+    end_us = sim_us(*cur_sim);
+}
+
+template <class RTC>
+static int enable_timer_irq(RTC &rtc)
+{
+    return rtc.irq_enable(RTC::INTR_ID_TIMER);
+}
+
+static int enable_timer_irq(MAX31331 &rtc)
+{
+    return rtc.interrupt_enable(TIE);
+}
+
+static int enable_timer_irq(MAX31334 &rtc)
+{
+    return rtc.interrupt_enable(TIE);
+}
+
+/* Wake on the INT output, a quarter period apart, 1 ms apart in the last period */
+static void step(RTCSim &sim, uint64_t period_us, bool last)
+{
+    host_clock_advance(last ? FINE_STEP_US : period_us / 4);
+    sim.sync();
+}
+
+/* The same countdown, loaded again from software on each TIF */
+template <class RTC>
+static int64_t software_chain(RTC &rtc, RTCSim &sim, uint64_t ticks, uint8_t freq, uint16_t max_count)
+{
+    uint64_t period_us = (uint64_t)max_count * 1000000 / timer_hz[freq];
+    uint64_t left = ticks;
+    uint64_t t0;
+    uint16_t count;
+    uint8_t status;
+
+    count = left > max_count ? max_count : (uint16_t)left;
+    t0 = sim_us(sim);
+    rtc.timer_init(count, false, (typename RTC::timer_freq_t)freq);
+    rtc.timer_start();
+
+    for (;;) {
+        step(sim, period_us, left <= max_count);
+        if (!sim.int_asserted()) {
+            continue;
+        }
+
+        rtc_event_read_status(&rtc, &status);
+        left -= count;
+        if (left == 0) {
+            break;
+        }
+
+        count = left > max_count ? max_count : (uint16_t)left;
+        rtc.timer_init(count, false, (typename RTC::timer_freq_t)freq);
+        rtc.timer_start();
+    }
+
+    rtc.timer_stop();
+    return (int64_t)sim_us(sim) - (int64_t)(t0 + ticks * 1000000 / timer_hz[freq]);
+}
+
+template <class RTC, uint16_t MAX_COUNT>
+static void run(const char *part, RTC &rtc, RTCSim &sim)
+{
+    RTCLongTimerT<RTC, MAX_COUNT> timer(&rtc);
+    rtc_long_timer_stats_t stats;
+    uint8_t status;
+
+    cur_sim = &sim;
+    Wire.attach(&sim);
+    rtc.begin();
+    rtc.set_epoch(START_EPOCH);
+    enable_timer_irq(rtc);
+
+    for (unsigned i = 0; i < sizeof(countdowns) / sizeof(countdowns[0]); i++) {
+        const countdown_t *c = &countdowns[i];
+        uint64_t t0, expected, period_us;
+        uint32_t wakes;
+        int64_t err, sw_err;
+
+        rtc_event_read_status(&rtc, &status);
+        timer.reset_stats();
+        end_us = 0;
+
+        t0 = sim_us(sim);
+        if (timer.start(c->duration_ms, c->resolution_ms, on_expired, NULL)) {
+            printf("%s: start() failed\n", part);
+            failures++;
+            continue;
+        }
+        wakes = timer.tifs_left();
+        period_us = (uint64_t)MAX_COUNT * 1000000 / timer_hz[timer.freq()];
+
+        while (timer.running()) {
+            step(sim, period_us, timer.tifs_left() == 1);
+            if (sim.int_asserted()) {
+                timer.irq();
+            }
+            if (timer.pending() && timer.service()) {
+                printf("%s: service() failed\n", part);
+                failures++;
+                break;
+            }
+        }
+
+        timer.get_stats(stats);
+        expected = t0 + timer.ticks() * 1000000 / timer_hz[timer.freq()];
+        err = (int64_t)end_us - (int64_t)expected;
+        sw_err = software_chain(rtc, sim, timer.ticks(), timer.freq(), MAX_COUNT);
+
+        printf("%-9s %-13s %5u %9llu %6u %6u %9.1f %9.1f\n", part, c->name,
+               (unsigned)timer_hz[timer.freq()], (unsigned long long)timer.ticks(),
+               (unsigned)stats.tifs, (unsigned)stats.reloads, err / 1000.0, sw_err / 1000.0);
+
+        if (stats.tifs != wakes || stats.expired != 1 || stats.errors ||
+            err < 0 || err > (int64_t)END_BOUND_US) {
+            printf("%s %s: %u wakes, %u expected, ended %.3f ms off\n", part, c->name,
+                   (unsigned)stats.tifs, (unsigned)wakes, err / 1000.0);
+            failures++;
+        }
+    }
+
+    Wire.detach(&sim);
+}
+
+int main(void)
+{
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    host_serial_mute(true);
+
+    printf("%-9s %-13s %5s %9s %6s %6s %9s %9s\n", "part", "countdown", "Hz", "ticks",
+           "wakes", "reload", "end ms", "sw ms");
+
+    {
+        MAX31329Sim sim;
+        MAX31329 rtc(&Wire);
+        run<MAX31329, 255>("MAX31329", rtc, sim);
+    }
+    {
+        MAX3134XSim sim(false);
+        MAX31341 rtc(&Wire, MAX31341_I2C_ADDRESS);
+        run<MAX31341, 255>("MAX31341", rtc, sim);
+    }
+    {
+        MAX31343Sim sim;
+        MAX31343 rtc(&Wire);
+        run<MAX31343, 255>("MAX31343", rtc, sim);
+    }
+    {
+        MAX3133XSim sim(MAX3133XSim::VARIANT_MAX31331);
+        MAX31331 rtc(&Wire);
+        run<MAX31331, 255>("MAX31331", rtc, sim);
+    }
+    {
+        MAX3133XSim sim(MAX3133XSim::VARIANT_MAX31334);
+        MAX31334 rtc(&Wire);
+        run<MAX31334, 65535>("MAX31334", rtc, sim);
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,253 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * Snapshot of a test rack through RTCLinuxManager.
+ *
+ * The rack has 4 I2C buses at 400 kHz, each with a 2 channel mux, and a
+ * MAX31343 and a MAX31335 on every channel: 16 devices on 8 i2c-dev fakes
+ * that sleep for the wire time of each message. The table compares
+ * reading them one by one in a loop with a manager snapshot using one
+ * worker for everything and one worker per bus, in wall time.
+ *
+ * Checks: every reading of a snapshot succeeds and lands within a second
+ * of the others, only the MAX31335 readings carry a 1/128 s count, and a
+ * channel whose transfers fail reports its two devices as failed while
+ * the rest of the snapshot goes through.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+#include "i2c_dev_fake.h"
+
+#define NUM_BUSES       4
+#define NUM_CHANNELS    2
+#define NUM_ADAPTERS    (NUM_BUSES * NUM_CHANNELS)
+#define NUM_DEVICES     (NUM_ADAPTERS * 2)
+#define ROUNDS          20
+
+static I2CDevFake adapters[NUM_ADAPTERS];
+static MAX31343Sim *sims_43[NUM_ADAPTERS];
+static MAX3133XSim *sims_35[NUM_ADAPTERS];
+static MAX31343 *rtcs_43[NUM_ADAPTERS];
+static MAX31335 *rtcs_35[NUM_ADAPTERS];
+
+static int failures;
+
+static uint64_t wall_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void build_rack(void)
+{
+    struct tm t;
+
+    memset(&t, 0, sizeof(t));
+    t.tm_year = 124;
+    t.tm_mon = 2;
+    t.tm_mday = 15;
+    t.tm_hour = 9;
+
+    for (int a = 0; a < NUM_ADAPTERS; a++) {
+        sims_43[a] = new MAX31343Sim();
+        sims_35[a] = new MAX3133XSim(MAX3133XSim::VARIANT_MAX31335);
+
+        adapters[a].set_clock(400000);
+        adapters[a].attach(sims_43[a]);
+        adapters[a].attach(sims_35[a]);
+
+        rtcs_43[a] = new MAX31343(&adapters[a]);
+        rtcs_35[a] = new MAX31335(&adapters[a]);
+        rtcs_43[a]->begin();
+        rtcs_35[a]->begin();
+
+    }
+
+    /* After begin(), which resets the parts and takes virtual time, caught up first */
+    for (int a = 0; a < NUM_ADAPTERS; a++) {
+        sims_43[a]->sync();
+        sims_35[a]->sync();
+        sims_43[a]->set_calendar(&t);
+        sims_35[a]->set_calendar(&t);
+        adapters[a].set_realtime(true);
+    }
+}
+
+/* Adapter a is channel a % NUM_CHANNELS of bus a / NUM_CHANNELS */
+static void add_rack(RTCLinuxManager &mgr, int buses)
+{
+    int bus[NUM_BUSES];
+
+    for (int b = 0; b < buses; b++) {
+        bus[b] = mgr.add_bus();
+    }
+
+    for (int a = 0; a < NUM_ADAPTERS; a++) {
+        int b = bus[(a / NUM_CHANNELS) % buses];
+
+        mgr.add_device(b, rtcs_43[a]);
+        mgr.add_device_hr(b, rtcs_35[a]);
+    }
+}
+
+static double sequential(void)
+{
+    rtc_epoch_t epoch;
+    rtc_time_hr_t hr;
+    uint64_t start = wall_us();
+
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int a = 0; a < NUM_ADAPTERS; a++) {
+            rtcs_43[a]->get_epoch(&epoch);
+            rtcs_35[a]->get_time_hr(&hr);
+        }
+    }
+
+    return (double)(wall_us() - start) / ROUNDS;
+}
+
+static void check(const char *what, const rtc_manager_reading_t *readings, int bad_adapter)
+{
+    bool frac = false;
+
+    for (int i = 0; i < NUM_DEVICES; i++) {
+        int a = i / 2;
+        bool want_fail = (a == bad_adapter);
+
+        if (want_fail != (readings[i].ret != 0)) {
+            printf("%s: device %d ret %d\n", what, i, readings[i].ret);
+            failures++;
+        }
+        if (want_fail) {
+            continue;
+        }
+        if ((readings[i].time.sec > readings[0].time.sec + 1) || (readings[i].time.sec + 1 < readings[0].time.sec)) {
+            printf("%s: device %d reads %lu, device 0 %lu\n", what, i,
+                   (unsigned long)readings[i].time.sec, (unsigned long)readings[0].time.sec);
+            failures++;
+        }
+        if (i % 2) {
+            frac |= (readings[i].time.frac != 0);
+        } else if (readings[i].time.frac != 0) {
+            printf("%s: MAX31343 device %d has a 1/128 s count\n", what, i);
+            failures++;
+        }
+    }
+
+    if (!frac) {
+        printf("%s: no MAX31335 reading has a 1/128 s count\n", what);
+        failures++;
+    }
+}
+
+static double managed(int buses, rtc_manager_reading_t *readings)
+{
+    RTCLinuxManager mgr;
+    uint64_t total = 0;
+
+    add_rack(mgr, buses);
+    if (mgr.begin()) {
+        printf("begin() failed\n");
+        failures++;
+        return 0;
+    }
+
+    for (int r = 0; r < ROUNDS; r++) {
+        if (mgr.snapshot(readings, NUM_DEVICES)) {
+            printf("%d buses: snapshot failed\n", buses);
+            failures++;
+        }
+        total += mgr.last_snapshot_us();
+    }
+    check("snapshot", readings, -1);
+
+    /* Channel 1 of bus 1 fails every transfer of this snapshot, retries included */
+    adapters[3].inject_errno(EIO, 6);
+    if (mgr.snapshot(readings, NUM_DEVICES) == 0) {
+        printf("%d buses: snapshot with a failing channel succeeded\n", buses);
+        failures++;
+    }
+    check("failing channel", readings, 3);
+
+    mgr.end();
+
+    return (double)total / ROUNDS;
+}
+
+int main(void)
+{
+    rtc_manager_reading_t readings[NUM_DEVICES];
+    double seq_us;
+    double one_us;
+    double per_bus_us;
+
+    host_serial_mute(true);
+
+    build_rack();
+
+    seq_us = sequential();
+    one_us = managed(1, readings);
+    per_bus_us = managed(NUM_BUSES, readings);
+
+    printf("%-28s %10s %7s\n", "16 devices, 4 buses", "wall_us", "speedup");
+    printf("%-28s %10.0f %7.2f\n", "get_epoch()/get_time_hr()", seq_us, 1.0);
+    printf("%-28s %10.0f %7.2f\n", "snapshot, 1 worker", one_us, seq_us / one_us);
+    printf("%-28s %10.0f %7.2f\n", "snapshot, 1 worker per bus", per_bus_us, seq_us / per_bus_us);
+
+    /* Last snapshot, one worker per bus, channel 1 of bus 1 failing */
+    printf("\n%-3s %-2s %-9s %4s %12s %4s %8s %10s\n", "bus", "ch", "part", "ret", "epoch", "frac", "start_us",
+           "latency_us");
+    for (int i = 0; i < NUM_DEVICES; i++) {
+        int a = i / 2;
+
+        printf("%-3d %-2d %-9s %4d %12lu %4u %8lu %10lu\n", a / NUM_CHANNELS, a % NUM_CHANNELS,
+               (i % 2) ? "MAX31335" : "MAX31343", readings[i].ret, (unsigned long)readings[i].time.sec,
+               readings[i].time.frac, (unsigned long)readings[i].start_us, (unsigned long)readings[i].latency_us);
+    }
+
+    if (failures) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+
+    return 0;
+}
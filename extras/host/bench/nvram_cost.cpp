@@ -0,0 +1,170 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * Cost of a full NVRAM write and read back.
+ *
+ * Each part with NVRAM writes and then reads its whole 64-byte NVRAM, once
+ * through the TwoWire mock and once through the i2c-dev fake. The drivers
+ * split transfers at the transport's max_read()/max_write(), so Wire takes
+ * several bursts where i2c-dev takes one I2C_RDWR. The table lists the
+ * transfers and wire time of each, and the data read back is checked
+ * against the data written.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+#include "i2c_dev_fake.h"
+
+static I2CDevFake fake;
+
+static uint8_t out[64];
+static uint8_t in[64];
+
+static int failures;
+
+static void header(void)
+{
+    printf("%-9s %-10s %-6s %5s %7s %6s %5s %7s %4s\n", "part", "transport", "op",
+           "bytes", "xfers", "bus_us", "ioctl", "bus_us", "ret");
+}
+
+static void report(const char *part, const char *transport, const char *op, int len, int ret)
+{
+    const host_i2c_stats_t &w = Wire.stats();
+    const i2c_dev_fake_stats_t &d = fake.stats();
+
+    printf("%-9s %-10s %-6s %5d %7lu %6llu %5lu %7llu %4d\n", part, transport, op, len,
+           (unsigned long)w.transfers, (unsigned long long)w.bus_time_us,
+           (unsigned long)d.ioctls, (unsigned long long)d.bus_time_us, ret);
+}
+
+static void check(const char *part, const char *transport, int len)
+{
+    if (memcmp(out, in, len) != 0) {
+        printf("%s/%s: NVRAM read back does not match\n", part, transport);
+        failures++;
+    }
+}
+
+/* MAX31329 and MAX31343 take (offset, buffer, length) */
+template <class RTC>
+static void run(const char *part, const char *transport, RTC &rtc)
+{
+    int len = rtc.nvram_size();
+    int ret;
+
+    memset(in, 0, sizeof(in));
+
+    Wire.reset_stats();
+    fake.reset_stats();
+    ret = rtc.nvram_write(0, out, len);
+    report(part, transport, "write", len, ret);
+    failures += (ret != 0);
+
+    Wire.reset_stats();
+    fake.reset_stats();
+    ret = rtc.nvram_read(0, in, len);
+    report(part, transport, "read", len, ret);
+    failures += (ret != 0);
+
+    check(part, transport, len);
+}
+
+/* MAX31341 takes (buffer, offset, length) */
+static void run(const char *part, const char *transport, MAX31341 &rtc)
+{
+    int len = rtc.nvram_size();
+    int ret;
+
+    memset(in, 0, sizeof(in));
+
+    Wire.reset_stats();
+    fake.reset_stats();
+    ret = rtc.nvram_write(out, 0, len);
+    report(part, transport, "write", len, ret);
+    failures += (ret != 0);
+
+    Wire.reset_stats();
+    fake.reset_stats();
+    ret = rtc.nvram_read(in, 0, len);
+    report(part, transport, "read", len, ret);
+    failures += (ret != 0);
+
+    check(part, transport, len);
+}
+
+template <class RTC, class SIM>
+static void bench(const char *part, uint8_t addr, SIM &wire_sim, SIM &dev_sim)
+{
+    RTC rtc(&Wire, addr);
+    RTC dev_rtc(&fake, addr);
+
+    Wire.attach(&wire_sim);
+    fake.attach(&dev_sim);
+
+    rtc.begin();
+    dev_rtc.begin();
+
+    run(part, "Wire", rtc);
+    run(part, "i2c-dev", dev_rtc);
+
+    fake.detach(&dev_sim);
+    Wire.detach(&wire_sim);
+}
+
+int main(void)
+{
+    for (unsigned i = 0; i < sizeof(out); i++) {
+        out[i] = 0x5A ^ (i * 7);
+    }
+
+    header();
+
+    {
+        MAX31329Sim wire_sim, dev_sim;
+        bench<MAX31329>("MAX31329", MAX31329_I2C_ADDRESS, wire_sim, dev_sim);
+    }
+    {
+        MAX3134XSim wire_sim(false), dev_sim(false);
+        bench<MAX31341>("MAX31341", MAX31341_I2C_ADDRESS, wire_sim, dev_sim);
+    }
+    {
+        MAX31343Sim wire_sim, dev_sim;
+        bench<MAX31343>("MAX31343", MAX31343_I2C_ADDRESS, wire_sim, dev_sim);
+    }
+
+    return failures ? 1 : 0;
+}
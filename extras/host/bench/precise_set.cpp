@@ -0,0 +1,182 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * Phase of the second loaded by set_epoch() and set_epoch_at() on
+ * MAX31341/MAX31342.
+ *
+ * set_epoch() loads the time when its SET_RTC write happens, some 10 ms
+ * and a few bus writes after the call. set_epoch_at() aims the end of
+ * that write at a given micros() instant. For a set of reference
+ * instants at 100 kHz and 400 kHz, the bench takes the start of the
+ * second from the simulator, which acts on SET_RTC at the end of the
+ * write, and prints:
+ *   - "plain": start of the second minus the set_epoch() call
+ *   - "at": start of the second minus the reference instant
+ *   - "report": what set_epoch_at() returned minus the "at" error
+ * as the worst absolute value over the runs, in us. The loaded time is
+ * checked too.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+
+#define NUM_RUNS    20
+#define START_EPOCH 1718000000UL    /* 2024-06-10 */
+
+static int failures;
+
+/* host_clock_us() at which the simulator last started a second */
+static uint64_t second_start(RTCSim &sim)
+{
+    sim.sync();
+    return host_clock_us() - sim.phase_us();
+}
+
+static void check_time(const char *part, RTCSim &sim, rtc_epoch_t want)
+{
+    struct tm t;
+
+    sim.get_calendar(&t);
+    if ((rtc_epoch_t)mktime(&t) != want) {
+        printf("%s: loaded %llu, expected %llu\n", part, (unsigned long long)mktime(&t),
+               (unsigned long long)want);
+        failures++;
+    }
+}
+
+static int64_t max_abs(int64_t a, int64_t b)
+{
+    a = (a < 0) ? -a : a;
+    b = (b < 0) ? -b : b;
+    return (a > b) ? a : b;
+}
+
+template <class RTC>
+static void run(const char *part, RTC &rtc, RTCSim &sim, uint32_t scl_hz)
+{
+    int64_t plain = 0, at = 0, report = 0, err;
+    int32_t reported;
+    uint64_t t0;
+    uint32_t at_us;
+    int ret;
+
+    Wire.setClock(scl_hz);
+
+    for (int i = 0; i < NUM_RUNS; i++) {
+        /* Calls at varying points of the virtual clock */
+        host_clock_advance(12345 + 7919 * i);
+
+        t0 = host_clock_us();
+        ret = rtc.set_epoch(START_EPOCH + i);
+        plain = max_abs(plain, (int64_t)(second_start(sim) - t0));
+        check_time(part, sim, START_EPOCH + i);
+
+        at_us = micros() + 30000 + 4001 * i;
+        ret |= rtc.set_epoch_at(START_EPOCH + 100 + i, at_us, &reported);
+        err = (int64_t)second_start(sim) - at_us;
+        at = max_abs(at, err);
+        report = max_abs(report, reported - err);
+        check_time(part, sim, START_EPOCH + 100 + i);
+
+        if (ret) {
+            printf("%s: set failed\n", part);
+            failures++;
+        }
+    }
+
+    /* Too close to be met, nothing is loaded or staged: only single register writes */
+    rtc.set_epoch(START_EPOCH);
+    Wire.reset_stats();
+    if (rtc.set_epoch_at(START_EPOCH + 500, micros() + 1000, &reported) != -1) {
+        printf("%s: set_epoch_at() accepted an instant it cannot meet\n", part);
+        failures++;
+    }
+    if (Wire.stats().bytes_out > 2 * Wire.stats().writes) {
+        printf("%s: set_epoch_at() staged a time it rejected\n", part);
+        failures++;
+    }
+    check_time(part, sim, START_EPOCH);
+
+    printf("%-9s %7u %8lld %6lld %7lld\n", part, (unsigned)scl_hz, (long long)plain,
+           (long long)at, (long long)report);
+
+    /* The bus mock is deterministic, only the micros() ticks of the waiting loop remain */
+    if ((at > 20) || (report > 20)) {
+        failures++;
+    }
+}
+
+template <class RTC>
+static void bench(const char *part, RTC &rtc, RTCSim &sim)
+{
+    Wire.attach(&sim);
+    rtc.begin();
+
+    run(part, rtc, sim, 100000);
+    run(part, rtc, sim, 400000);
+
+    Wire.setClock(100000);
+    Wire.detach(&sim);
+}
+
+int main(void)
+{
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    host_serial_mute(true);
+
+    printf("%-9s %7s %8s %6s %7s\n", "part", "scl hz", "plain us", "at us", "report");
+
+    {
+        MAX3134XSim sim(false);
+        MAX31341 rtc(&Wire, MAX31341_I2C_ADDRESS);
+        bench("MAX31341", rtc, sim);
+    }
+    {
+        MAX3134XSim sim(true);
+        MAX31342 rtc(&Wire, MAX31342_I2C_ADDRESS);
+        bench("MAX31342", rtc, sim);
+    }
+
+    if (failures) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,197 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * Time reads on parts without a read latch, MAX31328 and MAX31329.
+ *
+ * The simulators take the bytes of a read one byte time apart (100 kHz),
+ * so a second can tick between the seconds and the minutes. Each run
+ * makes NUM_CALLS get_epoch() calls:
+ *   - "random": at random points of the second
+ *   - "edge": ending within the read of a tick, the worst case
+ * with three read modes:
+ *   - "single": one burst read, rollover check off
+ *   - "double": the usual workaround, two reads, and a third if they differ
+ *   - "checked": set_rollover_check(), the default on these parts
+ * A result outside the time the simulator held from the start to the end
+ * of the call is torn. The table prints torn results, register reads and
+ * wire time per call, and how often the check re-read the seconds and the
+ * whole block. "checked" must have no torn results.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+
+#define NUM_CALLS   6000
+#define BYTE_US     90          /* 9 clocks at 100 kHz */
+
+enum { MODE_SINGLE, MODE_DOUBLE, MODE_CHECKED };
+
+static const char *mode_name[] = { "single", "double", "checked" };
+
+static int failures;
+
+static rtc_epoch_t sim_epoch(RTCSim &sim)
+{
+    struct tm t;
+
+    sim.get_calendar(&t);
+    return rtc_tm_to_epoch(&t);
+}
+
+template <class RTC>
+static int read_epoch(RTC &rtc, int mode, rtc_epoch_t *epoch)
+{
+    rtc_epoch_t again;
+    int ret;
+
+    ret = rtc.get_epoch(epoch);
+    if (ret || (mode != MODE_DOUBLE)) {
+        return ret;
+    }
+
+    ret = rtc.get_epoch(&again);
+    if (ret || (again == *epoch)) {
+        return ret;
+    }
+
+    return rtc.get_epoch(epoch);
+}
+
+template <class RTC>
+static void run(const char *part, RTC &rtc, RTCSim &sim, bool edge, int mode)
+{
+    rtc_time_read_stats_t stats;
+    rtc_epoch_t before;
+    rtc_epoch_t after;
+    rtc_epoch_t epoch;
+    uint32_t torn = 0;
+    uint32_t seed = 99;
+    struct tm t;
+
+    memset(&t, 0, sizeof(t));
+    t.tm_year = 124;
+    t.tm_mday = 1;
+    sim.sync();
+    sim.set_calendar(&t);
+
+    rtc.set_rollover_check(mode == MODE_CHECKED);
+    rtc.reset_time_read_stats();
+    Wire.reset_stats();
+
+    for (int n = 0; n < NUM_CALLS; n++) {
+        seed = seed * 1103515245 + 12345;
+        if (edge) {
+            /* The tick falls 0 to 1000 us into the call, which takes about 1 ms */
+            uint32_t into = (seed >> 8) % 1000;
+            uint32_t to_tick = 1000000 - sim.phase_us();
+
+            delayMicroseconds((to_tick > into) ? to_tick - into : to_tick + 1000000 - into);
+        } else {
+            delayMicroseconds((seed >> 8) % 1000000);
+        }
+
+        before = sim_epoch(sim);
+        if (read_epoch(rtc, mode, &epoch)) {
+            printf("%s: read failed\n", part);
+            failures++;
+            return;
+        }
+        after = sim_epoch(sim);
+
+        if ((epoch < before) || (epoch > after)) {
+            torn++;
+        }
+    }
+
+    rtc.get_time_read_stats(stats);
+    const host_i2c_stats_t &w = Wire.stats();
+
+    printf("%-9s %-7s %-8s %6lu %7.3f %8.1f %7lu %7lu\n", part, edge ? "edge" : "random", mode_name[mode],
+           (unsigned long)torn, (double)w.reads / NUM_CALLS, (double)w.bus_time_us / NUM_CALLS,
+           (unsigned long)stats.checks, (unsigned long)stats.rereads);
+
+    if ((mode == MODE_CHECKED) && torn) {
+        printf("%s: %lu torn results with the rollover check\n", part, (unsigned long)torn);
+        failures++;
+    }
+}
+
+template <class RTC>
+static void part(const char *name, RTC &rtc, RTCSim &sim)
+{
+    Wire.attach(&sim);
+    rtc.begin();
+    sim.set_read_byte_us(BYTE_US);
+
+    for (int edge = 0; edge < 2; edge++) {
+        for (int mode = MODE_SINGLE; mode <= MODE_CHECKED; mode++) {
+            run(name, rtc, sim, edge, mode);
+        }
+    }
+
+    Wire.detach(&sim);
+}
+
+int main(void)
+{
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    host_serial_mute(true);
+    Wire.setClock(100000);
+
+    printf("%-9s %-7s %-8s %6s %7s %8s %7s %7s\n", "part", "phase", "mode", "torn", "reads", "bus_us", "checks",
+           "rereads");
+
+    {
+        MAX31328Sim sim;
+        MAX31328 rtc(&Wire);
+        part("MAX31328", rtc, sim);
+    }
+    {
+        MAX31329Sim sim;
+        MAX31329 rtc(&Wire);
+        part("MAX31329", rtc, sim);
+    }
+
+    if (failures) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+
+    return 0;
+}
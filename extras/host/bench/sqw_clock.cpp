@@ -0,0 +1,187 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * Millisecond time from the 1 Hz SQW edges, RTCSqwClock.
+ *
+ * A loop asks for the time every 7 ms of virtual time for two minutes,
+ * straight from the driver and then through the SQW clock. The edges
+ * reach edge() 20 us after the simulator counts a second, as an interrupt
+ * would. From 60 s to 63 s no edges come, as if SQW had stopped, to show
+ * the clock falling back to RTC reads and syncing again.
+ *
+ * The served time is compared with the simulator's calendar and phase.
+ * "err ms" is the range of the simulator's time minus the served time
+ * over the synced calls. It is expected to stay within 0 to 1 ms, the
+ * truncation of micros() to milliseconds plus the edge latency.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+
+#define STEP_US         7000ULL
+#define RUN_US          (120ULL * 1000000)
+#define OUTAGE_FROM_US  (60ULL * 1000000)
+#define OUTAGE_TO_US    (63ULL * 1000000)
+#define EDGE_LATENCY_US 20
+#define START_EPOCH     1718000000UL    /* 2024-06-10 */
+
+static int failures;
+
+static void advance(RTCSim &sim, RTCSqwClock *clock, uint64_t start, uint64_t us)
+{
+    uint64_t to_edge, t;
+
+    while (us) {
+        sim.sync();
+        to_edge = 1000000 - sim.phase_us();
+        if (!clock || (to_edge + EDGE_LATENCY_US > us)) {
+            host_clock_advance(us);
+            return;
+        }
+        host_clock_advance(to_edge + EDGE_LATENCY_US);
+        us -= to_edge + EDGE_LATENCY_US;
+        t = host_clock_us() - start;
+        if ((t < OUTAGE_FROM_US) || (t >= OUTAGE_TO_US)) {
+            clock->edge();
+        }
+    }
+}
+
+template <class RTC>
+static void run(const char *part, RTC &rtc, RTCSim &sim, bool sqw)
+{
+    RTCSqwClockT<RTC> clock(&rtc);
+    rtc_sqw_clock_stats_t stats;
+    struct tm t;
+    rtc_epoch_t e;
+    uint16_t ms;
+    int64_t err, err_min = 0, err_max = 0;
+    uint32_t calls = 0, synced = 0;
+    uint64_t start, end;
+    int ret;
+
+    rtc.set_epoch(START_EPOCH);
+    if (sqw && clock.begin()) {
+        printf("%s: begin() failed\n", part);
+        failures++;
+    }
+
+    /* Start a third of the way into a second */
+    sim.sync();
+    host_clock_advance(1000000 - sim.phase_us() + 333000);
+
+    Wire.reset_stats();
+    start = host_clock_us();
+    end = start + RUN_US;
+
+    while (host_clock_us() < end) {
+        if (sqw) {
+            ret = clock.get_epoch_ms(&e, &ms);
+        } else {
+            ret = rtc.get_epoch(&e);
+            ms = 0;
+        }
+        sim.get_calendar(&t);
+        calls++;
+        if (ret) {
+            printf("%s: read failed\n", part);
+            failures++;
+        } else if (sqw && clock.is_synced()) {
+            err = ((int64_t)mktime(&t) * 1000 + sim.phase_us() / 1000) - ((int64_t)e * 1000 + ms);
+            if (!synced++) {
+                err_min = err_max = err;
+            }
+            err_min = (err < err_min) ? err : err_min;
+            err_max = (err > err_max) ? err : err_max;
+        }
+        advance(sim, sqw ? &clock : NULL, start, STEP_US);
+    }
+
+    const host_i2c_stats_t &s = Wire.stats();
+    clock.get_stats(stats);
+
+    printf("%-9s %-7s %6u %7u %8.1f %6u %5u %5u %4u %4d..%d\n", part, sqw ? "sqw" : "direct",
+           (unsigned)calls, (unsigned)s.transfers, s.bus_time_us / 1000.0, (unsigned)synced,
+           (unsigned)stats.syncs, (unsigned)stats.reads, (unsigned)stats.lost,
+           (int)err_min, (int)err_max);
+
+    if (sqw && ((err_min < 0) || (err_max > 1) || (stats.lost != 1) || (stats.syncs != 2))) {
+        printf("%s: out of bounds\n", part);
+        failures++;
+    }
+}
+
+template <class RTC>
+static void bench(const char *part, RTC &rtc, RTCSim &sim)
+{
+    Wire.attach(&sim);
+    rtc.begin();
+
+    run(part, rtc, sim, false);
+    run(part, rtc, sim, true);
+
+    Wire.detach(&sim);
+}
+
+int main(void)
+{
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    host_serial_mute(true);
+
+    printf("%-9s %-7s %6s %7s %8s %6s %5s %5s %4s %s\n", "part", "mode", "calls", "xfers",
+           "bus ms", "synced", "syncs", "reads", "lost", "err ms");
+
+    {
+        MAX31328Sim sim;
+        MAX31328 rtc(&Wire);
+        bench("MAX31328", rtc, sim);
+    }
+    {
+        MAX31343Sim sim;
+        MAX31343 rtc(&Wire);
+        bench("MAX31343", rtc, sim);
+    }
+
+    if (failures) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+
+    return 0;
+}
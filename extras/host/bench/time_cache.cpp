@@ -0,0 +1,246 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * Bus traffic and accuracy of get_epoch() through RTCTimeCache.
+ *
+ * A logger loop asks for the time every 20 ms of virtual time for 15
+ * minutes, 45000 calls. Each run is made once straight on the driver and
+ * then through the cache with a few policies, with and without the 1 Hz
+ * SQW edges. The edges are delivered exactly when the simulator counts a
+ * second, as an interrupt on the square wave output would.
+ *
+ * Every served time is compared with the simulator's calendar. "behind"
+ * counts calls that got an earlier second than the RTC held, "ahead" a
+ * later one. Direct reads show a few too, as the second can change
+ * between the read and the check. The MCU clock and the simulator share the virtual clock, so
+ * MCU drift is not modelled: the drift resyncs show the cost of a policy,
+ * not its need.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+
+#define STEP_US     20000ULL
+#define RUN_US      (15ULL * 60 * 1000000)
+#define START_EPOCH 1718000000UL    /* 2024-06-10 */
+
+static int failures;
+
+static void advance(RTCSim &sim, RTCTimeCache *cache, bool sqw, uint64_t us)
+{
+    uint64_t to_edge;
+
+    while (us) {
+        sim.sync();
+        to_edge = 1000000 - sim.phase_us();
+        if (!sqw || (to_edge > us)) {
+            host_clock_advance(us);
+            return;
+        }
+        host_clock_advance(to_edge);
+        us -= to_edge;
+        cache->sqw_edge();
+    }
+}
+
+template <class RTC>
+static void run(const char *part, RTC &rtc, RTCSim &sim, const char *mode,
+                const rtc_time_cache_cfg_t *cfg, bool sqw)
+{
+    RTCTimeCacheT<RTC> cache(&rtc);
+    rtc_time_cache_stats_t stats;
+    struct tm t;
+    rtc_epoch_t e, truth;
+    uint32_t calls = 0, behind = 0, ahead = 0;
+    uint64_t end;
+    int ret;
+
+    if (cfg) {
+        cache.set_config(*cfg);
+    }
+
+    /* Start a third of the way into a second */
+    rtc.set_epoch(START_EPOCH);
+    sim.sync();
+    host_clock_advance(1000000 - sim.phase_us() + 333000);
+
+    Wire.reset_stats();
+    end = host_clock_us() + RUN_US;
+
+    while (host_clock_us() < end) {
+        ret = cfg ? cache.get_epoch(&e) : rtc.get_epoch(&e);
+        sim.get_calendar(&t);
+        truth = (rtc_epoch_t)mktime(&t);
+        calls++;
+        if (ret) {
+            printf("%s/%s: get_epoch failed\n", part, mode);
+            failures++;
+        } else if (e < truth) {
+            behind++;
+        } else if (e > truth) {
+            ahead++;
+        }
+        advance(sim, &cache, sqw, STEP_US);
+    }
+
+    const host_i2c_stats_t &s = Wire.stats();
+    cache.get_stats(stats);
+
+    printf("%-9s %-17s %6u %7u %8.1f %6u %6u", part, mode, (unsigned)calls,
+           (unsigned)s.transfers, s.bus_time_us / 1000.0, (unsigned)behind, (unsigned)ahead);
+    if (cfg) {
+        printf(" %6u %4u %4u %5u %4u %4u\n", (unsigned)stats.misses,
+               (unsigned)stats.resyncs_period, (unsigned)stats.resyncs_drift,
+               (unsigned)stats.resyncs_edge, (unsigned)stats.corrections,
+               (unsigned)stats.max_edge_err_ms);
+    } else {
+        printf("\n");
+    }
+
+    /* The edges remove the lag of a read anchor, and nothing may run ahead */
+    if (ahead || (sqw && (behind > 1))) {
+        printf("%s/%s: %u behind, %u ahead\n", part, mode, (unsigned)behind, (unsigned)ahead);
+        failures++;
+    }
+}
+
+/* An RTC whose reads are set by the test */
+class ScriptedCache : public RTCTimeCache
+{
+public:
+    rtc_epoch_t now;
+
+protected:
+    int read_rtc(rtc_epoch_t *epoch) { *epoch = now; return 0; }
+    int write_rtc(rtc_epoch_t epoch) { now = epoch; return 0; }
+};
+
+/* A read one second past an edge-locked anchor must not be served ahead of it */
+static void check_locked_read(void)
+{
+    static const rtc_time_cache_cfg_t period_only = { 1000UL, 0, 0 };
+    ScriptedCache cache;
+    rtc_epoch_t first, second;
+
+    cache.set_config(period_only);
+    cache.set_epoch(START_EPOCH);
+    host_clock_advance(300000);
+    cache.sqw_edge();
+    host_clock_advance(700000);
+
+    /* The edge locks the anchor to START_EPOCH + 1, the period read sees the next second */
+    cache.now = START_EPOCH + 2;
+    cache.get_epoch(&first);
+    cache.get_epoch(&second);
+    if (second < first) {
+        printf("locked read: %lu then %lu\n", (unsigned long)first, (unsigned long)second);
+        failures++;
+    }
+}
+
+template <class RTC>
+static void bench(const char *part, RTC &rtc, RTCSim &sim)
+{
+    static const rtc_time_cache_cfg_t def = RTC_TIME_CACHE_CFG_DEFAULT;
+    static const rtc_time_cache_cfg_t resonator = { 600000UL, 10, 5000 };
+    static const rtc_time_cache_cfg_t period_only = { 1000UL, 0, 0 };
+    struct tm t;
+    rtc_epoch_t e;
+
+    Wire.attach(&sim);
+    rtc.begin();
+
+    run(part, rtc, sim, "direct", NULL, false);
+    run(part, rtc, sim, "cache 1s period", &period_only, false);
+    run(part, rtc, sim, "cache default", &def, false);
+    run(part, rtc, sim, "cache 5000ppm", &resonator, false);
+    run(part, rtc, sim, "cache default+sqw", &def, true);
+    run(part, rtc, sim, "cache 5000ppm+sqw", &resonator, true);
+
+    /* get_time() is gmtime() of get_epoch(), set_epoch() re-anchors */
+    {
+        RTCTimeCacheT<RTC> cache(&rtc);
+
+        cache.set_epoch(START_EPOCH + 86400 * 200 + 3723);
+        cache.get_time(&t);
+        cache.get_epoch(&e);
+        int yday = t.tm_yday;
+        int wday = t.tm_wday;
+        if (((rtc_epoch_t)mktime(&t) != e) || (yday != t.tm_yday) || (wday != t.tm_wday)) {
+            printf("%s: get_time() does not match get_epoch()\n", part);
+            failures++;
+        }
+    }
+
+    Wire.detach(&sim);
+}
+
+int main(void)
+{
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    host_serial_mute(true);
+
+    printf("%-9s %-17s %6s %7s %8s %6s %6s %6s %4s %4s %5s %4s %4s\n", "part", "mode", "calls",
+           "xfers", "bus ms", "behind", "ahead", "reads", "per", "drft", "edge", "corr", "e ms");
+
+    {
+        MAX31328Sim sim;
+        MAX31328 rtc(&Wire);
+        bench("MAX31328", rtc, sim);
+    }
+    {
+        MAX31343Sim sim;
+        MAX31343 rtc(&Wire);
+        bench("MAX31343", rtc, sim);
+    }
+    {
+        MAX3133XSim sim(MAX3133XSim::VARIANT_MAX31335);
+        MAX31335 rtc(&Wire);
+        bench("MAX31335", rtc, sim);
+    }
+
+    check_locked_read();
+
+    if (failures) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,223 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * Wire vs. Linux i2c-dev transport.
+ *
+ * Runs the same driver calls once through RTCWireTransport on the TwoWire
+ * mock and once through RTCLinuxI2C on the in-process i2c-dev fake. For
+ * each call the table lists the Wire transfers, the I2C_RDWR ioctls and
+ * messages, the wire time of both, and the returned values.
+ *
+ * With a device node argument, e.g. after
+ *
+ *   modprobe i2c-stub chip_addr=0x68
+ *
+ * it instead runs a MAX31343 time and NVRAM round trip through the real
+ * backend on that node. i2c-stub is a plain register file, so only data
+ * that the driver writes and reads back is checked.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+#include "i2c_dev_fake.h"
+
+/* 'wire_call' and 'dev_call' run the same call on 'rtc' and 'dev_rtc' */
+#define COMPARE(part, wire_call, dev_call)                                          \
+    do {                                                                            \
+        int _wret, _dret;                                                           \
+        Wire.reset_stats();                                                         \
+        fake.reset_stats();                                                         \
+        _wret = (wire_call);                                                        \
+        _dret = (dev_call);                                                         \
+        report(part, #wire_call, _wret, _dret);                                     \
+    } while (0)
+
+static I2CDevFake fake;
+
+static struct tm now_tm;
+static struct tm alarm_tm;
+static struct tm read_tm;
+
+static uint8_t ram[64];
+
+static void header(void)
+{
+    printf("%-9s %-72s %5s %7s %6s %5s %7s %5s %5s\n", "part", "call",
+           "xfers", "bus_us", "ioctl", "msgs", "bus_us", "ret", "ret");
+}
+
+static void report(const char *part, const char *call, int wire_ret, int dev_ret)
+{
+    const host_i2c_stats_t &w = Wire.stats();
+    const i2c_dev_fake_stats_t &d = fake.stats();
+
+    printf("%-9s %-72s %5lu %7llu %6lu %5lu %7llu %5d %5d\n", part, call,
+           (unsigned long)w.transfers, (unsigned long long)w.bus_time_us,
+           (unsigned long)d.ioctls, (unsigned long)d.messages,
+           (unsigned long long)d.bus_time_us, wire_ret, dev_ret);
+}
+
+static void bench_max31343(void)
+{
+    MAX31343Sim wire_sim;
+    MAX31343Sim dev_sim;
+    MAX31343 rtc(&Wire);
+    MAX31343 dev_rtc(&fake);
+    MAX31343::reg_status_t stat;
+
+    Wire.attach(&wire_sim);
+    fake.attach(&dev_sim);
+
+    rtc.begin();
+    dev_rtc.begin();
+
+    COMPARE("MAX31343", rtc.set_time(&now_tm), dev_rtc.set_time(&now_tm));
+    COMPARE("MAX31343", rtc.get_time(&read_tm), dev_rtc.get_time(&read_tm));
+    COMPARE("MAX31343", rtc.get_status(stat), dev_rtc.get_status(stat));
+    COMPARE("MAX31343", rtc.set_alarm(MAX31343::ALARM1, &alarm_tm, MAX31343::ALARM_PERIOD_DAILY),
+            dev_rtc.set_alarm(MAX31343::ALARM1, &alarm_tm, MAX31343::ALARM_PERIOD_DAILY));
+    COMPARE("MAX31343", rtc.nvram_write(0, ram, 16), dev_rtc.nvram_write(0, ram, 16));
+    COMPARE("MAX31343", rtc.nvram_read(0, ram, 16), dev_rtc.nvram_read(0, ram, 16));
+
+    fake.detach(&dev_sim);
+    Wire.detach(&wire_sim);
+}
+
+static void bench_max31335(void)
+{
+    MAX3133XSim wire_sim(MAX3133XSim::VARIANT_MAX31335);
+    MAX3133XSim dev_sim(MAX3133XSim::VARIANT_MAX31335);
+    MAX31335 rtc(&Wire);
+    MAX31335 dev_rtc(&fake);
+    max3133x_status_reg_t stat;
+    uint16_t sub_sec;
+
+    Wire.attach(&wire_sim);
+    fake.attach(&dev_sim);
+
+    rtc.begin();
+    dev_rtc.begin();
+
+    COMPARE("MAX31335", rtc.set_time(&now_tm), dev_rtc.set_time(&now_tm));
+    COMPARE("MAX31335", rtc.get_time(&read_tm, &sub_sec), dev_rtc.get_time(&read_tm, &sub_sec));
+    COMPARE("MAX31335", rtc.get_status_reg(&stat), dev_rtc.get_status_reg(&stat));
+    COMPARE("MAX31335", rtc.set_alarm(MAX31335::ALARM1, &alarm_tm, MAX31335::ALARM_PERIOD_DAILY),
+            dev_rtc.set_alarm(MAX31335::ALARM1, &alarm_tm, MAX31335::ALARM_PERIOD_DAILY));
+    COMPARE("MAX31335", rtc.timer_get(), dev_rtc.timer_get());
+
+    fake.detach(&dev_sim);
+    Wire.detach(&wire_sim);
+}
+
+/* Errors must surface through the driver the same way on both transports */
+static int check_nack(void)
+{
+    MAX31343 dev_rtc(&fake);
+    rtc_bus_stats_t drv;
+    int ret;
+
+    dev_rtc.reset_bus_stats();
+    ret = dev_rtc.get_time(&read_tm);
+    dev_rtc.get_bus_stats(drv);
+
+    if (ret != -1 || drv.errors[RTC_BUS_ERR_ADDR_NACK] != 1) {
+        printf("i2c-dev fake: missing device not reported as address NACK\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+static int run_device(const char *dev)
+{
+    RTCLinuxI2C bus(dev);
+    MAX31343 rtc(&bus);
+    uint8_t out[16];
+    uint8_t in[16];
+    int ret;
+
+    bus.begin();
+
+    for (unsigned i = 0; i < sizeof(out); i++) {
+        out[i] = 0xA0 + i;
+    }
+
+    ret = rtc.set_time(&now_tm);
+    if (ret == 0) {
+        ret = rtc.get_time(&read_tm);
+    }
+    if (ret != 0 || read_tm.tm_year != now_tm.tm_year || read_tm.tm_mday != now_tm.tm_mday ||
+        read_tm.tm_hour != now_tm.tm_hour || read_tm.tm_min != now_tm.tm_min) {
+        printf("%s: time round trip failed (%d)\n", dev, ret);
+        return 1;
+    }
+
+    ret = rtc.nvram_write(0, out, sizeof(out));
+    if (ret == 0) {
+        ret = rtc.nvram_read(0, in, sizeof(in));
+    }
+    if (ret != 0 || memcmp(out, in, sizeof(out)) != 0) {
+        printf("%s: NVRAM round trip failed (%d)\n", dev, ret);
+        return 1;
+    }
+
+    printf("%s: OK\n", dev);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    now_tm.tm_year = 124;
+    now_tm.tm_mon = 1;
+    now_tm.tm_mday = 29;
+    now_tm.tm_wday = 4;
+    now_tm.tm_hour = 23;
+    now_tm.tm_min = 59;
+    now_tm.tm_sec = 50;
+
+    alarm_tm = now_tm;
+    alarm_tm.tm_sec = 55;
+
+    if (argc > 1) {
+        return run_device(argv[1]);
+    }
+
+    header();
+    bench_max31343();
+    bench_max31335();
+
+    return check_nack();
+}
@@ -0,0 +1,317 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * Local time through RTCTimeZone against the C library.
+ *
+ * For each RTC_TZ_* rule, the POSIX TZ string of its comment is parsed
+ * with rtc_tz_parse() and must give the same rule. Then localtime_r()
+ * under that TZ and RTCTimeZone::localtime() must agree, tm_isdst
+ * included, every 15 minutes from 2020 to 2030 and every day and a bit
+ * from 2000 to 2105, and to_utc() must invert to_local() outside the
+ * hour repeated at the end of DST.
+ *
+ * The table gives the cost of a conversion on a clock going forward
+ * one second per call, in TSC cycles on x86, in ns elsewhere, and the
+ * cost of a local get_time() on a simulated MAX31343.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define COST_UNIT   "cycles"
+#else
+#define COST_UNIT   "ns"
+#endif
+
+#include <AnalogRTCLibrary.h>
+#include "rtc_sim.h"
+
+#define CONV_CALLS  200000
+#define CALL_LOOPS  2000
+
+/* 2020-01-01, 2030-01-01, 2000-01-01, 2105-01-01 */
+#define FINE_FROM   1577836800UL
+#define FINE_TO     1893456000UL
+#define COARSE_FROM 946684800UL
+#define COARSE_TO   4260211200UL
+
+struct zone {
+    const char *name;
+    const char *posix;
+    rtc_tz_rule_t rule;
+};
+
+static const zone zones[] = {
+    { "UTC", "UTC0", RTC_TZ_UTC },
+    { "US_HAWAII", "HST10", RTC_TZ_US_HAWAII },
+    { "US_ALASKA", "AKST9AKDT,M3.2.0,M11.1.0", RTC_TZ_US_ALASKA },
+    { "US_PACIFIC", "PST8PDT,M3.2.0,M11.1.0", RTC_TZ_US_PACIFIC },
+    { "US_MOUNTAIN", "MST7MDT,M3.2.0,M11.1.0", RTC_TZ_US_MOUNTAIN },
+    { "US_ARIZONA", "MST7", RTC_TZ_US_ARIZONA },
+    { "US_CENTRAL", "CST6CDT,M3.2.0,M11.1.0", RTC_TZ_US_CENTRAL },
+    { "US_EASTERN", "EST5EDT,M3.2.0,M11.1.0", RTC_TZ_US_EASTERN },
+    { "EU_WESTERN", "GMT0BST,M3.5.0/1,M10.5.0", RTC_TZ_EU_WESTERN },
+    { "EU_CENTRAL", "CET-1CEST,M3.5.0,M10.5.0/3", RTC_TZ_EU_CENTRAL },
+    { "EU_EASTERN", "EET-2EEST,M3.5.0/3,M10.5.0/4", RTC_TZ_EU_EASTERN },
+    { "INDIA", "IST-5:30", RTC_TZ_INDIA },
+    { "CHINA", "CST-8", RTC_TZ_CHINA },
+    { "JAPAN", "JST-9", RTC_TZ_JAPAN },
+    { "AU_EASTERN", "AEST-10AEDT,M10.1.0,M4.1.0/3", RTC_TZ_AU_EASTERN },
+};
+
+#define NUM_ZONES   (sizeof(zones) / sizeof(zones[0]))
+
+static const char *bad[] = {
+    "", "UT0", "CET", "CET-1CEST", "CET-1CEST,M3.5.0", "CET-1CEST,J60,J300",
+    "CET-1CEST,M13.5.0,M10.5.0", "CET-1CEST,M3.6.0,M10.5.0", "CET-1CEST,M3.5.7,M10.5.0",
+    "CET-1CEST,M3.5.0,M10.5.0/", "CET-1CEST,M3.5.0,M10.5.0x", "CET-25", "<CET-1",
+};
+
+static int failures;
+
+static uint64_t now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+static bool same_rule(const rtc_tz_rule_t &a, const rtc_tz_rule_t &b)
+{
+    if ((a.std_offset != b.std_offset) || (a.dst_shift != b.dst_shift)) {
+        return false;
+    }
+    if (!a.dst_shift) {
+        return true;
+    }
+
+    return (a.dst_start.mon == b.dst_start.mon) && (a.dst_start.week == b.dst_start.week)
+           && (a.dst_start.wday == b.dst_start.wday) && (a.dst_start.min == b.dst_start.min)
+           && (a.dst_end.mon == b.dst_end.mon) && (a.dst_end.week == b.dst_end.week)
+           && (a.dst_end.wday == b.dst_end.wday) && (a.dst_end.min == b.dst_end.min);
+}
+
+static void check_parse(void)
+{
+    rtc_tz_rule_t rule;
+
+    for (unsigned z = 0; z < NUM_ZONES; z++) {
+        if (rtc_tz_parse(zones[z].posix, &rule) || !same_rule(rule, zones[z].rule)) {
+            printf("%s: \"%s\" does not parse to RTC_TZ_%s\n", zones[z].name, zones[z].posix, zones[z].name);
+            failures++;
+        }
+    }
+
+    for (unsigned i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        if (rtc_tz_parse(bad[i], &rule) == 0) {
+            printf("\"%s\" parses\n", bad[i]);
+            failures++;
+        }
+    }
+}
+
+static int check_one(const zone &z, RTCTimeZone &tz, time_t utc)
+{
+    struct tm want;
+    struct tm got;
+    rtc_epoch_t local;
+    rtc_epoch_t back;
+
+    localtime_r(&utc, &want);
+    tz.localtime(utc, &got);
+
+    if ((want.tm_year != got.tm_year) || (want.tm_yday != got.tm_yday) || (want.tm_mon != got.tm_mon)
+        || (want.tm_mday != got.tm_mday) || (want.tm_wday != got.tm_wday) || (want.tm_hour != got.tm_hour)
+        || (want.tm_min != got.tm_min) || (want.tm_sec != got.tm_sec) || (want.tm_isdst != got.tm_isdst)) {
+        printf("%s: %ld is %s", z.name, (long)utc, asctime(&want));
+        printf("%s: %ld got %s", z.name, (long)utc, asctime(&got));
+        return 1;
+    }
+
+    local = tz.to_local(utc);
+    back = tz.to_utc(local);
+    if ((back != (rtc_epoch_t)utc) && (tz.to_local(back) != local)) {
+        printf("%s: to_utc(%lu) is %lu, not %ld\n", z.name, (unsigned long)local, (unsigned long)back, (long)utc);
+        return 1;
+    }
+
+    return 0;
+}
+
+static void check_zone(const zone &z)
+{
+    RTCTimeZone tz(z.rule);
+    int errors = 0;
+
+    setenv("TZ", z.posix, 1);
+    tzset();
+
+    for (uint64_t t = FINE_FROM; (t < FINE_TO) && (errors < 5); t += 900) {
+        errors += check_one(z, tz, t);
+    }
+    for (uint64_t t = COARSE_FROM; (t < COARSE_TO) && (errors < 5); t += 86400 + 7) {
+        errors += check_one(z, tz, t);
+    }
+
+    failures += errors;
+}
+
+static void cost(const zone &z)
+{
+    RTCTimeZone tz(z.rule);
+    struct tm t;
+    time_t utc;
+    uint64_t start;
+    uint64_t libc;
+    uint64_t lib_tm;
+    uint64_t lib_epoch;
+    rtc_epoch_t sum = 0;
+
+    setenv("TZ", z.posix, 1);
+    tzset();
+
+    start = now();
+    for (utc = FINE_FROM; utc < (time_t)(FINE_FROM + CONV_CALLS); utc++) {
+        localtime_r(&utc, &t);
+        __asm__ volatile("" : : "r"(&t) : "memory");
+    }
+    libc = now() - start;
+
+    start = now();
+    for (utc = FINE_FROM; utc < (time_t)(FINE_FROM + CONV_CALLS); utc++) {
+        tz.localtime(utc, &t);
+        __asm__ volatile("" : : "r"(&t) : "memory");
+    }
+    lib_tm = now() - start;
+
+    start = now();
+    for (utc = FINE_FROM; utc < (time_t)(FINE_FROM + CONV_CALLS); utc++) {
+        sum += tz.to_local(utc);
+    }
+    lib_epoch = now() - start;
+    __asm__ volatile("" : : "r"(sum));
+
+    printf("%-12s %12.1f %12.1f %12.1f\n", z.name, (double)libc / CONV_CALLS, (double)lib_tm / CONV_CALLS,
+           (double)lib_epoch / CONV_CALLS);
+}
+
+static void call_cost(void)
+{
+    static const rtc_tz_rule_t rule = RTC_TZ_EU_CENTRAL;
+    MAX31343Sim sim;
+    MAX31343 rtc(&Wire);
+    RTCTimeZone tz(rule);
+    struct tm t;
+    struct tm check;
+    rtc_epoch_t utc;
+    time_t now_utc;
+    uint64_t start;
+    uint64_t libc;
+    uint64_t lib;
+
+    setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+    tzset();
+
+    Wire.attach(&sim);
+    rtc.begin();
+
+    /* Set through the zone: 2024-07-01 12:00 CEST */
+    memset(&t, 0, sizeof(t));
+    t.tm_year = 124;
+    t.tm_mon = 6;
+    t.tm_mday = 1;
+    t.tm_hour = 12;
+    tz.set_time(rtc, &t);
+    rtc.get_epoch(&utc);
+    if (utc != 1719828000UL) {
+        printf("set_time() of 12:00 CEST wrote %lu\n", (unsigned long)utc);
+        failures++;
+    }
+
+    start = now();
+    for (int n = 0; n < CALL_LOOPS; n++) {
+        rtc.get_epoch(&utc);
+        now_utc = utc;
+        localtime_r(&now_utc, &check);
+    }
+    libc = now() - start;
+
+    start = now();
+    for (int n = 0; n < CALL_LOOPS; n++) {
+        tz.get_time(rtc, &t);
+    }
+    lib = now() - start;
+
+    if ((t.tm_hour != check.tm_hour) || (t.tm_isdst != 1)) {
+        printf("get_time() in CEST gives %02d:%02d dst %d\n", t.tm_hour, t.tm_min, t.tm_isdst);
+        failures++;
+    }
+
+    printf("\n%-30s %12s\n", "MAX31343 call", COST_UNIT);
+    printf("%-30s %12.1f\n", "get_epoch() + localtime_r()", (double)libc / CALL_LOOPS);
+    printf("%-30s %12.1f\n", "RTCTimeZone::get_time()", (double)lib / CALL_LOOPS);
+
+    Wire.detach(&sim);
+}
+
+int main(void)
+{
+    host_serial_mute(true);
+
+    check_parse();
+    for (unsigned z = 0; z < NUM_ZONES; z++) {
+        check_zone(zones[z]);
+    }
+
+    printf("%-12s %12s %12s %12s  (%s per call)\n", "zone", "localtime_r", "localtime", "to_local", COST_UNIT);
+    for (unsigned z = 0; z < NUM_ZONES; z++) {
+        cost(zones[z]);
+    }
+
+    call_cost();
+
+    if (failures) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+
+    return 0;
+}
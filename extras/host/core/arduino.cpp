@@ -0,0 +1,188 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <atomic>
+
+HardwareSerial Serial;
+
+/* Atomic, the bus workers of RTCLinuxManager share it */
+static std::atomic<uint64_t> clock_us(0);
+static uint8_t  pin_mode[HOST_NUM_PINS];
+static uint8_t  pin_in[HOST_NUM_PINS];
+static bool     pin_driven[HOST_NUM_PINS];
+static uint8_t  pin_out[HOST_NUM_PINS];
+
+uint64_t host_clock_us(void)
+{
+    return clock_us;
+}
+
+void host_clock_advance(uint64_t us)
+{
+    clock_us += us;
+}
+
+void host_clock_reset(void)
+{
+    clock_us = 0;
+}
+
+unsigned long micros(void)
+{
+    return (unsigned long)(clock_us++);
+}
+
+unsigned long millis(void)
+{
+    return (unsigned long)(clock_us++ / 1000);
+}
+
+void delay(unsigned long ms)
+{
+    clock_us += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    clock_us += us;
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin < HOST_NUM_PINS) {
+        pin_mode[pin] = mode;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    if (pin < HOST_NUM_PINS) {
+        pin_out[pin] = val ? HIGH : LOW;
+    }
+}
+
+int digitalRead(uint8_t pin)
+{
+    if (pin >= HOST_NUM_PINS) {
+        return LOW;
+    }
+
+    if (pin_mode[pin] == OUTPUT) {
+        return pin_out[pin];
+    }
+
+    /* An input nobody drives follows its pull-up */
+    if (!pin_driven[pin]) {
+        return (pin_mode[pin] == INPUT_PULLUP) ? HIGH : LOW;
+    }
+
+    return pin_in[pin];
+}
+
+void host_pin_set(uint8_t pin, int level)
+{
+    if (pin < HOST_NUM_PINS) {
+        pin_in[pin] = level ? HIGH : LOW;
+        pin_driven[pin] = true;
+    }
+}
+
+int host_pin_get(uint8_t pin)
+{
+    return (pin < HOST_NUM_PINS) ? pin_out[pin] : LOW;
+}
+
+/*
+ * Serial prints to stdout unless muted
+ */
+static bool serial_muted;
+
+void host_serial_mute(bool mute)
+{
+    serial_muted = mute;
+}
+
+static int serial_printf(const char *fmt, ...)
+{
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = serial_muted ? vsnprintf(NULL, 0, fmt, ap) : vprintf(fmt, ap);
+    va_end(ap);
+
+    return n;
+}
+
+static size_t print_int(long long val, int base)
+{
+    switch (base) {
+        case HEX:
+            return serial_printf("%llX", val);
+        case OCT:
+            return serial_printf("%llo", val);
+        case BIN: {
+            char buf[65];
+            int  i = 64;
+            unsigned long long u = (unsigned long long)val;
+
+            buf[i] = '\0';
+            do {
+                buf[--i] = '0' + (u & 1);
+                u >>= 1;
+            } while (u);
+            return serial_printf("%s", &buf[i]);
+        }
+        default:
+            return serial_printf("%lld", val);
+    }
+}
+
+size_t HardwareSerial::print(const char *str)               { return serial_printf("%s", str); }
+size_t HardwareSerial::print(char c)                        { return serial_printf("%c", c); }
+size_t HardwareSerial::print(int val, int base)             { return print_int(val, base); }
+size_t HardwareSerial::print(unsigned int val, int base)    { return print_int(val, base); }
+size_t HardwareSerial::print(long val, int base)            { return print_int(val, base); }
+size_t HardwareSerial::print(unsigned long val, int base)   { return print_int(val, base); }
+size_t HardwareSerial::print(double val, int digits)        { return serial_printf("%.*f", digits, val); }
+
+size_t HardwareSerial::println(void)                        { return serial_printf("\r\n"); }
+size_t HardwareSerial::println(const char *str)             { return print(str) + println(); }
+size_t HardwareSerial::println(char c)                      { return print(c) + println(); }
+size_t HardwareSerial::println(int val, int base)           { return print(val, base) + println(); }
+size_t HardwareSerial::println(unsigned int val, int base)  { return print(val, base) + println(); }
+size_t HardwareSerial::println(long val, int base)          { return print(val, base) + println(); }
+size_t HardwareSerial::println(unsigned long val, int base) { return print(val, base) + println(); }
+size_t HardwareSerial::println(double val, int digits)      { return print(val, digits) + println(); }
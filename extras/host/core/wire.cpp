@@ -0,0 +1,255 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#include <Wire.h>
+
+#define DEFAULT_SCL_HZ      100000
+
+TwoWire Wire;
+
+TwoWire::TwoWire()
+{
+    memset(m_devices, 0, sizeof(m_devices));
+    m_clock = DEFAULT_SCL_HZ;
+    m_tx_addr = 0;
+    m_tx_len = 0;
+    m_tx_overflow = false;
+    m_rx_len = 0;
+    m_rx_pos = 0;
+    m_err_code = 0;
+    m_err_count = 0;
+    m_begin_us = 0;
+    reset_stats();
+}
+
+void TwoWire::begin(void)
+{
+    m_tx_len = 0;
+    m_tx_overflow = false;
+    m_rx_len = 0;
+    m_rx_pos = 0;
+    m_stats.begins++;
+    host_clock_advance(m_begin_us);
+}
+
+int TwoWire::attach(HostI2CDevice *dev)
+{
+    for (int i = 0; i < HOST_I2C_MAX_DEVICES; i++) {
+        if (m_devices[i] == NULL) {
+            m_devices[i] = dev;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+void TwoWire::detach(HostI2CDevice *dev)
+{
+    for (int i = 0; i < HOST_I2C_MAX_DEVICES; i++) {
+        if (m_devices[i] == dev) {
+            m_devices[i] = NULL;
+        }
+    }
+}
+
+HostI2CDevice *TwoWire::find(uint8_t address)
+{
+    for (int i = 0; i < HOST_I2C_MAX_DEVICES; i++) {
+        if (m_devices[i] && m_devices[i]->address() == address) {
+            return m_devices[i];
+        }
+    }
+
+    return NULL;
+}
+
+void TwoWire::inject_error(uint8_t code, int count/*=1*/)
+{
+    m_err_code = code;
+    m_err_count = count;
+}
+
+void TwoWire::reset_stats(void)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+/*
+ * START + address + data bytes, 9 clocks each, + STOP/repeated START
+ */
+void TwoWire::account(int bytes)
+{
+    uint64_t bits = (uint64_t)(bytes + 1) * 9 + 2;
+    uint64_t us = (bits * 1000000 + m_clock - 1) / m_clock;
+
+    m_stats.transfers++;
+    m_stats.bus_time_us += us;
+    host_clock_advance(us);
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+    m_tx_addr = address;
+    m_tx_len = 0;
+    m_tx_overflow = false;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+    if (m_tx_len >= BUFFER_LENGTH) {
+        m_tx_overflow = true;
+        return 0;
+    }
+
+    m_tx_buf[m_tx_len++] = data;
+
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t quantity)
+{
+    size_t i;
+
+    for (i = 0; i < quantity; i++) {
+        if (write(data[i]) == 0) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop/*=true*/)
+{
+    HostI2CDevice *dev;
+
+    (void)sendStop;
+
+    if (m_tx_overflow) {
+        m_tx_len = 0;
+        return 1;
+    }
+
+    m_stats.writes++;
+
+    if (m_err_count > 0) {
+        m_err_count--;
+        m_stats.nacks++;
+        account(0);
+        return m_err_code;
+    }
+
+    dev = find(m_tx_addr);
+    if (dev == NULL) {
+        m_stats.nacks++;
+        account(0);
+        return 2;
+    }
+
+    /* The target acts on the data at the end of the transfer, e.g. SET_RTC */
+    account(m_tx_len);
+    if (!dev->i2c_write(m_tx_buf, m_tx_len)) {
+        m_stats.nacks++;
+        return 3;
+    }
+
+    m_stats.bytes_out += m_tx_len;
+    m_tx_len = 0;
+
+    return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop/*=true*/)
+{
+    HostI2CDevice *dev;
+    int n;
+
+    (void)sendStop;
+
+    m_rx_len = 0;
+    m_rx_pos = 0;
+
+    if (quantity > BUFFER_LENGTH) {
+        quantity = BUFFER_LENGTH;
+    }
+
+    m_stats.reads++;
+
+    if (m_err_count > 0) {
+        m_err_count--;
+        m_stats.nacks++;
+        account(0);
+        return 0;
+    }
+
+    dev = find(address);
+    if (dev == NULL) {
+        m_stats.nacks++;
+        account(0);
+        return 0;
+    }
+
+    n = dev->i2c_read(m_rx_buf, quantity);
+    if (n < 0) {
+        n = 0;
+    }
+
+    m_rx_len = (uint8_t)n;
+    m_stats.bytes_in += n;
+    account(n);
+
+    return m_rx_len;
+}
+
+int TwoWire::available(void)
+{
+    return m_rx_len - m_rx_pos;
+}
+
+int TwoWire::read(void)
+{
+    if (m_rx_pos >= m_rx_len) {
+        return -1;
+    }
+
+    return m_rx_buf[m_rx_pos++];
+}
+
+int TwoWire::peek(void)
+{
+    if (m_rx_pos >= m_rx_len) {
+        return -1;
+    }
+
+    return m_rx_buf[m_rx_pos];
+}
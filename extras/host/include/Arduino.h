@@ -0,0 +1,128 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * Host build stand-in for the Arduino core.
+ *
+ * Time is virtual: it only moves when delay()/delayMicroseconds() is called,
+ * when a bus transfer is clocked out by the TwoWire mock, or by one tick on
+ * every micros()/millis() call so that polling loops always terminate.
+ */
+
+#ifndef _HOST_ARDUINO_H_
+#define _HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+#define HIGH            1
+#define LOW             0
+
+#define INPUT           0
+#define OUTPUT          1
+#define INPUT_PULLUP    2
+
+#define DEC             10
+#define HEX             16
+#define OCT             8
+#define BIN             2
+
+#define HOST_NUM_PINS   64
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+/* Single threaded, there is nothing to mask */
+static inline void noInterrupts(void) {}
+static inline void interrupts(void) {}
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int  digitalRead(uint8_t pin);
+
+class HardwareSerial
+{
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    operator bool() const { return true; }
+
+    size_t print(const char *str);
+    size_t print(char c);
+    size_t print(int val, int base = DEC);
+    size_t print(unsigned int val, int base = DEC);
+    size_t print(long val, int base = DEC);
+    size_t print(unsigned long val, int base = DEC);
+    size_t print(double val, int digits = 2);
+
+    size_t println(void);
+    size_t println(const char *str);
+    size_t println(char c);
+    size_t println(int val, int base = DEC);
+    size_t println(unsigned int val, int base = DEC);
+    size_t println(long val, int base = DEC);
+    size_t println(unsigned long val, int base = DEC);
+    size_t println(double val, int digits = 2);
+};
+
+extern HardwareSerial Serial;
+
+/*
+ * Host-only hooks, used by the simulators and benches
+ */
+
+/** @brief Current virtual time in microseconds */
+uint64_t host_clock_us(void);
+
+/** @brief Moves virtual time forward */
+void host_clock_advance(uint64_t us);
+
+/** @brief Restarts virtual time from zero */
+void host_clock_reset(void);
+
+/** @brief Drives the level seen by digitalRead() on an input pin */
+void host_pin_set(uint8_t pin, int level);
+
+/** @brief Returns the last level written by digitalWrite() */
+int  host_pin_get(uint8_t pin);
+
+/** @brief Drops Serial output, e.g. driver error messages in benches that provoke errors */
+void host_serial_mute(bool mute);
+
+#endif /* _HOST_ARDUINO_H_ */
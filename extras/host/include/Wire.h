@@ -0,0 +1,172 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * Host build stand-in for the Arduino Wire library.
+ *
+ * Transfers are routed to simulated devices attached with TwoWire::attach().
+ * Buffer sizes, return codes and short-read behaviour follow the AVR core so
+ * that drivers see the same limits they hit on target. Every transfer is
+ * counted and advances the virtual clock by its wire time at the configured
+ * SCL rate.
+ */
+
+#ifndef _HOST_WIRE_H_
+#define _HOST_WIRE_H_
+
+#include <Arduino.h>
+
+#define BUFFER_LENGTH           32
+#define WIRE_HAS_END            1
+
+#define HOST_I2C_MAX_DEVICES    8
+
+/**
+ * @brief	Interface implemented by every simulated I2C target
+ */
+class HostI2CDevice
+{
+public:
+    virtual ~HostI2CDevice() {}
+
+    /** @brief 7-bit bus address */
+    virtual uint8_t address(void) const = 0;
+
+    /**
+     * @brief	Master write phase
+     *
+     * @param[in]	buf		Bytes after the address byte
+     * @param[in]	len		Number of bytes
+     *
+     * @returns true on ACK, false to NACK the data.
+     */
+    virtual bool i2c_write(const uint8_t *buf, int len) = 0;
+
+    /**
+     * @brief	Master read phase
+     *
+     * @param[out]	buf		Bytes returned by the target
+     * @param[in]	len		Number of bytes requested
+     *
+     * @returns Number of bytes supplied.
+     */
+    virtual int i2c_read(uint8_t *buf, int len) = 0;
+};
+
+/**
+ * @brief	Bus counters kept by the TwoWire mock
+ */
+typedef struct {
+    uint32_t transfers;		/**< Address phases put on the bus (write and read) */
+    uint32_t writes;		/**< Write transfers */
+    uint32_t reads;			/**< Read transfers */
+    uint32_t bytes_out;		/**< Data bytes sent to targets, register pointer included */
+    uint32_t bytes_in;		/**< Data bytes received from targets */
+    uint32_t nacks;			/**< Transfers not acknowledged */
+    uint32_t begins;		/**< begin() calls, drivers use them to recover the bus */
+    uint64_t bus_time_us;	/**< Wire time at the configured SCL rate */
+} host_i2c_stats_t;
+
+class TwoWire
+{
+public:
+    TwoWire();
+
+    void begin(void);
+    void begin(uint8_t address) { (void)address; begin(); }
+    void end(void) {}
+    void setClock(uint32_t clock) { m_clock = clock; }
+
+    void beginTransmission(uint8_t address);
+    void beginTransmission(int address) { beginTransmission((uint8_t)address); }
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t endTransmission(uint8_t sendStop) { return endTransmission(sendStop != 0); }
+
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop = true);
+    uint8_t requestFrom(int address, int quantity) { return requestFrom((uint8_t)address, (uint8_t)quantity, (uint8_t)true); }
+    uint8_t requestFrom(int address, int quantity, int sendStop) { return requestFrom((uint8_t)address, (uint8_t)quantity, (uint8_t)sendStop); }
+
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t quantity);
+    int available(void);
+    int read(void);
+    int peek(void);
+    void flush(void) {}
+
+    /*
+     * Host-only
+     */
+    int  attach(HostI2CDevice *dev);
+    void detach(HostI2CDevice *dev);
+
+    /**
+     * @brief	Fails the next transfers
+     *
+     * @param[in]	code	endTransmission() code to return (1..4)
+     * @param[in]	count	Number of transfers to fail
+     */
+    void inject_error(uint8_t code, int count = 1);
+
+    /**
+     * @brief	Virtual time taken by begin(), to model a slow peripheral re-init
+     */
+    void set_begin_time(uint32_t us) { m_begin_us = us; }
+
+    const host_i2c_stats_t &stats(void) const { return m_stats; }
+    void reset_stats(void);
+
+private:
+    HostI2CDevice *find(uint8_t address);
+    void account(int bytes);
+
+    HostI2CDevice *m_devices[HOST_I2C_MAX_DEVICES];
+    uint32_t m_clock;
+
+    uint8_t m_tx_addr;
+    uint8_t m_tx_buf[BUFFER_LENGTH];
+    uint8_t m_tx_len;
+    bool    m_tx_overflow;
+
+    uint8_t m_rx_buf[BUFFER_LENGTH];
+    uint8_t m_rx_len;
+    uint8_t m_rx_pos;
+
+    uint8_t m_err_code;
+    int     m_err_count;
+    uint32_t m_begin_us;
+
+    host_i2c_stats_t m_stats;
+};
+
+extern TwoWire Wire;
+
+#endif /* _HOST_WIRE_H_ */
@@ -0,0 +1,151 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#include "i2c_dev_fake.h"
+
+#include <errno.h>
+#include <time.h>
+#include <linux/i2c.h>
+
+#define DEFAULT_SCL_HZ      100000UL
+
+I2CDevFake::I2CDevFake() : RTCLinuxI2C(NULL)
+{
+    memset(m_devices, 0, sizeof(m_devices));
+    m_clock = DEFAULT_SCL_HZ;
+    m_realtime = false;
+    m_err = 0;
+    m_err_count = 0;
+    reset_stats();
+}
+
+int I2CDevFake::attach(HostI2CDevice *dev)
+{
+    for (int i = 0; i < HOST_I2C_MAX_DEVICES; i++) {
+        if (m_devices[i] == NULL) {
+            m_devices[i] = dev;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+void I2CDevFake::detach(HostI2CDevice *dev)
+{
+    for (int i = 0; i < HOST_I2C_MAX_DEVICES; i++) {
+        if (m_devices[i] == dev) {
+            m_devices[i] = NULL;
+        }
+    }
+}
+
+void I2CDevFake::inject_errno(int err, int count)
+{
+    m_err = err;
+    m_err_count = count;
+}
+
+void I2CDevFake::reset_stats(void)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+HostI2CDevice *I2CDevFake::find(uint8_t address)
+{
+    for (int i = 0; i < HOST_I2C_MAX_DEVICES; i++) {
+        if (m_devices[i] != NULL && m_devices[i]->address() == address) {
+            return m_devices[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Same wire time as the TwoWire mock: START or repeated START + address +
+ * data bytes, 9 clocks each, + STOP
+ */
+void I2CDevFake::account(int bytes)
+{
+    uint64_t bits = (uint64_t)(bytes + 1) * 9 + 2;
+    uint64_t us = (bits * 1000000 + m_clock - 1) / m_clock;
+
+    m_stats.messages++;
+    m_stats.bus_time_us += us;
+    host_clock_advance(us);
+
+    if (m_realtime) {
+        struct timespec ts = { 0, (long)us * 1000 };
+
+        nanosleep(&ts, NULL);
+    }
+}
+
+int I2CDevFake::transfer(struct i2c_msg *msgs, int num)
+{
+    m_stats.ioctls++;
+
+    if (m_err_count > 0) {
+        m_err_count--;
+        m_stats.nacks++;
+        return -m_err;
+    }
+
+    for (int i = 0; i < num; i++) {
+        HostI2CDevice *dev = find(msgs[i].addr);
+
+        if (dev == NULL) {
+            account(0);
+            m_stats.nacks++;
+            return -ENXIO;
+        }
+
+        account(msgs[i].len);
+
+        if (msgs[i].flags & I2C_M_RD) {
+            /* The kernel reports a short read as a failed transfer */
+            if (dev->i2c_read(msgs[i].buf, msgs[i].len) != msgs[i].len) {
+                return -EIO;
+            }
+            m_stats.bytes_in += msgs[i].len;
+        } else {
+            if (!dev->i2c_write(msgs[i].buf, msgs[i].len)) {
+                m_stats.nacks++;
+                return -EREMOTEIO;
+            }
+            m_stats.bytes_out += msgs[i].len;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * In-process stand-in for a Linux i2c-dev adapter.
+ *
+ * I2CDevFake is an RTCLinuxI2C whose transfer() hands the I2C_RDWR
+ * messages to the attached simulators instead of the kernel, so the
+ * backend's message framing and errno mapping run unchanged on any host.
+ */
+
+#ifndef _I2C_DEV_FAKE_H_
+#define _I2C_DEV_FAKE_H_
+
+#include <RTCCommon/RTCLinuxI2C.h>
+
+/**
+ * @brief	Counters kept by the fake adapter
+ */
+typedef struct {
+    uint32_t ioctls;		/**< I2C_RDWR calls */
+    uint32_t messages;		/**< i2c_msg entries, one address phase each */
+    uint32_t bytes_out;		/**< Data bytes sent to targets, register pointer included */
+    uint32_t bytes_in;		/**< Data bytes received from targets */
+    uint32_t nacks;			/**< Calls that failed with an address or data NACK */
+    uint64_t bus_time_us;	/**< Wire time at the configured SCL rate */
+} i2c_dev_fake_stats_t;
+
+class I2CDevFake : public RTCLinuxI2C
+{
+public:
+    I2CDevFake();
+
+    int  attach(HostI2CDevice *dev);
+    void detach(HostI2CDevice *dev);
+    void set_clock(uint32_t clock) { m_clock = clock; }
+
+    /**
+     * @brief	Also sleep for the wire time of each message, so transfers take real time
+     */
+    void set_realtime(bool realtime) { m_realtime = realtime; }
+
+    /**
+     * @brief	Fails the next I2C_RDWR calls with -err (e.g. ENXIO, EIO)
+     */
+    void inject_errno(int err, int count = 1);
+
+    const i2c_dev_fake_stats_t &stats(void) const { return m_stats; }
+    void reset_stats(void);
+
+protected:
+    int transfer(struct i2c_msg *msgs, int num);
+
+private:
+    HostI2CDevice *find(uint8_t address);
+    void account(int bytes);
+
+    HostI2CDevice *m_devices[HOST_I2C_MAX_DEVICES];
+    uint32_t m_clock;
+    bool m_realtime;
+    int m_err;
+    int m_err_count;
+    i2c_dev_fake_stats_t m_stats;
+};
+
+#endif /* _I2C_DEV_FAKE_H_ */
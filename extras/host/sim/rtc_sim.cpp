@@ -0,0 +1,723 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#include "rtc_sim.h"
+
+#include <MAX31328/MAX31328_registers.h>
+#include <MAX31329/MAX31329_registers.h>
+#include <MAX31341/MAX31341_registers.h>
+#include <MAX31342/MAX31342_registers.h>
+#include <MAX31343/MAX31343_registers.h>
+#include <MAX3133X/MAX3133X_registers.h>
+
+#define BCD2BIN(val) (((val) & 15) + ((val) >> 4) * 10)
+#define BIN2BCD(val) ((((val) / 10) << 4) + (val) % 10)
+
+#define US_PER_SEC          1000000UL
+
+static const uint16_t timer_hz[4] = {1024, 256, 64, 16};
+
+static int days_in_month(int month, int year)
+{
+    static const uint8_t days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+    if (month == 2 && (year % 4 == 0) && ((year % 100 != 0) || (year % 400 == 0))) {
+        return 29;
+    }
+
+    return days[month - 1];
+}
+
+static void temp_to_regs(float temp, uint8_t *msb, uint8_t *lsb)
+{
+    int count = (int)floorf(temp * 4 + 0.5f);
+
+    count &= 0x3FF;
+    *msb = (uint8_t)(count >> 2);
+    *lsb = (uint8_t)((count & 0x03) << 6);
+}
+
+/*****************************************************************************/
+RTCSim::RTCSim(const rtc_sim_layout_t *layout, uint8_t i2c_addr/*=0*/)
+{
+    m_layout = layout;
+    m_addr = i2c_addr ? i2c_addr : layout->i2c_addr;
+    m_reg_reads = 0;
+    m_reg_writes = 0;
+    /* Derived classes call power_on() once their own state is set up */
+    memset(m_regs, 0, sizeof(m_regs));
+    m_ptr = 0;
+    m_phase_us = 0;
+    m_timer_acc = 0;
+    m_last_us = host_clock_us();
+    m_read_byte_us = 0;
+}
+
+void RTCSim::power_on(void)
+{
+    struct tm epoch;
+
+    memset(m_regs, 0, sizeof(m_regs));
+    memset(&epoch, 0, sizeof(epoch));
+    epoch.tm_year = 100;
+    epoch.tm_mday = 1;
+    epoch.tm_wday = 6;	/* 2000-01-01 was a Saturday */
+    set_calendar(&epoch);
+
+    load_defaults();
+
+    m_ptr = 0;
+    m_timer_acc = 0;
+    m_last_us = host_clock_us();
+}
+
+void RTCSim::reset_block(void)
+{
+    uint8_t ram[SIM_REG_FILE_SIZE];
+    uint8_t reset_val = 0;
+    int ram_len = 0;
+
+    if (m_layout->ram_start != SIM_REG_NONE) {
+        ram_len = m_layout->ram_end - m_layout->ram_start + 1;
+        memcpy(ram, &m_regs[m_layout->ram_start], ram_len);
+    }
+    if (m_layout->reset_reg != SIM_REG_NONE) {
+        reset_val = m_regs[m_layout->reset_reg];
+    }
+
+    power_on();
+
+    if (ram_len) {
+        memcpy(&m_regs[m_layout->ram_start], ram, ram_len);
+    }
+    if (m_layout->reset_reg != SIM_REG_NONE) {
+        m_regs[m_layout->reset_reg] = reset_val;
+    }
+}
+
+void RTCSim::sync(void)
+{
+    uint64_t now = host_clock_us();
+
+    if (now > m_last_us) {
+        advance(now - m_last_us);
+    }
+    m_last_us = now;
+}
+
+bool RTCSim::running(void) const
+{
+    const rtc_sim_layout_t *l = m_layout;
+
+    if (l->reset_reg != SIM_REG_NONE) {
+        bool bit = (m_regs[l->reset_reg] & l->reset_mask) != 0;
+
+        if (bit != l->reset_active_low) {
+            return false;
+        }
+    }
+
+    if (l->osc_reg != SIM_REG_NONE) {
+        bool bit = (m_regs[l->osc_reg] & l->osc_mask) != 0;
+
+        if (bit == l->osc_active_low) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool RTCSim::is_time_reg(uint8_t reg) const
+{
+    return reg >= m_layout->seconds && reg < m_layout->seconds + 7;
+}
+
+void RTCSim::advance(uint64_t us)
+{
+    const rtc_sim_layout_t *l = m_layout;
+    uint8_t cfg;
+
+    if (!running()) {
+        return;
+    }
+
+    if (l->timer_cfg != SIM_REG_NONE) {
+        cfg = m_regs[l->timer_cfg];
+
+        if ((cfg & l->timer_te) && !(cfg & l->timer_tpause)) {
+            m_timer_acc += us * timer_hz[cfg & 0x03];
+
+            while (m_timer_acc >= US_PER_SEC) {
+                m_timer_acc -= US_PER_SEC;
+                tick_timer();
+            }
+        }
+    }
+
+    us += m_phase_us;
+    while (us >= US_PER_SEC) {
+        us -= US_PER_SEC;
+        tick_second();
+    }
+    m_phase_us = (uint32_t)us;
+}
+
+uint16_t RTCSim::timer_get(uint8_t reg) const
+{
+    if (m_layout->timer_width == 2) {
+        return (m_regs[reg] << 8) | m_regs[reg + 1];
+    }
+
+    return m_regs[reg];
+}
+
+void RTCSim::timer_set(uint8_t reg, uint16_t val)
+{
+    if (m_layout->timer_width == 2) {
+        m_regs[reg] = val >> 8;
+        m_regs[reg + 1] = val & 0xFF;
+    } else {
+        m_regs[reg] = val & 0xFF;
+    }
+}
+
+void RTCSim::tick_timer(void)
+{
+    const rtc_sim_layout_t *l = m_layout;
+    uint16_t count = timer_get(l->timer_count);
+
+    if (count == 0) {
+        return;
+    }
+
+    if (--count == 0) {
+        m_regs[l->status] |= SIM_FLAG_TI;
+
+        if (m_regs[l->timer_cfg] & l->timer_trpt) {
+            count = timer_get(l->timer_init);
+        }
+    }
+
+    timer_set(l->timer_count, count);
+}
+
+void RTCSim::tick_second(void)
+{
+    uint8_t *t = &m_regs[m_layout->seconds];
+    int sec, min, hour, wday, date, month, year, century;
+
+    sec = BCD2BIN(t[0] & 0x7F) + 1;
+    if (sec < 60) {
+        t[0] = BIN2BCD(sec);
+        check_alarms();
+        return;
+    }
+    t[0] = 0;
+
+    min = BCD2BIN(t[1] & 0x7F) + 1;
+    if (min < 60) {
+        t[1] = BIN2BCD(min);
+        check_alarms();
+        return;
+    }
+    t[1] = 0;
+
+    hour = BCD2BIN(t[2] & 0x3F) + 1;
+    if (hour < 24) {
+        t[2] = (t[2] & ~0x3F) | BIN2BCD(hour);
+        check_alarms();
+        return;
+    }
+    t[2] &= ~0x3F;
+
+    wday = BCD2BIN(t[3] & 0x07) + 1;
+    t[3] = (wday > 7) ? 1 : wday;
+
+    century = (t[5] & 0x80) ? 1 : 0;
+    month = BCD2BIN(t[5] & 0x1F);
+    year = BCD2BIN(t[6]);
+    date = BCD2BIN(t[4] & 0x3F) + 1;
+
+    if (date > days_in_month(month, 2000 + century * 100 + year)) {
+        date = 1;
+        if (++month > 12) {
+            month = 1;
+            if (++year > 99) {
+                year = 0;
+                century ^= 1;
+            }
+        }
+    }
+
+    t[4] = BIN2BCD(date);
+    t[5] = (century ? 0x80 : 0) | BIN2BCD(month);
+    t[6] = BIN2BCD(year);
+
+    check_alarms();
+}
+
+void RTCSim::check_alarms(void)
+{
+    const rtc_sim_layout_t *l = m_layout;
+    const uint8_t *t = &m_regs[l->seconds];
+    const uint8_t *a;
+    bool match;
+
+    #define FIELD_MATCH(alm, now, mask)	(((alm) & 0x80) || (((alm) & (mask)) == ((now) & (mask))))
+    #define DAY_DATE_MATCH(alm)			(((alm) & 0x80) || (((alm) & 0x40) ? \
+											(((alm) & 0x0F) == (t[3] & 0x0F)) : \
+											(((alm) & 0x3F) == (t[4] & 0x3F))))
+
+    if (l->alarm1 != SIM_REG_NONE) {
+        a = &m_regs[l->alarm1];
+
+        match = FIELD_MATCH(a[0], t[0], 0x7F) &&
+                FIELD_MATCH(a[1], t[1], 0x7F) &&
+                FIELD_MATCH(a[2], t[2], 0x3F) &&
+                DAY_DATE_MATCH(a[3]);
+
+        if (match && l->alarm1_len == 6) {
+            /* a1m5 (bit 7) masks the month, a1m6 (bit 6) the year */
+            match = ((a[4] & 0x80) || ((a[4] & 0x1F) == (t[5] & 0x1F))) &&
+                    ((a[4] & 0x40) || (a[5] == t[6]));
+        }
+
+        if (match) {
+            m_regs[l->status] |= SIM_FLAG_A1;
+        }
+    }
+
+    if (l->alarm2 != SIM_REG_NONE && t[0] == 0) {
+        a = &m_regs[l->alarm2];
+
+        match = FIELD_MATCH(a[0], t[1], 0x7F) &&
+                FIELD_MATCH(a[1], t[2], 0x3F) &&
+                DAY_DATE_MATCH(a[2]);
+
+        if (match) {
+            m_regs[l->status] |= SIM_FLAG_A2;
+        }
+    }
+
+    #undef FIELD_MATCH
+    #undef DAY_DATE_MATCH
+}
+
+void RTCSim::set_calendar(const struct tm *time)
+{
+    uint8_t *t = &m_regs[m_layout->seconds];
+
+    t[0] = BIN2BCD(time->tm_sec);
+    t[1] = BIN2BCD(time->tm_min);
+    t[2] = BIN2BCD(time->tm_hour);
+    t[3] = BIN2BCD(time->tm_wday + 1);
+    t[4] = BIN2BCD(time->tm_mday);
+    t[5] = BIN2BCD(time->tm_mon + 1) | ((time->tm_year >= 200) ? 0x80 : 0);
+    t[6] = BIN2BCD(time->tm_year % 100);
+
+    m_phase_us = 0;
+}
+
+void RTCSim::get_calendar(struct tm *time)
+{
+    const uint8_t *t = &m_regs[m_layout->seconds];
+
+    sync();
+
+    memset(time, 0, sizeof(*time));
+    time->tm_sec = BCD2BIN(t[0] & 0x7F);
+    time->tm_min = BCD2BIN(t[1] & 0x7F);
+    time->tm_hour = BCD2BIN(t[2] & 0x3F);
+    time->tm_wday = BCD2BIN(t[3] & 0x07) - 1;
+    time->tm_mday = BCD2BIN(t[4] & 0x3F);
+    time->tm_mon = BCD2BIN(t[5] & 0x1F) - 1;
+    time->tm_year = BCD2BIN(t[6]) + ((t[5] & 0x80) ? 200 : 100);
+}
+
+bool RTCSim::int_asserted(void)
+{
+    const rtc_sim_layout_t *l = m_layout;
+
+    sync();
+
+    return (m_regs[l->status] & m_regs[l->int_en] & (SIM_FLAG_A1 | SIM_FLAG_A2 | SIM_FLAG_TI)) != 0;
+}
+
+uint8_t RTCSim::reg_read(uint8_t reg)
+{
+    if (reg == m_layout->sub_sec) {
+        return (uint8_t)(((uint64_t)m_phase_us * 128) / US_PER_SEC);
+    }
+
+    return m_regs[reg];
+}
+
+void RTCSim::after_read(uint8_t reg)
+{
+    if (reg == m_layout->status) {
+        m_regs[reg] &= ~m_layout->status_rc_mask;
+    }
+}
+
+void RTCSim::reg_write(uint8_t reg, uint8_t val)
+{
+    const rtc_sim_layout_t *l = m_layout;
+    uint8_t old = m_regs[reg];
+
+    if (reg == l->sub_sec) {
+        return;
+    }
+
+    if (l->timer_count != SIM_REG_NONE &&
+        reg >= l->timer_count && reg < l->timer_count + l->timer_width) {
+        return;	/* read-only */
+    }
+
+    m_regs[reg] = val;
+
+    if (reg == l->reset_reg) {
+        bool bit = (val & l->reset_mask) != 0;
+
+        if (bit != l->reset_active_low) {
+            reset_block();
+        }
+    }
+
+    if (reg == l->timer_cfg && !(old & l->timer_te) && (val & l->timer_te)) {
+        timer_set(l->timer_count, timer_get(l->timer_init));
+        m_timer_acc = 0;
+    }
+
+    if (is_time_reg(reg)) {
+        /* writing the time restarts the countdown chain */
+        m_phase_us = 0;
+    }
+}
+
+bool RTCSim::i2c_write(const uint8_t *buf, int len)
+{
+    sync();
+
+    if (len == 0) {
+        return true;
+    }
+
+    m_ptr = buf[0];
+    for (int i = 1; i < len; i++) {
+        reg_write(m_ptr, buf[i]);
+        m_reg_writes++;
+        m_ptr = (m_ptr >= m_layout->reg_end) ? 0 : m_ptr + 1;
+    }
+
+    return true;
+}
+
+int RTCSim::i2c_read(uint8_t *buf, int len)
+{
+    sync();
+
+    for (int i = 0; i < len; i++) {
+        /* No read latch: each byte is taken a byte time later, ahead of the clock until the bus catches up */
+        if (m_read_byte_us) {
+            advance(m_read_byte_us);
+            m_last_us += m_read_byte_us;
+        }
+        buf[i] = reg_read(m_ptr);
+        after_read(m_ptr);
+        m_reg_reads++;
+        m_ptr = (m_ptr >= m_layout->reg_end) ? 0 : m_ptr + 1;
+    }
+
+    return len;
+}
+
+/*****************************************************************************
+ * MAX31328
+ *****************************************************************************/
+static const rtc_sim_layout_t max31328_layout = {
+    "MAX31328", MAX3128_I2C_ADDRESS, MAX31328_R_LSB_TEMP,
+    /* status, rc mask, int_en */
+    MAX31328_R_STATUS, 0, MAX31328_R_CONTROL,
+    /* sub-second, seconds */
+    SIM_REG_NONE, MAX31328_R_SECONDS,
+    /* alarms */
+    MAX31328_R_ALRM1_SECONDS, 4, MAX31328_R_ALRM2_MINUTES,
+    /* no timer */
+    SIM_REG_NONE, SIM_REG_NONE, SIM_REG_NONE, 1, 0, 0, 0,
+    /* oscillator */
+    MAX31328_R_CONTROL, MAX31328_F_CTRL_EOSC, true,
+    /* no software reset */
+    SIM_REG_NONE, 0, false,
+    /* no RAM */
+    SIM_REG_NONE, SIM_REG_NONE,
+};
+
+MAX31328Sim::MAX31328Sim(uint8_t i2c_addr/*=0*/) : RTCSim(&max31328_layout, i2c_addr)
+{
+    power_on();
+}
+
+void MAX31328Sim::load_defaults(void)
+{
+    m_regs[MAX31328_R_CONTROL] = MAX31328_F_CTRL_INTCN | MAX31328_F_CTRL_RS;
+    m_regs[MAX31328_R_STATUS] = MAX31328_F_STATUS_OSF | MAX31328_F_STATUS_EN32KHZ;
+    temp_to_regs(25.0f, &m_regs[MAX31328_R_MSB_TEMP], &m_regs[MAX31328_R_LSB_TEMP]);
+}
+
+void MAX31328Sim::reg_write(uint8_t reg, uint8_t val)
+{
+    const uint8_t flags = MAX31328_F_STATUS_A1F | MAX31328_F_STATUS_A2F | MAX31328_F_STATUS_OSF;
+
+    if (reg == MAX31328_R_STATUS) {
+        /* flags can only be cleared, BSY is read-only */
+        m_regs[reg] = (m_regs[reg] & val & flags) |
+                      (val & MAX31328_F_STATUS_EN32KHZ) |
+                      (m_regs[reg] & MAX31328_F_STATUS_BSY);
+        return;
+    }
+
+    if (reg == MAX31328_R_CONTROL && (val & MAX31328_F_CTRL_CONV)) {
+        /* conversion completes immediately */
+        val &= ~MAX31328_F_CTRL_CONV;
+    }
+
+    RTCSim::reg_write(reg, val);
+}
+
+/*****************************************************************************
+ * MAX31329
+ *****************************************************************************/
+static const rtc_sim_layout_t max31329_layout = {
+    "MAX31329", MAX31329_I2C_ADDRESS, MAX31329_R_RAM_REG_END,
+    MAX31329_R_STATUS,
+    MAX31329_F_STATUS_A1F | MAX31329_F_STATUS_A2F | MAX31329_F_STATUS_TIF | MAX31329_F_STATUS_DIF,
+    MAX31329_R_INT_EN,
+    SIM_REG_NONE, MAX31329_R_SECONDS,
+    MAX31329_R_ALM1_SEC, 6, MAX31329_R_ALM2_MIN,
+    MAX31329_R_TIMER_CONFIG, MAX31329_R_TIMER_COUNT, MAX31329_R_TIMER_INIT, 1,
+    MAX31329_F_TIMER_CONFIG_TE, MAX31329_F_TIMER_CONFIG_TPAUSE, MAX31329_F_TIMER_CONFIG_TRPT,
+    MAX31329_R_CFG1, MAX31329_F_CFG1_ENOSC, false,
+    MAX31329_R_RTC_RESET, MAX31329_F_RTC_RESET_SWRST, false,
+    MAX31329_R_RAM_REG_START, MAX31329_R_RAM_REG_END,
+};
+
+MAX31329Sim::MAX31329Sim(uint8_t i2c_addr/*=0*/) : RTCSim(&max31329_layout, i2c_addr)
+{
+    power_on();
+}
+
+void MAX31329Sim::load_defaults(void)
+{
+    m_regs[MAX31329_R_STATUS] = MAX31329_F_STATUS_OSF;
+    m_regs[MAX31329_R_CFG1] = MAX31329_F_CFG1_ENOSC;
+}
+
+/*****************************************************************************
+ * MAX31341 / MAX31342
+ *****************************************************************************/
+static const rtc_sim_layout_t max31341_layout = {
+    "MAX31341", MAX31341_I2C_ADDRESS, MAX31341_R_REV_ID,
+    MAX31341_R_INT_STATUS,
+    MAX31341_F_INT_STATUS_A1IF | MAX31341_F_INT_STATUS_A2IF | MAX31341_F_INT_STATUS_TIF |
+    MAX31341_F_INT_STATUS_EIF1 | MAX31341_F_INT_STATUS_ANA_IF,
+    MAX31341_R_INT_EN,
+    SIM_REG_NONE, MAX31341_R_SECONDS,
+    MAX31341_R_ALM1_SEC, 4, MAX31341_R_ALM2_MIN,
+    MAX31341_R_TIMER_CFG, MAX31341_R_TIMER_COUNT, MAX31341_R_TIMER_INIT, 1,
+    MAX31341_F_TIMER_CFG_TE, MAX31341_F_TIMER_CFG_TPAUSE, MAX31341_F_TIMER_CFG_TRPT,
+    MAX31341_R_CFG1, MAX31341_F_CFG1_OSCONZ, true,
+    MAX31341_R_CFG1, MAX31341_F_CFG1_SWRSTN, true,
+    MAX31341_R_RAM_START, MAX31341_R_RAM_END,
+};
+
+static const rtc_sim_layout_t max31342_layout = {
+    "MAX31342", MAX31342_I2C_ADDRESS, MAX31342_R_CLOCK_SYNC,
+    MAX31342_R_INT_STATUS,
+    MAX31341_F_INT_STATUS_A1IF | MAX31341_F_INT_STATUS_A2IF | MAX31341_F_INT_STATUS_TIF |
+    MAX31341_F_INT_STATUS_EIF1 | MAX31341_F_INT_STATUS_ANA_IF,
+    MAX31342_R_INT_EN,
+    SIM_REG_NONE, MAX31342_R_SECONDS,
+    MAX31342_R_ALM1_SEC, 6, MAX31342_R_ALM2_MIN,
+    MAX31342_R_TIMER_CFG, MAX31342_R_TIMER_COUNT, MAX31342_R_TIMER_INIT, 1,
+    MAX31342_F_TIMER_CFG_TE, MAX31342_F_TIMER_CFG_TPAUSE, MAX31342_F_TIMER_CFG_TRPT,
+    MAX31342_R_CFG1, MAX31342_F_CFG1_OSCONZ, true,
+    MAX31342_R_CFG1, MAX31342_F_CFG1_SWRSTN, true,
+    SIM_REG_NONE, SIM_REG_NONE,
+};
+
+MAX3134XSim::MAX3134XSim(bool max31342, uint8_t i2c_addr/*=0*/)
+    : RTCSim(max31342 ? &max31342_layout : &max31341_layout, i2c_addr)
+{
+    memset(m_set_buf, 0, sizeof(m_set_buf));
+    power_on();
+}
+
+void MAX3134XSim::load_defaults(void)
+{
+    m_regs[MAX31341_R_CFG1] = MAX31341_F_CFG1_SWRSTN;
+    m_regs[MAX31341_R_INT_STATUS] = MAX31341_F_INT_STATUS_OSF;
+    memcpy(m_set_buf, &m_regs[m_layout->seconds], sizeof(m_set_buf));
+}
+
+void MAX3134XSim::reg_write(uint8_t reg, uint8_t val)
+{
+    uint8_t old = m_regs[reg];
+
+    if (is_time_reg(reg)) {
+        /* held until SET_RTC */
+        m_set_buf[reg - m_layout->seconds] = val;
+        return;
+    }
+
+    RTCSim::reg_write(reg, val);
+
+    if (reg == MAX31341_R_CFG2 && !(old & MAX31341_F_CFG2_SET_RTC) && (val & MAX31341_F_CFG2_SET_RTC)) {
+        memcpy(&m_regs[m_layout->seconds], m_set_buf, sizeof(m_set_buf));
+        m_phase_us = 0;
+    }
+}
+
+/*****************************************************************************
+ * MAX31343
+ *****************************************************************************/
+static const rtc_sim_layout_t max31343_layout = {
+    "MAX31343", MAX31343_I2C_ADDRESS, MAX31343_R_RAM_REG_END,
+    MAX31343_R_STATUS,
+    MAX31343_F_STATUS_A1F | MAX31343_F_STATUS_A2F | MAX31343_F_STATUS_TIF | MAX31343_F_STATUS_TSF,
+    MAX31343_R_INT_EN,
+    SIM_REG_NONE, MAX31343_R_SECONDS,
+    MAX31343_R_ALM1_SEC, 6, MAX31343_R_ALM2_MIN,
+    MAX31343_R_TIMER_CONFIG, MAX31343_R_TIMER_COUNT, MAX31343_R_TIMER_INIT, 1,
+    MAX31343_F_TIMER_CONFIG_TE, MAX31343_F_TIMER_CONFIG_TPAUSE, MAX31343_F_TIMER_CONFIG_TRPT,
+    MAX31343_R_CFG1, MAX31343_F_CFG1_ENOSC, false,
+    MAX31343_R_RTC_RESET, MAX31343_F_RTC_RESET_SWRST, false,
+    MAX31343_R_RAM_REG_START, MAX31343_R_RAM_REG_END,
+};
+
+MAX31343Sim::MAX31343Sim(uint8_t i2c_addr/*=0*/) : RTCSim(&max31343_layout, i2c_addr)
+{
+    m_temp = 25.0f;
+    power_on();
+}
+
+void MAX31343Sim::load_defaults(void)
+{
+    m_regs[MAX31343_R_STATUS] = MAX31343_F_STATUS_OSF;
+    m_regs[MAX31343_R_CFG1] = MAX31343_F_CFG1_ENOSC;
+}
+
+void MAX31343Sim::reg_write(uint8_t reg, uint8_t val)
+{
+    if (reg == MAX31343_R_TS_CONFIG && (val & MAX31343_F_TS_CONFIG_ONESHOT_MODE)) {
+        /* conversion completes immediately, ONESHOT self-clears */
+        temp_to_regs(m_temp, &m_regs[MAX31343_R_TEMP_MSB], &m_regs[MAX31343_R_TEMP_LSB]);
+        val &= ~MAX31343_F_TS_CONFIG_ONESHOT_MODE;
+    }
+
+    RTCSim::reg_write(reg, val);
+}
+
+/*****************************************************************************
+ * MAX31331 / MAX31334 / MAX31335
+ *****************************************************************************/
+#define MAX3133X_STATUS_RC_MASK     (SIM_FLAG_A1 | SIM_FLAG_A2 | SIM_FLAG_TI | (1 << 3))
+#define MAX3133X_TIMER_BITS         (1 << 4), (1 << 3), (1 << 2)	/* te, tpause, trpt */
+
+static const rtc_sim_layout_t max31331_layout = {
+    "MAX31331", MAX3133X_I2C_ADDRESS, MAX31331_TS3_FLAGS,
+    MAX31331_STATUS, MAX3133X_STATUS_RC_MASK, MAX31331_INT_EN,
+    MAX31331_SECONDS_1_128, MAX31331_SECONDS,
+    MAX31331_ALM1_SEC, 6, MAX31331_ALM2_MIN,
+    MAX31331_TIMER_CONFIG, MAX31331_TIMER_COUNT, MAX31331_TIMER_INIT, 1, MAX3133X_TIMER_BITS,
+    MAX31331_RTC_CONFIG1, 0x01, false,
+    MAX31331_RTC_RESET, 0x01, false,
+    SIM_REG_NONE, SIM_REG_NONE,
+};
+
+static const rtc_sim_layout_t max31334_layout = {
+    "MAX31334", MAX3133X_I2C_ADDRESS, MAX31334_TS3_FLAGS,
+    MAX31334_STATUS, MAX3133X_STATUS_RC_MASK, MAX31334_INT_EN,
+    MAX31334_SECONDS_1_128, MAX31334_SECONDS,
+    MAX31334_ALM1_SEC, 6, MAX31334_ALM2_MIN,
+    MAX31334_TIMER_CONFIG, MAX31334_TIMER_COUNT2, MAX31334_TIMER_INIT2, 2, MAX3133X_TIMER_BITS,
+    MAX31334_RTC_CONFIG1, 0x01, false,
+    MAX31334_RTC_RESET, 0x01, false,
+    SIM_REG_NONE, SIM_REG_NONE,
+};
+
+static const rtc_sim_layout_t max31335_layout = {
+    "MAX31335", MAX31335_I2C_ADDRESS, MAX31335_TS3_FLAGS,
+    MAX31335_STATUS, MAX3133X_STATUS_RC_MASK, MAX31335_INT_EN,
+    MAX31335_SECONDS_1_128, MAX31335_SECONDS,
+    MAX31335_ALM1_SEC, 6, MAX31335_ALM2_MIN,
+    MAX31335_TIMER_CONFIG, MAX31335_TIMER_COUNT, MAX31335_TIMER_INIT, 1, MAX3133X_TIMER_BITS,
+    MAX31335_RTC_CONFIG1, 0x01, false,
+    MAX31335_RTC_RESET, 0x01, false,
+    SIM_REG_NONE, SIM_REG_NONE,
+};
+
+static const rtc_sim_layout_t *max3133x_layouts[] = {
+    &max31331_layout,
+    &max31334_layout,
+    &max31335_layout,
+};
+
+MAX3133XSim::MAX3133XSim(variant_t variant, uint8_t i2c_addr/*=0*/)
+    : RTCSim(max3133x_layouts[variant], i2c_addr)
+{
+    m_variant = variant;
+    m_temp = 25.0f;
+    power_on();
+}
+
+void MAX3133XSim::load_defaults(void)
+{
+    max3133x_status_reg_t status;
+
+    status.raw = 0;
+    status.bits.osf = 1;
+    m_regs[m_layout->status] = status.raw;
+
+    if (m_variant == VARIANT_MAX31335) {
+        temp_to_regs(m_temp, &m_regs[MAX31335_TEMP_DATA_MSB], &m_regs[MAX31335_TEMP_DATA_LSB]);
+    }
+}
+
+void MAX3133XSim::reg_write(uint8_t reg, uint8_t val)
+{
+    if (m_variant == VARIANT_MAX31335 && reg == MAX31335_TS_CONFIG) {
+        temp_to_regs(m_temp, &m_regs[MAX31335_TEMP_DATA_MSB], &m_regs[MAX31335_TEMP_DATA_LSB]);
+    }
+
+    RTCSim::reg_write(reg, val);
+}
@@ -0,0 +1,251 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * Register-level behavioural simulators for the supported RTCs.
+ *
+ * Each simulator owns a register file with an auto-incrementing pointer, a
+ * calendar that ticks from the virtual clock, alarm matching, a countdown
+ * timer and the status flags those raise. Parts differ only in where things
+ * live in the register map, which is described by an rtc_sim_layout_t, plus
+ * a few part-specific hooks (SET_RTC transfer, temperature conversion,
+ * write-to-clear status).
+ */
+
+#ifndef _RTC_SIM_H_
+#define _RTC_SIM_H_
+
+#include <Wire.h>
+#include <time.h>
+
+#define SIM_REG_NONE            0xFF
+#define SIM_REG_FILE_SIZE       256
+
+/* Status/interrupt enable bit positions shared by every part */
+#define SIM_FLAG_A1             (1 << 0)
+#define SIM_FLAG_A2             (1 << 1)
+#define SIM_FLAG_TI             (1 << 2)
+
+typedef struct {
+    const char *name;
+    uint8_t i2c_addr;
+    uint8_t reg_end;            /**< Last implemented register, pointer wraps after it */
+
+    uint8_t status;             /**< Flag register */
+    uint8_t status_rc_mask;     /**< Flags cleared by reading the status register */
+    uint8_t int_en;             /**< Interrupt enable register */
+
+    uint8_t sub_sec;            /**< 1/128s register, SIM_REG_NONE if absent */
+    uint8_t seconds;            /**< First register of the sec..year block */
+
+    uint8_t alarm1;             /**< Alarm1 seconds register */
+    uint8_t alarm1_len;         /**< 4 (sec..day/date) or 6 (sec..year) */
+    uint8_t alarm2;             /**< Alarm2 minutes register */
+
+    uint8_t timer_cfg;
+    uint8_t timer_count;        /**< MSB first when the timer is 16-bit */
+    uint8_t timer_init;
+    uint8_t timer_width;        /**< 1 or 2 bytes */
+    uint8_t timer_te;
+    uint8_t timer_tpause;
+    uint8_t timer_trpt;
+
+    uint8_t osc_reg;
+    uint8_t osc_mask;
+    bool    osc_active_low;     /**< Bit set means oscillator stopped */
+
+    uint8_t reset_reg;
+    uint8_t reset_mask;
+    bool    reset_active_low;   /**< Bit clear means block held in reset */
+
+    uint8_t ram_start;
+    uint8_t ram_end;
+} rtc_sim_layout_t;
+
+class RTCSim : public HostI2CDevice
+{
+public:
+    RTCSim(const rtc_sim_layout_t *layout, uint8_t i2c_addr = 0);
+    virtual ~RTCSim() {}
+
+    virtual uint8_t address(void) const { return m_addr; }
+    virtual bool i2c_write(const uint8_t *buf, int len);
+    virtual int  i2c_read(uint8_t *buf, int len);
+
+    /** @brief Power-on reset: registers to defaults, RAM cleared, calendar to 2000-01-01 */
+    void power_on(void);
+
+    /** @brief Catches the simulated part up with the virtual clock */
+    void sync(void);
+
+    /** @brief Backdoor register access, bypasses the bus and side effects */
+    uint8_t peek(uint8_t reg) const { return m_regs[reg]; }
+    void    poke(uint8_t reg, uint8_t val) { m_regs[reg] = val; }
+
+    /** @brief Loads the calendar directly, without bus traffic */
+    void set_calendar(const struct tm *time);
+    void get_calendar(struct tm *time);
+
+    /**
+     * @brief Model a part without a read latch: the bytes of a read are
+     *        taken us apart from the start of the read, so a tick can fall
+     *        between them. 0, the default, latches at the start.
+     */
+    void set_read_byte_us(uint32_t us) { m_read_byte_us = us; }
+
+    /** @brief Microseconds into the current second */
+    uint32_t phase_us(void) const { return m_phase_us; }
+
+    /** @brief Level of the active-low interrupt output */
+    bool int_asserted(void);
+
+    /** @brief Register reads/writes the part has seen */
+    uint32_t reg_reads(void) const { return m_reg_reads; }
+    uint32_t reg_writes(void) const { return m_reg_writes; }
+
+    const rtc_sim_layout_t *layout(void) const { return m_layout; }
+
+protected:
+    virtual void    load_defaults(void) {}
+    virtual uint8_t reg_read(uint8_t reg);
+    virtual void    reg_write(uint8_t reg, uint8_t val);
+    virtual void    after_read(uint8_t reg);
+
+    bool running(void) const;
+    bool is_time_reg(uint8_t reg) const;
+    void advance(uint64_t us);
+    void tick_second(void);
+    void tick_timer(void);
+    void check_alarms(void);
+    void reset_block(void);
+
+    uint16_t timer_get(uint8_t reg) const;
+    void     timer_set(uint8_t reg, uint16_t val);
+
+    const rtc_sim_layout_t *m_layout;
+    uint8_t  m_addr;
+    uint8_t  m_regs[SIM_REG_FILE_SIZE];
+    uint8_t  m_ptr;
+    uint32_t m_phase_us;
+    uint64_t m_timer_acc;
+    uint64_t m_last_us;
+    uint32_t m_read_byte_us;
+    uint32_t m_reg_reads;
+    uint32_t m_reg_writes;
+};
+
+/**
+ * @brief	MAX31328, write zero to clear status flags, EOSC is active low
+ */
+class MAX31328Sim : public RTCSim
+{
+public:
+    MAX31328Sim(uint8_t i2c_addr = 0);
+
+protected:
+    virtual void load_defaults(void);
+    virtual void reg_write(uint8_t reg, uint8_t val);
+};
+
+/**
+ * @brief	MAX31329
+ */
+class MAX31329Sim : public RTCSim
+{
+public:
+    MAX31329Sim(uint8_t i2c_addr = 0);
+
+protected:
+    virtual void load_defaults(void);
+};
+
+/**
+ * @brief	MAX31341 and MAX31342
+ *
+ * Time registers written over I2C go to a holding buffer and are only
+ * loaded into the counters on a SET_RTC rising edge.
+ */
+class MAX3134XSim : public RTCSim
+{
+public:
+    MAX3134XSim(bool max31342, uint8_t i2c_addr = 0);
+
+protected:
+    virtual void load_defaults(void);
+    virtual void reg_write(uint8_t reg, uint8_t val);
+
+    uint8_t m_set_buf[7];
+};
+
+/**
+ * @brief	MAX31343, one-shot temperature conversion
+ */
+class MAX31343Sim : public RTCSim
+{
+public:
+    MAX31343Sim(uint8_t i2c_addr = 0);
+
+    /** @brief Temperature reported by the next conversion, in Celsius */
+    void set_temperature(float temp) { m_temp = temp; }
+
+protected:
+    virtual void load_defaults(void);
+    virtual void reg_write(uint8_t reg, uint8_t val);
+
+    float m_temp;
+};
+
+/**
+ * @brief	MAX31331, MAX31334 and MAX31335
+ */
+class MAX3133XSim : public RTCSim
+{
+public:
+    typedef enum {
+        VARIANT_MAX31331,
+        VARIANT_MAX31334,
+        VARIANT_MAX31335,
+    } variant_t;
+
+    MAX3133XSim(variant_t variant, uint8_t i2c_addr = 0);
+
+    void set_temperature(float temp) { m_temp = temp; }
+
+protected:
+    virtual void load_defaults(void);
+    virtual void reg_write(uint8_t reg, uint8_t val);
+
+    variant_t m_variant;
+    float m_temp;
+};
+
+#endif /* _RTC_SIM_H_ */
@@ -0,0 +1,67 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+/*
+ * Flash size probe: MAX31328 alone
+ */
+
+#include <AnalogRTCLibrary.h>
+
+static MAX31328 rtc_max31328(&Wire);
+
+template <class RTC>
+static int exercise(RTC &rtc)
+{
+    struct tm t = {};
+    typename RTC::alarm_period_t period;
+    bool enabled;
+    int ret = 0;
+
+    rtc.begin();
+    t.tm_year = 124;
+    t.tm_mday = 1;
+    ret |= rtc.set_time(&t);
+    ret |= rtc.get_time(&t);
+    ret |= rtc.set_alarm(RTC::ALARM1, &t, RTC::ALARM_PERIOD_DAILY);
+    ret |= rtc.get_alarm(RTC::ALARM1, &t, &period, &enabled);
+
+    return ret;
+}
+
+int main(void)
+{
+    int ret = 0;
+
+    ret |= exercise(rtc_max31328);
+
+    return ret;
+}
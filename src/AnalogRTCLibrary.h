@@ -46,5 +46,23 @@
 
 #include "MAX31329/MAX31329.h"
 
+#include "RTCCommon/RTCLinuxI2C.h"
+
+#include "RTCCommon/RTCLinuxManager.h"
+
+#include "RTCCommon/RTCTimeCache.h"
+
+#include "RTCCommon/RTCSqwClock.h"
+
+#include "RTCCommon/RTCTimeZone.h"
+
+#include "RTCCommon/RTCCron.h"
+
+#include "RTCCommon/RTCAlarmScheduler.h"
+
+#include "RTCCommon/RTCEventQueue.h"
+
+#include "RTCCommon/RTCLongTimer.h"
+
 
 #endif /* _ANALOG_RTC_LIB_ */
@@ -38,91 +38,23 @@
 #define GET_BIT_VAL(val, pos, mask)     ( ( (val) & mask) >> pos )
 #define SET_BIT_VAL(val, pos, mask)     ( ( ((int)val) << pos) & mask )
 
-#define BCD2BIN(val) (((val) & 15) + ((val) >> 4) * 10)
-#define BIN2BCD(val) ((((val) / 10) << 4) + (val) % 10)
+static_assert((int)MAX31328::ALARM_PERIOD_EVERYSECOND == RTC_ALARM_PERIOD_EVERYSECOND &&
+              (int)MAX31328::ALARM_PERIOD_MONTHLY == RTC_ALARM_PERIOD_MONTHLY,
+              "alarm_period_t must match rtc_alarm_period_t");
 
 
-int MAX31328::read_register(uint8_t reg, uint8_t *buf, uint8_t len/*=1*/)
-{
-    int ret;
-    int counter = 0;
-
-    m_i2c->beginTransmission(m_slave_addr);
-    m_i2c->write(reg);
-
-    /*
-        stop = true, sends a stop message after transmission, releasing the I2C bus.
-        
-        stop = false, sends a restart message after transmission. 
-          The bus will not be released, which prevents another master device from transmitting between messages. 
-          This allows one master device to send multiple transmissions while in control.
-    */
-    ret = m_i2c->endTransmission(false);
-    /*
-        0:success
-        1:data too long to fit in transmit buffer
-        2:received NACK on transmit of address
-        3:received NACK on transmit of data
-        4:other error
-    */
-    if (ret != 0) {
-        m_i2c->begin(); // restart
-        return -1;
-    }
-
-    // Read    
-    m_i2c->requestFrom((char)m_slave_addr, (char)len, true);
-
-    while (m_i2c->available()) { // slave may send less than requested
-        buf[counter++] = m_i2c->read(); // receive a byte as character
-    }
-
-    //
-    if (counter != len) {
-        m_i2c->begin(); // restart
-        ret = -1;
-    }
-
-    return ret;
-}
-
-int MAX31328::write_register(uint8_t reg, const uint8_t *buf, uint8_t len/*=1*/)
+/********************************************************************************/
+MAX31328::MAX31328(TwoWire *i2c, uint8_t i2c_addr) : RTCCoreT(i2c, i2c_addr)
 {
-    int ret;
-
-    m_i2c->beginTransmission(m_slave_addr);
-    m_i2c->write(reg);
-    m_i2c->write(buf, len);
-    ret = m_i2c->endTransmission();
-    /*
-        0:success
-        1:data too long to fit in transmit buffer
-        2:received NACK on transmit of address
-        3:received NACK on transmit of data
-        4:other error
-    */
-
-    if (ret != 0) {
-        m_i2c->begin(); // restart
-    }
-
-    return ret;
 }
 
-/********************************************************************************/
-MAX31328::MAX31328(TwoWire *i2c, uint8_t i2c_addr)
+MAX31328::MAX31328(RTCTransport *bus, uint8_t i2c_addr) : RTCCoreT(bus, i2c_addr)
 {
-    if (i2c == NULL) {
-        while (1);
-    }
-
-    m_i2c = i2c;
-    m_slave_addr = i2c_addr;
 }
 
 void MAX31328::begin(void)
 {
-    m_i2c->begin();
+    m_bus->begin();
 }
 
 int MAX31328::get_status(reg_status_t &stat)
@@ -201,252 +133,32 @@ int MAX31328::set_configuration(reg_cfg_t cfg)
 
 int MAX31328::set_time(const struct tm *time)
 {
-    int ret;
-    regs_rtc_time_t regs;
-
-    if (time == NULL) {
-        return -1;
-    }
+    return core_set_time(time);
+}
 
-    /*********************************************************
-     * +----------+------+---------------------------+-------+
-     * | Member   | Type | Meaning                   | Range |
-     * +----------+------+---------------------------+-------+
-     * | tm_sec   | int  | seconds after the minute  | 0-61* |
-     * | tm_min   | int  | minutes after the hour    | 0-59  |
-     * | tm_hour  | int  | hours since midnight      | 0-23  |
-     * | tm_mday  | int  | day of the month          | 1-31  |
-     * | tm_mon   | int  | months since January      | 0-11  |
-     * | tm_year  | int  | years since 1900          |       |
-     * | tm_wday  | int  | days since Sunday         | 0-6   |
-     * | tm_yday  | int  | days since January 1      | 0-365 |
-     * | tm_isdst | int  | Daylight Saving Time flag |       |
-     * +----------+------+---------------------------+-------+
-     * * tm_sec is generally 0-59. The extra range is to accommodate for leap
-     *   seconds in certain systems.
-     *********************************************************/
-    regs.seconds.bcd.value = BIN2BCD(time->tm_sec);
-
-    regs.minutes.bcd.value = BIN2BCD(time->tm_min);
-
-    regs.hours.bcd_format24.value= BIN2BCD(time->tm_hour);
-
-    regs.day.bcd.value = BIN2BCD(time->tm_wday + 1);
-
-    regs.date.bcd.value = BIN2BCD(time->tm_mday);
-
-    regs.month.bcd.value = BIN2BCD(time->tm_mon + 1);
-
-    if (time->tm_year >= 200) {
-        regs.month.bits.century = 1;
-        regs.year.bcd.value = BIN2BCD(time->tm_year - 200);
-    } else if (time->tm_year >= 100) {
-        regs.month.bits.century = 0;
-        regs.year.bcd.value = BIN2BCD(time->tm_year - 100);
-    } else {
-        //Invalid set date!
-        return -1;
-    }
+int MAX31328::get_epoch(rtc_epoch_t *epoch)
+{
+    return core_get_epoch(epoch);
+}
 
-    ret = write_register(MAX31328_R_SECONDS, (uint8_t *) &regs, sizeof(regs));
-    
-    return ret;
+int MAX31328::set_epoch(rtc_epoch_t epoch)
+{
+    return core_set_epoch(epoch);
 }
 
 int MAX31328::set_alarm(alarm_no_t alarm_no, const struct tm *alarm_time, alarm_period_t period)
 {
-    int ret;
-    regs_alarm_t regs;
-
-    if ((alarm_no == ALARM2) && (period == ALARM_PERIOD_EVERYSECOND)) {
-        return -1; /* Alarm2 does not support "once per second" alarm*/
-    }
-
-    /* Set Alarm Period */
-    regs.sec.bits.axm1 = 1;
-    regs.min.bits.axm2 = 1;
-    regs.hrs.bits.axm3 = 1;
-    regs.day_date.bits.axm4 = 1;
-    regs.day_date.bits.dy_dt = 1;
-
-    switch (period) {
-        case ALARM_PERIOD_EVERYSECOND:
-            // Do nothing
-            break;
-        case ALARM_PERIOD_EVERYMINUTE:
-            regs.sec.bits.axm1 = 0;
-            break;
-        case ALARM_PERIOD_HOURLY:
-            regs.sec.bits.axm1 = 0;
-            regs.min.bits.axm2 = 0;
-            break;
-        case ALARM_PERIOD_DAILY:
-            regs.sec.bits.axm1 = 0;
-            regs.min.bits.axm2 = 0;
-            regs.hrs.bits.axm3 = 0;
-            break;
-        case ALARM_PERIOD_WEEKLY:
-            regs.sec.bits.axm1 = 0;
-            regs.min.bits.axm2 = 0;
-            regs.hrs.bits.axm3 = 0;
-            regs.day_date.bits.axm4 = 0;
-            break;
-        case ALARM_PERIOD_MONTHLY:
-            regs.sec.bits.axm1 = 0;
-            regs.min.bits.axm2 = 0;
-            regs.hrs.bits.axm3 = 0;
-            regs.day_date.bits.axm4 = 0;
-            regs.day_date.bits.dy_dt = 0;
-            break;
-        default:
-            return -1;
-    }
-
-    /* Convert time structure to alarm registers */
-    regs.sec.bcd.value = BIN2BCD(alarm_time->tm_sec);
-    regs.min.bcd.value = BIN2BCD(alarm_time->tm_min);
-    regs.hrs.bcd_format24.value = BIN2BCD(alarm_time->tm_hour);
-
-    if (regs.day_date.bits.dy_dt == 0) {
-        /* Date match */
-        regs.day_date.bcd_date.value = BIN2BCD(alarm_time->tm_mday);
-    } else {
-        /* Day match */
-        regs.day_date.bcd_day.value = BIN2BCD(alarm_time->tm_wday);
-    }
-
-    
-    /* 
-     *  Write Registers 
-     */
-    uint8_t *ptr_regs = (uint8_t *)&regs;
-
-    if (alarm_no == ALARM1) {
-        ret = write_register(MAX31328_R_ALRM1_SECONDS, &ptr_regs[0], sizeof(regs_alarm_t));
-    } else {
-        /* Discard sec starts from min register */
-        ret = write_register(MAX31328_R_ALRM2_MINUTES, &ptr_regs[1], sizeof(regs_alarm_t)-1);
-    }
-    if (ret) {
-        return ret;
-    }
-
-    return ret;
+    return core_set_alarm(alarm_no == ALARM1, alarm_time, period);
 }
 
 int MAX31328::get_alarm(alarm_no_t alarm_no, struct tm *alarm_time, alarm_period_t *period, bool *is_enabled)
 {
-    int ret;
-    regs_alarm_t regs;
-    uint8_t val8;
-    uint8_t *ptr_regs = (uint8_t *)&regs;
-
-    /*
-     *  Read registers
-     */
-    if (alarm_no == ALARM1) {
-        ret = read_register(MAX31328_R_ALRM1_SECONDS, &ptr_regs[0], sizeof(regs_alarm_t));
-    } else {
-        regs.sec.raw = 0;  /* zeroise second register for alarm2 */
-        /* starts from min register (no sec register) */
-        ret = read_register(MAX31328_R_ALRM2_MINUTES, &ptr_regs[1], sizeof(regs_alarm_t)-1);
-    }
-
-    if (ret) {
-        return ret;
-    }
-
-    /* 
-     *  Convert alarm registers to time structure 
-     */
-    alarm_time->tm_sec  = BCD2BIN(regs.sec.bcd.value);
-    alarm_time->tm_min  = BCD2BIN(regs.min.bcd.value);
-    alarm_time->tm_hour = BCD2BIN(regs.hrs.bcd_format24.value);
-
-    if (regs.day_date.bits.dy_dt == 0) { /* date */
-        alarm_time->tm_mday = BCD2BIN(regs.day_date.bcd_date.value);
-    } else { /* day */
-        alarm_time->tm_wday = BCD2BIN(regs.day_date.bcd_day.value);
-    }
-
-    /*
-     *  Find period
-     */
-    *period = (alarm_no == ALARM1) ? ALARM_PERIOD_EVERYSECOND : ALARM_PERIOD_EVERYMINUTE;
-
-    if ((alarm_no == ALARM1) && (regs.sec.bits.axm1 == 0)) *period = ALARM_PERIOD_EVERYMINUTE;
-    if (regs.min.bits.axm2 == 0) *period = ALARM_PERIOD_HOURLY;
-    if (regs.hrs.bits.axm3 == 0) *period = ALARM_PERIOD_DAILY;
-    if (regs.day_date.bits.axm4 == 0) *period = ALARM_PERIOD_WEEKLY;
-    if (regs.day_date.bits.dy_dt == 0) *period = ALARM_PERIOD_MONTHLY;
-
-
-    /*
-     *  Get enable status
-     */
-    ret = read_register(MAX31328_R_CONTROL, &val8);
-    if (ret) {
-        return ret;
-    }
-    *is_enabled = (val8 & (uint8_t)alarm_no) ? true: false;
-
-    return ret;
+    return core_get_alarm(alarm_no == ALARM1, alarm_time, period, is_enabled);
 }
 
 int MAX31328::get_time(struct tm *time)
 {
-    int ret;
-    regs_rtc_time_t regs;
-
-    if (time == NULL) {
-        return -1;
-    }
-
-    ret = read_register(MAX31328_R_SECONDS, (uint8_t *) &regs, sizeof(regs));
-    if (ret) {
-        return -1;
-    }
-
-    /* tm_sec seconds [0,61] */
-    time->tm_sec = BCD2BIN(regs.seconds.bcd.value);
-
-    /* tm_min minutes [0,59] */
-    time->tm_min = BCD2BIN(regs.minutes.bcd.value);
-
-    /* tm_hour hour [0,23] */
-    if (regs.hours.bits.f24_12) {
-        time->tm_hour = BCD2BIN(regs.hours.bcd_format12.value);
-
-        if (regs.hours.bits.hr20_am_pm  && (time->tm_hour != 12)) {
-            time->tm_hour += 12;
-        }
-    } else {
-        time->tm_hour = BCD2BIN(regs.hours.bcd_format24.value);
-    }
-
-    /* tm_wday day of week [0,6] (Sunday = 0) */
-    time->tm_wday = BCD2BIN(regs.day.bcd.value) - 1;
-
-    /* tm_mday day of month [1,31] */
-    time->tm_mday = BCD2BIN(regs.date.bcd.value);
-
-    /* tm_mon month of year [0,11] */
-    time->tm_mon = BCD2BIN(regs.month.bcd.value) - 1;
-
-    /* tm_year years since 2000 */
-    if (regs.month.bits.century) {
-        time->tm_year = BCD2BIN(regs.year.bcd.value) + 200;
-    } else {
-        time->tm_year = BCD2BIN(regs.year.bcd.value) + 100;
-    }
-
-    /* tm_yday day of year [0,365] */
-    time->tm_yday = 0; /* TODO */
-
-    /* tm_isdst daylight savings flag */
-    time->tm_isdst = 0; /* TODO */
-
-    return ret;
+    return core_get_time(time);
 }
 
 int MAX31328::irq_enable(intr_id_t id/*=INTR_ID_ALL*/)
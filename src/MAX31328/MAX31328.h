@@ -36,6 +36,9 @@
 
 
 #include <MAX31328/MAX31328_registers.h>
+#include <RTCCommon/RTCBusStats.h>
+#include <RTCCommon/RTCCore.h>
+#include <RTCCommon/RTCTransport.h>
 
 #include "Arduino.h"
 #include <Wire.h>
@@ -48,7 +51,20 @@
 #define MAX31328_ERR_BUSY             (-3)
 
 
-class MAX31328
+/**
+* @brief	MAX31328 register map for the shared time and alarm code
+*/
+struct max31328_core_regs {
+    static constexpr uint8_t time       = MAX31328_R_SECONDS;
+    static constexpr uint8_t alarm1     = MAX31328_R_ALRM1_SECONDS;
+    static constexpr uint8_t alarm2     = MAX31328_R_ALRM2_MINUTES;
+    static constexpr uint8_t alarm_en   = MAX31328_R_CONTROL;
+    static constexpr bool    alarm_ext  = false;
+    static constexpr bool    time_latch = false;
+    static constexpr bool    status_rc  = false;
+};
+
+class MAX31328 : public RTCCoreT<MAX31328, max31328_core_regs>
 {
     public:
         typedef enum {
@@ -111,6 +127,8 @@ class MAX31328
 
 
         MAX31328(TwoWire *i2c, uint8_t i2c_addr=MAX3128_I2C_ADDRESS);
+
+        MAX31328(RTCTransport *bus, uint8_t i2c_addr=MAX3128_I2C_ADDRESS);
         
         /**
         * @brief   First initialization, must be call before using class function
@@ -171,6 +189,24 @@ class MAX31328
         * @returns      0 on success, negative error code on failure.
         */
         int set_time(const struct tm *rtc_ctime);
+
+        /**
+        * @brief        Read time from RTC as Unix seconds, without struct tm.
+        *
+        * @param[out]   epoch Seconds since 1970-01-01 00:00:00, the RTC is taken as UTC.
+        *
+        * @returns      0 on success, negative error code on failure.
+        */
+        int get_epoch(rtc_epoch_t *epoch);
+
+        /**
+        * @brief        Set time info to RTC from Unix seconds.
+        *
+        * @param[in]    epoch Seconds since 1970-01-01 00:00:00, from 2000 up to the end of 2199.
+        *
+        * @returns      0 on success, negative error code on failure.
+        */
+        int set_epoch(rtc_epoch_t epoch);
         
         /**
         * @brief        Set an alarm condition
@@ -226,6 +262,8 @@ class MAX31328
         * @param[in]    freq Clock frequency, one of SQW_OUT_FREQ_*
         *
         * @return       0 on success, error code on failure
+        *
+        * @note         RTCSqwClockT uses the 1Hz output for millisecond time without bus access.
         */
         int set_square_wave_frequency(sqw_out_freq_t freq);
 
@@ -252,28 +290,6 @@ class MAX31328
         */
         int get_temp(float &temp);
 
-        /**
-        * @brief        Directly read value from register
-        *
-        * @param[in]    reg: Register address
-        * @param[in]    buf: destionation that values will be written
-        * @param[in]    len: expected read len
-        *
-        * @return       0 on success, error code on failure
-        */
-        int read_register(uint8_t reg, uint8_t *buf, uint8_t len=1);
-        
-        /**
-        * @brief        Directly write value to register
-        *
-        * @param[in]    reg: Register address
-        * @param[in]    buf: values that would like to be written
-        * @param[in]    len: buf len
-        *
-        * @return       0 on success, error code on failure
-        */
-        int write_register(uint8_t reg, const uint8_t *buf, uint8_t len=1);
-
     private:
         typedef struct {
             union {
@@ -436,8 +452,5 @@ class MAX31328
                 } bcd_date;
             } day_date;
         } regs_alarm_t;
-
-        TwoWire *m_i2c;
-        uint8_t  m_slave_addr;
 };
 #endif /* _MAX31328_H_ */
@@ -37,8 +37,10 @@
 #define GET_BIT_VAL(val, pos, mask)     ( ( (val) & mask) >> pos )
 #define SET_BIT_VAL(val, pos, mask)     ( ( ((int)val) << pos) & mask )
 
-#define BCD2BIN(val) (((val) & 15) + ((val) >> 4) * 10)
-#define BIN2BCD(val) ((((val) / 10) << 4) + (val) % 10)
+static_assert((int)MAX31329::ALARM_PERIOD_EVERYSECOND == RTC_ALARM_PERIOD_EVERYSECOND &&
+			  (int)MAX31329::ALARM_PERIOD_MONTHLY == RTC_ALARM_PERIOD_MONTHLY &&
+			  (int)MAX31329::ALARM_PERIOD_ONETIME == RTC_ALARM_PERIOD_ONETIME,
+			  "alarm_period_t must match rtc_alarm_period_t");
 
 
 #define ALL_IRQ  (	MAX31329_F_INT_EN_A1IE 	 | \
@@ -49,87 +51,18 @@
 					MAX31329_F_INT_EN_DOSF	 )
 
 
-int MAX31329::read_register(uint8_t reg, uint8_t *buf, uint8_t len/*=1*/)
-{
-    int ret;
-    int counter = 0;
-
-    m_i2c->beginTransmission(m_slave_addr);
-    m_i2c->write(reg);
-
-    /*
-        stop = true, sends a stop message after transmission, releasing the I2C bus.
-        
-        stop = false, sends a restart message after transmission. 
-          The bus will not be released, which prevents another master device from transmitting between messages. 
-          This allows one master device to send multiple transmissions while in control.
-    */
-    ret = m_i2c->endTransmission(false);
-    /*
-        0:success
-        1:data too long to fit in transmit buffer
-        2:received NACK on transmit of address
-        3:received NACK on transmit of data
-        4:other error
-    */
-    if (ret != 0) {
-        m_i2c->begin(); // restart
-        return -1;
-    }
-
-    // Read    
-    m_i2c->requestFrom((char)m_slave_addr, (char)len, true);
-
-    while (m_i2c->available()) { // slave may send less than requested
-        buf[counter++] = m_i2c->read(); // receive a byte as character
-    }
-
-    //
-    if (counter != len) {
-        m_i2c->begin(); // restart
-        ret = -1;
-    }
-
-    return ret;
-}
-
-int MAX31329::write_register(uint8_t reg, const uint8_t *buf, uint8_t len/*=1*/)
+/***********************************************************************************/
+MAX31329::MAX31329(TwoWire *i2c, uint8_t i2c_addr) : RTCCoreT(i2c, i2c_addr)
 {
-    int ret;
-
-    m_i2c->beginTransmission(m_slave_addr);
-    m_i2c->write(reg);
-    m_i2c->write(buf, len);
-    ret = m_i2c->endTransmission();
-    /*
-        0:success
-        1:data too long to fit in transmit buffer
-        2:received NACK on transmit of address
-        3:received NACK on transmit of data
-        4:other error
-    */
-
-    if (ret != 0) {
-        m_i2c->begin(); // restart
-    }
-
-    return ret;
 }
 
-/***********************************************************************************/
-MAX31329::MAX31329(TwoWire *i2c, uint8_t i2c_addr)
+MAX31329::MAX31329(RTCTransport *bus, uint8_t i2c_addr) : RTCCoreT(bus, i2c_addr)
 {
-	if (i2c == NULL) {
-		while (1);
-	}
-
-	m_i2c = i2c;
-	m_slave_addr = i2c_addr;
 }
 
 void MAX31329::begin(void)
 {
-	m_i2c->begin();
+	m_bus->begin();
 
 	sw_reset_release();
 	rtc_start();
@@ -206,327 +139,32 @@ int MAX31329::set_configuration(reg_cfg_t cfg)
 
 int MAX31329::get_time(struct tm *time)
 {
-	int ret;
-	rtc_time_regs_t regs;
-
-	if (time == NULL) {
-		return -1;
-	}
-
-	ret = read_register(MAX31329_R_SECONDS, (uint8_t *) &regs, sizeof(regs));
-	if (ret) {
-		return ret;
-	}
-
-	/* tm_sec seconds [0,61] */
-	time->tm_sec = BCD2BIN(regs.seconds.bcd.value);
-	/* tm_min minutes [0,59] */
-	time->tm_min = BCD2BIN(regs.minutes.bcd.value);
-	/* tm_hour hour [0,23] */
-	time->tm_hour = BCD2BIN(regs.hours.bcd.value);
-	/* tm_wday day of week [0,6] (Sunday = 0) */
-	time->tm_wday = BCD2BIN(regs.day.bcd.value) - 1;
-	/* tm_mday day of month [1,31] */
-	time->tm_mday = BCD2BIN(regs.date.bcd.value);
-	/* tm_mon month of year [0,11] */
-	time->tm_mon = BCD2BIN(regs.month.bcd.value) - 1;
-
-	/* tm_year years since 2000 */
-	if (regs.month.bits.century) {
-		time->tm_year = BCD2BIN(regs.year.bcd.value) + 200;
-	} else {
-		time->tm_year = BCD2BIN(regs.year.bcd.value) + 100;
-	}
-
-	/* tm_yday day of year [0,365] */
-	time->tm_yday = 0; /* TODO */
-	/* tm_isdst daylight savings flag */
-	time->tm_isdst = 0; /* TODO */
-
-	return ret;
+	return core_get_time(time);
 }
 
 int MAX31329::set_time(const struct tm *time)
 {
-	int ret;
-	rtc_time_regs_t regs;
-
-	if (time == NULL) {
-		return -1;
-	}
-
-	/*********************************************************
-	 * +----------+------+---------------------------+-------+
-	 * | Member   | Type | Meaning                   | Range |
-	 * +----------+------+---------------------------+-------+
-	 * | tm_sec   | int  | seconds after the minute  | 0-61* |
-	 * | tm_min   | int  | minutes after the hour    | 0-59  |
-	 * | tm_hour  | int  | hours since midnight      | 0-23  |
-	 * | tm_mday  | int  | day of the month          | 1-31  |
-	 * | tm_mon   | int  | months since January      | 0-11  |
-	 * | tm_year  | int  | years since 1900          |       |
-	 * | tm_wday  | int  | days since Sunday         | 0-6   |
-	 * | tm_yday  | int  | days since January 1      | 0-365 |
-	 * | tm_isdst | int  | Daylight Saving Time flag |       |
-	 * +----------+------+---------------------------+-------+
-	 * * tm_sec is generally 0-59. The extra range is to accommodate for leap
-	 *   seconds in certain systems.
-	 *********************************************************/
-	regs.seconds.bcd.value = BIN2BCD(time->tm_sec);
-	regs.minutes.bcd.value = BIN2BCD(time->tm_min);
-	regs.hours.bcd.value= BIN2BCD(time->tm_hour);
-	regs.day.bcd.value = BIN2BCD(time->tm_wday + 1);
-	regs.date.bcd.value = BIN2BCD(time->tm_mday);
-	regs.month.bcd.value = BIN2BCD(time->tm_mon + 1);
-
-	if (time->tm_year >= 200) {
-		regs.month.bits.century = 1;
-		regs.year.bcd.value = BIN2BCD(time->tm_year - 200);
-	} else if (time->tm_year >= 100) {
-		regs.month.bits.century = 0;
-		regs.year.bcd.value = BIN2BCD(time->tm_year - 100);
-	} else {
-		return -1;
-	}
+	return core_set_time(time);
+}
 
-	ret = write_register(MAX31329_R_SECONDS, (const uint8_t *) &regs, sizeof(regs)); 
+int MAX31329::get_epoch(rtc_epoch_t *epoch)
+{
+	return core_get_epoch(epoch);
+}
 
-	return ret;
+int MAX31329::set_epoch(rtc_epoch_t epoch)
+{
+	return core_set_epoch(epoch);
 }
 
 int MAX31329::set_alarm(alarm_no_t alarm_no, const struct tm *alarm_time, alarm_period_t period)
 {
-	int ret;
-	regs_alarm_t regs;
-
-	if (alarm_no == ALARM2) {
-		switch (period) {
-			case ALARM_PERIOD_EVERYSECOND:
-			case ALARM_PERIOD_ONETIME:
-			case ALARM_PERIOD_YEARLY:
-				return -1; // not support for alarm 2
-		}
-	}
-
-
-	/*
-	 *  Set period
-	 */
-
-	// clear all flag, default onetime 
-	regs.sec.bits.a1m1 = 0;
-	regs.min.bits.a1m2 = 0;
-	regs.hrs.bits.a1m3 = 0;
-	regs.day_date.bits.a1m4 = 0;
-	regs.mon.bits.a1m5 = 0;
-	regs.mon.bits.a1m6 = 0;
-	regs.day_date.bits.dy_dt = 0;
-
-	switch (period) {
-		case ALARM_PERIOD_ONETIME:
-			// do nothing
-			break;
-		case ALARM_PERIOD_YEARLY:
-			regs.mon.bits.a1m6 = 1;
-			break;
-		case ALARM_PERIOD_MONTHLY:
-			regs.mon.bits.a1m5 = 1;
-			regs.mon.bits.a1m6 = 1;
-			break;
-		case ALARM_PERIOD_WEEKLY:
-			regs.mon.bits.a1m5 = 1;
-			regs.mon.bits.a1m6 = 1;
-			regs.day_date.bits.dy_dt = 1;
-			break;
-		case ALARM_PERIOD_DAILY:
-			regs.day_date.bits.a1m4 = 1;
-			regs.mon.bits.a1m5 = 1;
-			regs.mon.bits.a1m6 = 1;
-			break;
-		case ALARM_PERIOD_HOURLY:
-			regs.hrs.bits.a1m3 = 1;
-			regs.day_date.bits.a1m4 = 1;
-			regs.mon.bits.a1m5 = 1;
-			regs.mon.bits.a1m6 = 1;
-			break;
-		case ALARM_PERIOD_EVERYMINUTE:
-			regs.min.bits.a1m2 = 1;
-			regs.hrs.bits.a1m3 = 1;
-			regs.day_date.bits.a1m4 = 1;
-			regs.mon.bits.a1m5 = 1;
-			regs.mon.bits.a1m6 = 1;
-			break;
-		case ALARM_PERIOD_EVERYSECOND:
-			regs.sec.bits.a1m1 = 1;
-			regs.min.bits.a1m2 = 1;
-			regs.hrs.bits.a1m3 = 1;
-			regs.day_date.bits.a1m4 = 1;
-			regs.mon.bits.a1m5 = 1;
-			regs.mon.bits.a1m6 = 1;
-			break;
-		default:
-			return -1;
-	}
-
-	/* 
-	 * Convert time structure to alarm registers 
-	 */
-	regs.sec.bcd.value = BIN2BCD(alarm_time->tm_sec);
-	regs.min.bcd.value = BIN2BCD(alarm_time->tm_min);
-
-	regs.hrs.bcd.value = BIN2BCD(alarm_time->tm_hour);
-
-	if (regs.day_date.bits.dy_dt == 0) {
-		/* Date match */
-		regs.day_date.bcd_date.value = BIN2BCD(alarm_time->tm_mday);
-	} else {
-		/* Day match */
-		regs.day_date.bcd_day.value = BIN2BCD(alarm_time->tm_wday);
-	}
-	regs.mon.bcd.value = BIN2BCD(alarm_time->tm_mon+1);
-    
-    if (alarm_time->tm_year >= 200) {
-		regs.year.bcd.value = BIN2BCD(alarm_time->tm_year - 200);
-	} else if (alarm_time->tm_year >= 100) {
-		regs.year.bcd.value = BIN2BCD(alarm_time->tm_year - 100);
-	} else {
-		return -1;
-	}
-
-
-    /* 
-     *  Write Registers 
-     */
-    uint8_t *ptr_regs = (uint8_t *)&regs;
-
-    if (alarm_no == ALARM1) {
-        ret = write_register(MAX31329_R_ALM1_SEC, &ptr_regs[0], sizeof(regs_alarm_t));
-    } else {
-        /* XXX discard min, mon & sec registers */
-        ret = write_register(MAX31329_R_ALM2_MIN, &ptr_regs[1], sizeof(regs_alarm_t)-3);
-		Serial.println(ret, HEX);
-    }
-
-	return ret;
+	return core_set_alarm(alarm_no == ALARM1, alarm_time, period);
 }
 
 int MAX31329::get_alarm(alarm_no_t alarm_no, struct tm *alarm_time, alarm_period_t *period, bool *is_enabled)
 {
-	int ret;
-	regs_alarm_t regs;
-	uint8_t reg;
-    uint8_t *ptr_regs = (uint8_t *)&regs;
-
-    /*
-     *  Read registers
-     */
-    if (alarm_no == ALARM1) {
-        ret = read_register(MAX31329_R_ALM1_SEC, &ptr_regs[0], sizeof(regs_alarm_t));
-    } else {
-        regs.sec.raw = 0;  /* zeroise second register for alarm2 */
-        /* XXX discard mon & sec registers */
-        ret = read_register(MAX31329_R_ALM2_MIN, &ptr_regs[1], sizeof(regs_alarm_t)-2);
-    }
-    if (ret) {
-        return ret;
-    }
-
-
-    /* 
-     *  Convert alarm registers to time structure 
-     */
-	alarm_time->tm_sec = BCD2BIN(regs.sec.bcd.value);
-	alarm_time->tm_min = BCD2BIN(regs.min.bcd.value);
-	alarm_time->tm_hour = BCD2BIN(regs.hrs.bcd.value);
-
-	if (regs.day_date.bits.dy_dt == 0) { /* date */
-		alarm_time->tm_mday = BCD2BIN(regs.day_date.bcd_date.value);
-	} else { /* day */
-		alarm_time->tm_wday = BCD2BIN(regs.day_date.bcd_day.value);
-	}
-	alarm_time->tm_mon = BCD2BIN(regs.mon.bcd.value) - 1;
-	alarm_time->tm_year = BCD2BIN(regs.year.bcd.value) + 100;	/* XXX no century bit */
-
-
-    /*
-     *  Find period
-     */
-    if(alarm_no == ALARM1) {
-        int alarm = regs.sec.bits.a1m1 | (regs.min.bits.a1m2<<1)
-                    | (regs.hrs.bits.a1m3<<2) | (regs.day_date.bits.a1m4<<3)
-                    | (regs.mon.bits.a1m5<<4) | (regs.mon.bits.a1m6<<5)
-                    | (regs.day_date.bits.dy_dt<<6);
-
-        switch(alarm) {
-            case 0b1111111:
-            case 0b0111111:
-                *period = ALARM_PERIOD_EVERYSECOND;
-                break;
-            case 0b1111110:
-            case 0b0111110:
-                *period = ALARM_PERIOD_EVERYMINUTE;
-                break;
-            case 0b1111100:
-            case 0b0111100:
-                *period = ALARM_PERIOD_HOURLY;
-                break;
-            case 0b0111000:
-            case 0b1111000:
-                *period = ALARM_PERIOD_DAILY;
-                break;
-            case 0b0110000:
-                *period = ALARM_PERIOD_MONTHLY;
-                break;
-            case 0b0100000:
-                *period = ALARM_PERIOD_YEARLY;
-                break;
-            case 0b0000000:
-                *period = ALARM_PERIOD_ONETIME;
-                break;
-            case 0b1110000:
-                *period = ALARM_PERIOD_WEEKLY;
-        }
-    } else {
-        int alarm = (regs.min.bits.a1m2) | (regs.hrs.bits.a1m3<<1)
-                    | (regs.day_date.bits.a1m4<<2)
-                    | (regs.day_date.bits.dy_dt<<3);
-
-        switch(alarm) {
-            case 0b1111:
-            case 0b0111:
-                *period = ALARM_PERIOD_EVERYMINUTE;
-                break;
-            case 0b1110:
-            case 0b0110:
-                *period = ALARM_PERIOD_HOURLY;
-                break;
-            case 0b1100:
-            case 0b0100:
-                *period = ALARM_PERIOD_DAILY;
-                break;
-            case 0b0000:
-                *period = ALARM_PERIOD_MONTHLY;
-                break;
-            case 0b1000:
-                *period = ALARM_PERIOD_WEEKLY;
-        }
-    }
-
-    /*
-     *  Get enable status
-     */
-	ret = read_register(MAX31329_R_INT_EN, (uint8_t *)&reg, 1);
-	if (ret) {
-		return ret;
-	}
-
-	if (alarm_no == ALARM1) {
-		*is_enabled = (reg & (1 << INTR_ID_ALARM1)) != 0;
-	} else {
-		*is_enabled = (reg & (1 << INTR_ID_ALARM2)) != 0;
-	}
-
-	return ret;
+	return core_get_alarm(alarm_no == ALARM1, alarm_time, period, is_enabled);
 }
 
 int MAX31329::powerfail_threshold_level(comp_thresh_t th)
@@ -687,6 +325,11 @@ int MAX31329::timer_init(uint8_t initial_value, bool repeat, timer_freq_t freq)
 	return ret;
 }
 
+int MAX31329::timer_reload(uint8_t value)
+{
+	return write_register(MAX31329_R_TIMER_INIT, &value, 1);
+}
+
 int MAX31329::timer_get(uint8_t &val)
 {
 	int ret;
@@ -919,7 +562,7 @@ int MAX31329::nvram_write(int offset, const uint8_t *buffer, int length)
 
 	totlen = (MAX31329_R_RAM_REG_END - MAX31329_R_RAM_REG_START) + 1;
 
-	if ((offset + length) > totlen) {
+	if ((offset < 0) || (length < 0) || ((offset + length) > totlen)) {
 		return -1;
 	}
 
@@ -927,7 +570,7 @@ int MAX31329::nvram_write(int offset, const uint8_t *buffer, int length)
 		return 0;
 	}
 
-    ret = write_register(MAX31329_R_RAM_REG_START + offset, buffer, length);
+    ret = write_burst(MAX31329_R_RAM_REG_START + offset, buffer, length);
 
 	return ret;
 }
@@ -939,7 +582,7 @@ int MAX31329::nvram_read(int offset, uint8_t *buffer, int length)
 
 	totlen = (MAX31329_R_RAM_REG_END - MAX31329_R_RAM_REG_START) + 1;
 
-	if ((offset + length) > totlen) {
+	if ((offset < 0) || (length < 0) || ((offset + length) > totlen)) {
 		return -1;
 	}
 
@@ -947,7 +590,7 @@ int MAX31329::nvram_read(int offset, uint8_t *buffer, int length)
 		return 0;
 	}
 
-    ret = read_register(MAX31329_R_RAM_REG_START + offset, buffer, length);
+    ret = read_burst(MAX31329_R_RAM_REG_START + offset, buffer, length);
 
 	return ret;
 }
@@ -34,6 +34,9 @@
 #define _MAX31329_H_
 
 #include <MAX31329/MAX31329_registers.h>
+#include <RTCCommon/RTCBusStats.h>
+#include <RTCCommon/RTCCore.h>
+#include <RTCCommon/RTCTransport.h>
 
 #include <time.h>
 #include <Wire.h>
@@ -46,7 +49,20 @@
 #define MAX31329_ERR_BUSY             (-3)
 
 
-class MAX31329
+/**
+* @brief	MAX31329 register map for the shared time and alarm code
+*/
+struct max31329_core_regs {
+	static constexpr uint8_t time       = MAX31329_R_SECONDS;
+	static constexpr uint8_t alarm1     = MAX31329_R_ALM1_SEC;
+	static constexpr uint8_t alarm2     = MAX31329_R_ALM2_MIN;
+	static constexpr uint8_t alarm_en   = MAX31329_R_INT_EN;
+	static constexpr bool    alarm_ext  = true;
+	static constexpr bool    time_latch = false;
+	static constexpr bool    status_rc  = true;
+};
+
+class MAX31329 : public RTCCoreT<MAX31329, max31329_core_regs>
 {
 	public:
 	    /**
@@ -195,6 +211,8 @@ class MAX31329
 
 		MAX31329(TwoWire *i2c, uint8_t i2c_addr=MAX31329_I2C_ADDRESS);
 
+		MAX31329(RTCTransport *bus, uint8_t i2c_addr=MAX31329_I2C_ADDRESS);
+
 	    /**
 	    * @brief   First initialization, must be call before using class function
 	    *
@@ -246,6 +264,24 @@ class MAX31329
 		*/
 		int set_time(const struct tm *rtc_ctime);
 
+		/**
+		* @brief		Read time from RTC as Unix seconds, without struct tm.
+		*
+		* @param[out]	epoch Seconds since 1970-01-01 00:00:00, the RTC is taken as UTC.
+		*
+		* @returns		0 on success, negative error code on failure.
+		*/
+		int get_epoch(rtc_epoch_t *epoch);
+
+		/**
+		* @brief		Set time info to RTC from Unix seconds.
+		*
+		* @param[in]	epoch Seconds since 1970-01-01 00:00:00, from 2000 up to the end of 2199.
+		*
+		* @returns		0 on success, negative error code on failure.
+		*/
+		int set_epoch(rtc_epoch_t epoch);
+
 		/**
 		* @brief		Set an alarm condition
 		*
@@ -346,6 +382,17 @@ class MAX31329
 		*/
 		int timer_init(uint8_t initial_value, bool repeat, timer_freq_t freq);
 
+		/**
+		* @brief		Write the timer initial value only, the timer keeps running
+		*
+		* @param[in]	value Timer initial value
+		*
+		* @return		0 on success, error code on failure
+		*
+		* @note			In repeat mode the value is loaded at the next expiry.
+		*/
+		int timer_reload(uint8_t value);
+
 		/**
 		* @brief	Read timer value
 		*
@@ -459,6 +506,9 @@ class MAX31329
 		/**
 		* @brief		Non-volatile memory write
 		*
+		* @details	Lengths beyond the transport limit are split into
+		*			back-to-back bursts, see RTCTransport::max_write().
+		*
 		* @param[in]	offset Offset of location in NVRAM
 		* @param[out]	buffer Pointer to the data to be written
 		* @param[in]	length Number of bytes to write
@@ -470,6 +520,9 @@ class MAX31329
 		/**
 		* @brief		Non-volatile memory read
 		*
+		* @details	Lengths beyond the transport limit are split into
+		*			back-to-back bursts, see RTCTransport::max_read().
+		*
 		* @param[in]	offset Offset of location in NVRAM
 		* @param[in]	buffer Buffer to read in to
 		* @param[in]	length Number of bytes to read
@@ -478,28 +531,6 @@ class MAX31329
 		*/
 		int nvram_read(int offset, uint8_t *buffer, int length);
 
-        /**
-        * @brief        Directly read value from register
-        *
-        * @param[in]    reg: Register address
-        * @param[in]    buf: destionation that values will be written
-        * @param[in]    len: expected read len
-        *
-        * @return       0 on success, error code on failure
-        */
-        int read_register(uint8_t reg, uint8_t *buf, uint8_t len=1);
-        
-        /**
-        * @brief        Directly write value to register
-        *
-        * @param[in]    reg: Register address
-        * @param[in]    buf: values that would like to be written
-        * @param[in]    len: buf len
-        *
-        * @return       0 on success, error code on failure
-        */
-        int write_register(uint8_t reg, const uint8_t *buf, uint8_t len=1);
-
 	private:
 		typedef struct {
 			union {
@@ -681,9 +712,6 @@ class MAX31329
 			} year;
 		} regs_alarm_t;
 
-		TwoWire *m_i2c;
-		uint8_t m_slave_addr;
-
 };
 
 #endif /* _MAX31329_H_ */
@@ -32,30 +32,65 @@
 
 #include "MAX3133X.h"
 
-#define BCD2BIN(val) (((val) & 15) + ((val) >> 4) * 10)
-#define BIN2BCD(val) ((((val) / 10) << 4) + (val) % 10)
 #define SWAPBYTES(val)  (((val & 0xFF) << 8) | ((val & 0xFF00) >> 8))
 
 #define pr_err(msg) Serial.println("max3133x.cpp: " msg)
 
-MAX3133X::MAX3133X(const reg_addr_t *reg_addr, TwoWire *i2c, uint8_t i2c_addr)
+MAX3133X::MAX3133X(TwoWire *i2c, uint8_t i2c_addr, max3133x_variant_t part) : wire_transport(i2c)
 {
-    if (i2c == NULL || reg_addr == NULL)
+    if (i2c == NULL)
         pr_err("i2c object is invalid!");
 
-    this->reg_addr = reg_addr;
-    i2c_handler = i2c;
+    i2c_handler = (i2c == NULL) ? NULL : &wire_transport;
     slave_addr = i2c_addr;
+    RTC_BUS_STATS_RESET(bus_stats);
+
+    memset(interrupt_handler_list, 0, sizeof(interrupt_handler_list));
+    int_pending = false;
+    variant = part;
 }
 
-int MAX3133X::begin(void)
+MAX3133X::MAX3133X(RTCTransport *bus, uint8_t i2c_addr, max3133x_variant_t part)
+{
+    if (bus == NULL)
+        pr_err("i2c object is invalid!");
+
+    i2c_handler = bus;
+    slave_addr = i2c_addr;
+    RTC_BUS_STATS_RESET(bus_stats);
+
+    memset(interrupt_handler_list, 0, sizeof(interrupt_handler_list));
+    int_pending = false;
+    variant = part;
+}
+
+void MAX3133X::interrupt_handler()
+{
+    int_pending = true;
+}
+
+bool MAX3133X::interrupt_pending() const
+{
+    return int_pending;
+}
+
+void MAX3133X::dispatch_interrupts(const handler *list, uint8_t num, uint8_t flags)
+{
+    for (uint8_t i = 0; i < num; i++) {
+        if ((flags & (1 << i)) && (list[i].func != NULL))
+            list[i].func(list[i].cb);
+    }
+}
+
+template <class Traits>
+int MAX3133XT<Traits>::begin(void)
 {
     int ret;
 
-    if (i2c_handler == NULL || reg_addr == NULL)
+    if (get_transport() == NULL)
         return MAX3133X_NULL_VALUE_ERR;
 
-    i2c_handler->begin();
+    get_transport()->begin();
     ret = sw_reset();
     if (ret != MAX3133X_NO_ERR)
         return ret;
@@ -69,35 +104,23 @@ int MAX3133X::begin(void)
 
 int MAX3133X::read_register(uint8_t reg, uint8_t *value, uint8_t len)
 {
-    int counter = 0;
+    int ret;
 
     if (value == NULL)
         return MAX3133X_NULL_VALUE_ERR;
-    
-    i2c_handler->beginTransmission(slave_addr);
 
-    if (i2c_handler->write(reg) != 1) {
-        i2c_handler->flush();
-        return MAX3133X_WRITE_REG_ERR;
-    }
+    RTC_BUS_STATS_TIME(bus_stats);
 
-    if (i2c_handler->endTransmission(false) != 0) {
-        i2c_handler->flush();
-        return MAX3133X_I2C_END_TRANS_ERR;
-    }
-
-    if (i2c_handler->requestFrom((uint8_t)slave_addr, len) != len) {
-        i2c_handler->flush();
-        return MAX3133X_I2C_BUFF_ERR;
-    }
+    ret = i2c_handler->read_register(slave_addr, reg, value, len);
+    RTC_BUS_STATS_XFER(bus_stats, 1, (ret == 0) ? len : 0);
+    if (ret != 0) {
+        RTC_BUS_STATS_ERROR(bus_stats, ret);
 
-    while (i2c_handler->available()) { // slave may send less than requested
-        value[counter++] = i2c_handler->read(); // receive a byte as character
-    }
-
-    if (counter != len) {
-        i2c_handler->flush();
-        return MAX3133X_READ_REG_ERR;
+        if (ret == RTC_BUS_ERR_DATA_TOO_LONG)
+            return MAX3133X_WRITE_REG_ERR;
+        if (ret == RTC_BUS_ERR_SHORT_READ)
+            return MAX3133X_I2C_BUFF_ERR;
+        return MAX3133X_I2C_END_TRANS_ERR;
     }
 
     return MAX3133X_NO_ERR;
@@ -105,29 +128,43 @@ int MAX3133X::read_register(uint8_t reg, uint8_t *value, uint8_t len)
 
 int MAX3133X::write_register(uint8_t reg, const uint8_t *value, uint8_t len)
 {
+    int ret;
+
     if (value == NULL) 
         return MAX3133X_NULL_VALUE_ERR;
 
-    i2c_handler->beginTransmission(slave_addr);
-
-    if (i2c_handler->write(reg) != 1) {
-        i2c_handler->flush();
-        return MAX3133X_WRITE_REG_ERR;
-    }
+    RTC_BUS_STATS_TIME(bus_stats);
 
-    if (i2c_handler->write(value, len) != len) {
-        i2c_handler->flush();
-        return MAX3133X_WRITE_REG_ERR;
-    }
+    ret = i2c_handler->write_register(slave_addr, reg, value, len);
+    RTC_BUS_STATS_XFER(bus_stats, 1 + len, 0);
+    if (ret != 0) {
+        RTC_BUS_STATS_ERROR(bus_stats, ret);
 
-    if (i2c_handler->endTransmission() != 0) {
-        i2c_handler->flush();
+        if (ret == RTC_BUS_ERR_DATA_TOO_LONG)
+            return MAX3133X_WRITE_REG_ERR;
         return MAX3133X_I2C_END_TRANS_ERR;
     }
 
     return MAX3133X_NO_ERR;
 }
 
+#if ANALOG_RTC_BUS_STATS
+void MAX3133X::get_bus_stats(rtc_bus_stats_t &stats)
+{
+    stats = bus_stats;
+}
+
+void MAX3133X::reset_bus_stats(void)
+{
+    RTC_BUS_STATS_RESET(bus_stats);
+}
+#endif
+
+RTCTransport *MAX3133X::get_transport(void)
+{
+    return i2c_handler;
+}
+
 #define SET_BIT_FIELD(address, reg_name, bit_field_name, value)                 \
 {   int ret;                                                                    \
     ret = read_register(address, (uint8_t *)&(reg_name), 1);                    \
@@ -143,61 +180,45 @@ int MAX3133X::write_register(uint8_t reg, const uint8_t *value, uint8_t len)
 
 inline int8_t MAX3133X::hours_reg_to_hour(const max3133x_hours_reg_t *hours_reg)
 {
-    hour_format_t format = hours_reg->bits_24hr.f_24_12 == 1 ? HOUR12 : HOUR24;
-    if (format == HOUR24) {
-        return BCD2BIN(hours_reg->bcd_24hr.value);
-    } else {
-        if (hours_reg->bits_12hr.am_pm) {
-            if (hours_reg->bcd_12hr.value < 12)
-                return (hours_reg->bcd_12hr.value + 12);
-        } else {
-            if (hours_reg->bcd_12hr.value == 12)
-                return (hours_reg->bcd_12hr.value - 12);
-        }
-    }
+    return rtc_hours_from_reg(hours_reg->raw);
 }
 
 inline void MAX3133X::rtc_regs_to_time(struct tm *time, const max3133x_rtc_time_regs_t *regs, uint16_t *sub_sec)
 {
+    rtc_bcd_time_t bin;
+
+    /* The block is the 1/128 s register followed by seconds to year */
+    rtc_bcd_decode_time_hr(&regs->seconds_1_128_reg.raw, &bin);
+
     if (sub_sec != NULL)
-        *sub_sec = (1000 * regs->seconds_1_128_reg.raw) / 128.0;
+        *sub_sec = rtc_hr_frac_to_ms(bin.frac);
 
     /* tm_sec seconds [0,61] */
-    time->tm_sec = BCD2BIN(regs->seconds_reg.bcd.value);
+    time->tm_sec = bin.sec;
 
     /* tm_min minutes [0,59] */
-    time->tm_min = BCD2BIN(regs->minutes_reg.bcd.value);
+    time->tm_min = bin.min;
 
     /* tm_hour hour [0,23] */
-    time->tm_hour = hours_reg_to_hour(&regs->hours_reg);
-    /*hour_format_t format = regs->hours_reg.bits_24hr.f_24_12 == 1 ? HOUR12 : HOUR24;
-    if (format == HOUR24) {
-        time->tm_hour = BCD2BIN(regs->hours_reg.bcd_24hr.value);
-    } else if (format == HOUR12) {
-        uint8_t hr24 = to_24hr(BCD2BIN(regs->hours_reg.bcd_12hr.value), regs->hours_reg.bits_12hr.am_pm);
-        time->tm_hour = hr24;
-    }*/
+    time->tm_hour = bin.hour;
 
     /* tm_wday day of week [0,6] (Sunday = 0) */
-    time->tm_wday = BCD2BIN(regs->day_reg.bcd.value) - 1;
+    time->tm_wday = bin.wday - 1;
 
     /* tm_mday day of month [1,31] */
-    time->tm_mday = BCD2BIN(regs->date_reg.bcd.value);
+    time->tm_mday = bin.mday;
 
     /* tm_mon month of year [0,11] */
-    time->tm_mon = BCD2BIN(regs->month_reg.bcd.value) - 1;
+    time->tm_mon = bin.mon - 1;
 
-    /* tm_year years since 2000 */
-    if (regs->month_reg.bits.century)
-        time->tm_year = BCD2BIN(regs->year_reg.bcd.value) + 200;
-    else
-        time->tm_year = BCD2BIN(regs->year_reg.bcd.value) + 100;
+    /* tm_year years since 1900 */
+    time->tm_year = bin.year + 100;
 
     /* tm_yday day of year [0,365] */
-    time->tm_yday = 0; /* TODO */
+    time->tm_yday = rtc_yday(time->tm_year + 1900, bin.mon, bin.mday);
 
     /* tm_isdst daylight savings flag */
-    time->tm_isdst = 0; /* TODO */
+    time->tm_isdst = 0; /* UTC, RTCTimeZone gives local time */
 }
 
 int MAX3133X::time_to_rtc_regs(max3133x_rtc_time_regs_t *regs, const struct tm *time, hour_format_t format)
@@ -219,17 +240,17 @@ int MAX3133X::time_to_rtc_regs(max3133x_rtc_time_regs_t *regs, const struct tm *
      * * tm_sec is generally 0-59. The extra range is to accommodate for leap
      *   seconds in certain systems.
      *********************************************************/
-    regs->seconds_reg.bcd.value = BIN2BCD(time->tm_sec);
+    regs->seconds_reg.bcd.value = rtc_bin2bcd(time->tm_sec);
 
-    regs->minutes_reg.bcd.value = BIN2BCD(time->tm_min);
+    regs->minutes_reg.bcd.value = rtc_bin2bcd(time->tm_min);
 
     if (format == HOUR24) {
-        regs->hours_reg.bcd_24hr.value = BIN2BCD(time->tm_hour);
+        regs->hours_reg.bcd_24hr.value = rtc_bin2bcd(time->tm_hour);
         regs->hours_reg.bits_24hr.f_24_12 = HOUR24;
     } else if (format == HOUR12) {
         uint8_t hr_12, pm;
         to_12hr(time->tm_hour, &hr_12, &pm);
-        regs->hours_reg.bcd_12hr.value = BIN2BCD(hr_12);
+        regs->hours_reg.bcd_12hr.value = rtc_bin2bcd(hr_12);
         regs->hours_reg.bits_12hr.f_24_12 = HOUR12;
         regs->hours_reg.bits_12hr.am_pm = pm;
     } else {
@@ -237,18 +258,18 @@ int MAX3133X::time_to_rtc_regs(max3133x_rtc_time_regs_t *regs, const struct tm *
         return MAX3133X_INVALID_TIME_ERR;
     }
 
-    regs->day_reg.bcd.value = BIN2BCD(time->tm_wday + 1);
+    regs->day_reg.bcd.value = rtc_bin2bcd(time->tm_wday + 1);
 
-    regs->date_reg.bcd.value = BIN2BCD(time->tm_mday);
+    regs->date_reg.bcd.value = rtc_bin2bcd(time->tm_mday);
 
-    regs->month_reg.bcd.value = BIN2BCD(time->tm_mon + 1);
+    regs->month_reg.bcd.value = rtc_bin2bcd(time->tm_mon + 1);
 
     if (time->tm_year >= 200) {
         regs->month_reg.bits.century = 1;
-        regs->year_reg.bcd.value = BIN2BCD(time->tm_year - 200);
+        regs->year_reg.bcd.value = rtc_bin2bcd(time->tm_year - 200);
     } else if (time->tm_year >= 100) {
         regs->month_reg.bits.century = 0;
-        regs->year_reg.bcd.value = BIN2BCD(time->tm_year - 100);
+        regs->year_reg.bcd.value = rtc_bin2bcd(time->tm_year - 100);
     } else {
         pr_err("Invalid set date!");
         return MAX3133X_INVALID_DATE_ERR;
@@ -257,7 +278,8 @@ int MAX3133X::time_to_rtc_regs(max3133x_rtc_time_regs_t *regs, const struct tm *
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::get_time(struct tm *time, uint16_t *sub_sec)
+template <class Traits>
+int MAX3133XT<Traits>::get_time(struct tm *time, uint16_t *sub_sec)
 {
     int ret;
     max3133x_rtc_time_regs_t max3133x_rtc_time_regs;
@@ -266,7 +288,7 @@ int MAX3133X::get_time(struct tm *time, uint16_t *sub_sec)
         return MAX3133X_NULL_VALUE_ERR;
     }
 
-    ret = read_register(reg_addr->seconds_1_128_reg_addr, 
+    ret = read_register(MAX3133X_REG(seconds_1_128_reg_addr), 
                         (uint8_t *) &max3133x_rtc_time_regs.seconds_1_128_reg,
                         sizeof(max3133x_rtc_time_regs));
     if (ret != MAX3133X_NO_ERR) {
@@ -278,7 +300,8 @@ int MAX3133X::get_time(struct tm *time, uint16_t *sub_sec)
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::set_time(const struct tm *time, hour_format_t format)
+template <class Traits>
+int MAX3133XT<Traits>::set_time(const struct tm *time, hour_format_t format)
 {
     int ret;
     max3133x_rtc_time_regs_t max3133x_rtc_time_regs;
@@ -292,92 +315,228 @@ int MAX3133X::set_time(const struct tm *time, hour_format_t format)
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
-    return write_register(reg_addr->seconds_reg_addr, &max3133x_rtc_time_regs.seconds_reg.raw, sizeof(max3133x_rtc_time_regs)-1);
+    return write_register(MAX3133X_REG(seconds_reg_addr), &max3133x_rtc_time_regs.seconds_reg.raw, sizeof(max3133x_rtc_time_regs)-1);
+}
+
+template <class Traits>
+int MAX3133XT<Traits>::get_epoch(rtc_epoch_t *epoch)
+{
+    int ret;
+    uint8_t regs[7];
+
+    if (epoch == NULL) {
+        pr_err("epoch is invalid!");
+        return MAX3133X_NULL_VALUE_ERR;
+    }
+
+    ret = read_register(MAX3133X_REG(seconds_reg_addr), regs, sizeof(regs));
+    if (ret != MAX3133X_NO_ERR) {
+        pr_err("read time registers failed!");
+        return ret;
+    }
+
+    if (rtc_time_regs_to_epoch(regs, epoch)) {
+        return MAX3133X_INVALID_DATE_ERR;
+    }
+
+    return MAX3133X_NO_ERR;
+}
+
+template <class Traits>
+int MAX3133XT<Traits>::get_time_hr(rtc_time_hr_t *time)
+{
+    int ret;
+    uint8_t regs[8];
+
+    if (time == NULL) {
+        pr_err("time is invalid!");
+        return MAX3133X_NULL_VALUE_ERR;
+    }
+
+    /* The 1/128 s register first, as in get_time() */
+    ret = read_register(MAX3133X_REG(seconds_1_128_reg_addr), regs, sizeof(regs));
+    if (ret != MAX3133X_NO_ERR) {
+        pr_err("read time registers failed!");
+        return ret;
+    }
+
+    time->frac = regs[0] & 0x7F;
+    if (rtc_time_regs_to_epoch(&regs[1], &time->sec)) {
+        return MAX3133X_INVALID_DATE_ERR;
+    }
+
+    return MAX3133X_NO_ERR;
+}
+
+template <class Traits>
+int MAX3133XT<Traits>::set_epoch(rtc_epoch_t epoch)
+{
+    uint8_t regs[7];
+
+    if (rtc_epoch_to_time_regs(epoch, regs)) {
+        pr_err("Invalid set date!");
+        return MAX3133X_INVALID_DATE_ERR;
+    }
+
+    return write_register(MAX3133X_REG(seconds_reg_addr), regs, sizeof(regs));
 }
 
 inline void MAX3133X::timestamp_regs_to_time(timestamp_t *timestamp, const max3133x_ts_regs_t *timestamp_reg)
 {
     /* tm_sec seconds [0,61] */
-    timestamp->ctime.tm_sec = BCD2BIN(timestamp_reg->ts_sec_reg.bcd.value);
+    timestamp->ctime.tm_sec = rtc_bcd2bin(timestamp_reg->ts_sec_reg.bcd.value);
 
     /* tm_min minutes [0,59] */
-    timestamp->ctime.tm_min = BCD2BIN(timestamp_reg->ts_min_reg.bcd.value);
+    timestamp->ctime.tm_min = rtc_bcd2bin(timestamp_reg->ts_min_reg.bcd.value);
 
     /* tm_hour hour [0,23] */
     timestamp->ctime.tm_hour = hours_reg_to_hour(&timestamp_reg->ts_hour_reg);
     /*hour_format_t format = timestamp_reg->ts_hour_reg.bits_24hr.f_24_12 ? HOUR12 : HOUR24;
     if (format == HOUR24) {
-        timestamp->ctime.tm_hour = BCD2BIN(timestamp_reg->ts_hour_reg.bcd_24hr.value);
+        timestamp->ctime.tm_hour = rtc_bcd2bin(timestamp_reg->ts_hour_reg.bcd_24hr.value);
     } else if (format == HOUR12) {
-        uint8_t hr24 = to_24hr(BCD2BIN(timestamp_reg->ts_hour_reg.bcd_12hr.value), timestamp_reg->ts_hour_reg.bits_12hr.am_pm);
+        uint8_t hr24 = to_24hr(rtc_bcd2bin(timestamp_reg->ts_hour_reg.bcd_12hr.value), timestamp_reg->ts_hour_reg.bits_12hr.am_pm);
         timestamp->ctime.tm_hour = hr24;
     }*/
 
     /* tm_mday day of month [1,31] */
-    timestamp->ctime.tm_mday = BCD2BIN(timestamp_reg->ts_date_reg.bcd.value);
+    timestamp->ctime.tm_mday = rtc_bcd2bin(timestamp_reg->ts_date_reg.bcd.value);
 
     /* tm_mon month of year [0,11] */
-    timestamp->ctime.tm_mon = BCD2BIN(timestamp_reg->ts_month_reg.bcd.value) - 1;
+    timestamp->ctime.tm_mon = rtc_bcd2bin(timestamp_reg->ts_month_reg.bcd.value) - 1;
 
     /* tm_year years since 2000 */
     if (timestamp_reg->ts_month_reg.bits.century)
-        timestamp->ctime.tm_year = BCD2BIN(timestamp_reg->ts_year_reg.bcd.value) + 200;
+        timestamp->ctime.tm_year = rtc_bcd2bin(timestamp_reg->ts_year_reg.bcd.value) + 200;
     else
-        timestamp->ctime.tm_year = BCD2BIN(timestamp_reg->ts_year_reg.bcd.value) + 100;
+        timestamp->ctime.tm_year = rtc_bcd2bin(timestamp_reg->ts_year_reg.bcd.value) + 100;
 
     /* tm_yday day of year [0,365] */
-    timestamp->ctime.tm_yday = 0; /* TODO */
+    timestamp->ctime.tm_yday = rtc_yday(timestamp->ctime.tm_year + 1900, timestamp->ctime.tm_mon + 1,
+                                        timestamp->ctime.tm_mday);
 
     /* tm_isdst daylight savings flag */
-    timestamp->ctime.tm_isdst = 0; /* TODO */
+    timestamp->ctime.tm_isdst = 0; /* UTC, RTCTimeZone gives local time */
 
-    timestamp->sub_sec = (1000 * timestamp_reg->ts_sec_1_128_reg.raw) / 128.0;
+    timestamp->sub_sec = rtc_hr_frac_to_ms(timestamp_reg->ts_sec_1_128_reg.raw);
 }
 
-int MAX3133X::get_status_reg(max3133x_status_reg_t * status_reg)
+int MAX3133X::timestamp_regs_to_hr(rtc_time_hr_t *time, const max3133x_ts_regs_t *timestamp_reg)
+{
+    /* The record has no day of week, rtc_time_regs_to_epoch() does not use it */
+    uint8_t regs[7] = {
+        timestamp_reg->ts_sec_reg.raw, timestamp_reg->ts_min_reg.raw, timestamp_reg->ts_hour_reg.raw, 0,
+        timestamp_reg->ts_date_reg.raw, timestamp_reg->ts_month_reg.raw, timestamp_reg->ts_year_reg.raw,
+    };
+
+    time->frac = timestamp_reg->ts_sec_1_128_reg.raw & 0x7F;
+    if (rtc_time_regs_to_epoch(regs, &time->sec))
+        return MAX3133X_INVALID_DATE_ERR;
+
+    return MAX3133X_NO_ERR;
+}
+
+template <class Traits>
+int MAX3133XT<Traits>::get_status_reg(max3133x_status_reg_t * status_reg)
 {
-    return read_register(reg_addr->status_reg_addr, &status_reg->raw, 1);
+    return read_register(MAX3133X_REG(status_reg_addr), &status_reg->raw, 1);
 }
 
 int MAX31335::get_status2_reg(max31335_status2_reg_t * status_reg)
 {
-    return read_register(reg_addr.status2_reg_addr, &status_reg->raw, 1);
+    return read_register(MAX3133X_REG(status2_reg_addr), &status_reg->raw, 1);
 }
 
-int MAX3133X::get_interrupt_reg(max3133x_int_en_reg_t * int_en_reg)
+template <class Traits>
+int MAX3133XT<Traits>::get_interrupt_reg(max3133x_int_en_reg_t * int_en_reg)
 {
-    return read_register(reg_addr->int_en_reg_addr, &int_en_reg->raw, 1);
+    return read_register(MAX3133X_REG(int_en_reg_addr), &int_en_reg->raw, 1);
 }
 
 int MAX31335::get_interrupt2_reg(max31335_int_en2_reg_t * int_en_reg)
 {
-    return read_register(reg_addr.int_en2_reg_addr, &int_en_reg->raw, 1);
+    return read_register(MAX3133X_REG(int_en2_reg_addr), &int_en_reg->raw, 1);
 }
 
-int MAX3133X::interrupt_enable(uint8_t mask)
+template <class Traits>
+int MAX3133XT<Traits>::interrupt_enable(uint8_t mask)
 {
     int ret;
     max3133x_int_en_reg_t int_en_reg;
 
-    ret = read_register(reg_addr->int_en_reg_addr, &int_en_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(int_en_reg_addr), &int_en_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
     int_en_reg.raw |= mask;
-    return write_register(reg_addr->int_en_reg_addr, &int_en_reg.raw, 1);
+    return write_register(MAX3133X_REG(int_en_reg_addr), &int_en_reg.raw, 1);
 }
 
-int MAX3133X::interrupt_disable(uint8_t mask)
+template <class Traits>
+int MAX3133XT<Traits>::interrupt_disable(uint8_t mask)
 {
     int ret;
     max3133x_int_en_reg_t int_en_reg;
 
-    ret = read_register(reg_addr->int_en_reg_addr, &int_en_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(int_en_reg_addr), &int_en_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
     int_en_reg.raw &= ~mask;
-    return write_register(reg_addr->int_en_reg_addr, &int_en_reg.raw, 1);
+    return write_register(MAX3133X_REG(int_en_reg_addr), &int_en_reg.raw, 1);
+}
+
+template <class Traits>
+int MAX3133XT<Traits>::interrupt_attach(intr_id_t id, interrupt_handler_function func, void *cb)
+{
+    if (id >= NUM_OF_INT)
+        return MAX3133X_INVALID_MASK_ERR;
+
+    if (func == NULL)
+        return MAX3133X_NULL_VALUE_ERR;
+
+    interrupt_handler_list[id].func = func;
+    interrupt_handler_list[id].cb = cb;
+
+    return interrupt_enable(1 << id);
+}
+
+template <class Traits>
+int MAX3133XT<Traits>::interrupt_detach(intr_id_t id)
+{
+    if (id >= NUM_OF_INT)
+        return MAX3133X_INVALID_MASK_ERR;
+
+    interrupt_handler_list[id].func = NULL;
+    interrupt_handler_list[id].cb = NULL;
+
+    return interrupt_disable(1 << id);
+}
+
+template <class Traits>
+int MAX3133XT<Traits>::post_interrupt_work(max3133x_status_reg_t *status)
+{
+    int ret;
+    max3133x_status_reg_t status_reg;
+
+    if (!int_pending)
+        return MAX3133X_NO_ERR;
+
+    /* Cleared before the read, an edge during the read is serviced on the next call */
+    int_pending = false;
+
+    ret = get_status_reg(&status_reg);
+    if (ret != MAX3133X_NO_ERR) {
+        int_pending = true;
+        return ret;
+    }
+
+    if (status)
+        *status = status_reg;
+
+    dispatch_interrupts(interrupt_handler_list, NUM_OF_INT, status_reg.raw);
+
+    return MAX3133X_NO_ERR;
 }
 
 int MAX31335::interrupt2_enable(uint8_t mask)
@@ -385,12 +544,12 @@ int MAX31335::interrupt2_enable(uint8_t mask)
     int ret;
     max31335_int_en2_reg_t int_en_reg;
 
-    ret = read_register(reg_addr.int_en2_reg_addr, &int_en_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(int_en2_reg_addr), &int_en_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
     int_en_reg.raw |= mask;
-    return write_register(reg_addr.int_en2_reg_addr, &int_en_reg.raw, 1);
+    return write_register(MAX3133X_REG(int_en2_reg_addr), &int_en_reg.raw, 1);
 }
 
 int MAX31335::interrupt2_disable(uint8_t mask)
@@ -398,29 +557,94 @@ int MAX31335::interrupt2_disable(uint8_t mask)
     int ret;
     max31335_int_en2_reg_t int_en_reg;
 
-    ret = read_register(reg_addr.int_en2_reg_addr, &int_en_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(int_en2_reg_addr), &int_en_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
     int_en_reg.raw &= ~mask;
-    return write_register(reg_addr.int_en2_reg_addr, &int_en_reg.raw, 1);
+    return write_register(MAX3133X_REG(int_en2_reg_addr), &int_en_reg.raw, 1);
 }
 
-int MAX3133X::sw_reset_assert()
+int MAX31335::interrupt2_attach(intr2_id_t id, interrupt_handler_function func, void *cb)
+{
+    if (id >= NUM_OF_INT1)
+        return MAX3133X_INVALID_MASK_ERR;
+
+    if (func == NULL)
+        return MAX3133X_NULL_VALUE_ERR;
+
+    interrupt2_handler_list[id].func = func;
+    interrupt2_handler_list[id].cb = cb;
+
+    return interrupt2_enable(1 << id);
+}
+
+int MAX31335::interrupt2_detach(intr2_id_t id)
+{
+    if (id >= NUM_OF_INT1)
+        return MAX3133X_INVALID_MASK_ERR;
+
+    interrupt2_handler_list[id].func = NULL;
+    interrupt2_handler_list[id].cb = NULL;
+
+    return interrupt2_disable(1 << id);
+}
+
+int MAX31335::post_interrupt_work(max3133x_status_reg_t *status, max31335_status2_reg_t *status2)
+{
+    int ret;
+    bool has_status2 = false;
+    max3133x_status_reg_t status_reg;
+    max31335_status2_reg_t status2_reg;
+
+    if (!int_pending)
+        return MAX3133X_NO_ERR;
+
+    for (uint8_t i = 0; i < NUM_OF_INT1; i++) {
+        if (interrupt2_handler_list[i].func != NULL)
+            has_status2 = true;
+    }
+
+    int_pending = false;
+
+    ret = get_status_reg(&status_reg);
+    if (ret == MAX3133X_NO_ERR && has_status2)
+        ret = get_status2_reg(&status2_reg);
+    if (ret != MAX3133X_NO_ERR) {
+        int_pending = true;
+        return ret;
+    }
+
+    if (status)
+        *status = status_reg;
+    if (status2 && has_status2)
+        *status2 = status2_reg;
+
+    dispatch_interrupts(interrupt_handler_list, NUM_OF_INT, status_reg.raw);
+    if (has_status2)
+        dispatch_interrupts(interrupt2_handler_list, NUM_OF_INT1, status2_reg.raw);
+
+    return MAX3133X_NO_ERR;
+}
+
+template <class Traits>
+int MAX3133XT<Traits>::sw_reset_assert()
 {
     max3133x_rtc_reset_reg_t rtc_reset_reg;
-    SET_BIT_FIELD(reg_addr->rtc_reset_reg_addr, rtc_reset_reg, rtc_reset_reg.bits.swrst, 1);
+    SET_BIT_FIELD(MAX3133X_REG(rtc_reset_reg_addr), rtc_reset_reg, rtc_reset_reg.bits.swrst, 1);
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::sw_reset_release()
+template <class Traits>
+int MAX3133XT<Traits>::sw_reset_release()
 {
     max3133x_rtc_reset_reg_t rtc_reset_reg;
-    SET_BIT_FIELD(reg_addr->rtc_reset_reg_addr, rtc_reset_reg, rtc_reset_reg.bits.swrst, 0);
+    SET_BIT_FIELD(MAX3133X_REG(rtc_reset_reg_addr), rtc_reset_reg, rtc_reset_reg.bits.swrst, 0);
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::sw_reset()
+template <class Traits>
+int MAX3133XT<Traits>::sw_reset()
 {
     int ret;
     ret = sw_reset_assert();
@@ -431,119 +655,281 @@ int MAX3133X::sw_reset()
     return sw_reset_release();
 }
 
-int MAX31331::rtc_config(rtc_config_t *max31331_config)
+int MAX3133X::config_txn::load()
 {
     int ret;
+
+    ret = rtc->read_register(base, device, NUM_OF_CFG_REGS);
+    if (ret != MAX3133X_NO_ERR)
+        return ret;
+
+    memcpy(staged, device, sizeof(staged));
+    loaded = true;
+    return MAX3133X_NO_ERR;
+}
+
+int MAX3133X::config_txn::commit()
+{
+    int ret;
+    int first, last;
+
+    if (!loaded)
+        return MAX3133X_CONFIG_NOT_LOADED_ERR;
+
+    for (first = 0; first < NUM_OF_CFG_REGS && staged[first] == device[first]; first++);
+    if (first == NUM_OF_CFG_REGS)
+        return MAX3133X_NO_ERR;
+
+    for (last = NUM_OF_CFG_REGS - 1; staged[last] == device[last]; last--);
+
+    ret = rtc->write_register(base + first, &staged[first], last - first + 1);
+    if (ret != MAX3133X_NO_ERR)
+        return ret;
+
+    memcpy(device, staged, sizeof(device));
+    return MAX3133X_NO_ERR;
+}
+
+uint8_t MAX3133X::config_txn::get(config_reg_t reg) const
+{
+    return staged[reg];
+}
+
+MAX3133X::config_txn &MAX3133X::config_txn::set(config_reg_t reg, uint8_t value)
+{
+    staged[reg] = value;
+    return *this;
+}
+
+MAX3133X::config_txn &MAX3133X::config_txn::update(config_reg_t reg, uint8_t mask, uint8_t value)
+{
+    staged[reg] = (staged[reg] & ~mask) | (value & mask);
+    return *this;
+}
+
+MAX3133X::config_txn &MAX3133X::config_txn::set_alarm1_auto_clear(a1ac_t a1ac)
+{
     max3133x_rtc_config1_reg_t rtc_config1_reg;
+
+    rtc_config1_reg.raw = staged[CFG_RTC_CONFIG1];
+    rtc_config1_reg.bits.a1ac = a1ac;
+    staged[CFG_RTC_CONFIG1] = rtc_config1_reg.raw;
+    return *this;
+}
+
+MAX3133X::config_txn &MAX3133X::config_txn::set_din_polarity(dip_t dip)
+{
+    max3133x_rtc_config1_reg_t rtc_config1_reg;
+
+    rtc_config1_reg.raw = staged[CFG_RTC_CONFIG1];
+    rtc_config1_reg.bits.dip = dip;
+    staged[CFG_RTC_CONFIG1] = rtc_config1_reg.raw;
+    return *this;
+}
+
+MAX3133X::config_txn &MAX3133X::config_txn::set_data_retention(data_ret_t data_ret)
+{
+    max3133x_rtc_config1_reg_t rtc_config1_reg;
+
+    rtc_config1_reg.raw = staged[CFG_RTC_CONFIG1];
+    rtc_config1_reg.bits.data_ret = data_ret;
+    staged[CFG_RTC_CONFIG1] = rtc_config1_reg.raw;
+    return *this;
+}
+
+MAX3133X::config_txn &MAX3133X::config_txn::set_i2c_timeout(i2c_timeout_t i2c_timeout)
+{
+    max3133x_rtc_config1_reg_t rtc_config1_reg;
+
+    rtc_config1_reg.raw = staged[CFG_RTC_CONFIG1];
+    rtc_config1_reg.bits.i2c_timeout = i2c_timeout;
+    staged[CFG_RTC_CONFIG1] = rtc_config1_reg.raw;
+    return *this;
+}
+
+MAX3133X::config_txn &MAX3133X::config_txn::set_oscillator(en_osc_t en_osc)
+{
+    max3133x_rtc_config1_reg_t rtc_config1_reg;
+
+    rtc_config1_reg.raw = staged[CFG_RTC_CONFIG1];
+    rtc_config1_reg.bits.en_osc = en_osc;
+    staged[CFG_RTC_CONFIG1] = rtc_config1_reg.raw;
+    return *this;
+}
+
+MAX3133X::config_txn &MAX3133X::config_txn::set_clkout(enclko_t enclko)
+{
     max31331_rtc_config2_reg_t rtc_config2_reg;
 
-    rtc_config1_reg.bits.a1ac           = max31331_config->a1ac;
-    rtc_config1_reg.bits.dip            = max31331_config->dip;
-    rtc_config1_reg.bits.data_ret       = max31331_config->data_ret;
-    rtc_config1_reg.bits.i2c_timeout    = max31331_config->i2c_timeout;
-    rtc_config1_reg.bits.en_osc         = max31331_config->en_osc;
+    rtc_config2_reg.raw = staged[CFG_RTC_CONFIG2];
+    rtc_config2_reg.bits.enclko = enclko;
+    staged[CFG_RTC_CONFIG2] = rtc_config2_reg.raw;
+    return *this;
+}
 
-    ret =  write_register(reg_addr.rtc_config1_reg_addr, &rtc_config1_reg.raw, 1);
+MAX3133X::config_txn &MAX3133X::config_txn::set_clko_freq(clko_hz_t clko_hz)
+{
+    max31331_rtc_config2_reg_t rtc_config2_reg;
+
+    rtc_config2_reg.raw = staged[CFG_RTC_CONFIG2];
+    rtc_config2_reg.bits.clko_hz = clko_hz;
+    staged[CFG_RTC_CONFIG2] = rtc_config2_reg.raw;
+    return *this;
+}
+
+MAX3133X::config_txn &MAX3133X::config_txn::set_timestamp_function(bool enable)
+{
+    max3133x_timestamp_config_reg_t timestamp_config_reg;
+
+    timestamp_config_reg.raw = staged[CFG_TIMESTAMP_CONFIG];
+    timestamp_config_reg.bits.tse = enable ? 1 : 0;
+    staged[CFG_TIMESTAMP_CONFIG] = timestamp_config_reg.raw;
+    return *this;
+}
+
+MAX3133X::config_txn &MAX3133X::config_txn::set_timestamp_overwrite(bool enable)
+{
+    max3133x_timestamp_config_reg_t timestamp_config_reg;
+
+    timestamp_config_reg.raw = staged[CFG_TIMESTAMP_CONFIG];
+    timestamp_config_reg.bits.tsow = enable ? 1 : 0;
+    staged[CFG_TIMESTAMP_CONFIG] = timestamp_config_reg.raw;
+    return *this;
+}
+
+MAX3133X::config_txn &MAX3133X::config_txn::set_timestamp_record(uint8_t record_mask)
+{
+    return update(CFG_TIMESTAMP_CONFIG, TSVLOW | TSPWM | TSDIN, record_mask);
+}
+
+MAX3133X::config_txn &MAX3133X::config_txn::set_timer(bool enable, bool pause, bool repeat, timer_freq_t freq)
+{
+    max3133x_timer_config_reg_t timer_config_reg;
+
+    timer_config_reg.raw = staged[CFG_TIMER_CONFIG];
+    timer_config_reg.bits.te        = enable ? 1 : 0;
+    timer_config_reg.bits.tpause    = pause ? 1 : 0;
+    timer_config_reg.bits.trpt      = repeat ? 1 : 0;
+    timer_config_reg.bits.tfs       = freq;
+    staged[CFG_TIMER_CONFIG] = timer_config_reg.raw;
+    return *this;
+}
+
+int MAX31331::rtc_config(rtc_config_t *max31331_config)
+{
+    int ret;
+    config_txn txn(this);
+
+    ret = txn.load();
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
-    rtc_config2_reg.bits.clko_hz    = max31331_config->clko_hz;
-    rtc_config2_reg.bits.enclko     = max31331_config->enclko;
+    txn.set_alarm1_auto_clear(max31331_config->a1ac)
+       .set_din_polarity(max31331_config->dip)
+       .set_data_retention(max31331_config->data_ret)
+       .set_i2c_timeout(max31331_config->i2c_timeout)
+       .set_oscillator(max31331_config->en_osc)
+       .set_clko_freq(max31331_config->clko_hz)
+       .set_clkout(max31331_config->enclko);
 
-    return write_register(reg_addr.rtc_config2_reg_addr, &rtc_config2_reg.raw, 1);
+    return txn.commit();
 }
 
 int MAX31334::rtc_config(rtc_config_t *max31334_config)
 {
     int ret;
-    max3133x_rtc_config1_reg_t rtc_config1_reg;
+    config_txn txn(this);
     max31334_rtc_config2_reg_t rtc_config2_reg;
 
-    rtc_config1_reg.bits.a1ac           = max31334_config->a1ac;
-    rtc_config1_reg.bits.dip            = max31334_config->dip;
-    rtc_config1_reg.bits.data_ret       = max31334_config->data_ret;
-    rtc_config1_reg.bits.i2c_timeout    = max31334_config->i2c_timeout;
-    rtc_config1_reg.bits.en_osc         = max31334_config->en_osc;
-
-    ret =  write_register(reg_addr.rtc_config1_reg_addr, &rtc_config1_reg.raw, 1);
+    ret = txn.load();
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
-    rtc_config2_reg.bits.clko_hz    = max31334_config->clko_hz;
-    rtc_config2_reg.bits.enclko     = max31334_config->enclko;
-    rtc_config2_reg.bits.ddb        = max31334_config->ddb;
-    rtc_config2_reg.bits.dse        = max31334_config->dse;
+    txn.set_alarm1_auto_clear(max31334_config->a1ac)
+       .set_din_polarity(max31334_config->dip)
+       .set_data_retention(max31334_config->data_ret)
+       .set_i2c_timeout(max31334_config->i2c_timeout)
+       .set_oscillator(max31334_config->en_osc)
+       .set_clko_freq(max31334_config->clko_hz)
+       .set_clkout(max31334_config->enclko);
 
-    return write_register(reg_addr.rtc_config2_reg_addr, &rtc_config2_reg.raw, 1);
+    rtc_config2_reg.raw         = txn.get(config_txn::CFG_RTC_CONFIG2);
+    rtc_config2_reg.bits.ddb    = max31334_config->ddb;
+    rtc_config2_reg.bits.dse    = max31334_config->dse;
+    txn.set(config_txn::CFG_RTC_CONFIG2, rtc_config2_reg.raw);
+
+    return txn.commit();
 }
 
 int MAX31335::rtc_config(rtc_config_t *max31335_config)
 {
     int ret;
+    config_txn txn(this);
     max31335_rtc_config1_reg_t rtc_config1_reg;
-    max31335_rtc_config2_reg_t rtc_config2_reg;
-    rtc_config1_reg.bits.en_io          = max31335_config->en_io;
-    rtc_config1_reg.bits.a1ac           = max31335_config->a1ac;
-    rtc_config1_reg.bits.dip            = max31335_config->dip;
-    rtc_config1_reg.bits.data_ret       = max31335_config->data_ret;
-    rtc_config1_reg.bits.i2c_timeout    = max31335_config->i2c_timeout;
-    rtc_config1_reg.bits.en_osc         = max31335_config->en_osc;
-
-    ret =  write_register(reg_addr.rtc_config1_reg_addr, &rtc_config1_reg.raw, 1);
+
+    ret = txn.load();
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
-    rtc_config2_reg.bits.clko_hz    = max31335_config->clko_hz;
-    rtc_config2_reg.bits.enclko     = max31335_config->enclko;
+    txn.set_alarm1_auto_clear(max31335_config->a1ac)
+       .set_din_polarity(max31335_config->dip)
+       .set_data_retention(max31335_config->data_ret)
+       .set_i2c_timeout(max31335_config->i2c_timeout)
+       .set_oscillator(max31335_config->en_osc)
+       .set_clko_freq(max31335_config->clko_hz)
+       .set_clkout(max31335_config->enclko);
+
+    rtc_config1_reg.raw         = txn.get(config_txn::CFG_RTC_CONFIG1);
+    rtc_config1_reg.bits.en_io  = max31335_config->en_io;
+    txn.set(config_txn::CFG_RTC_CONFIG1, rtc_config1_reg.raw);
 
-    return write_register(reg_addr.rtc_config2_reg_addr, &rtc_config2_reg.raw, 1);
+    return txn.commit();
 }
 
 int MAX31331::get_rtc_config(rtc_config_t *max31331_config)
 {
     int ret;
+    uint8_t regs[2];
     max3133x_rtc_config1_reg_t rtc_config1_reg;
     max31331_rtc_config2_reg_t rtc_config2_reg;
 
-    ret = read_register(reg_addr.rtc_config1_reg_addr, &rtc_config1_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(rtc_config1_reg_addr), regs, 2);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
+    rtc_config1_reg.raw = regs[0];
+    rtc_config2_reg.raw = regs[1];
+
     max31331_config->a1ac           = (a1ac_t)rtc_config1_reg.bits.a1ac;
     max31331_config->dip            = (dip_t)rtc_config1_reg.bits.dip;
     max31331_config->data_ret       = (data_ret_t)rtc_config1_reg.bits.data_ret;
     max31331_config->i2c_timeout    = (i2c_timeout_t)rtc_config1_reg.bits.i2c_timeout;
     max31331_config->en_osc         = (en_osc_t)rtc_config1_reg.bits.en_osc;
-
-    ret = read_register(reg_addr.rtc_config2_reg_addr, &rtc_config2_reg.raw, 1);
-    if (ret != MAX3133X_NO_ERR)
-        return ret;
-
     max31331_config->clko_hz        = (clko_hz_t)rtc_config2_reg.bits.clko_hz;
     max31331_config->enclko         = (enclko_t)rtc_config2_reg.bits.enclko;
+
     return MAX3133X_NO_ERR;
 }
 
 int MAX31334::get_rtc_config(rtc_config_t *max31334_config)
 {
     int ret;
+    uint8_t regs[2];
     max3133x_rtc_config1_reg_t rtc_config1_reg;
     max31334_rtc_config2_reg_t rtc_config2_reg;
 
-    ret =  read_register(reg_addr.rtc_config1_reg_addr, &rtc_config1_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(rtc_config1_reg_addr), regs, 2);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
+    rtc_config1_reg.raw = regs[0];
+    rtc_config2_reg.raw = regs[1];
+
     max31334_config->a1ac           = (a1ac_t)rtc_config1_reg.bits.a1ac;
     max31334_config->dip            = (dip_t)rtc_config1_reg.bits.dip;
     max31334_config->data_ret       = (data_ret_t)rtc_config1_reg.bits.data_ret;
     max31334_config->i2c_timeout    = (i2c_timeout_t)rtc_config1_reg.bits.i2c_timeout;
-    max31334_config->en_osc         = (en_osc_t)rtc_config1_reg.bits.en_osc;
-
-    ret = read_register(reg_addr.rtc_config2_reg_addr, &rtc_config2_reg.raw, 1);
-    if (ret != MAX3133X_NO_ERR)
-        return ret;
-
+    max31334_config->en_osc         = (en_osc_t)rtc_config1_reg.bits.en_osc;
     max31334_config->clko_hz        = (clko_hz_t)rtc_config2_reg.bits.clko_hz;
     max31334_config->ddb            = (ddb_t)rtc_config2_reg.bits.ddb;
     max31334_config->dse            = (dse_t)rtc_config2_reg.bits.dse;
@@ -555,90 +941,101 @@ int MAX31334::get_rtc_config(rtc_config_t *max31334_config)
 int MAX31335::get_rtc_config(rtc_config_t *max31335_config)
 {
     int ret;
+    uint8_t regs[2];
     max31335_rtc_config1_reg_t rtc_config1_reg;
     max31335_rtc_config2_reg_t rtc_config2_reg;
 
-    ret =  read_register(reg_addr.rtc_config1_reg_addr, &rtc_config1_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(rtc_config1_reg_addr), regs, 2);
     if (ret != MAX3133X_NO_ERR)
         return ret;
+
+    rtc_config1_reg.raw = regs[0];
+    rtc_config2_reg.raw = regs[1];
+
     max31335_config->en_io          = (en_io_t)rtc_config1_reg.bits.en_io;
     max31335_config->a1ac           = (a1ac_t)rtc_config1_reg.bits.a1ac;
     max31335_config->dip            = (dip_t)rtc_config1_reg.bits.dip;
     max31335_config->data_ret       = (data_ret_t)rtc_config1_reg.bits.data_ret;
     max31335_config->i2c_timeout    = (i2c_timeout_t)rtc_config1_reg.bits.i2c_timeout;
     max31335_config->en_osc         = (en_osc_t)rtc_config1_reg.bits.en_osc;
-
-    ret = read_register(reg_addr.rtc_config2_reg_addr, &rtc_config2_reg.raw, 1);
-    if (ret != MAX3133X_NO_ERR)
-        return ret;
-
     max31335_config->clko_hz        = (clko_hz_t)rtc_config2_reg.bits.clko_hz;
     max31335_config->enclko         = (enclko_t)rtc_config2_reg.bits.enclko;
 
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::set_alarm1_auto_clear(a1ac_t a1ac)
+template <class Traits>
+int MAX3133XT<Traits>::set_alarm1_auto_clear(a1ac_t a1ac)
 {
     max3133x_rtc_config1_reg_t rtc_config1_reg;
-    SET_BIT_FIELD(reg_addr->rtc_config1_reg_addr, rtc_config1_reg, rtc_config1_reg.bits.a1ac, a1ac);
+    SET_BIT_FIELD(MAX3133X_REG(rtc_config1_reg_addr), rtc_config1_reg, rtc_config1_reg.bits.a1ac, a1ac);
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::set_din_polarity(dip_t dip)
+template <class Traits>
+int MAX3133XT<Traits>::set_din_polarity(dip_t dip)
 {
     max3133x_rtc_config1_reg_t rtc_config1_reg;
-    SET_BIT_FIELD(reg_addr->rtc_config1_reg_addr, rtc_config1_reg, rtc_config1_reg.bits.dip, dip);
+    SET_BIT_FIELD(MAX3133X_REG(rtc_config1_reg_addr), rtc_config1_reg, rtc_config1_reg.bits.dip, dip);
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::data_retention_mode_config(bool enable)
+template <class Traits>
+int MAX3133XT<Traits>::data_retention_mode_config(bool enable)
 {
     max3133x_rtc_config1_reg_t rtc_config1_reg;
-    SET_BIT_FIELD(reg_addr->rtc_config1_reg_addr, rtc_config1_reg, rtc_config1_reg.bits.data_ret, enable);
+    SET_BIT_FIELD(MAX3133X_REG(rtc_config1_reg_addr), rtc_config1_reg, rtc_config1_reg.bits.data_ret, enable);
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::data_retention_mode_enter()
+template <class Traits>
+int MAX3133XT<Traits>::data_retention_mode_enter()
 {
     return data_retention_mode_config(1);
 }
 
-int MAX3133X::data_retention_mode_exit()
+template <class Traits>
+int MAX3133XT<Traits>::data_retention_mode_exit()
 {
     return data_retention_mode_config(0);
 }
 
-int MAX3133X::i2c_timeout_config(bool enable)
+template <class Traits>
+int MAX3133XT<Traits>::i2c_timeout_config(bool enable)
 {
     max3133x_rtc_config1_reg_t rtc_config1_reg;
-    SET_BIT_FIELD(reg_addr->rtc_config1_reg_addr, rtc_config1_reg, rtc_config1_reg.bits.i2c_timeout, enable);
+    SET_BIT_FIELD(MAX3133X_REG(rtc_config1_reg_addr), rtc_config1_reg, rtc_config1_reg.bits.i2c_timeout, enable);
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::i2c_timeout_enable()
+template <class Traits>
+int MAX3133XT<Traits>::i2c_timeout_enable()
 {
     return i2c_timeout_config(1);
 }
 
-int MAX3133X::i2c_timeout_disable()
+template <class Traits>
+int MAX3133XT<Traits>::i2c_timeout_disable()
 {
     return i2c_timeout_config(0);
 }
 
-int MAX3133X::oscillator_config(bool enable)
+template <class Traits>
+int MAX3133XT<Traits>::oscillator_config(bool enable)
 {
     max3133x_rtc_config1_reg_t rtc_config1_reg;
-    SET_BIT_FIELD(reg_addr->rtc_config1_reg_addr, rtc_config1_reg, rtc_config1_reg.bits.en_osc, enable);
+    SET_BIT_FIELD(MAX3133X_REG(rtc_config1_reg_addr), rtc_config1_reg, rtc_config1_reg.bits.en_osc, enable);
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::oscillator_enable()
+template <class Traits>
+int MAX3133XT<Traits>::oscillator_enable()
 {
     return oscillator_config(1);
 }
 
-int MAX3133X::oscillator_disable()
+template <class Traits>
+int MAX3133XT<Traits>::oscillator_disable()
 {
     return oscillator_config(0);
 }
@@ -648,7 +1045,7 @@ int MAX31334::get_sleep_state()
     int ret;
     max31334_rtc_config2_reg_t rtc_config2_reg;
 
-    ret = read_register(reg_addr.rtc_config2_reg_addr, &rtc_config2_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(rtc_config2_reg_addr), &rtc_config2_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
@@ -658,7 +1055,7 @@ int MAX31334::get_sleep_state()
 int MAX31334::din_sleep_entry_config(bool enable)
 {
     max31334_rtc_config2_reg_t rtc_config2_reg;
-    SET_BIT_FIELD(reg_addr.rtc_config2_reg_addr, rtc_config2_reg, rtc_config2_reg.bits.dse, enable);
+    SET_BIT_FIELD(MAX3133X_REG(rtc_config2_reg_addr), rtc_config2_reg, rtc_config2_reg.bits.dse, enable);
     return MAX3133X_NO_ERR;
 }
 
@@ -675,7 +1072,7 @@ int MAX31334::din_sleep_entry_disable()
 int MAX31334::din_pin_debounce_config(bool enable)
 {
     max31334_rtc_config2_reg_t rtc_config2_reg;
-    SET_BIT_FIELD(reg_addr.rtc_config2_reg_addr, rtc_config2_reg, rtc_config2_reg.bits.ddb, enable);
+    SET_BIT_FIELD(MAX3133X_REG(rtc_config2_reg_addr), rtc_config2_reg, rtc_config2_reg.bits.ddb, enable);
     return MAX3133X_NO_ERR;
 }
 
@@ -689,36 +1086,41 @@ int MAX31334::din_pin_debounce_disable()
     return din_pin_debounce_config(0);
 }
 
-int MAX3133X::clkout_config(bool enable)
+template <class Traits>
+int MAX3133XT<Traits>::clkout_config(bool enable)
 {
     max31334_rtc_config2_reg_t rtc_config2_reg;
-    SET_BIT_FIELD(reg_addr->rtc_config2_reg_addr, rtc_config2_reg, rtc_config2_reg.bits.enclko, enable);
+    SET_BIT_FIELD(MAX3133X_REG(rtc_config2_reg_addr), rtc_config2_reg, rtc_config2_reg.bits.enclko, enable);
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::clkout_enable()
+template <class Traits>
+int MAX3133XT<Traits>::clkout_enable()
 {
     return clkout_config(1);
 }
 
-int MAX3133X::clkout_disable()
+template <class Traits>
+int MAX3133XT<Traits>::clkout_disable()
 {
     return clkout_config(0);
 }
 
-int MAX3133X::set_clko_freq(clko_hz_t clko_hz)
+template <class Traits>
+int MAX3133XT<Traits>::set_clko_freq(clko_hz_t clko_hz)
 {
     max31334_rtc_config2_reg_t rtc_config2_reg;
-    SET_BIT_FIELD(reg_addr->rtc_config2_reg_addr, rtc_config2_reg, rtc_config2_reg.bits.clko_hz, clko_hz);
+    SET_BIT_FIELD(MAX3133X_REG(rtc_config2_reg_addr), rtc_config2_reg, rtc_config2_reg.bits.clko_hz, clko_hz);
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::get_clko_freq(clko_hz_t *clko_hz)
+template <class Traits>
+int MAX3133XT<Traits>::get_clko_freq(clko_hz_t *clko_hz)
 {
     int ret;
     max31334_rtc_config2_reg_t rtc_config2_reg;
 
-    ret = read_register(reg_addr->rtc_config2_reg_addr, &rtc_config2_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(rtc_config2_reg_addr), &rtc_config2_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
@@ -726,45 +1128,52 @@ int MAX3133X::get_clko_freq(clko_hz_t *clko_hz)
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::timestamp_function_enable()
+template <class Traits>
+int MAX3133XT<Traits>::timestamp_function_enable()
 {
     max3133x_timestamp_config_reg_t timestamp_config_reg;
-    SET_BIT_FIELD(reg_addr->timestamp_config_reg_addr, timestamp_config_reg, timestamp_config_reg.bits.tse, 1);
+    SET_BIT_FIELD(MAX3133X_REG(timestamp_config_reg_addr), timestamp_config_reg, timestamp_config_reg.bits.tse, 1);
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::timestamp_function_disable()
+template <class Traits>
+int MAX3133XT<Traits>::timestamp_function_disable()
 {
     max3133x_timestamp_config_reg_t timestamp_config_reg;
-    SET_BIT_FIELD(reg_addr->timestamp_config_reg_addr, timestamp_config_reg, timestamp_config_reg.bits.tse, 0);
+    SET_BIT_FIELD(MAX3133X_REG(timestamp_config_reg_addr), timestamp_config_reg, timestamp_config_reg.bits.tse, 0);
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::timestamp_registers_reset()
+template <class Traits>
+int MAX3133XT<Traits>::timestamp_registers_reset()
 {
     max3133x_timestamp_config_reg_t timestamp_config_reg;
-    SET_BIT_FIELD(reg_addr->timestamp_config_reg_addr, timestamp_config_reg, timestamp_config_reg.bits.tsr, 1);
+    SET_BIT_FIELD(MAX3133X_REG(timestamp_config_reg_addr), timestamp_config_reg, timestamp_config_reg.bits.tsr, 1);
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::timestamp_overwrite_config(bool enable)
+template <class Traits>
+int MAX3133XT<Traits>::timestamp_overwrite_config(bool enable)
 {
     max3133x_timestamp_config_reg_t timestamp_config_reg;
-    SET_BIT_FIELD(reg_addr->timestamp_config_reg_addr, timestamp_config_reg, timestamp_config_reg.bits.tsow, enable);
+    SET_BIT_FIELD(MAX3133X_REG(timestamp_config_reg_addr), timestamp_config_reg, timestamp_config_reg.bits.tsow, enable);
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::timestamp_overwrite_enable()
+template <class Traits>
+int MAX3133XT<Traits>::timestamp_overwrite_enable()
 {
     return timestamp_overwrite_config(1);
 }
 
-int MAX3133X::timestamp_overwrite_disable()
+template <class Traits>
+int MAX3133XT<Traits>::timestamp_overwrite_disable()
 {
     return timestamp_overwrite_config(0);
 }
 
-int MAX3133X::timestamp_record_enable(uint8_t record_enable_mask)
+template <class Traits>
+int MAX3133XT<Traits>::timestamp_record_enable(uint8_t record_enable_mask)
 {
     int ret;
     max3133x_timestamp_config_reg_t timestamp_config_reg;
@@ -772,15 +1181,16 @@ int MAX3133X::timestamp_record_enable(uint8_t record_enable_mask)
     if (record_enable_mask > (TSVLOW | TSPWM | TSDIN))
         return MAX3133X_INVALID_MASK_ERR;
 
-    ret = read_register(reg_addr->timestamp_config_reg_addr, &timestamp_config_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(timestamp_config_reg_addr), &timestamp_config_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
     timestamp_config_reg.raw |= record_enable_mask;
-    return write_register(reg_addr->timestamp_config_reg_addr, &timestamp_config_reg.raw, 1);
+    return write_register(MAX3133X_REG(timestamp_config_reg_addr), &timestamp_config_reg.raw, 1);
 }
 
-int MAX3133X::timestamp_record_disable(uint8_t record_disable_mask)
+template <class Traits>
+int MAX3133XT<Traits>::timestamp_record_disable(uint8_t record_disable_mask)
 {
     int ret;
     max3133x_timestamp_config_reg_t timestamp_config_reg;
@@ -788,12 +1198,12 @@ int MAX3133X::timestamp_record_disable(uint8_t record_disable_mask)
     if (record_disable_mask > (TSVLOW | TSPWM | TSDIN))
         return MAX3133X_INVALID_MASK_ERR;
 
-    ret = read_register(reg_addr->timestamp_config_reg_addr, &timestamp_config_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(timestamp_config_reg_addr), &timestamp_config_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
     timestamp_config_reg.raw &= ~record_disable_mask;
-    return write_register(reg_addr->timestamp_config_reg_addr, &timestamp_config_reg.raw, 1);
+    return write_register(MAX3133X_REG(timestamp_config_reg_addr), &timestamp_config_reg.raw, 1);
 }
 
 int MAX31331::timer_init(uint8_t timer_init, bool repeat, timer_freq_t freq)
@@ -801,7 +1211,7 @@ int MAX31331::timer_init(uint8_t timer_init, bool repeat, timer_freq_t freq)
     int ret;
     max3133x_timer_config_reg_t timer_config_reg;
 
-    ret = read_register(reg_addr.timer_config_reg_addr, &timer_config_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(timer_config_reg_addr), &timer_config_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
@@ -810,11 +1220,11 @@ int MAX31331::timer_init(uint8_t timer_init, bool repeat, timer_freq_t freq)
     timer_config_reg.bits.trpt = repeat ? 1 : 0;    /* Timer repeat mode */
     timer_config_reg.bits.tfs = freq;               /* Timer frequency */
 
-    ret = write_register(reg_addr.timer_config_reg_addr, &timer_config_reg.raw, 1);
+    ret = write_register(MAX3133X_REG(timer_config_reg_addr), &timer_config_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
-    return write_register(reg_addr.timer_init_reg_addr, &timer_init, 1);
+    return write_register(MAX3133X_REG(timer_init_reg_addr), &timer_init, 1);
 }
 
 int MAX31334::timer_init(uint16_t timer_init, bool repeat, timer_freq_t freq)
@@ -822,7 +1232,7 @@ int MAX31334::timer_init(uint16_t timer_init, bool repeat, timer_freq_t freq)
     int ret;
     max3133x_timer_config_reg_t timer_config_reg;
 
-    ret = read_register(reg_addr.timer_config_reg_addr, &timer_config_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(timer_config_reg_addr), &timer_config_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
@@ -831,13 +1241,13 @@ int MAX31334::timer_init(uint16_t timer_init, bool repeat, timer_freq_t freq)
     timer_config_reg.bits.trpt = repeat ? 1 : 0;    /* Timer repeat mode */
     timer_config_reg.bits.tfs = freq;               /* Timer frequency */
 
-    ret = write_register(reg_addr.timer_config_reg_addr, &timer_config_reg.raw, 1);
+    ret = write_register(MAX3133X_REG(timer_config_reg_addr), &timer_config_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
     timer_init = SWAPBYTES(timer_init);
 
-    return write_register(reg_addr.timer_init2_reg_addr, (uint8_t *)&timer_init, 2);
+    return write_register(MAX3133X_REG(timer_init2_reg_addr), (uint8_t *)&timer_init, 2);
 }
 
 int MAX31335::timer_init(uint16_t timer_init, bool repeat, timer_freq_t freq)
@@ -845,7 +1255,7 @@ int MAX31335::timer_init(uint16_t timer_init, bool repeat, timer_freq_t freq)
     int ret;
     max3133x_timer_config_reg_t timer_config_reg;
 
-    ret = read_register(reg_addr.timer_config_reg_addr, &timer_config_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(timer_config_reg_addr), &timer_config_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
@@ -854,11 +1264,16 @@ int MAX31335::timer_init(uint16_t timer_init, bool repeat, timer_freq_t freq)
     timer_config_reg.bits.trpt = repeat ? 1 : 0;    /* Timer repeat mode */
     timer_config_reg.bits.tfs = freq;               /* Timer frequency */
 
-    ret = write_register(reg_addr.timer_config_reg_addr, &timer_config_reg.raw, 1);
+    ret = write_register(MAX3133X_REG(timer_config_reg_addr), &timer_config_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
-    return write_register(reg_addr.timer_init_reg_addr, (uint8_t *)&timer_init, 1);
+    return write_register(MAX3133X_REG(timer_init_reg_addr), (uint8_t *)&timer_init, 1);
+}
+
+int MAX31331::timer_reload(uint8_t init_val)
+{
+    return write_register(MAX3133X_REG(timer_init_reg_addr), &init_val, 1);
 }
 
 int MAX31331::timer_get()
@@ -866,115 +1281,131 @@ int MAX31331::timer_get()
     int ret;
     uint8_t timer_count;
 
-    ret = read_register(reg_addr.timer_count_reg_addr, &timer_count, 1);
+    ret = read_register(MAX3133X_REG(timer_count_reg_addr), &timer_count, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
     return timer_count;
 }
 
+int MAX31334::timer_reload(uint16_t init_val)
+{
+    init_val = SWAPBYTES(init_val);
+
+    return write_register(MAX3133X_REG(timer_init2_reg_addr), (uint8_t *)&init_val, 2);
+}
+
 int MAX31334::timer_get()
 {
     int ret;
     uint16_t timer_count;
 
-    ret = read_register(reg_addr.timer_count2_reg_addr, (uint8_t *)&timer_count, 2);
+    ret = read_register(MAX3133X_REG(timer_count2_reg_addr), (uint8_t *)&timer_count, 2);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
     return SWAPBYTES(timer_count);
 }
 
+int MAX31335::timer_reload(uint8_t init_val)
+{
+    return write_register(MAX3133X_REG(timer_init_reg_addr), &init_val, 1);
+}
+
 int MAX31335::timer_get()
 {
     int ret;
     uint16_t timer_count;
 
-    ret = read_register(reg_addr.timer_count_reg_addr, (uint8_t *)&timer_count, 1);
+    ret = read_register(MAX3133X_REG(timer_count_reg_addr), (uint8_t *)&timer_count, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
     return timer_count;
 }
 
-int MAX3133X::timer_start()
+template <class Traits>
+int MAX3133XT<Traits>::timer_start()
 {
     int ret;
     max3133x_timer_config_reg_t timer_config_reg;
 
-    ret = read_register(reg_addr->timer_config_reg_addr, &timer_config_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(timer_config_reg_addr), &timer_config_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
     timer_config_reg.bits.te        = 1;
     timer_config_reg.bits.tpause    = 0;
 
-    return write_register(reg_addr->timer_config_reg_addr, &timer_config_reg.raw, 1);
+    return write_register(MAX3133X_REG(timer_config_reg_addr), &timer_config_reg.raw, 1);
 }
 
-int MAX3133X::timer_pause()
+template <class Traits>
+int MAX3133XT<Traits>::timer_pause()
 {
     int ret;
     max3133x_timer_config_reg_t timer_config_reg;
 
-    ret = read_register(reg_addr->timer_config_reg_addr, &timer_config_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(timer_config_reg_addr), &timer_config_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
     timer_config_reg.bits.te        = 1;
     timer_config_reg.bits.tpause    = 1;
 
-    return write_register(reg_addr->timer_config_reg_addr, &timer_config_reg.raw, 1);
+    return write_register(MAX3133X_REG(timer_config_reg_addr), &timer_config_reg.raw, 1);
 }
 
-int MAX3133X::timer_continue()
+template <class Traits>
+int MAX3133XT<Traits>::timer_continue()
 {
     int ret;
     max3133x_timer_config_reg_t timer_config_reg;
 
-    ret = read_register(reg_addr->timer_config_reg_addr, &timer_config_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(timer_config_reg_addr), &timer_config_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
     timer_config_reg.bits.te        = 1;
     timer_config_reg.bits.tpause    = 0;
 
-    return write_register(reg_addr->timer_config_reg_addr, &timer_config_reg.raw, 1);
+    return write_register(MAX3133X_REG(timer_config_reg_addr), &timer_config_reg.raw, 1);
 }
 
-int MAX3133X::timer_stop()
+template <class Traits>
+int MAX3133XT<Traits>::timer_stop()
 {
     int ret;
     max3133x_timer_config_reg_t timer_config_reg;
 
-    ret = read_register(reg_addr->timer_config_reg_addr, &timer_config_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(timer_config_reg_addr), &timer_config_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
     timer_config_reg.bits.te        = 0;
     timer_config_reg.bits.tpause    = 1;
 
-    return write_register(reg_addr->timer_config_reg_addr, &timer_config_reg.raw, 1);
+    return write_register(MAX3133X_REG(timer_config_reg_addr), &timer_config_reg.raw, 1);
 }
 
 int MAX31334::sleep_enter()
 {
     max31334_sleep_config_reg_t sleep_config_reg;
-    SET_BIT_FIELD(reg_addr.sleep_config_reg_addr, sleep_config_reg, sleep_config_reg.bits.slp, 1);
+    SET_BIT_FIELD(MAX3133X_REG(sleep_config_reg_addr), sleep_config_reg, sleep_config_reg.bits.slp, 1);
     return MAX3133X_NO_ERR;
 }
 
 int MAX31334::sleep_exit()
 {
     max31334_sleep_config_reg_t sleep_config_reg;
-    SET_BIT_FIELD(reg_addr.sleep_config_reg_addr, sleep_config_reg, sleep_config_reg.bits.slp, 0);
+    SET_BIT_FIELD(MAX3133X_REG(sleep_config_reg_addr), sleep_config_reg, sleep_config_reg.bits.slp, 0);
     return MAX3133X_NO_ERR;
 }
 
 int MAX31334::set_wait_state_timeout(wsto_t wsto)
 {
     max31334_sleep_config_reg_t sleep_config_reg;
-    SET_BIT_FIELD(reg_addr.sleep_config_reg_addr, sleep_config_reg, sleep_config_reg.bits.wsto, wsto);
+    SET_BIT_FIELD(MAX3133X_REG(sleep_config_reg_addr), sleep_config_reg, sleep_config_reg.bits.wsto, wsto);
     return MAX3133X_NO_ERR;
 }
 
@@ -983,7 +1414,7 @@ int MAX31334::get_wait_state_timeout(wsto_t* wsto)
     int ret;
     max31334_sleep_config_reg_t sleep_config_reg;
 
-    ret = read_register(reg_addr.sleep_config_reg_addr, &sleep_config_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(sleep_config_reg_addr), &sleep_config_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
@@ -996,12 +1427,12 @@ int MAX31334::wakeup_enable(uint8_t wakeup_enable_mask)
     int ret;
     max31334_sleep_config_reg_t sleep_config_reg;
 
-    ret = read_register(reg_addr.sleep_config_reg_addr, &sleep_config_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(sleep_config_reg_addr), &sleep_config_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
     sleep_config_reg.raw |= wakeup_enable_mask;
-    return write_register(reg_addr.sleep_config_reg_addr, &sleep_config_reg.raw, 1);
+    return write_register(MAX3133X_REG(sleep_config_reg_addr), &sleep_config_reg.raw, 1);
 }
 
 int MAX31334::wakeup_disable(uint8_t wakeup_disable_mask)
@@ -1009,37 +1440,41 @@ int MAX31334::wakeup_disable(uint8_t wakeup_disable_mask)
     int ret;
     max31334_sleep_config_reg_t sleep_config_reg;
 
-    ret = read_register(reg_addr.sleep_config_reg_addr, &sleep_config_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(sleep_config_reg_addr), &sleep_config_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
     sleep_config_reg.raw &= ~wakeup_disable_mask;
-    return write_register(reg_addr.sleep_config_reg_addr, &sleep_config_reg.raw, 1);
+    return write_register(MAX3133X_REG(sleep_config_reg_addr), &sleep_config_reg.raw, 1);
 }
 
-int MAX3133X::battery_voltage_detector_config(bool enable)
+template <class Traits>
+int MAX3133XT<Traits>::battery_voltage_detector_config(bool enable)
 {
     max3133x_pwr_mgmt_reg_t pwr_mgmt_reg;
-    SET_BIT_FIELD(reg_addr->pwr_mgmt_reg_addr, pwr_mgmt_reg, pwr_mgmt_reg.bits.en_vbat_detect, enable);
+    SET_BIT_FIELD(MAX3133X_REG(pwr_mgmt_reg_addr), pwr_mgmt_reg, pwr_mgmt_reg.bits.en_vbat_detect, enable);
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::battery_voltage_detector_enable()
+template <class Traits>
+int MAX3133XT<Traits>::battery_voltage_detector_enable()
 {
     return battery_voltage_detector_config(1);
 }
 
-int MAX3133X::battery_voltage_detector_disable()
+template <class Traits>
+int MAX3133XT<Traits>::battery_voltage_detector_disable()
 {
     return battery_voltage_detector_config(0);
 }
 
-int MAX3133X::supply_select(power_mgmt_supply_t supply)
+template <class Traits>
+int MAX3133XT<Traits>::supply_select(power_mgmt_supply_t supply)
 {
     int ret;
     max3133x_pwr_mgmt_reg_t pwr_mgmt_reg;
 
-    ret = read_register(reg_addr->pwr_mgmt_reg_addr, &pwr_mgmt_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(pwr_mgmt_reg_addr), &pwr_mgmt_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
@@ -1058,10 +1493,11 @@ int MAX3133X::supply_select(power_mgmt_supply_t supply)
             break;
     }
 
-    return write_register(reg_addr->pwr_mgmt_reg_addr, &pwr_mgmt_reg.raw, 1);
+    return write_register(MAX3133X_REG(pwr_mgmt_reg_addr), &pwr_mgmt_reg.raw, 1);
 }
 
-int MAX3133X::trickle_charger_enable(trickle_charger_ohm_t res, bool diode)
+template <class Traits>
+int MAX3133XT<Traits>::trickle_charger_enable(trickle_charger_ohm_t res, bool diode)
 {
     max3133x_trickle_reg_reg_t trickle_reg_reg;
     trickle_reg_reg.bits.trickle = res;
@@ -1071,23 +1507,25 @@ int MAX3133X::trickle_charger_enable(trickle_charger_ohm_t res, bool diode)
 
     trickle_reg_reg.bits.en_trickle = true;
 
-    return write_register(reg_addr->trickle_reg_addr, &trickle_reg_reg.raw, 1);
+    return write_register(MAX3133X_REG(trickle_reg_addr), &trickle_reg_reg.raw, 1);
 }
 
-int MAX3133X::trickle_charger_disable()
+template <class Traits>
+int MAX3133XT<Traits>::trickle_charger_disable()
 {
     max3133x_trickle_reg_reg_t trickle_reg_reg;
-    SET_BIT_FIELD(reg_addr->trickle_reg_addr, trickle_reg_reg, trickle_reg_reg.bits.en_trickle, 0);
+    SET_BIT_FIELD(MAX3133X_REG(trickle_reg_addr), trickle_reg_reg, trickle_reg_reg.bits.en_trickle, 0);
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::get_timestamp(int ts_num, timestamp_t *timestamp)
+template <class Traits>
+int MAX3133XT<Traits>::get_timestamp(int ts_num, timestamp_t *timestamp)
 {
     int ret;
     max3133x_ts_regs_t timestamp_reg;
     max3133x_ts_flags_reg_t ts_flags_reg;
     uint8_t ts_reg_addr;
-    uint8_t ts_flag_reg_addr = reg_addr->ts0_flags_reg_addr + sizeof(max3133x_ts_regs_t)*ts_num;
+    uint8_t ts_flag_reg_addr = MAX3133X_REG(ts0_flags_reg_addr) + sizeof(max3133x_ts_regs_t)*ts_num;
 
     ret = read_register(ts_flag_reg_addr, (uint8_t *)&ts_flags_reg, 1);
     if (ret != MAX3133X_NO_ERR)
@@ -1099,7 +1537,7 @@ int MAX3133X::get_timestamp(int ts_num, timestamp_t *timestamp)
     if (ts_flags_reg.raw == NOT_TRIGGERED)
         return ret;
 
-    ts_reg_addr = reg_addr->ts0_sec_1_128_reg_addr + sizeof(max3133x_ts_regs_t)*ts_num;
+    ts_reg_addr = MAX3133X_REG(ts0_sec_1_128_reg_addr) + sizeof(max3133x_ts_regs_t)*ts_num;
     ret = read_register(ts_reg_addr, (uint8_t *)&timestamp_reg, sizeof(max3133x_ts_regs_t)-1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
@@ -1108,24 +1546,53 @@ int MAX3133X::get_timestamp(int ts_num, timestamp_t *timestamp)
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::offset_configuration(int meas)
+template <class Traits>
+int MAX3133XT<Traits>::get_timestamp_hr(int ts_num, timestamp_hr_t *timestamp)
 {
-    short int offset;
-    double acc = (meas - 32768)*30.5175;
+    int ret;
+    max3133x_ts_regs_t timestamp_reg;
+    uint8_t ts_reg_addr = MAX3133X_REG(ts0_sec_1_128_reg_addr) + sizeof(max3133x_ts_regs_t)*ts_num;
+
+    if (timestamp == NULL) {
+        pr_err("timestamp is invalid!");
+        return MAX3133X_NULL_VALUE_ERR;
+    }
+
+    /* Time and flags of the record in one burst */
+    ret = read_register(ts_reg_addr, (uint8_t *)&timestamp_reg, sizeof(max3133x_ts_regs_t));
+    if (ret != MAX3133X_NO_ERR)
+        return ret;
+
+    timestamp->ts_num       = (ts_num_t)ts_num;
+    timestamp->ts_trigger   = (ts_trigger_t)(timestamp_reg.ts_flags_reg.raw & 0xF);
 
-    offset = (short int)(acc/0.477);
+    if (timestamp->ts_trigger == NOT_TRIGGERED)
+        return MAX3133X_NO_ERR;
 
-    return write_register(reg_addr->offset_high_reg_addr, (uint8_t *)&offset, 2);
+    return timestamp_regs_to_hr(&timestamp->time, &timestamp_reg);
 }
 
-int MAX3133X::oscillator_flag_config(bool enable)
+template <class Traits>
+int MAX3133XT<Traits>::oscillator_flag_config(bool enable)
 {
     max3133x_int_en_reg_t int_en_reg;
-    SET_BIT_FIELD(reg_addr->int_en_reg_addr, int_en_reg, int_en_reg.bits.dosf, !enable);
+    SET_BIT_FIELD(MAX3133X_REG(int_en_reg_addr), int_en_reg, int_en_reg.bits.dosf, !enable);
 
     return MAX3133X_NO_ERR;
 }
 
+template <class Traits>
+int MAX3133XT<Traits>::oscillator_flag_enable()
+{
+    return oscillator_flag_config(true);
+}
+
+template <class Traits>
+int MAX3133XT<Traits>::oscillator_flag_disable()
+{
+    return oscillator_flag_config(false);
+}
+
 inline void MAX3133X::to_12hr(uint8_t hr, uint8_t *hr_12, uint8_t *pm) {
     if (hr == 0) {
         *hr_12 = 12;
@@ -1194,15 +1661,15 @@ int MAX3133X::set_alarm_period(alarm_no_t alarm_no, max3133x_alarm_regs_t &regs,
 
 int MAX3133X::time_to_alarm_regs(max3133x_alarm_regs_t &regs, const struct tm *alarm_time, hour_format_t format)
 {
-    regs.sec.bcd.value = BIN2BCD(alarm_time->tm_sec);
-    regs.min.bcd.value = BIN2BCD(alarm_time->tm_min);
+    regs.sec.bcd.value = rtc_bin2bcd(alarm_time->tm_sec);
+    regs.min.bcd.value = rtc_bin2bcd(alarm_time->tm_min);
 
     if (format == HOUR24) {
-        regs.hrs.bcd_24hr.value = BIN2BCD(alarm_time->tm_hour);
+        regs.hrs.bcd_24hr.value = rtc_bin2bcd(alarm_time->tm_hour);
     } else if (format == HOUR12) {
         uint8_t hr_12, pm;
         to_12hr(alarm_time->tm_hour, &hr_12, &pm);
-        regs.hrs.bcd_12hr.value = BIN2BCD(hr_12);
+        regs.hrs.bcd_12hr.value = rtc_bin2bcd(hr_12);
         regs.hrs.bits_12hr.am_pm = pm;
     } else {
         pr_err("Invalid Hour Format!");
@@ -1210,16 +1677,16 @@ int MAX3133X::time_to_alarm_regs(max3133x_alarm_regs_t &regs, const struct tm *a
     }
 
     if (regs.day_date.bits.dy_dt_match == 0) /* Date match */
-        regs.day_date.bcd_date.value = BIN2BCD(alarm_time->tm_mday);
-    else /* Day match */
-        regs.day_date.bcd_day.value = BIN2BCD(alarm_time->tm_wday);
+        regs.day_date.bcd_date.value = rtc_bin2bcd(alarm_time->tm_mday);
+    else /* Day match, 1 to 7 as in the time registers */
+        regs.day_date.bcd_day.value = rtc_bin2bcd(alarm_time->tm_wday + 1);
 
-    regs.mon.bcd.value = BIN2BCD(alarm_time->tm_mon + 1);
+    regs.mon.bcd.value = rtc_bin2bcd(alarm_time->tm_mon + 1);
 
     if (alarm_time->tm_year >= 200) {
-        regs.year.bcd.value = BIN2BCD(alarm_time->tm_year - 200);
+        regs.year.bcd.value = rtc_bin2bcd(alarm_time->tm_year - 200);
     } else if (alarm_time->tm_year >= 100) {
-        regs.year.bcd.value = BIN2BCD(alarm_time->tm_year - 100);
+        regs.year.bcd.value = rtc_bin2bcd(alarm_time->tm_year - 100);
     } else {
         pr_err("Invalid set year!");
         return MAX3133X_INVALID_DATE_ERR;
@@ -1228,21 +1695,23 @@ int MAX3133X::time_to_alarm_regs(max3133x_alarm_regs_t &regs, const struct tm *a
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::set_alarm_regs(alarm_no_t alarm_no, const max3133x_alarm_regs_t *regs)
+template <class Traits>
+int MAX3133XT<Traits>::set_alarm_regs(alarm_no_t alarm_no, const max3133x_alarm_regs_t *regs)
 {
     uint8_t len = sizeof(max3133x_alarm_regs_t);
 
     if (alarm_no == ALARM1)
-        return write_register(reg_addr->alm1_sec_reg_addr, &regs->sec.raw, len);
+        return write_register(MAX3133X_REG(alm1_sec_reg_addr), &regs->sec.raw, len);
     else
-        return write_register(reg_addr->alm2_min_reg_addr, &regs->min.raw, len-3);
+        return write_register(MAX3133X_REG(alm2_min_reg_addr), &regs->min.raw, len-3);
 }
 
-int MAX3133X::get_rtc_time_format(hour_format_t *format)
+template <class Traits>
+int MAX3133XT<Traits>::get_rtc_time_format(hour_format_t *format)
 {
     int ret;
     max3133x_hours_reg_t hours_reg;
-    ret = read_register(reg_addr->hours_reg_addr, (uint8_t *)&hours_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(hours_reg_addr), (uint8_t *)&hours_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
@@ -1251,7 +1720,8 @@ int MAX3133X::get_rtc_time_format(hour_format_t *format)
     return MAX3133X_NO_ERR;
 }
 
-int MAX3133X::set_alarm(alarm_no_t alarm_no, const struct tm *alarm_time, alarm_period_t period)
+template <class Traits>
+int MAX3133XT<Traits>::set_alarm(alarm_no_t alarm_no, const struct tm *alarm_time, alarm_period_t period)
 {
     int ret;
     max3133x_alarm_regs_t alarm_regs;
@@ -1276,36 +1746,37 @@ int MAX3133X::set_alarm(alarm_no_t alarm_no, const struct tm *alarm_time, alarm_
 inline void MAX3133X::alarm_regs_to_time(alarm_no_t alarm_no, struct tm *alarm_time, 
                                  const max3133x_alarm_regs_t *regs, hour_format_t format)
 {
-    alarm_time->tm_min = BCD2BIN(regs->min.bcd.value);
+    alarm_time->tm_min = rtc_bcd2bin(regs->min.bcd.value);
 
     if (format == HOUR24) {
-        alarm_time->tm_hour = BCD2BIN(regs->hrs.bcd_24hr.value);
+        alarm_time->tm_hour = rtc_bcd2bin(regs->hrs.bcd_24hr.value);
     } else if (format == HOUR12) {
         if (regs->hrs.bits_12hr.am_pm) {
-            if (BCD2BIN(regs->hrs.bcd_12hr.value) < 12)
-                alarm_time->tm_hour = BCD2BIN(regs->hrs.bcd_12hr.value) + 12;
+            if (rtc_bcd2bin(regs->hrs.bcd_12hr.value) < 12)
+                alarm_time->tm_hour = rtc_bcd2bin(regs->hrs.bcd_12hr.value) + 12;
         } else {
-            if (BCD2BIN(regs->hrs.bcd_12hr.value) == 12)
-                alarm_time->tm_hour = BCD2BIN(regs->hrs.bcd_12hr.value) - 12;
+            if (rtc_bcd2bin(regs->hrs.bcd_12hr.value) == 12)
+                alarm_time->tm_hour = rtc_bcd2bin(regs->hrs.bcd_12hr.value) - 12;
         }
     }
 
     if (regs->day_date.bits.dy_dt_match == 0) { /* date */
-        alarm_time->tm_mday = BCD2BIN(regs->day_date.bcd_date.value);
+        alarm_time->tm_mday = rtc_bcd2bin(regs->day_date.bcd_date.value);
         alarm_time->tm_wday = 0;
     } else { /* day */
-        alarm_time->tm_wday = BCD2BIN(regs->day_date.bcd_day.value);
+        alarm_time->tm_wday = rtc_bcd2bin(regs->day_date.bcd_day.value) - 1;
         alarm_time->tm_mday = 0;
     }
 
     if (alarm_no == ALARM1) {
-        alarm_time->tm_sec = BCD2BIN(regs->sec.bcd.value);
-        alarm_time->tm_mon = BCD2BIN(regs->mon.bcd.value) - 1;
-        alarm_time->tm_year = BCD2BIN(regs->year.bcd.value) + 100;  /* XXX no century bit */
+        alarm_time->tm_sec = rtc_bcd2bin(regs->sec.bcd.value);
+        alarm_time->tm_mon = rtc_bcd2bin(regs->mon.bcd.value) - 1;
+        alarm_time->tm_year = rtc_bcd2bin(regs->year.bcd.value) + 100;  /* XXX no century bit */
     }
 }
 
-int MAX3133X::get_alarm(alarm_no_t alarm_no, struct tm *alarm_time, 
+template <class Traits>
+int MAX3133XT<Traits>::get_alarm(alarm_no_t alarm_no, struct tm *alarm_time, 
                         alarm_period_t *period, bool *is_enabled)
 {
     int ret;
@@ -1319,9 +1790,9 @@ int MAX3133X::get_alarm(alarm_no_t alarm_no, struct tm *alarm_time,
         return ret;
 
     if (alarm_no == ALARM1)
-        ret = read_register(reg_addr->alm1_sec_reg_addr, &alarm_regs.sec.raw, len);
+        ret = read_register(MAX3133X_REG(alm1_sec_reg_addr), &alarm_regs.sec.raw, len);
     else
-        ret = read_register(reg_addr->alm2_min_reg_addr, &alarm_regs.min.raw, len-3);
+        ret = read_register(MAX3133X_REG(alm2_min_reg_addr), &alarm_regs.min.raw, len-3);
 
     if (ret != MAX3133X_NO_ERR)
         return ret;
@@ -1349,257 +1820,287 @@ int MAX3133X::get_alarm(alarm_no_t alarm_no, struct tm *alarm_time,
         if (alarm_regs.mon.bits.am6 == 0) *period = ALARM_PERIOD_ONETIME;
     }
 
-    ret = read_register(reg_addr->int_en_reg_addr, (uint8_t *)&int_en_reg.raw, 1);
+    ret = read_register(MAX3133X_REG(int_en_reg_addr), (uint8_t *)&int_en_reg.raw, 1);
     if (ret != MAX3133X_NO_ERR)
         return ret;
 
     if (alarm_no == ALARM1)
-        *is_enabled = (int_en_reg.raw & (A1IE) == A1IE);
+        *is_enabled = ((int_en_reg.raw & A1IE) == A1IE);
     else
-        *is_enabled = (int_en_reg.raw & (A2IE) == A2IE);
+        *is_enabled = ((int_en_reg.raw & A2IE) == A2IE);
 
     return MAX3133X_NO_ERR;
 }
 
-const MAX3133X::reg_addr_t MAX31335::reg_addr = {
-/*RTC REG*/
-MAX31335_STATUS,
-MAX31335_INT_EN,
-MAX31335_STATUS2,
-MAX31335_INT_EN2,
-MAX31335_RTC_RESET,
-MAX31335_RTC_CONFIG1,
-MAX31335_RTC_CONFIG2,
-MAX31335_TIMESTAMP_CONFIG,
-MAX31335_TIMER_CONFIG,
-REG_NOT_AVAILABLE,
-MAX31335_SECONDS_1_128,
-MAX31335_SECONDS,
-MAX31335_MINUTES,
-MAX31335_HOURS,
-MAX31335_DAY,
-MAX31335_DATE,
-MAX31335_MONTH,
-MAX31335_YEAR,
-MAX31335_ALM1_SEC,
-MAX31335_ALM1_MIN,
-MAX31335_ALM1_HRS,
-MAX31335_ALM1_DAY_DATE,
-MAX31335_ALM1_MON,
-MAX31335_ALM1_YEAR,
-MAX31335_ALM2_MIN,
-MAX31335_ALM2_HRS,
-MAX31335_ALM2_DAY_DATE,
-MAX31335_TIMER_COUNT,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-MAX31335_TIMER_INIT,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-MAX31335_PWR_MGMT,
-MAX31335_TRICKLE_REG,
-MAX31335_AGING_OFFSET,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-/* TEMP_REG */
-MAX31335_TS_CONFIG,
-MAX31335_TEMP_ALM_HIGH_MSB,
-MAX31335_TEMP_ALM_HIGH_LSB,
-MAX31335_TEMP_ALM_LOW_MSB,
-MAX31335_TEMP_ALM_LOW_LSB,
-MAX31335_TEMP_DATA_MSB,
-MAX31335_TEMP_DATA_LSB,
-/*TS_RAM_REG*/
-MAX31335_TS0_SEC_1_128,
-MAX31335_TS0_SEC,
-MAX31335_TS0_MIN,
-MAX31335_TS0_HOUR,
-MAX31335_TS0_DATE,
-MAX31335_TS0_MONTH,
-MAX31335_TS0_YEAR,
-MAX31335_TS0_FLAGS,
-MAX31335_TS1_SEC_1_128,
-MAX31335_TS1_SEC,
-MAX31335_TS1_MIN,
-MAX31335_TS1_HOUR,
-MAX31335_TS1_DATE,
-MAX31335_TS1_MONTH,
-MAX31335_TS1_YEAR,
-MAX31335_TS1_FLAGS,
-MAX31335_TS2_SEC_1_128,
-MAX31335_TS2_SEC,
-MAX31335_TS2_MIN,
-MAX31335_TS2_HOUR,
-MAX31335_TS2_DATE,
-MAX31335_TS2_MONTH,
-MAX31335_TS2_YEAR,
-MAX31335_TS2_FLAGS,
-MAX31335_TS3_SEC_1_128,
-MAX31335_TS3_SEC,
-MAX31335_TS3_MIN,
-MAX31335_TS3_HOUR,
-MAX31335_TS3_DATE,
-MAX31335_TS3_MONTH,
-MAX31335_TS3_YEAR,
-MAX31335_TS3_FLAGS,
-};
-
-const MAX3133X::reg_addr_t MAX31334::reg_addr = {
-MAX31334_STATUS,
-MAX31334_INT_EN,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-MAX31334_RTC_RESET,
-MAX31334_RTC_CONFIG1,
-MAX31334_RTC_CONFIG2,
-MAX31334_TIMESTAMP_CONFIG,
-MAX31334_TIMER_CONFIG,
-MAX31334_SLEEP_CONFIG,
-MAX31334_SECONDS_1_128,
-MAX31334_SECONDS,
-MAX31334_MINUTES,
-MAX31334_HOURS,
-MAX31334_DAY,
-MAX31334_DATE,
-MAX31334_MONTH,
-MAX31334_YEAR,
-MAX31334_ALM1_SEC,
-MAX31334_ALM1_MIN,
-MAX31334_ALM1_HRS,
-MAX31334_ALM1_DAY_DATE,
-MAX31334_ALM1_MON,
-MAX31334_ALM1_YEAR,
-MAX31334_ALM2_MIN,
-MAX31334_ALM2_HRS,
-MAX31334_ALM2_DAY_DATE,
-REG_NOT_AVAILABLE,
-MAX31334_TIMER_COUNT2,
-MAX31334_TIMER_COUNT1,
-REG_NOT_AVAILABLE,
-MAX31334_TIMER_INIT2,
-MAX31334_TIMER_INIT1,
-MAX31334_PWR_MGMT,
-MAX31334_TRICKLE_REG,
-REG_NOT_AVAILABLE,
-MAX31334_OFFSET_HIGH,
-MAX31334_OFFSET_LOW,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-MAX31334_TS0_SEC_1_128,
-MAX31334_TS0_SEC,
-MAX31334_TS0_MIN,
-MAX31334_TS0_HOUR,
-MAX31334_TS0_DATE,
-MAX31334_TS0_MONTH,
-MAX31334_TS0_YEAR,
-MAX31334_TS0_FLAGS,
-MAX31334_TS1_SEC_1_128,
-MAX31334_TS1_SEC,
-MAX31334_TS1_MIN,
-MAX31334_TS1_HOUR,
-MAX31334_TS1_DATE,
-MAX31334_TS1_MONTH,
-MAX31334_TS1_YEAR,
-MAX31334_TS1_FLAGS,
-MAX31334_TS2_SEC_1_128,
-MAX31334_TS2_SEC,
-MAX31334_TS2_MIN,
-MAX31334_TS2_HOUR,
-MAX31334_TS2_DATE,
-MAX31334_TS2_MONTH,
-MAX31334_TS2_YEAR,
-MAX31334_TS2_FLAGS,
-MAX31334_TS3_SEC_1_128,
-MAX31334_TS3_SEC,
-MAX31334_TS3_MIN,
-MAX31334_TS3_HOUR,
-MAX31334_TS3_DATE,
-MAX31334_TS3_MONTH,
-MAX31334_TS3_YEAR,
-MAX31334_TS3_FLAGS,
-};
-
-const MAX3133X::reg_addr_t MAX31331::reg_addr = {
-MAX31331_STATUS,
-MAX31331_INT_EN,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-MAX31331_RTC_RESET,
-MAX31331_RTC_CONFIG1,
-MAX31331_RTC_CONFIG2,
-MAX31331_TIMESTAMP_CONFIG,
-MAX31331_TIMER_CONFIG,
-REG_NOT_AVAILABLE,
-MAX31331_SECONDS_1_128,
-MAX31331_SECONDS,
-MAX31331_MINUTES,
-MAX31331_HOURS,
-MAX31331_DAY,
-MAX31331_DATE,
-MAX31331_MONTH,
-MAX31331_YEAR,
-MAX31331_ALM1_SEC,
-MAX31331_ALM1_MIN,
-MAX31331_ALM1_HRS,
-MAX31331_ALM1_DAY_DATE,
-MAX31331_ALM1_MON,
-MAX31331_ALM1_YEAR,
-MAX31331_ALM2_MIN,
-MAX31331_ALM2_HRS,
-MAX31331_ALM2_DAY_DATE,
-MAX31331_TIMER_COUNT,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-MAX31331_TIMER_INIT,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-MAX31331_PWR_MGMT,
-MAX31331_TRICKLE_REG,
-REG_NOT_AVAILABLE,
-MAX31331_OFFSET_HIGH,
-MAX31331_OFFSET_LOW,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-REG_NOT_AVAILABLE,
-MAX31331_TS0_SEC_1_128,
-MAX31331_TS0_SEC,
-MAX31331_TS0_MIN,
-MAX31331_TS0_HOUR,
-MAX31331_TS0_DATE,
-MAX31331_TS0_MONTH,
-MAX31331_TS0_YEAR,
-MAX31331_TS0_FLAGS,
-MAX31331_TS1_SEC_1_128,
-MAX31331_TS1_SEC,
-MAX31331_TS1_MIN,
-MAX31331_TS1_HOUR,
-MAX31331_TS1_DATE,
-MAX31331_TS1_MONTH,
-MAX31331_TS1_YEAR,
-MAX31331_TS1_FLAGS,
-MAX31331_TS2_SEC_1_128,
-MAX31331_TS2_SEC,
-MAX31331_TS2_MIN,
-MAX31331_TS2_HOUR,
-MAX31331_TS2_DATE,
-MAX31331_TS2_MONTH,
-MAX31331_TS2_YEAR,
-MAX31331_TS2_FLAGS,
-MAX31331_TS3_SEC_1_128,
-MAX31331_TS3_SEC,
-MAX31331_TS3_MIN,
-MAX31331_TS3_HOUR,
-MAX31331_TS3_DATE,
-MAX31331_TS3_MONTH,
-MAX31331_TS3_YEAR,
-MAX31331_TS3_FLAGS,
-};
\ No newline at end of file
+template class MAX3133XT<max31331_traits>;
+template class MAX3133XT<max31334_traits>;
+template class MAX3133XT<max31335_traits>;
+
+/* Family API on MAX3133X, forwarded to the MAX3133XT of the part */
+#define MAX3133X_FORWARD(call)                                          \
+    switch (variant) {                                                  \
+    case MAX3133X_VARIANT_MAX31331:                                     \
+        return static_cast<MAX3133XT<max31331_traits> *>(this)->call;   \
+    case MAX3133X_VARIANT_MAX31334:                                     \
+        return static_cast<MAX3133XT<max31334_traits> *>(this)->call;   \
+    default:                                                            \
+        return static_cast<MAX3133XT<max31335_traits> *>(this)->call;   \
+    }
+
+int MAX3133X::begin(void)
+{
+    MAX3133X_FORWARD(begin())
+}
+
+int MAX3133X::get_time(struct tm *rtc_ctime, uint16_t *sub_sec)
+{
+    MAX3133X_FORWARD(get_time(rtc_ctime, sub_sec))
+}
+
+int MAX3133X::set_time(const struct tm *rtc_ctime, hour_format_t format)
+{
+    MAX3133X_FORWARD(set_time(rtc_ctime, format))
+}
+
+int MAX3133X::get_epoch(rtc_epoch_t *epoch)
+{
+    MAX3133X_FORWARD(get_epoch(epoch))
+}
+
+int MAX3133X::get_time_hr(rtc_time_hr_t *time)
+{
+    MAX3133X_FORWARD(get_time_hr(time))
+}
+
+int MAX3133X::set_epoch(rtc_epoch_t epoch)
+{
+    MAX3133X_FORWARD(set_epoch(epoch))
+}
+
+int MAX3133X::set_alarm(alarm_no_t alarm_no, const struct tm *alarm_time, alarm_period_t period)
+{
+    MAX3133X_FORWARD(set_alarm(alarm_no, alarm_time, period))
+}
+
+int MAX3133X::get_alarm(alarm_no_t alarm_no, struct tm *alarm_time, alarm_period_t *period, bool *is_enabled)
+{
+    MAX3133X_FORWARD(get_alarm(alarm_no, alarm_time, period, is_enabled))
+}
+
+int MAX3133X::get_status_reg(max3133x_status_reg_t * status_reg)
+{
+    MAX3133X_FORWARD(get_status_reg(status_reg))
+}
+
+int MAX3133X::get_interrupt_reg(max3133x_int_en_reg_t * int_en_reg)
+{
+    MAX3133X_FORWARD(get_interrupt_reg(int_en_reg))
+}
+
+int MAX3133X::interrupt_enable(uint8_t mask)
+{
+    MAX3133X_FORWARD(interrupt_enable(mask))
+}
+
+int MAX3133X::interrupt_disable(uint8_t mask)
+{
+    MAX3133X_FORWARD(interrupt_disable(mask))
+}
+
+int MAX3133X::interrupt_attach(intr_id_t id, interrupt_handler_function func, void *cb)
+{
+    MAX3133X_FORWARD(interrupt_attach(id, func, cb))
+}
+
+int MAX3133X::interrupt_detach(intr_id_t id)
+{
+    MAX3133X_FORWARD(interrupt_detach(id))
+}
+
+int MAX3133X::sw_reset_assert()
+{
+    MAX3133X_FORWARD(sw_reset_assert())
+}
+
+int MAX3133X::sw_reset_release()
+{
+    MAX3133X_FORWARD(sw_reset_release())
+}
+
+int MAX3133X::sw_reset()
+{
+    MAX3133X_FORWARD(sw_reset())
+}
+
+int MAX3133X::set_alarm1_auto_clear(a1ac_t a1ac)
+{
+    MAX3133X_FORWARD(set_alarm1_auto_clear(a1ac))
+}
+
+int MAX3133X::set_din_polarity(dip_t dip)
+{
+    MAX3133X_FORWARD(set_din_polarity(dip))
+}
+
+int MAX3133X::data_retention_mode_enter()
+{
+    MAX3133X_FORWARD(data_retention_mode_enter())
+}
+
+int MAX3133X::data_retention_mode_exit()
+{
+    MAX3133X_FORWARD(data_retention_mode_exit())
+}
+
+int MAX3133X::i2c_timeout_enable()
+{
+    MAX3133X_FORWARD(i2c_timeout_enable())
+}
+
+int MAX3133X::i2c_timeout_disable()
+{
+    MAX3133X_FORWARD(i2c_timeout_disable())
+}
+
+int MAX3133X::oscillator_enable()
+{
+    MAX3133X_FORWARD(oscillator_enable())
+}
+
+int MAX3133X::oscillator_disable()
+{
+    MAX3133X_FORWARD(oscillator_disable())
+}
+
+int MAX3133X::clkout_enable()
+{
+    MAX3133X_FORWARD(clkout_enable())
+}
+
+int MAX3133X::clkout_disable()
+{
+    MAX3133X_FORWARD(clkout_disable())
+}
+
+int MAX3133X::set_clko_freq(clko_hz_t clko_hz)
+{
+    MAX3133X_FORWARD(set_clko_freq(clko_hz))
+}
+
+int MAX3133X::get_clko_freq(clko_hz_t *clko_hz)
+{
+    MAX3133X_FORWARD(get_clko_freq(clko_hz))
+}
+
+int MAX3133X::timestamp_function_enable()
+{
+    MAX3133X_FORWARD(timestamp_function_enable())
+}
+
+int MAX3133X::timestamp_function_disable()
+{
+    MAX3133X_FORWARD(timestamp_function_disable())
+}
+
+int MAX3133X::timestamp_registers_reset()
+{
+    MAX3133X_FORWARD(timestamp_registers_reset())
+}
+
+int MAX3133X::timestamp_overwrite_enable()
+{
+    MAX3133X_FORWARD(timestamp_overwrite_enable())
+}
+
+int MAX3133X::timestamp_overwrite_disable()
+{
+    MAX3133X_FORWARD(timestamp_overwrite_disable())
+}
+
+int MAX3133X::timestamp_record_enable(uint8_t record_enable_mask)
+{
+    MAX3133X_FORWARD(timestamp_record_enable(record_enable_mask))
+}
+
+int MAX3133X::timestamp_record_disable(uint8_t record_disable_mask)
+{
+    MAX3133X_FORWARD(timestamp_record_disable(record_disable_mask))
+}
+
+int MAX3133X::timer_start()
+{
+    MAX3133X_FORWARD(timer_start())
+}
+
+int MAX3133X::timer_pause()
+{
+    MAX3133X_FORWARD(timer_pause())
+}
+
+int MAX3133X::timer_continue()
+{
+    MAX3133X_FORWARD(timer_continue())
+}
+
+int MAX3133X::timer_stop()
+{
+    MAX3133X_FORWARD(timer_stop())
+}
+
+int MAX3133X::battery_voltage_detector_enable()
+{
+    MAX3133X_FORWARD(battery_voltage_detector_enable())
+}
+
+int MAX3133X::battery_voltage_detector_disable()
+{
+    MAX3133X_FORWARD(battery_voltage_detector_disable())
+}
+
+int MAX3133X::supply_select(power_mgmt_supply_t supply)
+{
+    MAX3133X_FORWARD(supply_select(supply))
+}
+
+int MAX3133X::trickle_charger_enable(trickle_charger_ohm_t res, bool diode)
+{
+    MAX3133X_FORWARD(trickle_charger_enable(res, diode))
+}
+
+int MAX3133X::trickle_charger_disable()
+{
+    MAX3133X_FORWARD(trickle_charger_disable())
+}
+
+int MAX3133X::get_timestamp(int ts_num, timestamp_t *timestamp)
+{
+    MAX3133X_FORWARD(get_timestamp(ts_num, timestamp))
+}
+
+int MAX3133X::get_timestamp_hr(int ts_num, timestamp_hr_t *timestamp)
+{
+    MAX3133X_FORWARD(get_timestamp_hr(ts_num, timestamp))
+}
+
+int MAX3133X::offset_configuration(int meas)
+{
+    switch (variant) {
+    case MAX3133X_VARIANT_MAX31331:
+        return static_cast<MAX3133XT<max31331_traits> *>(this)->offset_configuration(meas);
+    case MAX3133X_VARIANT_MAX31334:
+        return static_cast<MAX3133XT<max31334_traits> *>(this)->offset_configuration(meas);
+    default:
+        /* No OFFSET_HIGH on MAX31335 */
+        return MAX3133X_NOT_SUPP_ERR;
+    }
+}
+
+int MAX3133X::oscillator_flag_enable()
+{
+    MAX3133X_FORWARD(oscillator_flag_enable())
+}
+
+int MAX3133X::oscillator_flag_disable()
+{
+    MAX3133X_FORWARD(oscillator_flag_disable())
+}
@@ -37,6 +37,10 @@
 #include <time.h>
 #include <Wire.h>
 #include "MAX3133X_registers.h"
+#include "MAX3133X_traits.h"
+#include <RTCCommon/RTCBusStats.h>
+#include <RTCCommon/RTCTime.h>
+#include <RTCCommon/RTCTransport.h>
 
 enum max3133x_error_codes{
     MAX3133X_NO_ERR,
@@ -52,9 +56,14 @@ enum max3133x_error_codes{
     MAX3133X_ALARM_EVERYMINUTE_NOT_SUPP_ERR = -10,
     MAX3133X_ALARM_EVERYSECOND_NOT_SUPP_ERR = -11,
     MAX3133X_I2C_BUFF_ERR                   = -12,
-    MAX3133X_I2C_END_TRANS_ERR              = -13
+    MAX3133X_I2C_END_TRANS_ERR              = -13,
+    MAX3133X_CONFIG_NOT_LOADED_ERR          = -14,
+    MAX3133X_NOT_SUPP_ERR                   = -15
 };
 
+template <class Traits>
+class MAX3133XT;
+
 class MAX3133X
 {
 public:
@@ -82,20 +91,24 @@ public:
     */
     int write_register(uint8_t reg, const uint8_t *value, uint8_t len);
 
+#if ANALOG_RTC_BUS_STATS
     /**
-    * @brief First initialization, must be call before using class function
+    * @brief Get bus counters accumulated by read_register()/write_register().
     *
+    * @param[out]   stats Copy of the counters.
     */
-    int begin(void);
+    void get_bus_stats(rtc_bus_stats_t &stats);
 
     /**
-    * @brief        Read time info from RTC.
-    *
-    * @param[out]   rtc_ctime Time info from RTC.
-    *
-    * @returns      0 on success, negative error code on failure.
+    * @brief Clear bus counters.
     */
-    int get_time(struct tm *rtc_ctime, uint16_t *sub_sec = NULL);
+    void reset_bus_stats(void);
+#endif
+
+    /**
+    * @brief Transport the device is accessed through, e.g. to set its recovery policy
+    */
+    RTCTransport *get_transport(void);
 
     /**
     * @brief Selection of 24hr-12hr hour format
@@ -105,15 +118,6 @@ public:
         HOUR12 = 1, /**< 12-Hour format */
     } hour_format_t;
 
-    /**
-    * @brief        Set time info to RTC.
-    *
-    * @param[in]    rtc_ctime Time info to be written to RTC.
-    *
-    * @returns      0 on success, negative error code on failure.
-    */
-    int set_time(const struct tm *rtc_ctime, hour_format_t format = HOUR24);
-
     /**
     * @brief Alarm periodicity selection
     */
@@ -136,47 +140,6 @@ public:
         ALARM2, /**< Alarm number 2 */
     } alarm_no_t;
 
-    /**
-    * @brief        Set an alarm condition
-    *
-    * @param[in]    alarm_no Alarm number, ALARM1 or ALARM2
-    * @param[in]    alarm_time Pointer to alarm time to be set
-    * @param[in]    period Alarm periodicity, one of ALARM_PERIOD_*
-    *
-    * @return       0 on success, error code on failure
-    */
-    int set_alarm(alarm_no_t alarm_no, const struct tm *alarm_time, alarm_period_t period);
-
-    /**
-    * @brief        Get alarm data & time
-    *
-    * @param[in]    alarm_no Alarm number, ALARM1 or ALARM2
-    * @param[out]   alarm_time Pointer to alarm time to be filled in
-    * @param[out]   period Pointer to the period of alarm, one of ALARM_PERIOD_*
-    * @param[out]   is_enabled Pointer to the state of alarm
-    *
-    * @return       0 on success, error code on failure
-    */
-    int get_alarm(alarm_no_t alarm_no, struct tm *alarm_time, alarm_period_t *period, bool *is_enabled);
-
-    /**
-     * @brief       Gets Status Register Value
-     *
-     * @param[in]   status_reg
-     *
-     * @returns     0 on success, negative error code on failure.
-     */
-    int get_status_reg(max3133x_status_reg_t * status_reg);
-
-    /**
-     * @brief       Gets Interrupt Enable Register Value
-     *
-     * @param[in]   int_en_reg
-     *
-     * @returns     0 on success, negative error code on failure.
-     */
-    int get_interrupt_reg(max3133x_int_en_reg_t * int_en_reg);
-
     /*Interrupt Enable Register Masks*/
     #define A1IE        0b00000001  /*Alarm1 interrupt mask*/
     #define A2IE        0b00000010  /*Alarm2 interrupt mask*/
@@ -189,43 +152,21 @@ public:
     #define NUM_OF_INT    6         /*Number of Interrupts*/
 
     /**
-     * @brief       Enables Interrupts
-     *
-     * @param[in]   mask
-     *
-     * @returns     0 on success, negative error code on failure.
-     */
-    int interrupt_enable(uint8_t mask);
-
-    /**
-     * @brief       Disables Interrupts
-     *
-     * @param[in]   mask
-     *
-     * @returns     0 on success, negative error code on failure.
-     */
-    int interrupt_disable(uint8_t mask);
-
-    /**
-    * @brief    Put device into reset state
-   *
-    * @return   0 on success, error code on failure
+    * @brief Interrupt sources of the STATUS register, bit positions
     */
-    int sw_reset_assert();
+    typedef enum {
+        INTR_ID_ALARM1,     /**< Alarm1 flag */
+        INTR_ID_ALARM2,     /**< Alarm2 flag */
+        INTR_ID_TIMER,      /**< Timer flag */
+        INTR_ID_DIN,        /**< Digital (DIN) flag */
+        INTR_ID_VBATLOW,    /**< VBAT low flag */
+        INTR_ID_PFAIL,      /**< Power fail flag */
+    } intr_id_t;
 
     /**
-    * @brief    Release device from state state
-    *
-    * @return   0 on success, error code on failure
+    * @brief Interrupt handler callback, cb is the pointer given to interrupt_attach()
     */
-    int sw_reset_release();
-
-    /**
-     * @brief   Resets the digital block and the I2C programmable registers except for RAM registers and RTC_reset.
-     *
-     * @returns 0 on success, negative error code on failure.
-     */
-    int sw_reset();
+    typedef void (*interrupt_handler_function)(void *cb);
 
     /**
      * @brief EN_IO Configuration
@@ -312,34 +253,533 @@ public:
     }ddb_t;
 
     /**
-     * @brief CLKOUT enable Configuration
-     *
-     * @details
-     *  - Register      : RTC_CONFIG2
-     *  - Bit Fields    : [2]
-     *  - Default       : 0x0
-     *  - Description   : CLKOUT enable
-     */
-    typedef enum{
-        INTERRUPT,
-        CLOCK_OUTPUT
-    }enclko_t;
+     * @brief CLKOUT enable Configuration
+     *
+     * @details
+     *  - Register      : RTC_CONFIG2
+     *  - Bit Fields    : [2]
+     *  - Default       : 0x0
+     *  - Description   : CLKOUT enable
+     */
+    typedef enum{
+        INTERRUPT,
+        CLOCK_OUTPUT
+    }enclko_t;
+
+    /**
+     * @brief Register Configuration
+     *
+     * @details
+     *  - Register      : RTC_CONFIG1
+     *  - Bit Fields    : [5:4]
+     *  - Default       : 0x0
+     *  - Description   : Alarm1 Auto Clear
+     */
+    typedef enum{
+        BY_READING,     /**< 0x0: Alarm1 flag and interrupt can only be cleared by reading Status register via I2C */
+        AFTER_10MS,     /**< 0x1: Alarm1 flag and interrupt are cleared ~10ms after assertion */
+        AFTER_500MS,    /**< 0x2: Alarm1 flag and interrupt are cleared ~500ms after assertion */
+        AFTER_5s        /**< 0x3: Alarm1 flag and interrupt are cleared ~5s after assertion. This option should not be used when Alarm1 is set to OncePerSec. */
+    }a1ac_t;
+
+    /**
+     * @brief Digital (DIN) interrupt polarity configuration
+     *
+     * @details
+     *  - Register      : RTC_CONFIG1
+     *  - Bit Fields    : [3]
+     *  - Default       : 0x0
+     *  - Description   : Digital (DIN) interrupt polarity
+     */
+    typedef enum{
+        FALLING_EDGE,   /**< 0x0: Interrupt triggers on falling edge of DIN input. */
+        RISING_EDGE     /**< 0x1: Interrupt triggers on rising edge of DIN input. */
+    }dip_t;
+
+    /**
+     * @brief Set output clock frequency on INTBb/CLKOUT pin Configuration
+     *
+     * @details
+     *  - Register      : RTC_CONFIG2
+     *  - Bit Fields    : [1:0]
+     *  - Default       : 0x3
+     *  - Description   : Output clock frequency on INTBb/CLKOUT pin
+     */
+    typedef enum{
+        CLKOUT_1HZ,
+        CLKOUT_64HZ,
+        CLKOUT_1024KHZ,
+        CLKOUT_32KHZ_UNCOMP
+    }clko_hz_t;
+
+    /*Timestamp Config Register Masks*/
+    #define TSVLOW  0b00100000  /*Record Timestamp on VBATLOW detection */
+    #define TSPWM   0b00010000  /*Record Timestamp on power supply switch (VCC <-> VBAT)*/
+    #define TSDIN   0b00001000  /*Record Timestamp on DIN transition. Polarity controlled by DIP bitfield in RTC_Config1 register.*/
+
+    /**
+     * @brief Timer frequency selection Configuration
+     *
+     * @details
+     *  - Register      : TIMER_CONFIG
+     *  - Bit Fields    : [1:0]
+     *  - Default       : 0x0
+     *  - Description   : Timer frequency selection
+     */
+    typedef enum {
+        TIMER_FREQ_1024HZ,  /**< 1024Hz */
+        TIMER_FREQ_256HZ,   /**< 256Hz */
+        TIMER_FREQ_64HZ,    /**< 64Hz */
+        TIMER_FREQ_16HZ,    /**< 16Hz */
+    } timer_freq_t;
+
+    /**
+    * @brief Supply voltage select.
+    */
+    typedef enum {
+        POW_MGMT_SUPPLY_SEL_AUTO,   /**< Circuit decides whether to use VCC or VBACKUP */
+        POW_MGMT_SUPPLY_SEL_VCC,    /**< Use VCC as supply */
+        POW_MGMT_SUPPLY_SEL_VBAT,   /**< Use VBAT as supply */
+    } power_mgmt_supply_t;
+
+    /**
+    * @brief Selection of charging path's resistor value
+    */
+    typedef enum {
+        TRICKLE_CHARGER_3K,     /**< 3000 Ohm */
+        TRICKLE_CHARGER_3K_2,   /**< 3000 Ohm */
+        TRICKLE_CHARGER_6K,     /**< 6000 Ohm */
+        TRICKLE_CHARGER_11K,    /**< 11000 Ohm */
+    } trickle_charger_ohm_t;
+
+    /**
+    * @brief Selection of Timestamp
+    */
+    typedef enum {
+        TS0,        /**< Timestamp 0 */
+        TS1,        /**< Timestamp 1 */
+        TS2,        /**< Timestamp 2 */
+        TS3,        /**< Timestamp 3 */
+        NUM_OF_TS   /**< Number of Timestamps */
+    } ts_num_t;
+
+    /**
+    * @brief Timestamp Triggers
+    */
+    typedef enum {
+        NOT_TRIGGERED	= 0,  /**< Not Triggered */
+        DINF			= 1,  /**< triggered by DIN transition */
+        VCCF			= 2,  /**< triggered by VBAT -> VCC switch */
+        VBATF			= 4,  /**< triggered by VCC -> VBAT switch */
+        VLOWF			= 8,  /**< triggered by VLOW detection */
+    } ts_trigger_t;
+
+    typedef struct{
+        ts_num_t     ts_num;
+        ts_trigger_t ts_trigger;
+        uint16_t     sub_sec;
+        struct tm    ctime;
+    }timestamp_t;
+
+    /**
+    * @brief Timestamp to 1/128 s, see get_timestamp_hr()
+    */
+    typedef struct{
+        ts_num_t      ts_num;
+        ts_trigger_t  ts_trigger;
+        rtc_time_hr_t time;
+    }timestamp_hr_t;
+
+    /**
+    * @brief    Staged update of the configuration block
+    *
+    * @details  RTC_CONFIG1, RTC_CONFIG2, TIMESTAMP_CONFIG and TIMER_CONFIG are adjacent on every
+    *           MAX3133X variant. load() reads the four registers in one burst, the setters only
+    *           change the RAM copy and commit() writes the span between the first and the last
+    *           changed register in one burst. Nothing is written if no register changed.
+    *
+    * @note     Fields that are not staged keep the value read by load(), reserved bits included.
+    */
+    class config_txn {
+    public:
+        typedef enum {
+            CFG_RTC_CONFIG1,
+            CFG_RTC_CONFIG2,
+            CFG_TIMESTAMP_CONFIG,
+            CFG_TIMER_CONFIG,
+            NUM_OF_CFG_REGS
+        } config_reg_t;
+
+        template <class Traits>
+        config_txn(MAX3133XT<Traits> *rtc);
+
+        /**
+        * @brief    Read the configuration block from the device, discarding staged changes.
+        *
+        * @returns  0 on success, negative error code on failure.
+        */
+        int load();
+
+        /**
+        * @brief    Write the staged changes to the device.
+        *
+        * @returns  0 on success, negative error code on failure.
+        */
+        int commit();
+
+        /**
+        * @brief    Staged raw value of a configuration register.
+        */
+        uint8_t get(config_reg_t reg) const;
+
+        /**
+        * @brief    Stage a raw value for a configuration register.
+        */
+        config_txn &set(config_reg_t reg, uint8_t value);
+
+        /**
+        * @brief    Stage the bits selected by mask, leaving the others untouched.
+        */
+        config_txn &update(config_reg_t reg, uint8_t mask, uint8_t value);
+
+        /* RTC_CONFIG1 */
+        config_txn &set_alarm1_auto_clear(a1ac_t a1ac);
+        config_txn &set_din_polarity(dip_t dip);
+        config_txn &set_data_retention(data_ret_t data_ret);
+        config_txn &set_i2c_timeout(i2c_timeout_t i2c_timeout);
+        config_txn &set_oscillator(en_osc_t en_osc);
+
+        /* RTC_CONFIG2 */
+        config_txn &set_clkout(enclko_t enclko);
+        config_txn &set_clko_freq(clko_hz_t clko_hz);
+
+        /* TIMESTAMP_CONFIG */
+        config_txn &set_timestamp_function(bool enable);
+        config_txn &set_timestamp_overwrite(bool enable);
+        config_txn &set_timestamp_record(uint8_t record_mask);
+
+        /* TIMER_CONFIG */
+        config_txn &set_timer(bool enable, bool pause, bool repeat, timer_freq_t freq);
+
+    private:
+        MAX3133X    *rtc;
+        uint8_t     base;       /* RTC_CONFIG1 address */
+        bool        loaded;
+        uint8_t     device[NUM_OF_CFG_REGS];
+        uint8_t     staged[NUM_OF_CFG_REGS];
+    };
+
+    /**
+    * @brief    Interrupt handler function, call it from the INTA pin ISR
+    *
+    * @details  Only marks the interrupt as pending, no bus access is done. The flags are
+    *           read and the attached handlers are called by post_interrupt_work().
+    */
+    void interrupt_handler();
+
+    /**
+    * @brief    True if interrupt_handler() was called since the last post_interrupt_work()
+    */
+    bool interrupt_pending() const;
+
+    /**
+    * @brief    Family API through a MAX3133X reference or pointer
+    *
+    * @details  Each call forwards to MAX3133XT of the part the object was built as, see there
+    *           for the description. Called on a part class, the MAX3133XT functions are used
+    *           directly. offset_configuration() returns MAX3133X_NOT_SUPP_ERR on MAX31335.
+    *           The interrupt handlers are serviced by post_interrupt_work() of the part class.
+    *
+    * @note     A forwarded call links the function of all three parts. Where flash counts,
+    *           hold the part class, or MAX3133XT<traits>, instead of MAX3133X.
+    */
+    int begin(void);
+    int get_time(struct tm *rtc_ctime, uint16_t *sub_sec = NULL);
+    int set_time(const struct tm *rtc_ctime, hour_format_t format = HOUR24);
+    int get_epoch(rtc_epoch_t *epoch);
+    int get_time_hr(rtc_time_hr_t *time);
+    int set_epoch(rtc_epoch_t epoch);
+    int set_alarm(alarm_no_t alarm_no, const struct tm *alarm_time, alarm_period_t period);
+    int get_alarm(alarm_no_t alarm_no, struct tm *alarm_time, alarm_period_t *period, bool *is_enabled);
+    int get_status_reg(max3133x_status_reg_t * status_reg);
+    int get_interrupt_reg(max3133x_int_en_reg_t * int_en_reg);
+    int interrupt_enable(uint8_t mask);
+    int interrupt_disable(uint8_t mask);
+    int interrupt_attach(intr_id_t id, interrupt_handler_function func, void *cb = NULL);
+    int interrupt_detach(intr_id_t id);
+    int sw_reset_assert();
+    int sw_reset_release();
+    int sw_reset();
+    int set_alarm1_auto_clear(a1ac_t a1ac);
+    int set_din_polarity(dip_t dip);
+    int data_retention_mode_enter();
+    int data_retention_mode_exit();
+    int i2c_timeout_enable();
+    int i2c_timeout_disable();
+    int oscillator_enable();
+    int oscillator_disable();
+    int clkout_enable();
+    int clkout_disable();
+    int set_clko_freq(clko_hz_t    clko_hz);
+    int get_clko_freq(clko_hz_t    *clko_hz);
+    int timestamp_function_enable();
+    int timestamp_function_disable();
+    int timestamp_registers_reset();
+    int timestamp_overwrite_enable();
+    int timestamp_overwrite_disable();
+    int timestamp_record_enable(uint8_t record_enable_mask);
+    int timestamp_record_disable(uint8_t record_disable_mask);
+    int timer_start();
+    int timer_pause();
+    int timer_continue();
+    int timer_stop();
+    int battery_voltage_detector_enable();
+    int battery_voltage_detector_disable();
+    int supply_select(power_mgmt_supply_t supply);
+    int trickle_charger_enable(trickle_charger_ohm_t res, bool diode);
+    int trickle_charger_disable();
+    int get_timestamp(int ts_num, timestamp_t *timestamp);
+    int get_timestamp_hr(int ts_num, timestamp_hr_t *timestamp);
+    int offset_configuration(int meas);
+    int oscillator_flag_enable();
+    int oscillator_flag_disable();
+
+protected:
+    /* Constructors */
+    MAX3133X(TwoWire *i2c, uint8_t i2c_addr, max3133x_variant_t variant);
+
+    MAX3133X(RTCTransport *bus, uint8_t i2c_addr, max3133x_variant_t variant);
+
+    /* Register image conversions, shared by every variant */
+    void rtc_regs_to_time(struct tm *time, const max3133x_rtc_time_regs_t *regs, uint16_t *sub_sec);
+
+    int time_to_rtc_regs(max3133x_rtc_time_regs_t *regs, const struct tm *time, hour_format_t format);
+
+    void timestamp_regs_to_time(timestamp_t *timestamp, const max3133x_ts_regs_t *timestamp_reg);
+
+    int timestamp_regs_to_hr(rtc_time_hr_t *time, const max3133x_ts_regs_t *timestamp_reg);
+
+    int time_to_alarm_regs(max3133x_alarm_regs_t &regs, const struct tm *alarm_time, hour_format_t format);
+
+    void alarm_regs_to_time(alarm_no_t alarm_no, struct tm *alarm_time, const max3133x_alarm_regs_t *regs, hour_format_t format);
+
+    int set_alarm_period(alarm_no_t alarm_no, max3133x_alarm_regs_t &regs, alarm_period_t period);
+
+    void to_12hr(uint8_t hr, uint8_t *hr_12, uint8_t *pm);
+
+    int8_t hours_reg_to_hour(const max3133x_hours_reg_t *hours_reg);
+
+    struct handler {
+        interrupt_handler_function func;
+        void *cb;
+    };
+
+    /* Call the handler of every source in flags, bit n is list[n] */
+    static void dispatch_interrupts(const handler *list, uint8_t num, uint8_t flags);
+
+    handler interrupt_handler_list[NUM_OF_INT];
+
+    volatile bool int_pending;
+
+    /* Part the object was built as, for the family API above */
+    uint8_t variant;
+
+private:
+    /* PRIVATE TYPE DECLARATIONS */
+
+    /* PRIVATE VARIABLE DECLARATIONS */
+    RTCWireTransport wire_transport;
+
+    RTCTransport *i2c_handler;
+
+    uint8_t  slave_addr;
+
+#if ANALOG_RTC_BUS_STATS
+    rtc_bus_stats_t bus_stats;
+#endif
+};
+
+/** MAX3133X family driver
+*
+* Register addresses come from the Traits type (max31331_traits, max31334_traits or
+* max31335_traits) as compile time constants. The part classes below derive from it
+* and add what only their part has.
+*/
+template <class Traits>
+class MAX3133XT : public MAX3133X
+{
+public:
+    typedef Traits traits;
+
+    MAX3133XT(TwoWire *i2c, uint8_t i2c_addr = Traits::i2c_addr) : MAX3133X(i2c, i2c_addr, Traits::variant) {}
+
+    MAX3133XT(RTCTransport *bus, uint8_t i2c_addr = Traits::i2c_addr) : MAX3133X(bus, i2c_addr, Traits::variant) {}
+
+    /**
+    * @brief First initialization, must be call before using class function
+    *
+    */
+    int begin(void);
+
+    /**
+    * @brief        Read time info from RTC.
+    *
+    * @param[out]   rtc_ctime Time info from RTC.
+    *
+    * @returns      0 on success, negative error code on failure.
+    */
+    int get_time(struct tm *rtc_ctime, uint16_t *sub_sec = NULL);
+
+    /**
+    * @brief        Set time info to RTC.
+    *
+    * @param[in]    rtc_ctime Time info to be written to RTC.
+    *
+    * @returns      0 on success, negative error code on failure.
+    */
+    int set_time(const struct tm *rtc_ctime, hour_format_t format = HOUR24);
+
+    /**
+    * @brief        Read time from RTC as Unix seconds, without struct tm.
+    *
+    * @param[out]   epoch Seconds since 1970-01-01 00:00:00, the RTC is taken as UTC.
+    *
+    * @returns      0 on success, negative error code on failure.
+    */
+    int get_epoch(rtc_epoch_t *epoch);
+
+    /**
+    * @brief        Read time from RTC as Unix seconds and 1/128 s ticks.
+    *
+    * @param[out]   time Seconds since 1970-01-01 00:00:00 and the sub-second count.
+    *
+    * @returns      0 on success, negative error code on failure.
+    *
+    * @note         No floating point is used. Convert with rtc_hr_to_ms()/rtc_hr_to_us().
+    */
+    int get_time_hr(rtc_time_hr_t *time);
+
+    /**
+    * @brief        Set time info to RTC from Unix seconds, in 24 hour format.
+    *
+    * @param[in]    epoch Seconds since 1970-01-01 00:00:00, from 2000 up to the end of 2199.
+    *
+    * @returns      0 on success, negative error code on failure.
+    */
+    int set_epoch(rtc_epoch_t epoch);
+
+    /**
+    * @brief        Set an alarm condition
+    *
+    * @param[in]    alarm_no Alarm number, ALARM1 or ALARM2
+    * @param[in]    alarm_time Pointer to alarm time to be set
+    * @param[in]    period Alarm periodicity, one of ALARM_PERIOD_*
+    *
+    * @return       0 on success, error code on failure
+    */
+    int set_alarm(alarm_no_t alarm_no, const struct tm *alarm_time, alarm_period_t period);
+
+    /**
+    * @brief        Get alarm data & time
+    *
+    * @param[in]    alarm_no Alarm number, ALARM1 or ALARM2
+    * @param[out]   alarm_time Pointer to alarm time to be filled in
+    * @param[out]   period Pointer to the period of alarm, one of ALARM_PERIOD_*
+    * @param[out]   is_enabled Pointer to the state of alarm
+    *
+    * @return       0 on success, error code on failure
+    */
+    int get_alarm(alarm_no_t alarm_no, struct tm *alarm_time, alarm_period_t *period, bool *is_enabled);
+
+    /**
+     * @brief       Gets Status Register Value
+     *
+     * @param[in]   status_reg
+     *
+     * @returns     0 on success, negative error code on failure.
+     */
+    int get_status_reg(max3133x_status_reg_t * status_reg);
+
+    /**
+     * @brief       Gets Interrupt Enable Register Value
+     *
+     * @param[in]   int_en_reg
+     *
+     * @returns     0 on success, negative error code on failure.
+     */
+    int get_interrupt_reg(max3133x_int_en_reg_t * int_en_reg);
+
+    /**
+     * @brief       Enables Interrupts
+     *
+     * @param[in]   mask
+     *
+     * @returns     0 on success, negative error code on failure.
+     */
+    int interrupt_enable(uint8_t mask);
+
+    /**
+     * @brief       Disables Interrupts
+     *
+     * @param[in]   mask
+     *
+     * @returns     0 on success, negative error code on failure.
+     */
+    int interrupt_disable(uint8_t mask);
+
+    /**
+    * @brief        Attach a handler to an interrupt source and enable the source
+    *
+    * @param[in]    id      Interrupt source
+    * @param[in]    func    Handler, called from post_interrupt_work()
+    * @param[in]    cb      Pointer passed to the handler
+    *
+    * @returns      0 on success, negative error code on failure.
+    */
+    int interrupt_attach(intr_id_t id, interrupt_handler_function func, void *cb = NULL);
+
+    /**
+    * @brief        Disable an interrupt source and detach its handler
+    *
+    * @param[in]    id      Interrupt source
+    *
+    * @returns      0 on success, negative error code on failure.
+    */
+    int interrupt_detach(intr_id_t id);
+
+    /**
+    * @brief        Post interrupt jobs after interrupt is detected.
+    *
+    * @details      Call it from the main loop. Does nothing unless interrupt_handler() ran,
+    *               otherwise reads STATUS once, which also clears the flags, and calls the
+    *               handler of every flag that is set.
+    *
+    * @param[out]   status  STATUS register as read, optional
+    *
+    * @returns      0 on success, negative error code on failure.
+    */
+    int post_interrupt_work(max3133x_status_reg_t *status = NULL);
+
+    /**
+    * @brief    Put device into reset state
+   *
+    * @return   0 on success, error code on failure
+    */
+    int sw_reset_assert();
 
     /**
-     * @brief Register Configuration
+    * @brief    Release device from state state
+    *
+    * @return   0 on success, error code on failure
+    */
+    int sw_reset_release();
+
+    /**
+     * @brief   Resets the digital block and the I2C programmable registers except for RAM registers and RTC_reset.
      *
-     * @details
-     *  - Register      : RTC_CONFIG1
-     *  - Bit Fields    : [5:4]
-     *  - Default       : 0x0
-     *  - Description   : Alarm1 Auto Clear
+     * @returns 0 on success, negative error code on failure.
      */
-    typedef enum{
-        BY_READING,     /**< 0x0: Alarm1 flag and interrupt can only be cleared by reading Status register via I2C */
-        AFTER_10MS,     /**< 0x1: Alarm1 flag and interrupt are cleared ~10ms after assertion */
-        AFTER_500MS,    /**< 0x2: Alarm1 flag and interrupt are cleared ~500ms after assertion */
-        AFTER_5s        /**< 0x3: Alarm1 flag and interrupt are cleared ~5s after assertion. This option should not be used when Alarm1 is set to OncePerSec. */
-    }a1ac_t;
+    int sw_reset();
 
     /**
      * @brief       Sets Alarm1 Auto Clear Mode
@@ -350,20 +790,6 @@ public:
      */
     int set_alarm1_auto_clear(a1ac_t a1ac);
 
-    /**
-     * @brief Digital (DIN) interrupt polarity configuration
-     *
-     * @details
-     *  - Register      : RTC_CONFIG1
-     *  - Bit Fields    : [3]
-     *  - Default       : 0x0
-     *  - Description   : Digital (DIN) interrupt polarity
-     */
-    typedef enum{
-        FALLING_EDGE,   /**< 0x0: Interrupt triggers on falling edge of DIN input. */
-        RISING_EDGE     /**< 0x1: Interrupt triggers on rising edge of DIN input. */
-    }dip_t;
-
     /**
      * @brief       Digital (DIN) interrupt polarity
      *
@@ -429,22 +855,6 @@ public:
     */
     int clkout_disable();
 
-    /**
-     * @brief Set output clock frequency on INTBb/CLKOUT pin Configuration
-     *
-     * @details
-     *  - Register      : RTC_CONFIG2
-     *  - Bit Fields    : [1:0]
-     *  - Default       : 0x3
-     *  - Description   : Output clock frequency on INTBb/CLKOUT pin
-     */
-    typedef enum{
-        CLKOUT_1HZ,
-        CLKOUT_64HZ,
-        CLKOUT_1024KHZ,
-        CLKOUT_32KHZ_UNCOMP
-    }clko_hz_t;
-
     /**
      * @brief       Set output clock frequency on INTBb/CLKOUT pin
      *
@@ -502,11 +912,6 @@ public:
     */
     int timestamp_overwrite_disable();
 
-    /*Timestamp Config Register Masks*/
-    #define TSVLOW  0b00100000  /*Record Timestamp on VBATLOW detection */
-    #define TSPWM   0b00010000  /*Record Timestamp on power supply switch (VCC <-> VBAT)*/
-    #define TSDIN   0b00001000  /*Record Timestamp on DIN transition. Polarity controlled by DIP bitfield in RTC_Config1 register.*/
-
     /**
      * @brief       Enable Timestamp Records
      *
@@ -525,22 +930,6 @@ public:
      */
     int timestamp_record_disable(uint8_t record_disable_mask);
 
-    /**
-     * @brief Timer frequency selection Configuration
-     *
-     * @details
-     *  - Register      : TIMER_CONFIG
-     *  - Bit Fields    : [1:0]
-     *  - Default       : 0x0
-     *  - Description   : Timer frequency selection
-     */
-    typedef enum {
-        TIMER_FREQ_1024HZ,  /**< 1024Hz */
-        TIMER_FREQ_256HZ,   /**< 256Hz */
-        TIMER_FREQ_64HZ,    /**< 64Hz */
-        TIMER_FREQ_16HZ,    /**< 16Hz */
-    } timer_freq_t;
-
     /**
     * @brief    Enable timer
     *
@@ -583,15 +972,6 @@ public:
     */
     int battery_voltage_detector_disable();
 
-    /**
-    * @brief Supply voltage select.
-    */
-    typedef enum {
-        POW_MGMT_SUPPLY_SEL_AUTO,   /**< Circuit decides whether to use VCC or VBACKUP */
-        POW_MGMT_SUPPLY_SEL_VCC,    /**< Use VCC as supply */
-        POW_MGMT_SUPPLY_SEL_VBAT,   /**< Use VBAT as supply */
-    } power_mgmt_supply_t;
-
     /**
     * @brief        Select device power source
     *
@@ -601,16 +981,6 @@ public:
     */
     int supply_select(power_mgmt_supply_t supply);
 
-    /**
-    * @brief Selection of charging path's resistor value
-    */
-    typedef enum {
-        TRICKLE_CHARGER_3K,     /**< 3000 Ohm */
-        TRICKLE_CHARGER_3K_2,   /**< 3000 Ohm */
-        TRICKLE_CHARGER_6K,     /**< 6000 Ohm */
-        TRICKLE_CHARGER_11K,    /**< 11000 Ohm */
-    } trickle_charger_ohm_t;
-
     /**
     * @brief        Configure trickle charger charging path, also enable it
     *
@@ -628,35 +998,6 @@ public:
     */
     int trickle_charger_disable();
 
-    /**
-    * @brief Selection of Timestamp
-    */
-    typedef enum {
-        TS0,        /**< Timestamp 0 */
-        TS1,        /**< Timestamp 1 */
-        TS2,        /**< Timestamp 2 */
-        TS3,        /**< Timestamp 3 */
-        NUM_OF_TS   /**< Number of Timestamps */
-    } ts_num_t;
-
-    /**
-    * @brief Timestamp Triggers
-    */
-    typedef enum {
-        NOT_TRIGGERED	= 0,  /**< Not Triggered */
-        DINF			= 1,  /**< triggered by DIN transition */
-        VCCF			= 2,  /**< triggered by VBAT -> VCC switch */
-        VBATF			= 4,  /**< triggered by VCC -> VBAT switch */
-        VLOWF			= 8,  /**< triggered by VLOW detection */
-    } ts_trigger_t;
-
-    typedef struct{
-        ts_num_t     ts_num;
-        ts_trigger_t ts_trigger;
-        uint16_t     sub_sec;
-        struct tm    ctime;
-    }timestamp_t;
-
     /**
     * @brief        Read Timestamp info.
     *
@@ -667,13 +1008,26 @@ public:
     */
     int get_timestamp(int ts_num, timestamp_t *timestamp);
 
+    /**
+    * @brief        Read Timestamp info as Unix seconds and 1/128 s ticks.
+    *
+    * @param[in]    ts_num Timestamp number.
+    * @param[out]   timestamp Trigger and time, the time is only set if the record was triggered.
+    *
+    * @returns      0 on success, negative error code on failure.
+    */
+    int get_timestamp_hr(int ts_num, timestamp_hr_t *timestamp);
+
     /**
     * @brief        correct the clock accuracy on your board. refer the datasheet for additional informations
     *
     * @param[in]    meas Timestamp number.
     *
     * @returns      0 on success, negative error code on failure.
+    *
+    * @note         Not available on parts without OFFSET_HIGH/OFFSET_LOW; calling it there fails to compile.
     */
+    template <class T = Traits>
     int offset_configuration(int meas);
 
     /**
@@ -690,118 +1044,17 @@ public:
      */
     int oscillator_flag_disable();
 
-protected:
-    typedef struct {
-        uint8_t     status_reg_addr;
-        uint8_t     int_en_reg_addr;
-        uint8_t     status2_reg_addr;
-        uint8_t     int_en2_reg_addr;
-        uint8_t     rtc_reset_reg_addr;
-        uint8_t     rtc_config1_reg_addr;
-        uint8_t     rtc_config2_reg_addr;
-        uint8_t     timestamp_config_reg_addr;
-        uint8_t     timer_config_reg_addr;
-        uint8_t     sleep_config_reg_addr;
-        uint8_t     seconds_1_128_reg_addr;
-        uint8_t     seconds_reg_addr;
-        uint8_t     minutes_reg_addr;
-        uint8_t     hours_reg_addr;
-        uint8_t     day_reg_addr;
-        uint8_t     date_reg_addr;
-        uint8_t     month_reg_addr;
-        uint8_t     year_reg_addr;
-        uint8_t     alm1_sec_reg_addr;
-        uint8_t     alm1_min_reg_addr;
-        uint8_t     alm1_hrs_reg_addr;
-        uint8_t     alm1_day_date_reg_addr;
-        uint8_t     alm1_mon_reg_addr;
-        uint8_t     alm1_year_reg_addr;
-        uint8_t     alm2_min_reg_addr;
-        uint8_t     alm2_hrs_reg_addr;
-        uint8_t     alm2_day_date_reg_addr;
-        uint8_t     timer_count_reg_addr;
-        uint8_t     timer_count2_reg_addr;
-        uint8_t     timer_count1_reg_addr;
-        uint8_t     timer_init_reg_addr;
-        uint8_t     timer_init2_reg_addr;
-        uint8_t     timer_init1_reg_addr;
-        uint8_t     pwr_mgmt_reg_addr;
-        uint8_t     trickle_reg_addr;
-        uint8_t     aging_offset_reg_addr;
-        uint8_t     offset_high_reg_addr;
-        uint8_t     offset_low_reg_addr;
-        uint8_t     ts_config_reg_addr;
-        uint8_t     temp_alm_high_msb_reg_addr;
-        uint8_t     temp_alm_high_lsb_reg_addr;
-        uint8_t     temp_alm_low_msb_reg_addr;
-        uint8_t     temp_alm_low_lsb_reg_addr;
-        uint8_t     temp_data_msb_reg_addr;
-        uint8_t     temp_data_lsb_reg_addr;
-        uint8_t     ts0_sec_1_128_reg_addr;
-        uint8_t     ts0_sec_reg_addr;
-        uint8_t     ts0_min_reg_addr;
-        uint8_t     ts0_hour_reg_addr;
-        uint8_t     ts0_date_reg_addr;
-        uint8_t     ts0_month_reg_addr;
-        uint8_t     ts0_year_reg_addr;
-        uint8_t     ts0_flags_reg_addr;
-        uint8_t     ts1_sec_1_128_reg_addr;
-        uint8_t     ts1_sec_reg_addr;
-        uint8_t     ts1_min_reg_addr;
-        uint8_t     ts1_hour_reg_addr;
-        uint8_t     ts1_date_reg_addr;
-        uint8_t     ts1_month_reg_addr;
-        uint8_t     ts1_year_reg_addr;
-        uint8_t     ts1_flags_reg_addr;
-        uint8_t     ts2_sec_1_128_reg_addr;
-        uint8_t     ts2_sec_reg_addr;
-        uint8_t     ts2_min_reg_addr;
-        uint8_t     ts2_hour_reg_addr;
-        uint8_t     ts2_date_reg_addr;
-        uint8_t     ts2_month_reg_addr;
-        uint8_t     ts2_year_reg_addr;
-        uint8_t     ts2_flags_reg_addr;
-        uint8_t     ts3_sec_1_128_reg_addr;
-        uint8_t     ts3_sec_reg_addr;
-        uint8_t     ts3_min_reg_addr;
-        uint8_t     ts3_hour_reg_addr;
-        uint8_t     ts3_date_reg_addr;
-        uint8_t     ts3_month_reg_addr;
-        uint8_t     ts3_year_reg_addr;
-        uint8_t     ts3_flags_reg_addr;
-    } reg_addr_t;
-
-    /* Constructors */
-    MAX3133X(const reg_addr_t *reg_addr, TwoWire *i2c, uint8_t i2c_addr = MAX3133X_I2C_ADDRESS);
-
 private:
-    /* PRIVATE TYPE DECLARATIONS */
-
-    /* PRIVATE VARIABLE DECLARATIONS */
-    TwoWire *i2c_handler;
-
-    uint8_t  slave_addr;
-
-    /* PRIVATE CONSTANT VARIABLE DECLARATIONS */
-    const reg_addr_t *reg_addr;
-
-    /* PRIVATE FUNCTION DECLARATIONS */
-    void rtc_regs_to_time(struct tm *time, const max3133x_rtc_time_regs_t *regs, uint16_t *sub_sec);
-
-    int time_to_rtc_regs(max3133x_rtc_time_regs_t *regs, const struct tm *time, hour_format_t format);
-
-    void timestamp_regs_to_time(timestamp_t *timestamp, const max3133x_ts_regs_t *timestamp_reg);
-
-    int time_to_alarm_regs(max3133x_alarm_regs_t &regs, const struct tm *alarm_time, hour_format_t format);
-
-    void alarm_regs_to_time(alarm_no_t alarm_no, struct tm *alarm_time, const max3133x_alarm_regs_t *regs, hour_format_t format);
-
-    int set_alarm_period(alarm_no_t alarm_no, max3133x_alarm_regs_t &regs, alarm_period_t period);
+    /* Burst accesses rely on these blocks being contiguous */
+    static_assert(Traits::year_reg_addr - Traits::seconds_1_128_reg_addr + 1 == sizeof(max3133x_rtc_time_regs_t),
+                  "time registers are not contiguous");
+    static_assert(Traits::timer_config_reg_addr - Traits::rtc_config1_reg_addr + 1 == config_txn::NUM_OF_CFG_REGS,
+                  "configuration registers are not contiguous");
+    static_assert(Traits::ts1_sec_1_128_reg_addr - Traits::ts0_sec_1_128_reg_addr == sizeof(max3133x_ts_regs_t),
+                  "timestamp records are not contiguous");
 
     int set_alarm_regs(alarm_no_t alarm_no, const max3133x_alarm_regs_t *regs);
 
-    void to_12hr(uint8_t hr, uint8_t *hr_12, uint8_t *pm);
-
     int get_rtc_time_format(hour_format_t *format);
 
     int data_retention_mode_config(bool enable);
@@ -817,36 +1070,33 @@ private:
     int timestamp_overwrite_config(bool enable);
 
     int oscillator_flag_config(bool enable);
+};
 
-    int8_t hours_reg_to_hour(const max3133x_hours_reg_t *hours_reg);
-
-    /**
-    * @brief    Interrupt handler function
-    */
-    void interrupt_handler();
+template <class Traits>
+MAX3133X::config_txn::config_txn(MAX3133XT<Traits> *rtc) : rtc(rtc), base(Traits::rtc_config1_reg_addr), loaded(false)
+{
+    memset(device, 0, sizeof(device));
+    memset(staged, 0, sizeof(staged));
+}
 
-    /**
-    * @brief Post interrupt jobs after interrupt is detected.
-    */
-    void post_interrupt_work();
+template <class Traits>
+template <class T>
+int MAX3133XT<Traits>::offset_configuration(int meas)
+{
+    short int offset;
+    double acc = (meas - 32768)*30.5175;
 
-    struct handler {
-        void (*func)(void *);
-        void *cb;
-    };
+    offset = (short int)(acc/0.477);
 
-    handler interrupt_handler_list[NUM_OF_INT];
-};
+    return write_register(max3133x_reg<T::offset_high_reg_addr>::value, (uint8_t *)&offset, 2);
+}
 
 /** MAX31335 Device Class
 *
 * Hold configurations for the MAX31335
 */
-class MAX31335 : public MAX3133X
+class MAX31335 : public MAX3133XT<max31335_traits>
 {
-private:
-    static const reg_addr_t reg_addr;
-
 public:
     typedef struct{
         en_io_t         en_io;      /*RTC_CONFIG1 - DIN pin enable when running on VBAT*/
@@ -892,6 +1142,17 @@ public:
     */
     int timer_init(uint16_t init_val, bool repeat, timer_freq_t freq);
 
+    /**
+    * @brief        Write the timer initial value only, the timer keeps running
+    *
+    * @param[in]    init_val Timer initial value
+    *
+    * @return       0 on success, error code on failure
+    *
+    * @note         In repeat mode the value is loaded at the next expiry.
+    */
+    int timer_reload(uint8_t init_val);
+
     /**
     * @brief    Read timer value
     *
@@ -941,18 +1202,69 @@ public:
      */
     int interrupt2_disable(uint8_t mask);
 
-    MAX31335(TwoWire *i2c, uint8_t i2c_addr = MAX31335_I2C_ADDRESS) : MAX3133X(&reg_addr, i2c, i2c_addr) {}
+    /**
+    * @brief Interrupt sources of the STATUS2 register, bit positions
+    */
+    typedef enum {
+        INTR2_ID_UNDER_TEMP,    /**< Under temperature flag */
+        INTR2_ID_OVER_TEMP,     /**< Over temperature flag */
+        INTR2_ID_TEMP_READY,    /**< Temperature ready flag */
+    } intr2_id_t;
+
+    /**
+    * @brief        Attach a handler to a STATUS2 interrupt source and enable the source
+    *
+    * @param[in]    id      Interrupt source
+    * @param[in]    func    Handler, called from post_interrupt_work()
+    * @param[in]    cb      Pointer passed to the handler
+    *
+    * @returns      0 on success, negative error code on failure.
+    */
+    int interrupt2_attach(intr2_id_t id, interrupt_handler_function func, void *cb = NULL);
+
+    /**
+    * @brief        Disable a STATUS2 interrupt source and detach its handler
+    *
+    * @param[in]    id      Interrupt source
+    *
+    * @returns      0 on success, negative error code on failure.
+    */
+    int interrupt2_detach(intr2_id_t id);
+
+    /**
+    * @brief        Post interrupt jobs after interrupt is detected.
+    *
+    * @details      Same as MAX3133XT::post_interrupt_work(), STATUS2 is read as well when a
+    *               STATUS2 handler is attached.
+    *
+    * @param[out]   status  STATUS register as read, optional
+    * @param[out]   status2 STATUS2 register as read, optional, left untouched if not read
+    *
+    * @returns      0 on success, negative error code on failure.
+    */
+    int post_interrupt_work(max3133x_status_reg_t *status = NULL, max31335_status2_reg_t *status2 = NULL);
+
+    MAX31335(TwoWire *i2c, uint8_t i2c_addr = MAX31335_I2C_ADDRESS) : MAX3133XT<max31335_traits>(i2c, i2c_addr)
+    {
+        memset(interrupt2_handler_list, 0, sizeof(interrupt2_handler_list));
+    }
+
+    MAX31335(RTCTransport *bus, uint8_t i2c_addr = MAX31335_I2C_ADDRESS) : MAX3133XT<max31335_traits>(bus, i2c_addr)
+    {
+        memset(interrupt2_handler_list, 0, sizeof(interrupt2_handler_list));
+    }
+
+private:
+    handler interrupt2_handler_list[NUM_OF_INT1];
 };
 
 /** MAX31334 Device Class
 *
 * Hold configurations for the MAX31334
 */
-class MAX31334 : public MAX3133X
+class MAX31334 : public MAX3133XT<max31334_traits>
 {
 private:
-    static const reg_addr_t reg_addr;
-
     int din_sleep_entry_config(bool enable);
 
     int din_pin_debounce_config(bool enable);
@@ -1003,6 +1315,17 @@ public:
     */
     int timer_init(uint16_t init_val, bool repeat, timer_freq_t freq);
 
+    /**
+    * @brief        Write the timer initial value only, the timer keeps running
+    *
+    * @param[in]    init_val Timer initial value
+    *
+    * @return       0 on success, error code on failure
+    *
+    * @note         In repeat mode the value is loaded at the next expiry.
+    */
+    int timer_reload(uint16_t init_val);
+
     /**
     * @brief    Read timer value
     *
@@ -1132,18 +1455,17 @@ public:
      */
     int wakeup_disable(uint8_t wakeup_disable_mask);
 
-    MAX31334(TwoWire *i2c, uint8_t i2c_addr = MAX3133X_I2C_ADDRESS) : MAX3133X(&reg_addr, i2c, i2c_addr) {}
+    MAX31334(TwoWire *i2c, uint8_t i2c_addr = MAX3133X_I2C_ADDRESS) : MAX3133XT<max31334_traits>(i2c, i2c_addr) {}
+
+    MAX31334(RTCTransport *bus, uint8_t i2c_addr = MAX3133X_I2C_ADDRESS) : MAX3133XT<max31334_traits>(bus, i2c_addr) {}
 };
 
 /** MAX31331 Device Class
 *
 * Hold configurations for the MAX31331
 */
-class MAX31331 : public MAX3133X
+class MAX31331 : public MAX3133XT<max31331_traits>
 {
-private:
-    static const reg_addr_t reg_addr;
-
 public:
     typedef struct{
         a1ac_t          a1ac;       /*RTC_CONFIG1 - Alarm1 Auto Clear */
@@ -1188,6 +1510,17 @@ public:
     */
     int timer_init(uint8_t  init_val, bool repeat, timer_freq_t freq);
 
+    /**
+    * @brief        Write the timer initial value only, the timer keeps running
+    *
+    * @param[in]    init_val Timer initial value
+    *
+    * @return       0 on success, error code on failure
+    *
+    * @note         In repeat mode the value is loaded at the next expiry.
+    */
+    int timer_reload(uint8_t init_val);
+
     /**
     * @brief    Read timer value
     *
@@ -1195,7 +1528,35 @@ public:
     */
     int timer_get();
 
-    MAX31331(TwoWire *i2c, uint8_t i2c_addr = MAX3133X_I2C_ADDRESS) : MAX3133X(&reg_addr, i2c, i2c_addr) {}
+    MAX31331(TwoWire *i2c, uint8_t i2c_addr = MAX3133X_I2C_ADDRESS) : MAX3133XT<max31331_traits>(i2c, i2c_addr) {}
+
+    MAX31331(RTCTransport *bus, uint8_t i2c_addr = MAX3133X_I2C_ADDRESS) : MAX3133XT<max31331_traits>(bus, i2c_addr) {}
 };
 
+/**
+* @brief    Status read for RTCEventQueueT, STATUS is cleared by the read
+*/
+template <class Traits>
+int rtc_event_read_status(MAX3133XT<Traits> *rtc, uint8_t *status)
+{
+    int ret;
+    max3133x_status_reg_t status_reg;
+
+    ret = rtc->get_status_reg(&status_reg);
+    if (ret != MAX3133X_NO_ERR)
+        return ret;
+
+    *status = status_reg.raw;
+    return MAX3133X_NO_ERR;
+}
+
+/**
+* @brief    Time read for RTCEventQueueT, to 1/128 s
+*/
+template <class Traits>
+int rtc_event_read_time(MAX3133XT<Traits> *rtc, rtc_time_hr_t *time)
+{
+    return rtc->get_time_hr(time);
+}
+
 #endif /* MAX3133X_HPP_ */
\ No newline at end of file
@@ -0,0 +1,317 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#ifndef MAX3133X_TRAITS_HPP_
+#define MAX3133X_TRAITS_HPP_
+
+#include "MAX3133X_registers.h"
+
+/*
+ * Register maps of the MAX3133X variants, one traits type per part.
+ *
+ * Every address is a compile time constant, so MAX3133XT<traits> encodes it
+ * as an immediate operand instead of loading it from a per-part table.
+ * Registers the part does not have are REG_NOT_AVAILABLE; reaching one
+ * through MAX3133X_REG() fails to compile.
+ */
+
+/**
+* @brief    Address of a register that must exist on the part
+*/
+template <uint8_t addr>
+struct max3133x_reg {
+    static_assert(addr != REG_NOT_AVAILABLE, "register not available on this MAX3133X variant");
+    static constexpr uint8_t value = addr;
+};
+
+/* Used inside MAX3133XT and the part classes, where 'traits' is the part's traits type */
+#define MAX3133X_REG(name)  (max3133x_reg<traits::name>::value)
+
+/**
+* @brief    Part of a traits type, lets MAX3133X reach MAX3133XT<traits> at run time
+*/
+typedef enum {
+    MAX3133X_VARIANT_MAX31331,
+    MAX3133X_VARIANT_MAX31334,
+    MAX3133X_VARIANT_MAX31335
+} max3133x_variant_t;
+
+struct max31331_traits {
+    static constexpr uint8_t i2c_addr                   = MAX3133X_I2C_ADDRESS;
+    static constexpr max3133x_variant_t variant         = MAX3133X_VARIANT_MAX31331;
+
+    static constexpr uint8_t status_reg_addr            = MAX31331_STATUS;
+    static constexpr uint8_t int_en_reg_addr            = MAX31331_INT_EN;
+    static constexpr uint8_t status2_reg_addr           = REG_NOT_AVAILABLE;
+    static constexpr uint8_t int_en2_reg_addr           = REG_NOT_AVAILABLE;
+    static constexpr uint8_t rtc_reset_reg_addr         = MAX31331_RTC_RESET;
+    static constexpr uint8_t rtc_config1_reg_addr       = MAX31331_RTC_CONFIG1;
+    static constexpr uint8_t rtc_config2_reg_addr       = MAX31331_RTC_CONFIG2;
+    static constexpr uint8_t timestamp_config_reg_addr  = MAX31331_TIMESTAMP_CONFIG;
+    static constexpr uint8_t timer_config_reg_addr      = MAX31331_TIMER_CONFIG;
+    static constexpr uint8_t sleep_config_reg_addr      = REG_NOT_AVAILABLE;
+    static constexpr uint8_t seconds_1_128_reg_addr     = MAX31331_SECONDS_1_128;
+    static constexpr uint8_t seconds_reg_addr           = MAX31331_SECONDS;
+    static constexpr uint8_t minutes_reg_addr           = MAX31331_MINUTES;
+    static constexpr uint8_t hours_reg_addr             = MAX31331_HOURS;
+    static constexpr uint8_t day_reg_addr               = MAX31331_DAY;
+    static constexpr uint8_t date_reg_addr              = MAX31331_DATE;
+    static constexpr uint8_t month_reg_addr             = MAX31331_MONTH;
+    static constexpr uint8_t year_reg_addr              = MAX31331_YEAR;
+    static constexpr uint8_t alm1_sec_reg_addr          = MAX31331_ALM1_SEC;
+    static constexpr uint8_t alm1_min_reg_addr          = MAX31331_ALM1_MIN;
+    static constexpr uint8_t alm1_hrs_reg_addr          = MAX31331_ALM1_HRS;
+    static constexpr uint8_t alm1_day_date_reg_addr     = MAX31331_ALM1_DAY_DATE;
+    static constexpr uint8_t alm1_mon_reg_addr          = MAX31331_ALM1_MON;
+    static constexpr uint8_t alm1_year_reg_addr         = MAX31331_ALM1_YEAR;
+    static constexpr uint8_t alm2_min_reg_addr          = MAX31331_ALM2_MIN;
+    static constexpr uint8_t alm2_hrs_reg_addr          = MAX31331_ALM2_HRS;
+    static constexpr uint8_t alm2_day_date_reg_addr     = MAX31331_ALM2_DAY_DATE;
+    static constexpr uint8_t timer_count_reg_addr       = MAX31331_TIMER_COUNT;
+    static constexpr uint8_t timer_count2_reg_addr      = REG_NOT_AVAILABLE;
+    static constexpr uint8_t timer_count1_reg_addr      = REG_NOT_AVAILABLE;
+    static constexpr uint8_t timer_init_reg_addr        = MAX31331_TIMER_INIT;
+    static constexpr uint8_t timer_init2_reg_addr       = REG_NOT_AVAILABLE;
+    static constexpr uint8_t timer_init1_reg_addr       = REG_NOT_AVAILABLE;
+    static constexpr uint8_t pwr_mgmt_reg_addr          = MAX31331_PWR_MGMT;
+    static constexpr uint8_t trickle_reg_addr           = MAX31331_TRICKLE_REG;
+    static constexpr uint8_t aging_offset_reg_addr      = REG_NOT_AVAILABLE;
+    static constexpr uint8_t offset_high_reg_addr       = MAX31331_OFFSET_HIGH;
+    static constexpr uint8_t offset_low_reg_addr        = MAX31331_OFFSET_LOW;
+    static constexpr uint8_t ts_config_reg_addr         = REG_NOT_AVAILABLE;
+    static constexpr uint8_t temp_alm_high_msb_reg_addr = REG_NOT_AVAILABLE;
+    static constexpr uint8_t temp_alm_high_lsb_reg_addr = REG_NOT_AVAILABLE;
+    static constexpr uint8_t temp_alm_low_msb_reg_addr  = REG_NOT_AVAILABLE;
+    static constexpr uint8_t temp_alm_low_lsb_reg_addr  = REG_NOT_AVAILABLE;
+    static constexpr uint8_t temp_data_msb_reg_addr     = REG_NOT_AVAILABLE;
+    static constexpr uint8_t temp_data_lsb_reg_addr     = REG_NOT_AVAILABLE;
+    static constexpr uint8_t ts0_sec_1_128_reg_addr     = MAX31331_TS0_SEC_1_128;
+    static constexpr uint8_t ts0_sec_reg_addr           = MAX31331_TS0_SEC;
+    static constexpr uint8_t ts0_min_reg_addr           = MAX31331_TS0_MIN;
+    static constexpr uint8_t ts0_hour_reg_addr          = MAX31331_TS0_HOUR;
+    static constexpr uint8_t ts0_date_reg_addr          = MAX31331_TS0_DATE;
+    static constexpr uint8_t ts0_month_reg_addr         = MAX31331_TS0_MONTH;
+    static constexpr uint8_t ts0_year_reg_addr          = MAX31331_TS0_YEAR;
+    static constexpr uint8_t ts0_flags_reg_addr         = MAX31331_TS0_FLAGS;
+    static constexpr uint8_t ts1_sec_1_128_reg_addr     = MAX31331_TS1_SEC_1_128;
+    static constexpr uint8_t ts1_sec_reg_addr           = MAX31331_TS1_SEC;
+    static constexpr uint8_t ts1_min_reg_addr           = MAX31331_TS1_MIN;
+    static constexpr uint8_t ts1_hour_reg_addr          = MAX31331_TS1_HOUR;
+    static constexpr uint8_t ts1_date_reg_addr          = MAX31331_TS1_DATE;
+    static constexpr uint8_t ts1_month_reg_addr         = MAX31331_TS1_MONTH;
+    static constexpr uint8_t ts1_year_reg_addr          = MAX31331_TS1_YEAR;
+    static constexpr uint8_t ts1_flags_reg_addr         = MAX31331_TS1_FLAGS;
+    static constexpr uint8_t ts2_sec_1_128_reg_addr     = MAX31331_TS2_SEC_1_128;
+    static constexpr uint8_t ts2_sec_reg_addr           = MAX31331_TS2_SEC;
+    static constexpr uint8_t ts2_min_reg_addr           = MAX31331_TS2_MIN;
+    static constexpr uint8_t ts2_hour_reg_addr          = MAX31331_TS2_HOUR;
+    static constexpr uint8_t ts2_date_reg_addr          = MAX31331_TS2_DATE;
+    static constexpr uint8_t ts2_month_reg_addr         = MAX31331_TS2_MONTH;
+    static constexpr uint8_t ts2_year_reg_addr          = MAX31331_TS2_YEAR;
+    static constexpr uint8_t ts2_flags_reg_addr         = MAX31331_TS2_FLAGS;
+    static constexpr uint8_t ts3_sec_1_128_reg_addr     = MAX31331_TS3_SEC_1_128;
+    static constexpr uint8_t ts3_sec_reg_addr           = MAX31331_TS3_SEC;
+    static constexpr uint8_t ts3_min_reg_addr           = MAX31331_TS3_MIN;
+    static constexpr uint8_t ts3_hour_reg_addr          = MAX31331_TS3_HOUR;
+    static constexpr uint8_t ts3_date_reg_addr          = MAX31331_TS3_DATE;
+    static constexpr uint8_t ts3_month_reg_addr         = MAX31331_TS3_MONTH;
+    static constexpr uint8_t ts3_year_reg_addr          = MAX31331_TS3_YEAR;
+    static constexpr uint8_t ts3_flags_reg_addr         = MAX31331_TS3_FLAGS;
+};
+
+struct max31334_traits {
+    static constexpr uint8_t i2c_addr                   = MAX3133X_I2C_ADDRESS;
+    static constexpr max3133x_variant_t variant         = MAX3133X_VARIANT_MAX31334;
+
+    static constexpr uint8_t status_reg_addr            = MAX31334_STATUS;
+    static constexpr uint8_t int_en_reg_addr            = MAX31334_INT_EN;
+    static constexpr uint8_t status2_reg_addr           = REG_NOT_AVAILABLE;
+    static constexpr uint8_t int_en2_reg_addr           = REG_NOT_AVAILABLE;
+    static constexpr uint8_t rtc_reset_reg_addr         = MAX31334_RTC_RESET;
+    static constexpr uint8_t rtc_config1_reg_addr       = MAX31334_RTC_CONFIG1;
+    static constexpr uint8_t rtc_config2_reg_addr       = MAX31334_RTC_CONFIG2;
+    static constexpr uint8_t timestamp_config_reg_addr  = MAX31334_TIMESTAMP_CONFIG;
+    static constexpr uint8_t timer_config_reg_addr      = MAX31334_TIMER_CONFIG;
+    static constexpr uint8_t sleep_config_reg_addr      = MAX31334_SLEEP_CONFIG;
+    static constexpr uint8_t seconds_1_128_reg_addr     = MAX31334_SECONDS_1_128;
+    static constexpr uint8_t seconds_reg_addr           = MAX31334_SECONDS;
+    static constexpr uint8_t minutes_reg_addr           = MAX31334_MINUTES;
+    static constexpr uint8_t hours_reg_addr             = MAX31334_HOURS;
+    static constexpr uint8_t day_reg_addr               = MAX31334_DAY;
+    static constexpr uint8_t date_reg_addr              = MAX31334_DATE;
+    static constexpr uint8_t month_reg_addr             = MAX31334_MONTH;
+    static constexpr uint8_t year_reg_addr              = MAX31334_YEAR;
+    static constexpr uint8_t alm1_sec_reg_addr          = MAX31334_ALM1_SEC;
+    static constexpr uint8_t alm1_min_reg_addr          = MAX31334_ALM1_MIN;
+    static constexpr uint8_t alm1_hrs_reg_addr          = MAX31334_ALM1_HRS;
+    static constexpr uint8_t alm1_day_date_reg_addr     = MAX31334_ALM1_DAY_DATE;
+    static constexpr uint8_t alm1_mon_reg_addr          = MAX31334_ALM1_MON;
+    static constexpr uint8_t alm1_year_reg_addr         = MAX31334_ALM1_YEAR;
+    static constexpr uint8_t alm2_min_reg_addr          = MAX31334_ALM2_MIN;
+    static constexpr uint8_t alm2_hrs_reg_addr          = MAX31334_ALM2_HRS;
+    static constexpr uint8_t alm2_day_date_reg_addr     = MAX31334_ALM2_DAY_DATE;
+    static constexpr uint8_t timer_count_reg_addr       = REG_NOT_AVAILABLE;
+    static constexpr uint8_t timer_count2_reg_addr      = MAX31334_TIMER_COUNT2;
+    static constexpr uint8_t timer_count1_reg_addr      = MAX31334_TIMER_COUNT1;
+    static constexpr uint8_t timer_init_reg_addr        = REG_NOT_AVAILABLE;
+    static constexpr uint8_t timer_init2_reg_addr       = MAX31334_TIMER_INIT2;
+    static constexpr uint8_t timer_init1_reg_addr       = MAX31334_TIMER_INIT1;
+    static constexpr uint8_t pwr_mgmt_reg_addr          = MAX31334_PWR_MGMT;
+    static constexpr uint8_t trickle_reg_addr           = MAX31334_TRICKLE_REG;
+    static constexpr uint8_t aging_offset_reg_addr      = REG_NOT_AVAILABLE;
+    static constexpr uint8_t offset_high_reg_addr       = MAX31334_OFFSET_HIGH;
+    static constexpr uint8_t offset_low_reg_addr        = MAX31334_OFFSET_LOW;
+    static constexpr uint8_t ts_config_reg_addr         = REG_NOT_AVAILABLE;
+    static constexpr uint8_t temp_alm_high_msb_reg_addr = REG_NOT_AVAILABLE;
+    static constexpr uint8_t temp_alm_high_lsb_reg_addr = REG_NOT_AVAILABLE;
+    static constexpr uint8_t temp_alm_low_msb_reg_addr  = REG_NOT_AVAILABLE;
+    static constexpr uint8_t temp_alm_low_lsb_reg_addr  = REG_NOT_AVAILABLE;
+    static constexpr uint8_t temp_data_msb_reg_addr     = REG_NOT_AVAILABLE;
+    static constexpr uint8_t temp_data_lsb_reg_addr     = REG_NOT_AVAILABLE;
+    static constexpr uint8_t ts0_sec_1_128_reg_addr     = MAX31334_TS0_SEC_1_128;
+    static constexpr uint8_t ts0_sec_reg_addr           = MAX31334_TS0_SEC;
+    static constexpr uint8_t ts0_min_reg_addr           = MAX31334_TS0_MIN;
+    static constexpr uint8_t ts0_hour_reg_addr          = MAX31334_TS0_HOUR;
+    static constexpr uint8_t ts0_date_reg_addr          = MAX31334_TS0_DATE;
+    static constexpr uint8_t ts0_month_reg_addr         = MAX31334_TS0_MONTH;
+    static constexpr uint8_t ts0_year_reg_addr          = MAX31334_TS0_YEAR;
+    static constexpr uint8_t ts0_flags_reg_addr         = MAX31334_TS0_FLAGS;
+    static constexpr uint8_t ts1_sec_1_128_reg_addr     = MAX31334_TS1_SEC_1_128;
+    static constexpr uint8_t ts1_sec_reg_addr           = MAX31334_TS1_SEC;
+    static constexpr uint8_t ts1_min_reg_addr           = MAX31334_TS1_MIN;
+    static constexpr uint8_t ts1_hour_reg_addr          = MAX31334_TS1_HOUR;
+    static constexpr uint8_t ts1_date_reg_addr          = MAX31334_TS1_DATE;
+    static constexpr uint8_t ts1_month_reg_addr         = MAX31334_TS1_MONTH;
+    static constexpr uint8_t ts1_year_reg_addr          = MAX31334_TS1_YEAR;
+    static constexpr uint8_t ts1_flags_reg_addr         = MAX31334_TS1_FLAGS;
+    static constexpr uint8_t ts2_sec_1_128_reg_addr     = MAX31334_TS2_SEC_1_128;
+    static constexpr uint8_t ts2_sec_reg_addr           = MAX31334_TS2_SEC;
+    static constexpr uint8_t ts2_min_reg_addr           = MAX31334_TS2_MIN;
+    static constexpr uint8_t ts2_hour_reg_addr          = MAX31334_TS2_HOUR;
+    static constexpr uint8_t ts2_date_reg_addr          = MAX31334_TS2_DATE;
+    static constexpr uint8_t ts2_month_reg_addr         = MAX31334_TS2_MONTH;
+    static constexpr uint8_t ts2_year_reg_addr          = MAX31334_TS2_YEAR;
+    static constexpr uint8_t ts2_flags_reg_addr         = MAX31334_TS2_FLAGS;
+    static constexpr uint8_t ts3_sec_1_128_reg_addr     = MAX31334_TS3_SEC_1_128;
+    static constexpr uint8_t ts3_sec_reg_addr           = MAX31334_TS3_SEC;
+    static constexpr uint8_t ts3_min_reg_addr           = MAX31334_TS3_MIN;
+    static constexpr uint8_t ts3_hour_reg_addr          = MAX31334_TS3_HOUR;
+    static constexpr uint8_t ts3_date_reg_addr          = MAX31334_TS3_DATE;
+    static constexpr uint8_t ts3_month_reg_addr         = MAX31334_TS3_MONTH;
+    static constexpr uint8_t ts3_year_reg_addr          = MAX31334_TS3_YEAR;
+    static constexpr uint8_t ts3_flags_reg_addr         = MAX31334_TS3_FLAGS;
+};
+
+struct max31335_traits {
+    static constexpr uint8_t i2c_addr                   = MAX31335_I2C_ADDRESS;
+    static constexpr max3133x_variant_t variant         = MAX3133X_VARIANT_MAX31335;
+
+    static constexpr uint8_t status_reg_addr            = MAX31335_STATUS;
+    static constexpr uint8_t int_en_reg_addr            = MAX31335_INT_EN;
+    static constexpr uint8_t status2_reg_addr           = MAX31335_STATUS2;
+    static constexpr uint8_t int_en2_reg_addr           = MAX31335_INT_EN2;
+    static constexpr uint8_t rtc_reset_reg_addr         = MAX31335_RTC_RESET;
+    static constexpr uint8_t rtc_config1_reg_addr       = MAX31335_RTC_CONFIG1;
+    static constexpr uint8_t rtc_config2_reg_addr       = MAX31335_RTC_CONFIG2;
+    static constexpr uint8_t timestamp_config_reg_addr  = MAX31335_TIMESTAMP_CONFIG;
+    static constexpr uint8_t timer_config_reg_addr      = MAX31335_TIMER_CONFIG;
+    static constexpr uint8_t sleep_config_reg_addr      = REG_NOT_AVAILABLE;
+    static constexpr uint8_t seconds_1_128_reg_addr     = MAX31335_SECONDS_1_128;
+    static constexpr uint8_t seconds_reg_addr           = MAX31335_SECONDS;
+    static constexpr uint8_t minutes_reg_addr           = MAX31335_MINUTES;
+    static constexpr uint8_t hours_reg_addr             = MAX31335_HOURS;
+    static constexpr uint8_t day_reg_addr               = MAX31335_DAY;
+    static constexpr uint8_t date_reg_addr              = MAX31335_DATE;
+    static constexpr uint8_t month_reg_addr             = MAX31335_MONTH;
+    static constexpr uint8_t year_reg_addr              = MAX31335_YEAR;
+    static constexpr uint8_t alm1_sec_reg_addr          = MAX31335_ALM1_SEC;
+    static constexpr uint8_t alm1_min_reg_addr          = MAX31335_ALM1_MIN;
+    static constexpr uint8_t alm1_hrs_reg_addr          = MAX31335_ALM1_HRS;
+    static constexpr uint8_t alm1_day_date_reg_addr     = MAX31335_ALM1_DAY_DATE;
+    static constexpr uint8_t alm1_mon_reg_addr          = MAX31335_ALM1_MON;
+    static constexpr uint8_t alm1_year_reg_addr         = MAX31335_ALM1_YEAR;
+    static constexpr uint8_t alm2_min_reg_addr          = MAX31335_ALM2_MIN;
+    static constexpr uint8_t alm2_hrs_reg_addr          = MAX31335_ALM2_HRS;
+    static constexpr uint8_t alm2_day_date_reg_addr     = MAX31335_ALM2_DAY_DATE;
+    static constexpr uint8_t timer_count_reg_addr       = MAX31335_TIMER_COUNT;
+    static constexpr uint8_t timer_count2_reg_addr      = REG_NOT_AVAILABLE;
+    static constexpr uint8_t timer_count1_reg_addr      = REG_NOT_AVAILABLE;
+    static constexpr uint8_t timer_init_reg_addr        = MAX31335_TIMER_INIT;
+    static constexpr uint8_t timer_init2_reg_addr       = REG_NOT_AVAILABLE;
+    static constexpr uint8_t timer_init1_reg_addr       = REG_NOT_AVAILABLE;
+    static constexpr uint8_t pwr_mgmt_reg_addr          = MAX31335_PWR_MGMT;
+    static constexpr uint8_t trickle_reg_addr           = MAX31335_TRICKLE_REG;
+    static constexpr uint8_t aging_offset_reg_addr      = MAX31335_AGING_OFFSET;
+    static constexpr uint8_t offset_high_reg_addr       = REG_NOT_AVAILABLE;
+    static constexpr uint8_t offset_low_reg_addr        = REG_NOT_AVAILABLE;
+    static constexpr uint8_t ts_config_reg_addr         = MAX31335_TS_CONFIG;
+    static constexpr uint8_t temp_alm_high_msb_reg_addr = MAX31335_TEMP_ALM_HIGH_MSB;
+    static constexpr uint8_t temp_alm_high_lsb_reg_addr = MAX31335_TEMP_ALM_HIGH_LSB;
+    static constexpr uint8_t temp_alm_low_msb_reg_addr  = MAX31335_TEMP_ALM_LOW_MSB;
+    static constexpr uint8_t temp_alm_low_lsb_reg_addr  = MAX31335_TEMP_ALM_LOW_LSB;
+    static constexpr uint8_t temp_data_msb_reg_addr     = MAX31335_TEMP_DATA_MSB;
+    static constexpr uint8_t temp_data_lsb_reg_addr     = MAX31335_TEMP_DATA_LSB;
+    static constexpr uint8_t ts0_sec_1_128_reg_addr     = MAX31335_TS0_SEC_1_128;
+    static constexpr uint8_t ts0_sec_reg_addr           = MAX31335_TS0_SEC;
+    static constexpr uint8_t ts0_min_reg_addr           = MAX31335_TS0_MIN;
+    static constexpr uint8_t ts0_hour_reg_addr          = MAX31335_TS0_HOUR;
+    static constexpr uint8_t ts0_date_reg_addr          = MAX31335_TS0_DATE;
+    static constexpr uint8_t ts0_month_reg_addr         = MAX31335_TS0_MONTH;
+    static constexpr uint8_t ts0_year_reg_addr          = MAX31335_TS0_YEAR;
+    static constexpr uint8_t ts0_flags_reg_addr         = MAX31335_TS0_FLAGS;
+    static constexpr uint8_t ts1_sec_1_128_reg_addr     = MAX31335_TS1_SEC_1_128;
+    static constexpr uint8_t ts1_sec_reg_addr           = MAX31335_TS1_SEC;
+    static constexpr uint8_t ts1_min_reg_addr           = MAX31335_TS1_MIN;
+    static constexpr uint8_t ts1_hour_reg_addr          = MAX31335_TS1_HOUR;
+    static constexpr uint8_t ts1_date_reg_addr          = MAX31335_TS1_DATE;
+    static constexpr uint8_t ts1_month_reg_addr         = MAX31335_TS1_MONTH;
+    static constexpr uint8_t ts1_year_reg_addr          = MAX31335_TS1_YEAR;
+    static constexpr uint8_t ts1_flags_reg_addr         = MAX31335_TS1_FLAGS;
+    static constexpr uint8_t ts2_sec_1_128_reg_addr     = MAX31335_TS2_SEC_1_128;
+    static constexpr uint8_t ts2_sec_reg_addr           = MAX31335_TS2_SEC;
+    static constexpr uint8_t ts2_min_reg_addr           = MAX31335_TS2_MIN;
+    static constexpr uint8_t ts2_hour_reg_addr          = MAX31335_TS2_HOUR;
+    static constexpr uint8_t ts2_date_reg_addr          = MAX31335_TS2_DATE;
+    static constexpr uint8_t ts2_month_reg_addr         = MAX31335_TS2_MONTH;
+    static constexpr uint8_t ts2_year_reg_addr          = MAX31335_TS2_YEAR;
+    static constexpr uint8_t ts2_flags_reg_addr         = MAX31335_TS2_FLAGS;
+    static constexpr uint8_t ts3_sec_1_128_reg_addr     = MAX31335_TS3_SEC_1_128;
+    static constexpr uint8_t ts3_sec_reg_addr           = MAX31335_TS3_SEC;
+    static constexpr uint8_t ts3_min_reg_addr           = MAX31335_TS3_MIN;
+    static constexpr uint8_t ts3_hour_reg_addr          = MAX31335_TS3_HOUR;
+    static constexpr uint8_t ts3_date_reg_addr          = MAX31335_TS3_DATE;
+    static constexpr uint8_t ts3_month_reg_addr         = MAX31335_TS3_MONTH;
+    static constexpr uint8_t ts3_year_reg_addr          = MAX31335_TS3_YEAR;
+    static constexpr uint8_t ts3_flags_reg_addr         = MAX31335_TS3_FLAGS;
+};
+
+#endif /* MAX3133X_TRAITS_HPP_ */
@@ -36,8 +36,9 @@
 #define GET_BIT_VAL(val, pos, mask)     ( ( (val) & mask) >> pos )
 #define SET_BIT_VAL(val, pos, mask)     ( ( ((int)val) << pos) & mask )
 
-#define BCD2BIN(val) (((val) & 15) + ((val) >> 4) * 10)
-#define BIN2BCD(val) ((((val) / 10) << 4) + (val) % 10)
+static_assert((int)MAX31342::ALARM_PERIOD_EVERYSECOND == RTC_ALARM_PERIOD_EVERYSECOND &&
+			  (int)MAX31342::ALARM_PERIOD_MONTHLY == RTC_ALARM_PERIOD_MONTHLY,
+			  "alarm_period_t must match rtc_alarm_period_t");
 
 
 #define ALL_IRQ  (	MAX31342_F_INT_EN_A1IE 	 | \
@@ -45,88 +46,18 @@
 					MAX31342_F_INT_EN_TIE 	 | \
 					MAX31342_F_INT_EN_DOSF	 )
 
-int MAX31342::read_register(uint8_t reg, uint8_t *buf, uint8_t len/*=1*/)
+/*****************************************************************************/
+MAX31342::MAX31342(TwoWire *i2c, uint8_t i2c_addr) : RTCCoreT(i2c, i2c_addr)
 {
-    int ret;
-    int counter = 0;
-
-    m_i2c->beginTransmission(m_slave_addr);
-    m_i2c->write(reg);
-
-    /*
-        stop = true, sends a stop message after transmission, releasing the I2C bus.
-        
-        stop = false, sends a restart message after transmission. 
-          The bus will not be released, which prevents another master device from transmitting between messages. 
-          This allows one master device to send multiple transmissions while in control.
-    */
-    ret = m_i2c->endTransmission(false);
-    /*
-        0:success
-        1:data too long to fit in transmit buffer
-        2:received NACK on transmit of address
-        3:received NACK on transmit of data
-        4:other error
-    */
-    if (ret != 0) {
-        m_i2c->begin(); // restart
-        return -1;
-    }
-
-    // Read    
-    m_i2c->requestFrom((char)m_slave_addr, (char)len, true);
-
-    while (m_i2c->available()) { // slave may send less than requested
-        buf[counter++] = m_i2c->read(); // receive a byte as character
-    }
-
-    //
-    if (counter != len) {
-        m_i2c->begin(); // restart
-        ret = -1;
-    }
-
-    return ret;
 }
 
-int MAX31342::write_register(uint8_t reg, const uint8_t *buf, uint8_t len/*=1*/)
+MAX31342::MAX31342(RTCTransport *bus, uint8_t i2c_addr) : RTCCoreT(bus, i2c_addr)
 {
-    int ret;
-
-    m_i2c->beginTransmission(m_slave_addr);
-    m_i2c->write(reg);
-    m_i2c->write(buf, len);
-    ret = m_i2c->endTransmission();
-    /*
-        0:success
-        1:data too long to fit in transmit buffer
-        2:received NACK on transmit of address
-        3:received NACK on transmit of data
-        4:other error
-    */
-
-    if (ret != 0) {
-        m_i2c->begin(); // restart
-    }
-
-    return ret;
-}
-
-/*****************************************************************************/
-MAX31342::MAX31342(TwoWire *i2c, uint8_t i2c_addr)
-{
-	if (i2c == NULL) {
-		while (1) {
-            ;
-        }
-	}
-	m_i2c = i2c;
-	m_slave_addr = i2c_addr;
 }
 
 void MAX31342::begin(void)
 {
-    m_i2c->begin();
+    m_bus->begin();
     
     sw_reset_release();
     rtc_start();
@@ -205,99 +136,41 @@ int MAX31342::set_configuration(reg_cfg_t cfg)
 
 int MAX31342::get_time(struct tm *time)
 {
-	int ret;
-	regs_rtc_time_t regs;
+	return core_get_time(time);
+}
 
-	if (time == NULL) {
-		return -1;
-	}
+int MAX31342::set_time(const struct tm *time)
+{
+    int ret;
 
-	ret = read_register(MAX31342_R_SECONDS, (uint8_t *) &regs, sizeof(regs));
+	ret = core_set_time(time);
 	if (ret) {
 		return ret;
 	}
 
-	/* tm_sec seconds [0,61] */
-	time->tm_sec = BCD2BIN(regs.seconds.bcd.value);
-	/* tm_min minutes [0,59] */
-	time->tm_min = BCD2BIN(regs.minutes.bcd.value);
-	/* tm_hour hour [0,23] */
-	time->tm_hour = BCD2BIN(regs.hours.bcd.value);
-	/* tm_wday day of week [0,6] (Sunday = 0) */
-	time->tm_wday = BCD2BIN(regs.day.bcd.value) - 1;
-	/* tm_mday day of month [1,31] */
-	time->tm_mday = BCD2BIN(regs.date.bcd.value);
-	/* tm_mon month of year [0,11] */
-	time->tm_mon = BCD2BIN(regs.month.bcd.value) - 1;
-
-	/* tm_year years since 2000 */
-	if (regs.month.bits.century) {
-		time->tm_year = BCD2BIN(regs.year.bcd.value) + 200;
-	} else {
-		time->tm_year = BCD2BIN(regs.year.bcd.value) + 100;
-	}
-
-	/* tm_yday day of year [0,365] */
-	time->tm_yday = 0; /* TODO */
-	/* tm_isdst daylight savings flag */
-	time->tm_isdst = 0; /* TODO */
+	return set_rtc();
+}
 
-	return ret;
+int MAX31342::get_epoch(rtc_epoch_t *epoch)
+{
+	return core_get_epoch(epoch);
 }
 
-int MAX31342::set_time(const struct tm *time)
+int MAX31342::set_epoch(rtc_epoch_t epoch)
 {
     int ret;
-	regs_rtc_time_t regs;
-
-	if (time == NULL) {
-		return -1;
-	}
 
-	/*********************************************************
-	 * +----------+------+---------------------------+-------+
-	 * | Member   | Type | Meaning                   | Range |
-	 * +----------+------+---------------------------+-------+
-	 * | tm_sec   | int  | seconds after the minute  | 0-61* |
-	 * | tm_min   | int  | minutes after the hour    | 0-59  |
-	 * | tm_hour  | int  | hours since midnight      | 0-23  |
-	 * | tm_mday  | int  | day of the month          | 1-31  |
-	 * | tm_mon   | int  | months since January      | 0-11  |
-	 * | tm_year  | int  | years since 1900          |       |
-	 * | tm_wday  | int  | days since Sunday         | 0-6   |
-	 * | tm_yday  | int  | days since January 1      | 0-365 |
-	 * | tm_isdst | int  | Daylight Saving Time flag |       |
-	 * +----------+------+---------------------------+-------+
-	 * * tm_sec is generally 0-59. The extra range is to accommodate for leap
-	 *   seconds in certain systems.
-	 *********************************************************/
-	regs.seconds.bcd.value = BIN2BCD(time->tm_sec);
-	regs.minutes.bcd.value = BIN2BCD(time->tm_min);
-	regs.hours.bcd.value= BIN2BCD(time->tm_hour);
-	regs.day.bcd.value = BIN2BCD(time->tm_wday + 1);
-	regs.date.bcd.value = BIN2BCD(time->tm_mday);
-	regs.month.bcd.value = BIN2BCD(time->tm_mon + 1);
-
-	if (time->tm_year >= 200) {
-		regs.month.bits.century = 1;
-		regs.year.bcd.value = BIN2BCD(time->tm_year - 200);
-	} else if (time->tm_year >= 100) {
-		regs.month.bits.century = 0;
-		regs.year.bcd.value = BIN2BCD(time->tm_year - 100);
-	} else {
-		//Invalid set date!
-		return -1;
-	}
-
-    ret = write_register(MAX31342_R_SECONDS, (uint8_t *)&regs, sizeof(regs));
+	ret = core_set_epoch(epoch);
 	if (ret) {
 		return ret;
 	}
 
-    
-    /*
-     *  Set RTC
-     */
+	return set_rtc();
+}
+
+int MAX31342::set_rtc(void)
+{
+    int ret;
     uint8_t val8;
 
 	/* Toggle Set_RTC bit to set RTC registers */
@@ -330,157 +203,112 @@ int MAX31342::set_time(const struct tm *time)
     return ret;
 }
 
-int MAX31342::set_alarm(alarm_no_t alarm_no, const struct tm *alarm_time, alarm_period_t period)
+int MAX31342::set_epoch_at(rtc_epoch_t epoch, uint32_t at_us, int32_t *phase_err_us)
 {
 	int ret;
-	regs_alarm_t regs;
+	uint8_t val8;
+	uint32_t trigger_us;
 
-	if (alarm_no == ALARM2) {
-		switch (period) {
-			case ALARM_PERIOD_EVERYSECOND:
-				return -1; // not support for alarm 2
-		}
+	ret = set_rtc_prepare(at_us, &val8, &trigger_us);
+	if (ret) {
+		return ret;
 	}
 
-	/*
-	 *  Set period
-	 */
-	regs.sec.bits.axm1 = 1;
-	regs.min.bits.axm2 = 1;
-	regs.hrs.bits.axm3 = 1;
-	regs.day_date.bits.axm4 = 1;
-	regs.day_date.bits.dy_dt = 1;
-
-	switch (period) {
-		case ALARM_PERIOD_EVERYSECOND:
-			// Do nothing
-			break;
-		case ALARM_PERIOD_EVERYMINUTE:
-			regs.sec.bits.axm1 = 0;
-			break;
-		case ALARM_PERIOD_HOURLY:
-			regs.sec.bits.axm1 = 0;
-			regs.min.bits.axm2 = 0;
-			break;
-		case ALARM_PERIOD_DAILY:
-			regs.sec.bits.axm1 = 0;
-			regs.min.bits.axm2 = 0;
-			regs.hrs.bits.axm3 = 0;
-			break;
-		case ALARM_PERIOD_WEEKLY:
-			regs.sec.bits.axm1 = 0;
-			regs.min.bits.axm2 = 0;
-			regs.hrs.bits.axm3 = 0;
-			regs.day_date.bits.axm4 = 0;
-			break;
-		case ALARM_PERIOD_MONTHLY:
-			regs.sec.bits.axm1 = 0;
-			regs.min.bits.axm2 = 0;
-			regs.hrs.bits.axm3 = 0;
-			regs.day_date.bits.axm4 = 0;
-			regs.day_date.bits.dy_dt = 0;
-			break;
-		default:
-			return -1;
-	}
-
-	/* 
-	 * Convert time structure to alarm registers 
-	 */
-	regs.sec.bcd.value = BIN2BCD(alarm_time->tm_sec);
-	regs.min.bcd.value = BIN2BCD(alarm_time->tm_min);
-	regs.hrs.bcd.value = BIN2BCD(alarm_time->tm_hour);
-
-	if (regs.day_date.bits.dy_dt == 0) {
-		/* Date match */
-		regs.day_date.bcd_date.value = BIN2BCD(alarm_time->tm_mday);
-	} else {
-		/* Day match */
-		regs.day_date.bcd_day.value = BIN2BCD(alarm_time->tm_wday);
-	}
-	//regs.mon.bcd.value = BIN2BCD(alarm_time->tm_mon);
+	ret = core_set_epoch(epoch);
 	if (ret) {
 		return ret;
 	}
 
-    /* 
-     *  Write Registers 
-     */
-	uint8_t *ptr_regs = (uint8_t *)&regs;
+	return set_rtc_at(val8, trigger_us, at_us, phase_err_us);
+}
 
-	if (alarm_no == ALARM1) {
-		ret = write_register(MAX31342_R_ALM1_SEC, &ptr_regs[0], sizeof(regs_alarm_t));
-	} else {
-		/* Discard sec starts from min register */
-		ret = write_register(MAX31342_R_ALM2_MIN, &ptr_regs[1], sizeof(regs_alarm_t)-1);
+int MAX31342::set_time_at(const struct tm *time, uint32_t at_us, int32_t *phase_err_us)
+{
+	int ret;
+	uint8_t val8;
+	uint32_t trigger_us;
+
+	ret = set_rtc_prepare(at_us, &val8, &trigger_us);
+	if (ret) {
+		return ret;
 	}
 
-	return ret;
+	ret = core_set_time(time);
+	if (ret) {
+		return ret;
+	}
+
+	return set_rtc_at(val8, trigger_us, at_us, phase_err_us);
 }
 
-int MAX31342::get_alarm(alarm_no_t alarm_no, struct tm *alarm_time, alarm_period_t *period, bool *is_enabled)
+int MAX31342::set_rtc_prepare(uint32_t at_us, uint8_t *cfg2, uint32_t *trigger_us)
 {
 	int ret;
-	regs_alarm_t regs;
-	uint8_t *ptr_regs = (uint8_t *)&regs;
+	uint32_t start;
+	uint32_t done;
 
-	if (alarm_no == ALARM1) {
-		ret = read_register(MAX31342_R_ALM1_SEC, &ptr_regs[0], sizeof(regs_alarm_t));
-	} else {
-		regs.sec.raw = 0;	/* zeroise second register for alarm2 */
-		/* starts from min register (no sec register) */
-		ret = read_register(MAX31342_R_ALM2_MIN, &ptr_regs[1], sizeof(regs_alarm_t)-1);
+	ret = read_register(MAX31342_R_CFG2, cfg2);
+	if (ret) {
+		return ret;
 	}
-    if (ret) {
-        return ret;
-    }
-
-    /* 
-     *  Convert alarm registers to time structure 
-     */
-	alarm_time->tm_sec = BCD2BIN(regs.sec.bcd.value);
-	alarm_time->tm_min = BCD2BIN(regs.min.bcd.value);
-	alarm_time->tm_hour = BCD2BIN(regs.hrs.bcd.value);
 
-	if (regs.day_date.bits.dy_dt == 0) { /* date */
-		alarm_time->tm_mday = BCD2BIN(regs.day_date.bcd_date.value);
-	} else { /* day */
-		alarm_time->tm_wday = BCD2BIN(regs.day_date.bcd_day.value);
+	/* Same write as the one that raises SET_RTC, timed to start that one early enough */
+	*cfg2 &= ~MAX31342_F_CFG2_SET_RTC;
+	start = micros();
+	ret = write_register(MAX31342_R_CFG2, cfg2);
+	if (ret) {
+		return ret;
 	}
-	//alarm_time->tm_mon = BCD2BIN(regs.mon.bcd.value) - 1;
-	//alarm_time->tm_year = BCD2BIN(regs.year.bcd.value) + 100;	/* XXX no century bit */
+	done = micros();
+	*trigger_us = at_us - (done - start);
 
+	/* SET_RTC stays low for 10ms, as in set_rtc(); checked before the time registers are staged */
+	if ((int32_t)(*trigger_us - done) < 10000) {
+		return -1;
+	}
 
-    /*
-     *  Find period
-     */
-	*period = (alarm_no == ALARM1) ? ALARM_PERIOD_EVERYSECOND : ALARM_PERIOD_EVERYMINUTE;
+	return 0;
+}
 
-	if ((alarm_no == ALARM1) && (regs.sec.bits.axm1 == 0)) *period = ALARM_PERIOD_EVERYMINUTE;
-	if (regs.min.bits.axm2 == 0) *period = ALARM_PERIOD_HOURLY;
-	if (regs.hrs.bits.axm3 == 0) *period = ALARM_PERIOD_DAILY;
-	if (regs.day_date.bits.axm4 == 0) *period = ALARM_PERIOD_WEEKLY;
- 	if (regs.day_date.bits.dy_dt == 0) *period = ALARM_PERIOD_MONTHLY;
-	//if ((alarm_no == ALARM1) && (regs.mon.bits.axm5 == 0)) *period = ALARM_PERIOD_YEARLY;
-	//if ((alarm_no == ALARM1) && (regs.mon.bits.axm6 == 0)) *period = ALARM_PERIOD_ONETIME;
+int MAX31342::set_rtc_at(uint8_t cfg2, uint32_t trigger_us, uint32_t at_us, int32_t *phase_err_us)
+{
+	int ret;
+	uint32_t done;
+	int32_t wait;
 
+	/* The staging only shortens the wait, SET_RTC has been low since set_rtc_prepare() */
+	while ((wait = (int32_t)(trigger_us - micros())) > 0) {
+		if (wait > 2000) {
+			delay(wait / 1000 - 1);
+		}
+	}
 
-    /*
-     *  Get enable status
-     */
- 	uint8_t val8;
-	ret = read_register(MAX31342_R_INT_EN, &val8);
+	cfg2 |= MAX31342_F_CFG2_SET_RTC;
+	ret = write_register(MAX31342_R_CFG2, &cfg2);
+	done = micros();
 	if (ret) {
 		return ret;
 	}
 
-	if (alarm_no == ALARM1) {
-		*is_enabled = (val8 & (1 << INTR_ID_ALARM1)) != 0;
-	} else {
-		*is_enabled = (val8 & (1 << INTR_ID_ALARM2)) != 0;
+	if (phase_err_us) {
+		*phase_err_us = (int32_t)(done - at_us);
 	}
 
-	return ret;
+	/* SET_RTC bit should be kept high at least 10ms */
+	delay(10);
+
+	cfg2 &= ~MAX31342_F_CFG2_SET_RTC;
+	return write_register(MAX31342_R_CFG2, &cfg2);
+}
+
+int MAX31342::set_alarm(alarm_no_t alarm_no, const struct tm *alarm_time, alarm_period_t period)
+{
+	return core_set_alarm(alarm_no == ALARM1, alarm_time, period);
+}
+
+int MAX31342::get_alarm(alarm_no_t alarm_no, struct tm *alarm_time, alarm_period_t *period, bool *is_enabled)
+{
+	return core_get_alarm(alarm_no == ALARM1, alarm_time, period, is_enabled);
 }
 
 int MAX31342::set_square_wave_frequency(sqw_out_freq_t freq)
@@ -629,6 +457,11 @@ int MAX31342::timer_init(uint8_t initial_value, bool repeat, timer_freq_t freq)
 	return ret;
 }
 
+int MAX31342::timer_reload(uint8_t value)
+{
+	return write_register(MAX31342_R_TIMER_INIT, &value, 1);
+}
+
 int MAX31342::timer_get(uint8_t &count)
 {
 	int ret;
@@ -34,6 +34,9 @@
 #define _MAX31342_H_
 
 #include <MAX31342/MAX31342_registers.h>
+#include <RTCCommon/RTCBusStats.h>
+#include <RTCCommon/RTCCore.h>
+#include <RTCCommon/RTCTransport.h>
 
 #include <Arduino.h>
 #include <Wire.h>
@@ -43,7 +46,20 @@
 #define MAX31342_DRV_VERSION        "v1.0.0"
 
 
-class MAX31342
+/**
+* @brief	MAX31342 register map for the shared time and alarm code
+*/
+struct max31342_core_regs {
+	static constexpr uint8_t time       = MAX31342_R_SECONDS;
+	static constexpr uint8_t alarm1     = MAX31342_R_ALM1_SEC;
+	static constexpr uint8_t alarm2     = MAX31342_R_ALM2_MIN;
+	static constexpr uint8_t alarm_en   = MAX31342_R_INT_EN;
+	static constexpr bool    alarm_ext  = false;
+	static constexpr bool    time_latch = true;
+	static constexpr bool    status_rc  = true;
+};
+
+class MAX31342 : public RTCCoreT<MAX31342, max31342_core_regs>
 {
 public:
 	/**
@@ -207,6 +223,14 @@ public:
 	* @param[in]	i2c_addr slave addr
 	*/
 	MAX31342(TwoWire *i2c, uint8_t i2c_addr);
+
+	/**
+	* @brief	Constructor for a device behind a custom bus transport.
+	*
+	* @param[in]	bus Transport the device is attached to.
+	* @param[in]	i2c_addr slave addr
+	*/
+	MAX31342(RTCTransport *bus, uint8_t i2c_addr);
     
     /**
 	* @brief  First initialization, must be called before using class function
@@ -268,6 +292,51 @@ public:
 	*/
 	int set_time(const struct tm *rtc_ctime);
 
+	/**
+	* @brief		Read time from RTC as Unix seconds, without struct tm.
+	*
+	* @param[out]	epoch Seconds since 1970-01-01 00:00:00, the RTC is taken as UTC.
+	*
+	* @returns		0 on success, negative error code on failure.
+	*/
+	int get_epoch(rtc_epoch_t *epoch);
+
+	/**
+	* @brief		Set time info to RTC from Unix seconds.
+	*
+	* @param[in]	epoch Seconds since 1970-01-01 00:00:00, from 2000 up to the end of 2199.
+	*
+	* @returns		0 on success, negative error code on failure.
+	*/
+	int set_epoch(rtc_epoch_t epoch);
+
+	/**
+	* @brief		Set time info to RTC so that its second starts at a given micros() instant.
+	*
+	* @details		The time registers are staged first. The SET_RTC write that loads them is
+	*				then started early by the duration of an identical CFG2 write measured
+	*				just before, so that it completes at at_us. E.g. on a GPS PPS interrupt at
+	*				t, set_epoch_at(gps_epoch + 1, t + 1000000). at_us must leave 10ms plus
+	*				one CFG2 write when the call starts; this is checked before anything is
+	*				staged. The part adds its own synchronization delay after SET_RTC, below
+	*				10ms with the internal oscillator.
+	*
+	* @param[in]	epoch Seconds since 1970-01-01 00:00:00 at at_us.
+	* @param[in]	at_us micros() instant at which the second starts.
+	* @param[out]	phase_err_us Measured end of the SET_RTC write minus at_us, may be NULL.
+	*
+	* @returns		0 on success, -1 if at_us is less than 10ms plus one CFG2 write away or
+	*				past (no time register is written), error code on failure.
+	*/
+	int set_epoch_at(rtc_epoch_t epoch, uint32_t at_us, int32_t *phase_err_us = NULL);
+
+	/**
+	* @brief		Set time info to RTC so that its second starts at a given micros() instant.
+	*
+	* @details		See set_epoch_at().
+	*/
+	int set_time_at(const struct tm *rtc_ctime, uint32_t at_us, int32_t *phase_err_us = NULL);
+
 	/**
 	* @brief		Set an alarm condition
 	*
@@ -363,6 +432,17 @@ public:
 	*/
 	int timer_init(uint8_t value, bool repeat, timer_freq_t freq);
 
+	/**
+	* @brief		Write the timer initial value only, the timer keeps running
+	*
+	* @param[in]	value Timer initial value
+	*
+	* @return		0 on success, error code on failure
+	*
+	* @note			In repeat mode the value is loaded at the next expiry.
+	*/
+	int timer_reload(uint8_t value);
+
 	/**
 	* @brief	Read timer value
 	*
@@ -461,28 +541,6 @@ public:
 	*/
 	int rtc_stop();
 
-    /**
-	* @brief		Read from a register.
-	*
-	* @param[in]	reg Address of a register to be read.
-	* @param[out]	value Pointer to save result value.
-	* @param[in]	len Size of result to be read.
-	*
-	* @returns		0 on success, negative error code on failure.
-	*/
-	int read_register(uint8_t reg, uint8_t *dst, uint8_t len=1);
-
-	/**
-	* @brief		Write to a register.
-	*
-	* @param[in]	reg Address of a register to be written.
-	* @param[out]	value Pointer of value to be written to register.
-	* @param[in]	len Size of result to be written.
-	*
-	* @returns		0 on success, negative error code on failure.
-	*/
-	int write_register(uint8_t reg, const uint8_t *src, uint8_t len=1);
-
 private:
 	typedef struct {
 	    union {
@@ -636,10 +694,16 @@ private:
 	    } day_date;
 	} regs_alarm_t;
 
-	TwoWire *m_i2c;
-	uint8_t m_slave_addr;
-
 	int set_clock_sync_delay(sync_delay_t delay);
+
+	/* Toggle SET_RTC to load the time registers into the counter */
+	int set_rtc(void);
+
+	/* Lower SET_RTC, measure that write and check at_us leaves the 10ms low time */
+	int set_rtc_prepare(uint32_t at_us, uint8_t *cfg2, uint32_t *trigger_us);
+
+	/* Raise SET_RTC so that the write completes at at_us */
+	int set_rtc_at(uint8_t cfg2, uint32_t trigger_us, uint32_t at_us, int32_t *phase_err_us);
 };
 
 #endif /* _MAX31342_H_ */
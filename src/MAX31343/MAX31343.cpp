@@ -37,9 +37,11 @@
 #define GET_BIT_VAL(val, pos, mask)     ( ( (val) & mask) >> pos )
 #define SET_BIT_VAL(val, pos, mask)     ( ( ((int)val) << pos) & mask )
 
-#define BCD2BIN(val) (((val) & 15) + ((val) >> 4) * 10)
-#define BIN2BCD(val) ((((val) / 10) << 4) + (val) % 10)
 
+static_assert((int)MAX31343::ALARM_PERIOD_EVERYSECOND == RTC_ALARM_PERIOD_EVERYSECOND &&
+			  (int)MAX31343::ALARM_PERIOD_MONTHLY == RTC_ALARM_PERIOD_MONTHLY &&
+			  (int)MAX31343::ALARM_PERIOD_ONETIME == RTC_ALARM_PERIOD_ONETIME,
+			  "alarm_period_t must match rtc_alarm_period_t");
 
 #define ALL_IRQ  (	MAX31343_F_INT_EN_A1IE 	 | \
 					MAX31343_F_INT_EN_A2IE 	 | \
@@ -52,86 +54,142 @@
 int MAX31343::read_register(uint8_t reg, uint8_t *buf, uint8_t len/*=1*/)
 {
     int ret;
-    int counter = 0;
-
-    m_i2c->beginTransmission(m_slave_addr);
-    m_i2c->write(reg);
-
-    /*
-        stop = true, sends a stop message after transmission, releasing the I2C bus.
-        
-        stop = false, sends a restart message after transmission. 
-          The bus will not be released, which prevents another master device from transmitting between messages. 
-          This allows one master device to send multiple transmissions while in control.
-    */
-    ret = m_i2c->endTransmission(false);
-    /*
-        0:success
-        1:data too long to fit in transmit buffer
-        2:received NACK on transmit of address
-        3:received NACK on transmit of data
-        4:other error
-    */
+
+    ret = RTCCore::read_register(reg, buf, len);
     if (ret != 0) {
-        m_i2c->begin(); // restart
-        return -1;
+        return ret;
     }
 
-    // Read    
-    m_i2c->requestFrom((char)m_slave_addr, (char)len, true);
+    shadow_update(reg, buf, len);
+
+    return ret;
+}
 
-    while (m_i2c->available()) { // slave may send less than requested
-        buf[counter++] = m_i2c->read(); // receive a byte as character
+int MAX31343::write_register(uint8_t reg, const uint8_t *buf, uint8_t len/*=1*/)
+{
+    int ret;
+
+    ret = RTCCore::write_register(reg, buf, len);
+
+    return shadow_written(reg, buf, len, ret);
+}
+
+int MAX31343::shadow_index(uint8_t reg)
+{
+    switch (reg) {
+    case MAX31343_R_INT_EN:       return 0;
+    case MAX31343_R_RTC_RESET:    return 1;
+    case MAX31343_R_CFG1:         return 2;
+    case MAX31343_R_CFG2:         return 3;
+    case MAX31343_R_TIMER_CONFIG: return 4;
+    case MAX31343_R_PWR_MGMT:     return 5;
+    case MAX31343_R_TRICKLE:      return 6;
+    case MAX31343_R_TS_CONFIG:    return 7;
+    default:                      return -1;
     }
+}
 
-    //
-    if (counter != len) {
-        m_i2c->begin(); // restart
-        ret = -1;
+void MAX31343::shadow_update(uint8_t reg, const uint8_t *buf, int len)
+{
+    if (!m_shadow_enabled) {
+        return;
+    }
+
+    for (int i = 0; i < len; i++) {
+        int idx = shadow_index(reg + i);
+        if (idx < 0) {
+            continue;
+        }
+
+        m_shadow[idx] = buf[i];
+        if ((reg + i) == MAX31343_R_TS_CONFIG) {
+            /* ONESHOT clears itself when the conversion completes */
+            m_shadow[idx] &= ~MAX31343_F_TS_CONFIG_ONESHOT_MODE;
+        }
+        m_shadow_valid |= (1 << idx);
+    }
+}
+
+int MAX31343::shadow_written(uint8_t reg, const uint8_t *buf, int len, int ret)
+{
+    if (ret == 0) {
+        shadow_update(reg, buf, len);
+        return ret;
+    }
+
+    /* Device content of the cached registers is unknown now */
+    for (int i = 0; i < len; i++) {
+        int idx = shadow_index(reg + i);
+        if (idx >= 0) {
+            m_shadow_valid &= ~(1 << idx);
+        }
     }
 
     return ret;
 }
 
-int MAX31343::write_register(uint8_t reg, const uint8_t *buf, uint8_t len/*=1*/)
+int MAX31343::read_cached_register(uint8_t reg, uint8_t *val)
+{
+    int idx = shadow_index(reg);
+
+    if (m_shadow_enabled && (idx >= 0) && (m_shadow_valid & (1 << idx))) {
+        *val = m_shadow[idx];
+        return 0;
+    }
+
+    return read_register(reg, val, 1);
+}
+
+void MAX31343::shadow_enable(bool enable/*=true*/)
+{
+    m_shadow_enabled = enable;
+    m_shadow_valid = 0;
+}
+
+void MAX31343::shadow_invalidate(void)
+{
+    m_shadow_valid = 0;
+}
+
+int MAX31343::shadow_sync(void)
 {
     int ret;
+    uint8_t regs[5];
 
-    m_i2c->beginTransmission(m_slave_addr);
-    m_i2c->write(reg);
-    m_i2c->write(buf, len);
-    ret = m_i2c->endTransmission();
-    /*
-        0:success
-        1:data too long to fit in transmit buffer
-        2:received NACK on transmit of address
-        3:received NACK on transmit of data
-        4:other error
-    */
+    if (!m_shadow_enabled) {
+        return 0;
+    }
 
-    if (ret != 0) {
-        m_i2c->begin(); // restart
+    m_shadow_valid = 0;
+
+    /* INT_EN..TIMER_CONFIG and PWR_MGMT..TS_CONFIG, shadow is filled by read_register() */
+    ret = read_register(MAX31343_R_INT_EN, regs, 5);
+    if (ret) {
+        return ret;
     }
 
-    return ret;
+    return read_register(MAX31343_R_PWR_MGMT, regs, 5);
 }
 
 /***********************************************************************************/
-MAX31343::MAX31343(TwoWire *i2c, uint8_t i2c_addr)
+MAX31343::MAX31343(TwoWire *i2c, uint8_t i2c_addr) : RTCCoreT(i2c, i2c_addr)
 {
-	if (i2c == NULL) {
-		while (1);
-	}
+	m_shadow_valid = 0;
+	m_shadow_enabled = false;
+}
 
-	m_i2c = i2c;
-	m_slave_addr = i2c_addr;
+MAX31343::MAX31343(RTCTransport *bus, uint8_t i2c_addr) : RTCCoreT(bus, i2c_addr)
+{
+	m_shadow_valid = 0;
+	m_shadow_enabled = false;
 }
 
 void MAX31343::begin(void)
 {
-	m_i2c->begin();
+	m_bus->begin();
 
 	sw_reset_release();
+	shadow_sync();
 	rtc_start();
 	irq_disable();
 }
@@ -146,6 +204,13 @@ int MAX31343::get_status(reg_status_t &stat)
         return ret;
     }
 
+    decode_status(val8, stat);
+
+    return ret;
+}
+
+void MAX31343::decode_status(uint8_t val8, reg_status_t &stat)
+{
     stat.bits.a1f    = GET_BIT_VAL(val8, MAX31343_F_STATUS_A1F_POS,      MAX31343_F_STATUS_A1F);
     stat.bits.a2f    = GET_BIT_VAL(val8, MAX31343_F_STATUS_A2F_POS,      MAX31343_F_STATUS_A2F);
     stat.bits.tif    = GET_BIT_VAL(val8, MAX31343_F_STATUS_TIF_POS,      MAX31343_F_STATUS_TIF);
@@ -153,8 +218,6 @@ int MAX31343::get_status(reg_status_t &stat)
     stat.bits.pfail  = GET_BIT_VAL(val8, MAX31343_F_STATUS_PFAIL_POS,    MAX31343_F_STATUS_PFAIL);
     stat.bits.osf    = GET_BIT_VAL(val8, MAX31343_F_STATUS_OSF_POS,      MAX31343_F_STATUS_OSF);
     stat.bits.psdect = GET_BIT_VAL(val8, MAX31343_F_STATUS_PSDECT_POS,   MAX31343_F_STATUS_PSDECT);
-
-    return ret;
 }
 
 int MAX31343::get_configuration(reg_cfg_t &cfg)
@@ -167,6 +230,13 @@ int MAX31343::get_configuration(reg_cfg_t &cfg)
         return ret;
     }
 
+    decode_configuration(regs, cfg);
+
+    return ret;
+}
+
+void MAX31343::decode_configuration(const uint8_t *regs, reg_cfg_t &cfg)
+{
 	// configuration byte 1
     cfg.bits.enosc  	 = GET_BIT_VAL(regs[0], MAX31343_F_CFG1_ENOSC_POS,   	 MAX31343_F_CFG1_ENOSC);
     cfg.bits.i2c_timeout = GET_BIT_VAL(regs[0], MAX31343_F_CFG1_I2C_TIMEOUT_POS, MAX31343_F_CFG1_I2C_TIMEOUT);
@@ -175,8 +245,6 @@ int MAX31343::get_configuration(reg_cfg_t &cfg)
     cfg.bits.sqw_hz  	 = GET_BIT_VAL(regs[1], MAX31343_F_CFG2_SQW_HZ_POS,   MAX31343_F_CFG2_SQW_HZ);
     cfg.bits.clko_hz	 = GET_BIT_VAL(regs[1], MAX31343_F_CFG2_CLKO_HZ_POS,  MAX31343_F_CFG2_CLKO_HZ);
     cfg.bits.enclko	 	 = GET_BIT_VAL(regs[1], MAX31343_F_CFG2_ENCLKO_POS,   MAX31343_F_CFG2_ENCLKO);
-   
-    return ret;
 }
 
 int MAX31343::set_configuration(reg_cfg_t cfg)
@@ -199,326 +267,37 @@ int MAX31343::set_configuration(reg_cfg_t cfg)
 
 int MAX31343::get_time(struct tm *time)
 {
-	int ret;
-	rtc_time_regs_t regs;
-
-	if (time == NULL) {
-		return -1;
-	}
-
-	ret = read_register(MAX31343_R_SECONDS, (uint8_t *) &regs, sizeof(regs));
-	if (ret) {
-		return ret;
-	}
-
-	/* tm_sec seconds [0,61] */
-	time->tm_sec = BCD2BIN(regs.seconds.bcd.value);
-	/* tm_min minutes [0,59] */
-	time->tm_min = BCD2BIN(regs.minutes.bcd.value);
-	/* tm_hour hour [0,23] */
-	time->tm_hour = BCD2BIN(regs.hours.bcd.value);
-	/* tm_wday day of week [0,6] (Sunday = 0) */
-	time->tm_wday = BCD2BIN(regs.day.bcd.value) - 1;
-	/* tm_mday day of month [1,31] */
-	time->tm_mday = BCD2BIN(regs.date.bcd.value);
-	/* tm_mon month of year [0,11] */
-	time->tm_mon = BCD2BIN(regs.month.bcd.value) - 1;
-
-	/* tm_year years since 2000 */
-	if (regs.month.bits.century) {
-		time->tm_year = BCD2BIN(regs.year.bcd.value) + 200;
-	} else {
-		time->tm_year = BCD2BIN(regs.year.bcd.value) + 100;
-	}
-
-	/* tm_yday day of year [0,365] */
-	time->tm_yday = 0; /* TODO */
-	/* tm_isdst daylight savings flag */
-	time->tm_isdst = 0; /* TODO */
-
-	return ret;
+	return core_get_time(time);
 }
 
 int MAX31343::set_time(const struct tm *time)
 {
-	int ret;
-	rtc_time_regs_t regs;
-
-	if (time == NULL) {
-		return -1;
-	}
-
-	/*********************************************************
-	 * +----------+------+---------------------------+-------+
-	 * | Member   | Type | Meaning                   | Range |
-	 * +----------+------+---------------------------+-------+
-	 * | tm_sec   | int  | seconds after the minute  | 0-61* |
-	 * | tm_min   | int  | minutes after the hour    | 0-59  |
-	 * | tm_hour  | int  | hours since midnight      | 0-23  |
-	 * | tm_mday  | int  | day of the month          | 1-31  |
-	 * | tm_mon   | int  | months since January      | 0-11  |
-	 * | tm_year  | int  | years since 1900          |       |
-	 * | tm_wday  | int  | days since Sunday         | 0-6   |
-	 * | tm_yday  | int  | days since January 1      | 0-365 |
-	 * | tm_isdst | int  | Daylight Saving Time flag |       |
-	 * +----------+------+---------------------------+-------+
-	 * * tm_sec is generally 0-59. The extra range is to accommodate for leap
-	 *   seconds in certain systems.
-	 *********************************************************/
-	regs.seconds.bcd.value = BIN2BCD(time->tm_sec);
-	regs.minutes.bcd.value = BIN2BCD(time->tm_min);
-	regs.hours.bcd.value= BIN2BCD(time->tm_hour);
-	regs.day.bcd.value = BIN2BCD(time->tm_wday + 1);
-	regs.date.bcd.value = BIN2BCD(time->tm_mday);
-	regs.month.bcd.value = BIN2BCD(time->tm_mon + 1);
-
-	if (time->tm_year >= 200) {
-		regs.month.bits.century = 1;
-		regs.year.bcd.value = BIN2BCD(time->tm_year - 200);
-	} else if (time->tm_year >= 100) {
-		regs.month.bits.century = 0;
-		regs.year.bcd.value = BIN2BCD(time->tm_year - 100);
-	} else {
-		return -1;
-	}
+	return core_set_time(time);
+}
 
-	ret = write_register(MAX31343_R_SECONDS, (const uint8_t *) &regs, sizeof(regs)); 
+int MAX31343::get_epoch(rtc_epoch_t *epoch)
+{
+	return core_get_epoch(epoch);
+}
 
-	return ret;
+int MAX31343::set_epoch(rtc_epoch_t epoch)
+{
+	return core_set_epoch(epoch);
 }
 
 int MAX31343::set_alarm(alarm_no_t alarm_no, const struct tm *alarm_time, alarm_period_t period)
 {
-	int ret;
-	regs_alarm_t regs;
-
-	if (alarm_no == ALARM2) {
-		switch (period) {
-			case ALARM_PERIOD_EVERYSECOND:
-			case ALARM_PERIOD_ONETIME:
-			case ALARM_PERIOD_YEARLY:
-				return -1; // not support for alarm 2
-		}
-	}
-
-
-	/*
-	 *  Set period
-	 */
-
-	// clear all flag, default onetime 
-	regs.sec.bits.a1m1 = 0;
-	regs.min.bits.a1m2 = 0;
-	regs.hrs.bits.a1m3 = 0;
-	regs.day_date.bits.a1m4 = 0;
-	regs.mon.bits.a1m5 = 0;
-	regs.mon.bits.a1m6 = 0;
-	regs.day_date.bits.dy_dt = 0;
-
-	switch (period) {
-		case ALARM_PERIOD_ONETIME:
-			// do nothing
-			break;
-		case ALARM_PERIOD_YEARLY:
-			regs.mon.bits.a1m6 = 1;
-			break;
-		case ALARM_PERIOD_MONTHLY:
-			regs.mon.bits.a1m5 = 1;
-			regs.mon.bits.a1m6 = 1;
-			break;
-		case ALARM_PERIOD_WEEKLY:
-			regs.mon.bits.a1m5 = 1;
-			regs.mon.bits.a1m6 = 1;
-			regs.day_date.bits.dy_dt = 1;
-			break;
-		case ALARM_PERIOD_DAILY:
-			regs.day_date.bits.a1m4 = 1;
-			regs.mon.bits.a1m5 = 1;
-			regs.mon.bits.a1m6 = 1;
-			break;
-		case ALARM_PERIOD_HOURLY:
-			regs.hrs.bits.a1m3 = 1;
-			regs.day_date.bits.a1m4 = 1;
-			regs.mon.bits.a1m5 = 1;
-			regs.mon.bits.a1m6 = 1;
-			break;
-		case ALARM_PERIOD_EVERYMINUTE:
-			regs.min.bits.a1m2 = 1;
-			regs.hrs.bits.a1m3 = 1;
-			regs.day_date.bits.a1m4 = 1;
-			regs.mon.bits.a1m5 = 1;
-			regs.mon.bits.a1m6 = 1;
-			break;
-		case ALARM_PERIOD_EVERYSECOND:
-			regs.sec.bits.a1m1 = 1;
-			regs.min.bits.a1m2 = 1;
-			regs.hrs.bits.a1m3 = 1;
-			regs.day_date.bits.a1m4 = 1;
-			regs.mon.bits.a1m5 = 1;
-			regs.mon.bits.a1m6 = 1;
-			break;
-		default:
-			return -1;
-	}
-
-	/* 
-	 * Convert time structure to alarm registers 
-	 */
-	regs.sec.bcd.value = BIN2BCD(alarm_time->tm_sec);
-	regs.min.bcd.value = BIN2BCD(alarm_time->tm_min);
-
-	regs.hrs.bcd.value = BIN2BCD(alarm_time->tm_hour);
-
-	if (regs.day_date.bits.dy_dt == 0) {
-		/* Date match */
-		regs.day_date.bcd_date.value = BIN2BCD(alarm_time->tm_mday);
-	} else {
-		/* Day match */
-		regs.day_date.bcd_day.value = BIN2BCD(alarm_time->tm_wday);
-	}
-	regs.mon.bcd.value = BIN2BCD(alarm_time->tm_mon+1);
-    
-    if (alarm_time->tm_year >= 200) {
-		regs.year.bcd.value = BIN2BCD(alarm_time->tm_year - 200);
-	} else if (alarm_time->tm_year >= 100) {
-		regs.year.bcd.value = BIN2BCD(alarm_time->tm_year - 100);
-	} else {
-		return -1;
-	}
-
-
-    /* 
-     *  Write Registers 
-     */
-    uint8_t *ptr_regs = (uint8_t *)&regs;
-
-    if (alarm_no == ALARM1) {
-        ret = write_register(MAX31343_R_ALM1_SEC, &ptr_regs[0], sizeof(regs_alarm_t));
-    } else {
-        /* XXX discard min, mon & sec registers */
-        ret = write_register(MAX31343_R_ALM2_MIN, &ptr_regs[1], sizeof(regs_alarm_t)-3);
-    }
-
-	return ret;
+	return core_set_alarm(alarm_no == ALARM1, alarm_time, period);
 }
 
 int MAX31343::get_alarm(alarm_no_t alarm_no, struct tm *alarm_time, alarm_period_t *period, bool *is_enabled)
 {
-	int ret;
-	regs_alarm_t regs;
-	uint8_t reg;
-    uint8_t *ptr_regs = (uint8_t *)&regs;
-
-    /*
-     *  Read registers
-     */
-    if (alarm_no == ALARM1) {
-        ret = read_register(MAX31343_R_ALM1_SEC, &ptr_regs[0], sizeof(regs_alarm_t));
-    } else {
-        regs.sec.raw = 0;  /* zeroise second register for alarm2 */
-        /* XXX discard mon & sec registers */
-        ret = read_register(MAX31343_R_ALM2_MIN, &ptr_regs[1], sizeof(regs_alarm_t)-2);
-    }
-    if (ret) {
-        return ret;
-    }
-
-
-    /* 
-     *  Convert alarm registers to time structure 
-     */
-	alarm_time->tm_sec = BCD2BIN(regs.sec.bcd.value);
-	alarm_time->tm_min = BCD2BIN(regs.min.bcd.value);
-	alarm_time->tm_hour = BCD2BIN(regs.hrs.bcd.value);
-
-	if (regs.day_date.bits.dy_dt == 0) { /* date */
-		alarm_time->tm_mday = BCD2BIN(regs.day_date.bcd_date.value);
-	} else { /* day */
-		alarm_time->tm_wday = BCD2BIN(regs.day_date.bcd_day.value);
-	}
-	alarm_time->tm_mon = BCD2BIN(regs.mon.bcd.value) - 1;
-	alarm_time->tm_year = BCD2BIN(regs.year.bcd.value) + 100;	/* XXX no century bit */
-
-
-    /*
-     *  Find period
-     */
-    if(alarm_no == ALARM1) {
-        int alarm = regs.sec.bits.a1m1 | (regs.min.bits.a1m2<<1)
-                    | (regs.hrs.bits.a1m3<<2) | (regs.day_date.bits.a1m4<<3)
-                    | (regs.mon.bits.a1m5<<4) | (regs.mon.bits.a1m6<<5)
-                    | (regs.day_date.bits.dy_dt<<6);
-
-        switch(alarm) {
-            case 0b1111111:
-            case 0b0111111:
-                *period = ALARM_PERIOD_EVERYSECOND;
-                break;
-            case 0b1111110:
-            case 0b0111110:
-                *period = ALARM_PERIOD_EVERYMINUTE;
-                break;
-            case 0b1111100:
-            case 0b0111100:
-                *period = ALARM_PERIOD_HOURLY;
-                break;
-            case 0b0111000:
-            case 0b1111000:
-                *period = ALARM_PERIOD_DAILY;
-                break;
-            case 0b0110000:
-                *period = ALARM_PERIOD_MONTHLY;
-                break;
-            case 0b0100000:
-                *period = ALARM_PERIOD_YEARLY;
-                break;
-            case 0b0000000:
-                *period = ALARM_PERIOD_ONETIME;
-                break;
-            case 0b1110000:
-                *period = ALARM_PERIOD_WEEKLY;
-        }
-    } else {
-        int alarm = (regs.min.bits.a1m2) | (regs.hrs.bits.a1m3<<1)
-                    | (regs.day_date.bits.a1m4<<2)
-                    | (regs.day_date.bits.dy_dt<<3);
-
-        switch(alarm) {
-            case 0b1111:
-            case 0b0111:
-                *period = ALARM_PERIOD_EVERYMINUTE;
-                break;
-            case 0b1110:
-            case 0b0110:
-                *period = ALARM_PERIOD_HOURLY;
-                break;
-            case 0b1100:
-            case 0b0100:
-                *period = ALARM_PERIOD_DAILY;
-                break;
-            case 0b0000:
-                *period = ALARM_PERIOD_MONTHLY;
-                break;
-            case 0b1000:
-                *period = ALARM_PERIOD_WEEKLY;
-        }
-    }
-
-    /*
-     *  Get enable status
-     */
-	ret = read_register(MAX31343_R_INT_EN, (uint8_t *)&reg, 1);
-	if (ret) {
-		return ret;
-	}
-
-	if (alarm_no == ALARM1) {
-		*is_enabled = (reg & (1 << INTR_ID_ALARM1)) != 0;
-	} else {
-		*is_enabled = (reg & (1 << INTR_ID_ALARM2)) != 0;
-	}
+	return core_get_alarm(alarm_no == ALARM1, alarm_time, period, is_enabled);
+}
 
-	return ret;
+int MAX31343::read_alarm_enable(uint8_t *val)
+{
+	return read_cached_register(MAX31343_R_INT_EN, val);
 }
 
 int MAX31343::powerfail_threshold_level(comp_thresh_t th)
@@ -526,7 +305,7 @@ int MAX31343::powerfail_threshold_level(comp_thresh_t th)
 	int ret;
 	uint8_t reg;
 
-	ret = read_register(MAX31343_R_PWR_MGMT, &reg, 1);
+	ret = read_cached_register(MAX31343_R_PWR_MGMT, &reg);
 	if (ret) {
 		return ret;
 	}
@@ -544,7 +323,7 @@ int MAX31343::supply_select(power_mgmt_supply_t supply)
 	int ret;
 	uint8_t reg;
 
-	ret = read_register(MAX31343_R_PWR_MGMT, &reg, 1);
+	ret = read_cached_register(MAX31343_R_PWR_MGMT, &reg);
 	if (ret) {
 		return ret;
 	}
@@ -588,7 +367,7 @@ int MAX31343::trickle_charger_disable()
     int ret;
     uint8_t reg;
     
-	ret = read_register(MAX31343_R_TRICKLE, &reg, 1);
+	ret = read_cached_register(MAX31343_R_TRICKLE, &reg);
 	if (ret) {
 		return ret;
 	}
@@ -604,7 +383,7 @@ int MAX31343::set_square_wave_frequency(sqw_out_freq_t freq)
 	int ret;
 	uint8_t cfg2;
 
-	ret = read_register(MAX31343_R_CFG2, &cfg2, 1);
+	ret = read_cached_register(MAX31343_R_CFG2, &cfg2);
 	if (ret) {
 		return ret;
 	}
@@ -622,7 +401,7 @@ int MAX31343::clko_enable(clko_freq_t freq)
 	int ret;
 	uint8_t cfg2;
 
-	ret = read_register(MAX31343_R_CFG2, (uint8_t *)&cfg2, 1);
+	ret = read_cached_register(MAX31343_R_CFG2, &cfg2);
 	if (ret) {
 		return ret;
 	}
@@ -642,7 +421,7 @@ int MAX31343::clko_disable()
 	int ret;
 	uint8_t cfg2;
 
-	ret = read_register(MAX31343_R_CFG2, &cfg2, 1);
+	ret = read_cached_register(MAX31343_R_CFG2, &cfg2);
 	if (ret) {
 		return ret;
 	}
@@ -658,7 +437,7 @@ int MAX31343::timer_init(uint8_t initial_value, bool repeat, timer_freq_t freq)
 	int ret;
 	uint8_t cfg;
 
-	ret = read_register(MAX31343_R_TIMER_CONFIG, &cfg, 1);
+	ret = read_cached_register(MAX31343_R_TIMER_CONFIG, &cfg);
 	if (ret) {
 		return ret;
 	}
@@ -684,6 +463,11 @@ int MAX31343::timer_init(uint8_t initial_value, bool repeat, timer_freq_t freq)
 	return ret;
 }
 
+int MAX31343::timer_reload(uint8_t value)
+{
+	return write_register(MAX31343_R_TIMER_INIT, &value, 1);
+}
+
 int MAX31343::timer_get(uint8_t &val)
 {
 	int ret;
@@ -703,7 +487,7 @@ int MAX31343::timer_start()
 	int ret;
 	uint8_t cfg;
 
-	ret = read_register(MAX31343_R_TIMER_CONFIG, &cfg, 1);
+	ret = read_cached_register(MAX31343_R_TIMER_CONFIG, &cfg);
 	if (ret) {
 		return ret;
 	}
@@ -721,7 +505,7 @@ int MAX31343::timer_pause()
 	int ret;
 	uint8_t cfg;
 
-	ret = read_register(MAX31343_R_TIMER_CONFIG, &cfg, 1);
+	ret = read_cached_register(MAX31343_R_TIMER_CONFIG, &cfg);
 	if (ret) {
 		return ret;
 	}
@@ -739,7 +523,7 @@ int MAX31343::timer_continue()
 	int ret;
 	uint8_t cfg;
 
-	ret = read_register(MAX31343_R_TIMER_CONFIG, &cfg, 1);
+	ret = read_cached_register(MAX31343_R_TIMER_CONFIG, &cfg);
 	if (ret) {
 		return ret;
 	}
@@ -757,7 +541,7 @@ int MAX31343::timer_stop()
 	int ret;
 	uint8_t cfg;
 
-	ret = read_register(MAX31343_R_TIMER_CONFIG, &cfg, 1);
+	ret = read_cached_register(MAX31343_R_TIMER_CONFIG, &cfg);
 	if (ret) {
 		return ret;
 	}
@@ -775,7 +559,7 @@ int MAX31343::set_data_retention_mode(bool enable)
 	int ret;
 	uint8_t cfg1;
 
-	ret = read_register(MAX31343_R_CFG1, &cfg1, 1);
+	ret = read_cached_register(MAX31343_R_CFG1, &cfg1);
 	if (ret) {
 		return ret;
 	}
@@ -798,7 +582,7 @@ int MAX31343::start_temp_conversion(bool automode/*=false*/, ttsint_t interval/*
 	int ret;
 	uint8_t reg;
 
-	ret = read_register(MAX31343_R_TS_CONFIG, &reg, 1);
+	ret = read_cached_register(MAX31343_R_TS_CONFIG, &reg);
 	if (ret) {
 		return ret;
 	}
@@ -842,15 +626,23 @@ int MAX31343::get_temp(float &temp)
 {
     int ret;
     uint8_t  buf[2];
-    uint16_t count;
-
-    #define TEMP_RESOLUTION_FOR_10_BIT      (0.25f)
 
     ret = read_register(MAX31343_R_TEMP_MSB, buf, 2);
     if (ret) {
         return ret;
     }
 
+    decode_temp(buf, temp);
+
+    return ret;
+}
+
+void MAX31343::decode_temp(const uint8_t *buf, float &temp)
+{
+    uint16_t count;
+
+    #define TEMP_RESOLUTION_FOR_10_BIT      (0.25f)
+
     // buf[0] includes upper 8 bits, buf[1](7:6 bits) includes lower 2 bits
     count =(buf[0]<<2) | ( (buf[1]>>6) & 0x03 );
 
@@ -864,8 +656,6 @@ int MAX31343::get_temp(float &temp)
     } else {
         temp   = count * TEMP_RESOLUTION_FOR_10_BIT;
     }
-
-    return ret;    
 }
 
 int MAX31343::irq_enable(intr_id_t id/*=INTR_ID_ALL*/)
@@ -873,7 +663,7 @@ int MAX31343::irq_enable(intr_id_t id/*=INTR_ID_ALL*/)
 	int ret;
 	uint8_t val8;
 
-	ret = read_register(MAX31343_R_INT_EN, &val8, 1);
+	ret = read_cached_register(MAX31343_R_INT_EN, &val8);
 	if (ret) {
 		return ret;
 	}
@@ -894,7 +684,7 @@ int MAX31343::irq_disable(intr_id_t id/*=INTR_ID_ALL*/)
 	int ret;
 	uint8_t val8;
 
-	ret = read_register(MAX31343_R_INT_EN, &val8, 1);
+	ret = read_cached_register(MAX31343_R_INT_EN, &val8);
 	if (ret) {
 		return ret;
 	}
@@ -929,6 +719,9 @@ int MAX31343::sw_reset_assert()
 	reg = 1; /* Put device in reset state */
 	ret = write_register(MAX31343_R_RTC_RESET, &reg, 1);
 
+	/* Registers return to their defaults, drop the shadow */
+	shadow_invalidate();
+
 	return ret;
 }
 
@@ -941,6 +734,8 @@ int MAX31343::sw_reset_release()
 	reg = 0;
 	ret = write_register(MAX31343_R_RTC_RESET, &reg, 1);
 
+	shadow_invalidate();
+
 	return ret;
 }
 
@@ -949,7 +744,7 @@ int MAX31343::rtc_start()
 	int ret;
 	uint8_t cfg1;
 
-	ret = read_register(MAX31343_R_CFG1, &cfg1, 1);
+	ret = read_cached_register(MAX31343_R_CFG1, &cfg1);
 	if (ret) {
 		return ret;
 	}
@@ -966,7 +761,7 @@ int MAX31343::rtc_stop()
 	int ret;
 	uint8_t cfg1;
 
-	ret = read_register(MAX31343_R_CFG1, &cfg1, 1);
+	ret = read_cached_register(MAX31343_R_CFG1, &cfg1);
 	if (ret) {
 		return ret;
 	}
@@ -991,7 +786,7 @@ int MAX31343::nvram_write(int offset, const uint8_t *buffer, int length)
 
 	totlen = (MAX31343_R_RAM_REG_END - MAX31343_R_RAM_REG_START) + 1;
 
-	if ((offset + length) > totlen) {
+	if ((offset < 0) || (length < 0) || ((offset + length) > totlen)) {
 		return -1;
 	}
 
@@ -999,7 +794,7 @@ int MAX31343::nvram_write(int offset, const uint8_t *buffer, int length)
 		return 0;
 	}
 
-    ret = write_register(MAX31343_R_RAM_REG_START + offset, buffer, length);
+    ret = write_burst(MAX31343_R_RAM_REG_START + offset, buffer, length);
 
 	return ret;
 }
@@ -1011,7 +806,7 @@ int MAX31343::nvram_read(int offset, uint8_t *buffer, int length)
 
 	totlen = (MAX31343_R_RAM_REG_END - MAX31343_R_RAM_REG_START) + 1;
 
-	if ((offset + length) > totlen) {
+	if ((offset < 0) || (length < 0) || ((offset + length) > totlen)) {
 		return -1;
 	}
 
@@ -1019,7 +814,128 @@ int MAX31343::nvram_read(int offset, uint8_t *buffer, int length)
 		return 0;
 	}
 
-    ret = read_register(MAX31343_R_RAM_REG_START + offset, buffer, length);
+    ret = read_burst(MAX31343_R_RAM_REG_START + offset, buffer, length);
+
+	return ret;
+}
+
+int MAX31343::snapshot(reg_image_t &img)
+{
+	int ret;
+
+	ret = read_burst(MAX31343_R_STATUS, img.regs, sizeof(img.regs));
+	if (ret == 0) {
+		shadow_update(MAX31343_R_STATUS, img.regs, sizeof(img.regs));
+	}
 
 	return ret;
 }
+
+int MAX31343::restore(const reg_image_t &img, bool nvram/*=true*/)
+{
+	int ret;
+	uint8_t regs[MAX31343_R_TIMER_CONFIG - MAX31343_R_INT_EN + 1];
+	uint8_t ts_config;
+
+	/* Alarm1 and Alarm2 */
+	ret = write_burst(MAX31343_R_ALM1_SEC, &img.regs[MAX31343_R_ALM1_SEC],
+						MAX31343_R_ALM2DAY_DATE - MAX31343_R_ALM1_SEC + 1);
+	ret = shadow_written(MAX31343_R_ALM1_SEC, &img.regs[MAX31343_R_ALM1_SEC],
+						MAX31343_R_ALM2DAY_DATE - MAX31343_R_ALM1_SEC + 1, ret);
+	if (ret) {
+		return ret;
+	}
+
+	/* Timer init, power management and trickle charger */
+	ret = write_burst(MAX31343_R_TIMER_INIT, &img.regs[MAX31343_R_TIMER_INIT],
+						MAX31343_R_TRICKLE - MAX31343_R_TIMER_INIT + 1);
+	ret = shadow_written(MAX31343_R_TIMER_INIT, &img.regs[MAX31343_R_TIMER_INIT],
+						MAX31343_R_TRICKLE - MAX31343_R_TIMER_INIT + 1, ret);
+	if (ret) {
+		return ret;
+	}
+
+	/* Do not trigger a conversion, ONESHOT is a command bit */
+	ts_config = img.regs[MAX31343_R_TS_CONFIG] & ~MAX31343_F_TS_CONFIG_ONESHOT_MODE;
+	ret = write_register(MAX31343_R_TS_CONFIG, &ts_config, 1);
+	if (ret) {
+		return ret;
+	}
+
+	if (nvram) {
+		ret = write_burst(MAX31343_R_RAM_REG_START, image_nvram(img), nvram_size());
+		if (ret) {
+			return ret;
+		}
+	}
+
+	/* Interrupt enables and configuration last, timer config starts the timer */
+	memcpy(regs, &img.regs[MAX31343_R_INT_EN], sizeof(regs));
+	regs[MAX31343_R_RTC_RESET - MAX31343_R_INT_EN] = 0;
+
+	ret = write_burst(MAX31343_R_INT_EN, regs, sizeof(regs));
+
+	return shadow_written(MAX31343_R_INT_EN, regs, sizeof(regs), ret);
+}
+
+void MAX31343::image_get_status(const reg_image_t &img, reg_status_t &stat)
+{
+	decode_status(img.regs[MAX31343_R_STATUS], stat);
+}
+
+void MAX31343::image_get_configuration(const reg_image_t &img, reg_cfg_t &cfg)
+{
+	decode_configuration(&img.regs[MAX31343_R_CFG1], cfg);
+}
+
+int MAX31343::image_get_time(const reg_image_t &img, struct tm *time)
+{
+	if (time == NULL) {
+		return -1;
+	}
+
+	decode_time(&img.regs[MAX31343_R_SECONDS], time);
+
+	return 0;
+}
+
+int MAX31343::image_get_alarm(const reg_image_t &img, alarm_no_t alarm_no, struct tm *alarm_time,
+								alarm_period_t *period, bool *is_enabled)
+{
+	int found;
+	uint8_t regs[RTC_CORE_ALARM_EXT_LEN] = {0};
+	uint8_t int_en = img.regs[MAX31343_R_INT_EN];
+
+	if ((alarm_time == NULL) || (period == NULL) || (is_enabled == NULL)) {
+		return -1;
+	}
+
+	if (alarm_no == ALARM1) {
+		memcpy(&regs[0], &img.regs[MAX31343_R_ALM1_SEC], RTC_CORE_ALARM_EXT_LEN);
+	} else {
+		memcpy(&regs[1], &img.regs[MAX31343_R_ALM2_MIN], MAX31343_R_ALM2DAY_DATE - MAX31343_R_ALM2_MIN + 1);
+	}
+
+	found = decode_alarm_ext(alarm_no == ALARM1, regs, alarm_time);
+	if (found >= 0) {
+		*period = (alarm_period_t)found;
+	}
+
+	if (alarm_no == ALARM1) {
+		*is_enabled = (int_en & MAX31343_F_INT_EN_A1IE) != 0;
+	} else {
+		*is_enabled = (int_en & MAX31343_F_INT_EN_A2IE) != 0;
+	}
+
+	return 0;
+}
+
+void MAX31343::image_get_temp(const reg_image_t &img, float &temp)
+{
+	decode_temp(&img.regs[MAX31343_R_TEMP_MSB], temp);
+}
+
+const uint8_t *MAX31343::image_nvram(const reg_image_t &img)
+{
+	return &img.regs[MAX31343_R_RAM_REG_START];
+}
@@ -34,6 +34,9 @@
 #define _MAX31343_H_
 
 #include <MAX31343/MAX31343_registers.h>
+#include <RTCCommon/RTCBusStats.h>
+#include <RTCCommon/RTCCore.h>
+#include <RTCCommon/RTCTransport.h>
 
 #include <time.h>
 #include <Wire.h>
@@ -45,8 +48,24 @@
 #define MAX31343_ERR_UNKNOWN          (-1)
 #define MAX31343_ERR_BUSY             (-3)
 
+/* Configuration registers cached by the shadow, one bit each in m_shadow_valid */
+#define MAX31343_SHADOW_SIZE          8
 
-class MAX31343
+
+/**
+* @brief	MAX31343 register map for the shared time and alarm code
+*/
+struct max31343_core_regs {
+	static constexpr uint8_t time       = MAX31343_R_SECONDS;
+	static constexpr uint8_t alarm1     = MAX31343_R_ALM1_SEC;
+	static constexpr uint8_t alarm2     = MAX31343_R_ALM2_MIN;
+	static constexpr uint8_t alarm_en   = MAX31343_R_INT_EN;
+	static constexpr bool    alarm_ext  = true;
+	static constexpr bool    time_latch = true;
+	static constexpr bool    status_rc  = true;
+};
+
+class MAX31343 : public RTCCoreT<MAX31343, max31343_core_regs>
 {
 	public:
 	    /**
@@ -205,8 +224,17 @@ class MAX31343
 			} bits;
 		} reg_cfg_t;
 
+		/**
+		* @brief	Image of the whole register map, STATUS up to RAM_REG_END
+		*/
+		typedef struct {
+			uint8_t regs[MAX31343_R_RAM_REG_END + 1];
+		} reg_image_t;
+
 		MAX31343(TwoWire *i2c, uint8_t i2c_addr=MAX31343_I2C_ADDRESS);
 
+		MAX31343(RTCTransport *bus, uint8_t i2c_addr=MAX31343_I2C_ADDRESS);
+
 	    /**
 	    * @brief   First initialization, must be call before using class function
 	    *
@@ -258,6 +286,24 @@ class MAX31343
 		*/
 		int set_time(const struct tm *rtc_ctime);
 
+		/**
+		* @brief		Read time from RTC as Unix seconds, without struct tm.
+		*
+		* @param[out]	epoch Seconds since 1970-01-01 00:00:00, the RTC is taken as UTC.
+		*
+		* @returns		0 on success, negative error code on failure.
+		*/
+		int get_epoch(rtc_epoch_t *epoch);
+
+		/**
+		* @brief		Set time info to RTC from Unix seconds.
+		*
+		* @param[in]	epoch Seconds since 1970-01-01 00:00:00, from 2000 up to the end of 2199.
+		*
+		* @returns		0 on success, negative error code on failure.
+		*/
+		int set_epoch(rtc_epoch_t epoch);
+
 		/**
 		* @brief		Set an alarm condition
 		*
@@ -321,6 +367,8 @@ class MAX31343
 		* @param[in]	freq Clock frequency, one of SQUARE_WAVE_OUT_FREQ_*
 		*
 		* @return		0 on success, error code on failure
+		*
+		* @note			RTCSqwClockT uses the 1Hz output for millisecond time without bus access.
 		*/
 		int set_square_wave_frequency(sqw_out_freq_t freq);
 
@@ -352,6 +400,17 @@ class MAX31343
 		*/
 		int timer_init(uint8_t initial_value, bool repeat, timer_freq_t freq);
 
+		/**
+		* @brief		Write the timer initial value only, the timer keeps running
+		*
+		* @param[in]	value Timer initial value
+		*
+		* @return		0 on success, error code on failure
+		*
+		* @note			In repeat mode the value is loaded at the next expiry.
+		*/
+		int timer_reload(uint8_t value);
+
 		/**
 		* @brief	Read timer value
 		*
@@ -490,6 +549,9 @@ class MAX31343
 		/**
 		* @brief		Non-volatile memory write
 		*
+		* @details	Lengths beyond the transport limit are split into
+		*			back-to-back bursts, see RTCTransport::max_write().
+		*
 		* @param[in]	offset Offset of location in NVRAM
 		* @param[out]	buffer Pointer to the data to be written
 		* @param[in]	length Number of bytes to write
@@ -501,6 +563,9 @@ class MAX31343
 		/**
 		* @brief		Non-volatile memory read
 		*
+		* @details	Lengths beyond the transport limit are split into
+		*			back-to-back bursts, see RTCTransport::max_read().
+		*
 		* @param[in]	offset Offset of location in NVRAM
 		* @param[in]	buffer Buffer to read in to
 		* @param[in]	length Number of bytes to read
@@ -509,6 +574,93 @@ class MAX31343
 		*/
 		int nvram_read(int offset, uint8_t *buffer, int length);
 
+		/**
+		* @brief		Enable/disable the configuration register shadow
+		*
+		* @details		While enabled, INT_EN, RTC_RESET, CFG1, CFG2, TIMER_CONFIG,
+		*				PWR_MGMT, TRICKLE and TS_CONFIG are mirrored in RAM, so
+		*				read-modify-write setters only issue the write transaction.
+		*				STATUS, TIMER_COUNT, time and temperature registers are
+		*				never cached. The shadow is filled by begin() or shadow_sync().
+		*
+		* @param[in]	enable true to use the shadow, false to always read the device
+		*/
+		void shadow_enable(bool enable=true);
+
+		/**
+		* @brief		Read the whole register map with as few bursts as possible
+		*
+		* @details		STATUS is part of the image, so pending flags are
+		*				cleared by the snapshot exactly like get_status() does.
+		*
+		* @param[out]	img Register image to be filled in
+		*
+		* @return		0 on success, error code on failure
+		*/
+		int snapshot(reg_image_t &img);
+
+		/**
+		* @brief		Write the configuration part of a register image back
+		*
+		* @details		Alarm, timer init, power management, trickle, temperature
+		*				sensor and interrupt/configuration registers are written.
+		*				STATUS, time, timer count and temperature are left untouched
+		*				and the device is never put into software reset.
+		*
+		* @param[in]	img Register image, e.g. from snapshot()
+		* @param[in]	nvram true to also write the NVRAM content
+		*
+		* @return		0 on success, error code on failure
+		*/
+		int restore(const reg_image_t &img, bool nvram=true);
+
+		/**
+		* @brief		Decode status byte of a register image
+		*/
+		static void image_get_status(const reg_image_t &img, reg_status_t &stat);
+
+		/**
+		* @brief		Decode configuration bytes of a register image
+		*/
+		static void image_get_configuration(const reg_image_t &img, reg_cfg_t &cfg);
+
+		/**
+		* @brief		Decode time info of a register image
+		*
+		* @return		0 on success, error code on failure
+		*/
+		static int image_get_time(const reg_image_t &img, struct tm *rtc_ctime);
+
+		/**
+		* @brief		Decode alarm info of a register image, see get_alarm()
+		*
+		* @return		0 on success, error code on failure
+		*/
+		static int image_get_alarm(const reg_image_t &img, alarm_no_t alarm_no, struct tm *alarm_time,
+									alarm_period_t *period, bool *is_enabled);
+
+		/**
+		* @brief		Decode temperature of a register image
+		*/
+		static void image_get_temp(const reg_image_t &img, float &temp);
+
+		/**
+		* @brief		NVRAM content of a register image, nvram_size() bytes long
+		*/
+		static const uint8_t *image_nvram(const reg_image_t &img);
+
+		/**
+		* @brief		Reload the configuration register shadow from the device
+		*
+		* @return		0 on success, error code on failure
+		*/
+		int shadow_sync(void);
+
+		/**
+		* @brief		Drop the shadow content, next access reads from the device
+		*/
+		void shadow_invalidate(void);
+
         /**
         * @brief        Directly read value from register
         *
@@ -709,9 +861,21 @@ class MAX31343
 			} year;
 		} regs_alarm_t;
 
-		TwoWire *m_i2c;
-		uint8_t m_slave_addr;
+		uint8_t m_shadow[MAX31343_SHADOW_SIZE];
+		uint8_t m_shadow_valid;		/* one bit per m_shadow slot */
+		bool	m_shadow_enabled;
+
+		static void decode_status(uint8_t val8, reg_status_t &stat);
+		static void decode_configuration(const uint8_t *regs, reg_cfg_t &cfg);
+		static void decode_temp(const uint8_t *buf, float &temp);
+
+		static int shadow_index(uint8_t reg);
+		void shadow_update(uint8_t reg, const uint8_t *buf, int len);
+		int shadow_written(uint8_t reg, const uint8_t *buf, int len, int ret);
+		int read_cached_register(uint8_t reg, uint8_t *val);
 
+		friend class RTCCoreT<MAX31343, max31343_core_regs>;
+		int read_alarm_enable(uint8_t *val);
 };
 
 #endif /* _MAX31343_H_ */
@@ -0,0 +1,532 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#include <RTCCommon/RTCAlarmScheduler.h>
+#include <RTCCommon/RTCCore.h>
+
+#define SECS_PER_MIN	60UL
+#define SECS_PER_HOUR	3600UL
+#define SECS_PER_DAY	86400UL
+#define SECS_PER_WEEK	604800UL
+
+RTCAlarmScheduler::RTCAlarmScheduler(rtc_alarm_entry_t *entries, uint16_t *heap, uint16_t capacity,
+	bool onetime)
+{
+	m_entries = entries;
+	m_heap = heap;
+	m_capacity = capacity;
+	m_count = 0;
+	m_armed = 0;
+	m_armed_valid = false;
+	m_a1_enabled = false;
+	m_onetime = onetime;
+	m_in_service = false;
+	m_pending = false;
+	m_a2_id = RTC_ALARM_ID_NONE;
+	memset(&m_a2, 0, sizeof(m_a2));
+
+	for (uint16_t i = 0; i < capacity; i++) {
+		m_entries[i].pos = RTC_ALARM_ID_NONE;
+		m_heap[i] = i;
+	}
+
+	reset_stats();
+}
+
+int RTCAlarmScheduler::begin(void)
+{
+	int ret;
+	uint8_t flags;
+
+	ret = take_flags(&flags);
+	if (ret) {
+		m_stats.errors++;
+		return ret;
+	}
+
+	m_a1_enabled = false;
+	m_armed_valid = false;
+
+	ret = arm();
+	if (ret) {
+		return ret;
+	}
+
+	if (m_a2_id != RTC_ALARM_ID_NONE) {
+		ret = enable_alarm(false, true);
+		if (ret) {
+			m_stats.errors++;
+		}
+	}
+
+	return ret;
+}
+
+int RTCAlarmScheduler::add(rtc_epoch_t when, uint32_t period, rtc_alarm_cb_t cb, void *arg, uint16_t *id)
+{
+	int hw_period;
+	struct tm time;
+	rtc_alarm_entry_t entry;
+
+	if (cb == NULL) {
+		return -1;
+	}
+
+	entry.when = when;
+	entry.period = period;
+	entry.cron = NULL;
+	entry.cb = cb;
+	entry.arg = arg;
+
+	if ((m_a2_id == RTC_ALARM_ID_NONE) && fits_alarm2(when, period, &hw_period)) {
+		rtc_epoch_to_tm(when, &time);
+		return add_alarm2(&time, hw_period, &entry, id);
+	}
+
+	return add_heap(&entry, id);
+}
+
+int RTCAlarmScheduler::add_cron(const rtc_cron_t *cron, rtc_alarm_cb_t cb, void *arg, uint16_t *id)
+{
+	int ret;
+	int hw_period;
+	rtc_epoch_t now;
+	struct tm time;
+	rtc_alarm_entry_t entry;
+
+	if ((cron == NULL) || (cb == NULL)) {
+		return -1;
+	}
+
+	ret = read_rtc(&now);
+	if (ret) {
+		m_stats.errors++;
+		return ret;
+	}
+
+	if (rtc_cron_next(cron, now, &entry.when)) {
+		return -1;
+	}
+	entry.period = 0;
+	entry.cron = cron;
+	entry.cb = cb;
+	entry.arg = arg;
+
+	/* ALARM2 has no seconds register and no one per second, month or year match */
+	if ((m_a2_id == RTC_ALARM_ID_NONE) && (cron->sec == 1) &&
+		(rtc_cron_to_alarm(cron, &time, &hw_period) == 0) &&
+		(hw_period >= RTC_ALARM_PERIOD_EVERYMINUTE) && (hw_period <= RTC_ALARM_PERIOD_MONTHLY)) {
+		return add_alarm2(&time, hw_period, &entry, id);
+	}
+
+	return add_heap(&entry, id);
+}
+
+int RTCAlarmScheduler::remove(uint16_t id)
+{
+	int ret;
+
+	if ((id == m_capacity) && (m_a2_id != RTC_ALARM_ID_NONE)) {
+		m_a2_id = RTC_ALARM_ID_NONE;
+
+		ret = enable_alarm(false, false);
+		if (ret) {
+			m_stats.errors++;
+		}
+		return ret;
+	}
+
+	if ((id >= m_capacity) || (m_entries[id].pos == RTC_ALARM_ID_NONE)) {
+		return -1;
+	}
+
+	heap_remove(m_entries[id].pos);
+
+	return m_in_service ? 0 : arm();
+}
+
+int RTCAlarmScheduler::service(uint16_t *fired)
+{
+	int ret;
+	uint8_t flags;
+	bool woken;
+	uint16_t id;
+	uint16_t runs = 0;
+	rtc_epoch_t now;
+	rtc_epoch_t when;
+	rtc_alarm_entry_t *e;
+
+	m_pending = false;
+
+	if (fired) {
+		*fired = 0;
+	}
+
+	ret = take_flags(&flags);
+	if (ret == 0) {
+		ret = read_rtc(&now);
+	}
+	if (ret) {
+		m_stats.errors++;
+		m_pending = true;
+		return ret;
+	}
+
+	m_in_service = true;
+	woken = (flags != 0);
+
+	do {
+		/* ALARM2 also matches before the first time of its alarm, such a match is not a fire */
+		if ((flags & RTC_ALARM_FLAG_A2) && (m_a2_id != RTC_ALARM_ID_NONE) && (m_a2.when <= now)) {
+			id = m_a2_id;
+			when = m_a2.when;
+			if (!reschedule(&m_a2, now)) {
+				remove(id);
+			}
+			m_stats.fired_a2++;
+			runs++;
+			m_a2.cb(id, when, m_a2.arg);
+		}
+
+		while (m_count && (m_entries[m_heap[0]].when <= now)) {
+			id = m_heap[0];
+			e = &m_entries[id];
+			when = e->when;
+
+			/* Back in the heap before the callback, which can remove it */
+			if (reschedule(e, now)) {
+				sift_down(0);
+			} else {
+				heap_remove(0);
+			}
+
+			m_stats.fired++;
+			runs++;
+			e->cb(id, when, e->arg);
+		}
+
+		ret = arm();
+		if (ret || !m_count || (m_entries[m_heap[0]].when > now + 1)) {
+			break;
+		}
+
+		/* The root was due within a second, make sure the time did not pass it while ALARM1 was written */
+		ret = read_rtc(&now);
+		if (ret) {
+			m_stats.errors++;
+			break;
+		}
+		flags = 0;
+	} while (m_entries[m_heap[0]].when <= now);
+
+	m_in_service = false;
+
+	if (woken && !runs) {
+		m_stats.early++;
+	}
+
+	if (fired) {
+		*fired = runs;
+	}
+
+	return ret;
+}
+
+int RTCAlarmScheduler::next(rtc_epoch_t *when) const
+{
+	bool found = false;
+
+	if (m_count) {
+		*when = m_entries[m_heap[0]].when;
+		found = true;
+	}
+	if ((m_a2_id != RTC_ALARM_ID_NONE) && (!found || (m_a2.when < *when))) {
+		*when = m_a2.when;
+		found = true;
+	}
+
+	return found ? 0 : -1;
+}
+
+void RTCAlarmScheduler::get_stats(rtc_alarm_sched_stats_t &stats)
+{
+	stats = m_stats;
+}
+
+void RTCAlarmScheduler::reset_stats(void)
+{
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+bool RTCAlarmScheduler::fits_alarm2(rtc_epoch_t when, uint32_t period, int *hw_period) const
+{
+	/* ALARM2 has no seconds register, it matches at second 0 */
+	if ((when % SECS_PER_MIN) != 0) {
+		return false;
+	}
+
+	switch (period) {
+		case SECS_PER_MIN:	*hw_period = RTC_ALARM_PERIOD_EVERYMINUTE; break;
+		case SECS_PER_HOUR:	*hw_period = RTC_ALARM_PERIOD_HOURLY; break;
+		case SECS_PER_DAY:	*hw_period = RTC_ALARM_PERIOD_DAILY; break;
+		case SECS_PER_WEEK:	*hw_period = RTC_ALARM_PERIOD_WEEKLY; break;
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+int RTCAlarmScheduler::add_alarm2(const struct tm *time, int hw_period, const rtc_alarm_entry_t *entry, uint16_t *id)
+{
+	int ret;
+
+	ret = write_alarm(false, time, hw_period);
+	if (ret == 0) {
+		ret = enable_alarm(false, true);
+	}
+	if (ret) {
+		m_stats.errors++;
+		return ret;
+	}
+
+	m_a2 = *entry;
+	m_a2_id = m_capacity;
+
+	if (id) {
+		*id = m_a2_id;
+	}
+
+	return 0;
+}
+
+int RTCAlarmScheduler::add_heap(const rtc_alarm_entry_t *entry, uint16_t *id)
+{
+	int ret;
+	uint16_t slot;
+	rtc_epoch_t now;
+
+	if (m_count >= m_capacity) {
+		return -1;
+	}
+
+	/* The free ids are kept past the end of the heap */
+	slot = m_heap[m_count];
+	m_entries[slot] = *entry;
+	heap_insert(slot);
+
+	if (id) {
+		*id = slot;
+	}
+
+	if (m_in_service || (m_entries[slot].pos != 0)) {
+		return 0;
+	}
+
+	ret = arm();
+	if (ret) {
+		return ret;
+	}
+
+	/* ALARM1 never matches a time that has passed, leave it to service() */
+	ret = read_rtc(&now);
+	if (ret) {
+		m_stats.errors++;
+		return ret;
+	}
+	if (entry->when <= now) {
+		m_pending = true;
+	}
+
+	return 0;
+}
+
+void RTCAlarmScheduler::heap_swap(uint16_t a, uint16_t b)
+{
+	uint16_t id = m_heap[a];
+
+	m_heap[a] = m_heap[b];
+	m_heap[b] = id;
+	m_entries[m_heap[a]].pos = a;
+	m_entries[m_heap[b]].pos = b;
+}
+
+void RTCAlarmScheduler::sift_up(uint16_t pos)
+{
+	uint16_t parent;
+
+	while (pos) {
+		parent = (pos - 1) / 2;
+		if (m_entries[m_heap[parent]].when <= m_entries[m_heap[pos]].when) {
+			break;
+		}
+		heap_swap(pos, parent);
+		pos = parent;
+	}
+}
+
+void RTCAlarmScheduler::sift_down(uint16_t pos)
+{
+	uint16_t child;
+
+	for (;;) {
+		child = 2 * pos + 1;
+		if (child >= m_count) {
+			break;
+		}
+		if ((child + 1 < m_count) && (m_entries[m_heap[child + 1]].when < m_entries[m_heap[child]].when)) {
+			child++;
+		}
+		if (m_entries[m_heap[pos]].when <= m_entries[m_heap[child]].when) {
+			break;
+		}
+		heap_swap(pos, child);
+		pos = child;
+	}
+}
+
+void RTCAlarmScheduler::heap_insert(uint16_t id)
+{
+	m_entries[id].pos = m_count;
+	m_heap[m_count++] = id;
+	sift_up(m_count - 1);
+}
+
+void RTCAlarmScheduler::heap_remove(uint16_t pos)
+{
+	uint16_t id = m_heap[pos];
+	uint16_t last = m_count - 1;
+
+	if (pos != last) {
+		heap_swap(pos, last);
+	}
+
+	/* The removed id stays at the old last position, the first free one */
+	m_count--;
+	m_entries[id].pos = RTC_ALARM_ID_NONE;
+
+	if (pos != last) {
+		id = m_heap[pos];
+		sift_up(pos);
+		sift_down(m_entries[id].pos);
+	}
+}
+
+bool RTCAlarmScheduler::reschedule(rtc_alarm_entry_t *entry, rtc_epoch_t now)
+{
+	rtc_epoch_t skip;
+	rtc_epoch_t when;
+
+	if (entry->cron) {
+		if (rtc_cron_next(entry->cron, entry->when, &when)) {
+			return false;
+		}
+		if (when <= now) {
+			/* Counted once however many matches were skipped */
+			m_stats.missed++;
+			if (rtc_cron_next(entry->cron, now, &when)) {
+				return false;
+			}
+		}
+		entry->when = when;
+		return true;
+	}
+
+	if (entry->period == 0) {
+		return false;
+	}
+
+	when = entry->when + entry->period;
+	if (when <= now) {
+		skip = (now - when) / entry->period + 1;
+		m_stats.missed += skip;
+		when += skip * entry->period;
+	}
+	entry->when = when;
+
+	return true;
+}
+
+int RTCAlarmScheduler::set_alarm1_irq(bool enable)
+{
+	int ret;
+
+	if (m_a1_enabled == enable) {
+		return 0;
+	}
+
+	ret = enable_alarm(true, enable);
+	if (ret) {
+		m_stats.errors++;
+		return ret;
+	}
+
+	m_a1_enabled = enable;
+
+	return 0;
+}
+
+int RTCAlarmScheduler::arm(void)
+{
+	int ret;
+	int period;
+	rtc_epoch_t when;
+	struct tm time;
+
+	if (m_count == 0) {
+		m_armed_valid = false;
+		return set_alarm1_irq(false);
+	}
+
+	when = m_entries[m_heap[0]].when;
+	if (m_armed_valid && (m_armed == when)) {
+		return set_alarm1_irq(true);
+	}
+
+	rtc_epoch_to_tm(when, &time);
+
+	/* The year register starts at 2000 */
+	period = (m_onetime && (time.tm_year >= 100)) ? RTC_ALARM_PERIOD_ONETIME : RTC_ALARM_PERIOD_MONTHLY;
+
+	ret = write_alarm(true, &time, period);
+	if (ret) {
+		m_stats.errors++;
+		m_armed_valid = false;
+		return ret;
+	}
+
+	m_stats.arms++;
+	m_armed = when;
+	m_armed_valid = true;
+
+	return set_alarm1_irq(true);
+}
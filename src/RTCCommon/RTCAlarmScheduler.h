@@ -0,0 +1,341 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#ifndef _RTC_ALARM_SCHEDULER_H_
+#define _RTC_ALARM_SCHEDULER_H_
+
+#include <Arduino.h>
+#include <time.h>
+#include <RTCCommon/RTCCore.h>
+#include <RTCCommon/RTCTime.h>
+#include <RTCCommon/RTCCron.h>
+#include <RTCCommon/RTCEventQueue.h>
+
+/*
+ * Many logical alarms on the two hardware alarms.
+ *
+ * The scheduler keeps the logical alarms in a binary min-heap ordered by
+ * their next fire time, so add() and remove() are O(log n) and the
+ * earliest alarm is always at the root. The root is the only one written
+ * to ALARM1, and it is written again only when the root changes. The MCU
+ * can sleep until the RTC interrupt: call irq() from the pin interrupt
+ * handler and service() from the main loop when pending() says so.
+ * service() reads and clears the alarm flags, runs the callbacks of every
+ * alarm that is due, puts the periodic ones back with their next time and
+ * writes the new root to ALARM1.
+ *
+ * ALARM1 is written with the one-time match (year, month, date and time)
+ * where the part has it, alarm_ext of its register map. Parts without
+ * month and year alarm registers get the monthly match (date and time)
+ * instead, which can wake the MCU early by whole months; such a wake finds
+ * nothing due and only re-arms.
+ *
+ * A periodic alarm that a hardware period can express, every minute, hour,
+ * day or week at second 0, is put on ALARM2 instead while ALARM2 is free.
+ * ALARM2 then runs free with no bus access per fire at all. An ALARM2
+ * match before the alarm's first time is ignored.
+ *
+ * add_cron() takes a compiled cron schedule, see RTCCron.h. One that an
+ * ALARM2 period matches goes on ALARM2 the same way, any other one is
+ * re-armed from rtc_cron_next() after each fire.
+ *
+ * Callbacks run from service(), never from the interrupt, and can add()
+ * and remove() alarms, their own included.
+ *
+ * RTCAlarmScheduler holds the logic and is compiled once.
+ * RTCAlarmSchedulerT binds it to a driver that has set_alarm(),
+ * irq_enable()/irq_disable(), get_status() and irq_clear_flag(), i.e.
+ * MAX31328, MAX31329, MAX31341, MAX31342 or MAX31343, and provides the
+ * storage for a fixed number of alarms:
+ *
+ *	MAX31343 rtc(&Wire);
+ *	RTCAlarmSchedulerT<MAX31343, 64> sched(&rtc);
+ *
+ *	void rtc_isr(void) { sched.irq(); }
+ *
+ *	attachInterrupt(digitalPinToInterrupt(INT_PIN), rtc_isr, FALLING);
+ *	sched.begin();
+ *	sched.add(now + 90, 0, on_timeout, NULL);
+ *	sched.add(midnight, 86400, on_midnight, NULL);
+ *
+ *	if (sched.pending()) sched.service();
+ */
+
+/**
+* @brief	No alarm / position of an alarm slot that is not in use
+*/
+#define RTC_ALARM_ID_NONE		0xFFFF
+
+/**
+* @brief	Alarm flags returned by RTCAlarmScheduler::take_flags()
+*/
+#define RTC_ALARM_FLAG_A1		0x01
+#define RTC_ALARM_FLAG_A2		0x02
+
+/**
+* @brief	Alarm callback
+*
+* @param[in]	id		Alarm id returned by add()
+* @param[in]	when	Time the alarm was due, Unix seconds
+* @param[in]	arg		Pointer given to add()
+*/
+typedef void (*rtc_alarm_cb_t)(uint16_t id, rtc_epoch_t when, void *arg);
+
+/**
+* @brief	Logical alarm
+*/
+typedef struct {
+	rtc_epoch_t		when;		/**< Next fire time, Unix seconds */
+	uint32_t		period;		/**< Seconds between fires, 0 for a one-shot alarm */
+	const rtc_cron_t *cron;		/**< Schedule of an add_cron() alarm, NULL otherwise */
+	rtc_alarm_cb_t	cb;
+	void			*arg;
+	uint16_t		pos;		/**< Heap position, RTC_ALARM_ID_NONE when free */
+} rtc_alarm_entry_t;
+
+/**
+* @brief	Alarm scheduler counters
+*/
+typedef struct {
+	uint32_t fired;		/**< Callbacks run for alarms from the heap */
+	uint32_t fired_a2;	/**< Callbacks run for the alarm on ALARM2 */
+	uint32_t arms;		/**< ALARM1 writes */
+	uint32_t missed;	/**< Periods skipped because service() ran late */
+	uint32_t early;		/**< Wakes with nothing due */
+	uint32_t errors;	/**< Failed RTC accesses */
+} rtc_alarm_sched_stats_t;
+
+class RTCAlarmScheduler
+{
+public:
+	virtual ~RTCAlarmScheduler() {}
+
+	/**
+	* @brief	Clear stale alarm flags and enable the alarm interrupts in use
+	*
+	* @returns	0 on success, the driver's error code on failure
+	*/
+	int begin(void);
+
+	/**
+	* @brief	Add an alarm, O(log n)
+	*
+	* @details	An alarm whose time has already passed fires on the next service().
+	*
+	* @param[in]	when	First fire time, Unix seconds
+	* @param[in]	period	Seconds between fires, 0 for a one-shot alarm
+	* @param[in]	cb		Callback, run from service()
+	* @param[in]	arg		Passed to the callback
+	* @param[out]	id		Alarm id for remove(), can be NULL
+	*
+	* @returns	0 on success, -1 if the scheduler is full or cb is NULL,
+	*			the driver's error code if writing the alarm failed
+	*/
+	int add(rtc_epoch_t when, uint32_t period, rtc_alarm_cb_t cb, void *arg, uint16_t *id = NULL);
+
+	/**
+	* @brief	Add an alarm that fires on a cron schedule, O(log n)
+	*
+	* @details	The first fire is the first match after the current RTC time.
+	*
+	* @param[in]	cron	Schedule from rtc_cron_parse(), kept by pointer until the alarm is removed
+	* @param[in]	cb		Callback, run from service()
+	* @param[in]	arg		Passed to the callback
+	* @param[out]	id		Alarm id for remove(), can be NULL
+	*
+	* @returns	0 on success, -1 if the scheduler is full, cron or cb is NULL or
+	*			the schedule never matches, the driver's error code if an RTC access failed
+	*/
+	int add_cron(const rtc_cron_t *cron, rtc_alarm_cb_t cb, void *arg, uint16_t *id = NULL);
+
+	/**
+	* @brief	Remove an alarm, O(log n)
+	*
+	* @returns	0 on success, -1 if id is not in use,
+	*			the driver's error code if writing the alarm failed
+	*/
+	int remove(uint16_t id);
+
+	/**
+	* @brief	Note the RTC interrupt, safe to call from an interrupt handler
+	*/
+	void irq(void) { m_pending = true; }
+
+	/**
+	* @brief	Whether service() has work: an interrupt came or an alarm was added already due
+	*/
+	bool pending(void) const { return m_pending; }
+
+	/**
+	* @brief	Read and clear the alarm flags, run the due callbacks and re-arm ALARM1
+	*
+	* @param[out]	fired	Number of callbacks run, can be NULL
+	*
+	* @returns	0 on success, the driver's error code on failure
+	*/
+	int service(uint16_t *fired = NULL);
+
+	/**
+	* @brief	Earliest time an alarm is due
+	*
+	* @returns	0 on success, -1 if no alarm is scheduled
+	*/
+	int next(rtc_epoch_t *when) const;
+
+	/**
+	* @brief	Number of alarms scheduled, the one on ALARM2 included
+	*/
+	uint16_t count(void) const { return m_count + (m_a2_id != RTC_ALARM_ID_NONE); }
+
+	/**
+	* @brief	Get counters.
+	*/
+	void get_stats(rtc_alarm_sched_stats_t &stats);
+
+	/**
+	* @brief	Clear counters.
+	*/
+	void reset_stats(void);
+
+protected:
+	/**
+	* @param[in]	entries		capacity slots
+	* @param[in]	heap		capacity slots
+	* @param[in]	capacity	Number of alarms, less than RTC_ALARM_ID_NONE
+	* @param[in]	onetime		ALARM1 has the one-time match
+	*/
+	RTCAlarmScheduler(rtc_alarm_entry_t *entries, uint16_t *heap, uint16_t capacity, bool onetime);
+
+	/** @brief	Driver get_epoch() */
+	virtual int read_rtc(rtc_epoch_t *epoch) = 0;
+
+	/** @brief	Driver set_alarm(), period is an rtc_alarm_period_t */
+	virtual int write_alarm(bool alarm1, const struct tm *time, int period) = 0;
+
+	/** @brief	Driver irq_enable()/irq_disable() of one alarm */
+	virtual int enable_alarm(bool alarm1, bool enable) = 0;
+
+	/** @brief	Read and clear the alarm flags, RTC_ALARM_FLAG_* */
+	virtual int take_flags(uint8_t *flags) = 0;
+
+private:
+	bool fits_alarm2(rtc_epoch_t when, uint32_t period, int *hw_period) const;
+	int add_alarm2(const struct tm *time, int hw_period, const rtc_alarm_entry_t *entry, uint16_t *id);
+	int add_heap(const rtc_alarm_entry_t *entry, uint16_t *id);
+	void heap_swap(uint16_t a, uint16_t b);
+	void sift_up(uint16_t pos);
+	void sift_down(uint16_t pos);
+	void heap_insert(uint16_t id);
+	void heap_remove(uint16_t pos);
+	bool reschedule(rtc_alarm_entry_t *entry, rtc_epoch_t now);
+	int set_alarm1_irq(bool enable);
+	int arm(void);
+
+	rtc_alarm_entry_t *m_entries;
+	uint16_t *m_heap;		/* Alarm ids, [0, m_count) is the heap, the rest are free ids */
+	uint16_t m_capacity;
+	uint16_t m_count;
+	rtc_epoch_t m_armed;	/* Time written to ALARM1 */
+	bool m_armed_valid;
+	bool m_a1_enabled;
+	bool m_onetime;			/* ALARM1 takes the one-time match */
+	bool m_in_service;
+	volatile bool m_pending;
+
+	uint16_t m_a2_id;		/* Alarm on ALARM2, RTC_ALARM_ID_NONE if none */
+	rtc_alarm_entry_t m_a2;
+	rtc_alarm_sched_stats_t m_stats;
+};
+
+/**
+* @brief	Whether ALARM1 of a driver on RTCCore has the one-time match
+*/
+template <class Derived, class Regs>
+bool rtc_alarm_onetime(const RTCCoreT<Derived, Regs> *core)
+{
+	(void)core;
+	return Regs::alarm_ext;
+}
+
+/**
+* @brief	Alarm scheduler with room for N alarms over a MAX31328, MAX31329, MAX31341, MAX31342 or MAX31343
+*/
+template <class RTC, uint16_t N>
+class RTCAlarmSchedulerT : public RTCAlarmScheduler
+{
+public:
+	/**
+	* @param[in]	rtc		Driver, begin() already called
+	*/
+	explicit RTCAlarmSchedulerT(RTC *rtc)
+		: RTCAlarmScheduler(m_slots, m_ids, N, rtc_alarm_onetime(rtc)), m_rtc(rtc) {}
+
+protected:
+	int read_rtc(rtc_epoch_t *epoch) { return m_rtc->get_epoch(epoch); }
+
+	int write_alarm(bool alarm1, const struct tm *time, int period)
+	{
+		return m_rtc->set_alarm(alarm1 ? RTC::ALARM1 : RTC::ALARM2, time,
+			(typename RTC::alarm_period_t)period);
+	}
+
+	int enable_alarm(bool alarm1, bool enable)
+	{
+		typename RTC::intr_id_t id = alarm1 ? RTC::INTR_ID_ALARM1 : RTC::INTR_ID_ALARM2;
+
+		return enable ? m_rtc->irq_enable(id) : m_rtc->irq_disable(id);
+	}
+
+	int take_flags(uint8_t *flags)
+	{
+		int ret;
+		uint8_t status;
+
+		/* One status read, the flags cleared with a write only where the read does not */
+		ret = rtc_event_read_status(m_rtc, &status);
+		if (ret) {
+			return ret;
+		}
+
+		*flags = ((status & RTC::INTR_ID_ALARM1) ? RTC_ALARM_FLAG_A1 : 0) |
+			((status & RTC::INTR_ID_ALARM2) ? RTC_ALARM_FLAG_A2 : 0);
+
+		return 0;
+	}
+
+private:
+	RTC *m_rtc;
+	rtc_alarm_entry_t m_slots[N];
+	uint16_t m_ids[N];
+};
+
+#endif /* _RTC_ALARM_SCHEDULER_H_ */
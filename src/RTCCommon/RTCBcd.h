@@ -0,0 +1,241 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#ifndef _RTC_BCD_H_
+#define _RTC_BCD_H_
+
+#include <stdint.h>
+
+/*
+ * BCD conversions shared by the drivers.
+ *
+ * rtc_bcd_decode_time() turns the seconds to year register block, and
+ * rtc_bcd_decode_time_hr() the MAX3133X block that starts with the 1/128 s
+ * register, into binary fields in one pass. ANALOG_RTC_BCD selects how,
+ * for the whole library, e.g. -DANALOG_RTC_BCD=RTC_BCD_SWAR:
+ *
+ *	RTC_BCD_ARITH	16 * hi + lo - 6 * hi per byte. Smallest, the default
+ *					on 8 and 16-bit targets.
+ *	RTC_BCD_LUT		256-byte table, one load per byte. The table is
+ *					const data, which AVR keeps in RAM.
+ *	RTC_BCD_SWAR	The same arithmetic on four bytes at a time in a
+ *					32-bit word. The default on 32-bit and wider targets.
+ *
+ * All three give the same result for every input, invalid BCD included.
+ * The _arith/_lut/_swar variants are always available, for benchmarks.
+ */
+#define RTC_BCD_ARITH	0
+#define RTC_BCD_LUT		1
+#define RTC_BCD_SWAR	2
+
+#ifndef ANALOG_RTC_BCD
+#if UINTPTR_MAX > 0xFFFF
+#define ANALOG_RTC_BCD	RTC_BCD_SWAR
+#else
+#define ANALOG_RTC_BCD	RTC_BCD_ARITH
+#endif
+#endif
+
+/**
+* @brief	Time register block in binary
+*/
+typedef struct {
+	uint8_t frac;	/**< 1/128 s, 0 to 127, only set by rtc_bcd_decode_time_hr() */
+	uint8_t sec;	/**< 0 to 59 */
+	uint8_t min;	/**< 0 to 59 */
+	uint8_t hour;	/**< 0 to 23, from 12 or 24 hour mode */
+	uint8_t wday;	/**< Day of week register, 1 to 7 */
+	uint8_t mday;	/**< 1 to 31 */
+	uint8_t mon;	/**< 1 to 12 */
+	uint8_t year;	/**< Years since 2000, 0 to 199, century bit included */
+} rtc_bcd_time_t;
+
+/* Template so that the table has one copy in an image, without a .cpp */
+template <int N = 0>
+struct rtc_bcd_table {
+	static const uint8_t lut[256];
+};
+
+#define RTC_BCD_ROW(h)	(h) * 10, (h) * 10 + 1, (h) * 10 + 2, (h) * 10 + 3, \
+						(h) * 10 + 4, (h) * 10 + 5, (h) * 10 + 6, (h) * 10 + 7, \
+						(h) * 10 + 8, (h) * 10 + 9, (h) * 10 + 10, (h) * 10 + 11, \
+						(h) * 10 + 12, (h) * 10 + 13, (h) * 10 + 14, (h) * 10 + 15
+
+template <int N>
+const uint8_t rtc_bcd_table<N>::lut[256] = {
+	RTC_BCD_ROW(0), RTC_BCD_ROW(1), RTC_BCD_ROW(2), RTC_BCD_ROW(3),
+	RTC_BCD_ROW(4), RTC_BCD_ROW(5), RTC_BCD_ROW(6), RTC_BCD_ROW(7),
+	RTC_BCD_ROW(8), RTC_BCD_ROW(9), RTC_BCD_ROW(10), RTC_BCD_ROW(11),
+	RTC_BCD_ROW(12), RTC_BCD_ROW(13), RTC_BCD_ROW(14), RTC_BCD_ROW(15),
+};
+
+#undef RTC_BCD_ROW
+
+static inline uint8_t rtc_bcd2bin_arith(uint8_t val)
+{
+	return val - (val >> 4) * 6;
+}
+
+static inline uint8_t rtc_bcd2bin_lut(uint8_t val)
+{
+	return rtc_bcd_table<>::lut[val];
+}
+
+/**
+* @brief	Binary of a BCD byte
+*/
+static inline uint8_t rtc_bcd2bin(uint8_t val)
+{
+#if ANALOG_RTC_BCD == RTC_BCD_LUT
+	return rtc_bcd2bin_lut(val);
+#else
+	return rtc_bcd2bin_arith(val);
+#endif
+}
+
+/**
+* @brief	BCD byte of a binary value, 0 to 99
+*/
+static inline uint8_t rtc_bin2bcd(uint8_t val)
+{
+	return val + (val / 10) * 6;
+}
+
+/**
+* @brief	Hours, 0 to 23, of an hours register in 12 (bit 6 set, bit 5 PM) or 24 hour mode
+*/
+static inline uint8_t rtc_bcd_hours(uint8_t reg)
+{
+	uint8_t hours;
+
+	if (reg & (1 << 6)) {
+		/* 12 hour mode, 12 AM is midnight */
+		hours = rtc_bcd2bin(reg & 0x1F) % 12;
+		if (reg & (1 << 5)) {
+			hours += 12;
+		}
+	} else {
+		hours = rtc_bcd2bin(reg & 0x3F);
+	}
+
+	return hours;
+}
+
+/* Field masks of seconds, minutes, hours, day; date, month, year */
+#define RTC_BCD_MASK_LO		0x073F7F7FUL
+#define RTC_BCD_MASK_HI		0x00FF1F3FUL
+
+/* 16 * hi + lo to 10 * hi + lo in each byte. hi * 6 fits a byte and never exceeds it, no carries */
+static inline uint32_t rtc_bcd2bin_swar(uint32_t word)
+{
+	return word - ((word >> 4) & 0x0F0F0F0FUL) * 6;
+}
+
+static inline void rtc_bcd_decode_time_swar(const uint8_t *regs, rtc_bcd_time_t *time)
+{
+	uint32_t lo = (uint32_t)regs[0] | ((uint32_t)regs[1] << 8) | ((uint32_t)regs[2] << 16)
+				  | ((uint32_t)regs[3] << 24);
+	uint32_t hi = (uint32_t)regs[4] | ((uint32_t)regs[5] << 8) | ((uint32_t)regs[6] << 16);
+
+	lo = rtc_bcd2bin_swar(lo & RTC_BCD_MASK_LO);
+	hi = rtc_bcd2bin_swar(hi & RTC_BCD_MASK_HI);
+
+	time->sec = (uint8_t)lo;
+	time->min = (uint8_t)(lo >> 8);
+	time->hour = (uint8_t)(lo >> 16);
+	time->wday = (uint8_t)(lo >> 24);
+	time->mday = (uint8_t)hi;
+	time->mon = (uint8_t)(hi >> 8);
+	time->year = (uint8_t)(hi >> 16) + ((regs[5] & 0x80) ? 100 : 0);
+
+	if (regs[2] & (1 << 6)) {
+		time->hour = rtc_bcd_hours(regs[2]);
+	}
+}
+
+static inline void rtc_bcd_decode_time_lut(const uint8_t *regs, rtc_bcd_time_t *time)
+{
+	time->sec = rtc_bcd2bin_lut(regs[0] & 0x7F);
+	time->min = rtc_bcd2bin_lut(regs[1] & 0x7F);
+	time->hour = rtc_bcd2bin_lut(regs[2] & 0x3F);
+	time->wday = rtc_bcd2bin_lut(regs[3] & 0x07);
+	time->mday = rtc_bcd2bin_lut(regs[4] & 0x3F);
+	time->mon = rtc_bcd2bin_lut(regs[5] & 0x1F);
+	time->year = rtc_bcd2bin_lut(regs[6]) + ((regs[5] & 0x80) ? 100 : 0);
+
+	if (regs[2] & (1 << 6)) {
+		time->hour = rtc_bcd_hours(regs[2]);
+	}
+}
+
+static inline void rtc_bcd_decode_time_arith(const uint8_t *regs, rtc_bcd_time_t *time)
+{
+	time->sec = rtc_bcd2bin_arith(regs[0] & 0x7F);
+	time->min = rtc_bcd2bin_arith(regs[1] & 0x7F);
+	time->hour = rtc_bcd2bin_arith(regs[2] & 0x3F);
+	time->wday = rtc_bcd2bin_arith(regs[3] & 0x07);
+	time->mday = rtc_bcd2bin_arith(regs[4] & 0x3F);
+	time->mon = rtc_bcd2bin_arith(regs[5] & 0x1F);
+	time->year = rtc_bcd2bin_arith(regs[6]) + ((regs[5] & 0x80) ? 100 : 0);
+
+	if (regs[2] & (1 << 6)) {
+		time->hour = rtc_bcd_hours(regs[2]);
+	}
+}
+
+/**
+* @brief	Decode seconds, minutes, hours, day, date, month with the century bit, year
+*
+* @param[in]	regs	7 registers, seconds first
+* @param[out]	time	Binary fields, frac left as is
+*/
+static inline void rtc_bcd_decode_time(const uint8_t *regs, rtc_bcd_time_t *time)
+{
+#if ANALOG_RTC_BCD == RTC_BCD_SWAR
+	rtc_bcd_decode_time_swar(regs, time);
+#elif ANALOG_RTC_BCD == RTC_BCD_LUT
+	rtc_bcd_decode_time_lut(regs, time);
+#else
+	rtc_bcd_decode_time_arith(regs, time);
+#endif
+}
+
+/**
+* @brief	Decode the MAX3133X block: 1/128 s, then the 7 registers of rtc_bcd_decode_time()
+*/
+static inline void rtc_bcd_decode_time_hr(const uint8_t *regs, rtc_bcd_time_t *time)
+{
+	time->frac = regs[0] & 0x7F;
+	rtc_bcd_decode_time(&regs[1], time);
+}
+
+#endif /* _RTC_BCD_H_ */
@@ -0,0 +1,104 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#ifndef _RTC_BUS_STATS_H_
+#define _RTC_BUS_STATS_H_
+
+#include <Arduino.h>
+
+/*
+ * Bus instrumentation for the driver read_register()/write_register() paths.
+ *
+ * Disabled by default; nothing below adds code or data to the drivers unless
+ * ANALOG_RTC_BUS_STATS is non-zero. Enable it for the whole library, e.g.
+ * with a build flag (-DANALOG_RTC_BUS_STATS=1), not from a sketch: the
+ * setting changes the size of the driver classes and must be the same in
+ * every translation unit.
+ */
+#ifndef ANALOG_RTC_BUS_STATS
+#define ANALOG_RTC_BUS_STATS	0
+#endif
+
+/**
+* @brief	Bus error classes, numbered after Wire endTransmission() codes
+*/
+typedef enum {
+	RTC_BUS_ERR_DATA_TOO_LONG = 1,	/**< Data too long to fit in transmit buffer */
+	RTC_BUS_ERR_ADDR_NACK,			/**< NACK on transmit of address */
+	RTC_BUS_ERR_DATA_NACK,			/**< NACK on transmit of data */
+	RTC_BUS_ERR_OTHER,				/**< Other error */
+	RTC_BUS_ERR_SHORT_READ,			/**< Fewer bytes received than requested */
+	RTC_BUS_ERR_MAX
+} rtc_bus_err_t;
+
+/**
+* @brief	Bus counters kept by each driver instance
+*/
+typedef struct {
+	uint32_t transactions;				/**< Transport calls, a register read is one write-then-read transfer */
+	uint32_t bytes_out;					/**< Bytes written, register address included */
+	uint32_t bytes_in;					/**< Bytes read */
+	uint32_t errors[RTC_BUS_ERR_MAX];	/**< Errors indexed by rtc_bus_err_t, [0] unused */
+	uint32_t bus_time_us;				/**< Time spent in read_register()/write_register(), from micros() */
+} rtc_bus_stats_t;
+
+#if ANALOG_RTC_BUS_STATS
+
+/**
+* @brief	Adds the time spent in the enclosing scope to bus_time_us
+*/
+class RTCBusTimer
+{
+public:
+	RTCBusTimer(rtc_bus_stats_t &stats) : m_stats(stats), m_start(micros()) {}
+	~RTCBusTimer() { m_stats.bus_time_us += micros() - m_start; }
+
+private:
+	rtc_bus_stats_t &m_stats;
+	unsigned long m_start;
+};
+
+#define RTC_BUS_STATS_RESET(s)			memset(&(s), 0, sizeof(s))
+#define RTC_BUS_STATS_TIME(s)			RTCBusTimer rtc_bus_timer_(s)
+#define RTC_BUS_STATS_XFER(s, out, in)	do { (s).transactions++; (s).bytes_out += (out); (s).bytes_in += (in); } while (0)
+#define RTC_BUS_STATS_ERROR(s, code)	((s).errors[((code) > 0 && (code) < RTC_BUS_ERR_MAX) ? (code) : RTC_BUS_ERR_OTHER]++)
+
+#else
+
+#define RTC_BUS_STATS_RESET(s)			do { } while (0)
+#define RTC_BUS_STATS_TIME(s)			do { } while (0)
+#define RTC_BUS_STATS_XFER(s, out, in)	do { } while (0)
+#define RTC_BUS_STATS_ERROR(s, code)	do { } while (0)
+
+#endif /* ANALOG_RTC_BUS_STATS */
+
+#endif /* _RTC_BUS_STATS_H_ */
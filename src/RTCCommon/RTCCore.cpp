@@ -0,0 +1,454 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#include <RTCCommon/RTCCore.h>
+
+/* Time block */
+#define MONTH_CENTURY		(1 << 7)
+
+/* Alarm blocks */
+#define ALARM_MASK			(1 << 7)	/* AxMn: don't care bit of sec/min/hrs/day_date */
+#define ALARM_DY_DT			(1 << 6)	/* 1: day of week match, 0: date match */
+#define ALARM_MON_M5		(1 << 7)	/* A1M5: don't care month */
+#define ALARM_MON_M6		(1 << 6)	/* A1M6: don't care year */
+
+enum {
+	REG_SEC,
+	REG_MIN,
+	REG_HRS,
+	REG_DAY_DATE,
+	REG_MON,
+	REG_YEAR
+};
+
+RTCCore::RTCCore(TwoWire *i2c, uint8_t i2c_addr) : m_wire(i2c)
+{
+	if (i2c == NULL) {
+		while (1);
+	}
+
+	m_bus = &m_wire;
+	m_slave_addr = i2c_addr;
+	m_rollover_check = false;
+	reset_time_read_stats();
+	RTC_BUS_STATS_RESET(m_bus_stats);
+}
+
+RTCCore::RTCCore(RTCTransport *bus, uint8_t i2c_addr)
+{
+	if (bus == NULL) {
+		while (1);
+	}
+
+	m_bus = bus;
+	m_slave_addr = i2c_addr;
+	m_rollover_check = false;
+	reset_time_read_stats();
+	RTC_BUS_STATS_RESET(m_bus_stats);
+}
+
+int RTCCore::read_register(uint8_t reg, uint8_t *buf, uint8_t len/*=1*/)
+{
+	int ret;
+
+	RTC_BUS_STATS_TIME(m_bus_stats);
+
+	/*
+		Register address write and data read in one transfer, joined by a restart.
+		The bus is not released between them, which prevents another master device
+		from transmitting between the two phases.
+	*/
+	ret = m_bus->read_register(m_slave_addr, reg, buf, len);
+	RTC_BUS_STATS_XFER(m_bus_stats, 1, (ret == 0) ? len : 0);
+	/*
+		0:success
+		1:data too long to fit in transmit buffer
+		2:received NACK on transmit of address
+		3:received NACK on transmit of data
+		4:other error
+		5:slave sent less than requested
+	*/
+	if (ret != 0) {
+		RTC_BUS_STATS_ERROR(m_bus_stats, ret);
+		return -1;
+	}
+
+	return ret;
+}
+
+int RTCCore::write_register(uint8_t reg, const uint8_t *buf, uint8_t len/*=1*/)
+{
+	int ret;
+
+	RTC_BUS_STATS_TIME(m_bus_stats);
+
+	ret = m_bus->write_register(m_slave_addr, reg, buf, len);
+	RTC_BUS_STATS_XFER(m_bus_stats, 1 + len, 0);
+	/*
+		0:success
+		1:data too long to fit in transmit buffer
+		2:received NACK on transmit of address
+		3:received NACK on transmit of data
+		4:other error
+	*/
+	if (ret != 0) {
+		RTC_BUS_STATS_ERROR(m_bus_stats, ret);
+	}
+
+	return ret;
+}
+
+int RTCCore::read_burst(uint8_t reg, uint8_t *buf, int len)
+{
+	int ret;
+	int chunk;
+	int max = m_bus->max_read();
+
+	while (len > 0) {
+		chunk = (len > max) ? max : len;
+
+		ret = read_register(reg, buf, chunk);
+		if (ret) {
+			return ret;
+		}
+
+		reg += chunk;
+		buf += chunk;
+		len -= chunk;
+	}
+
+	return 0;
+}
+
+int RTCCore::write_burst(uint8_t reg, const uint8_t *buf, int len)
+{
+	int ret;
+	int chunk;
+	int max = m_bus->max_write();
+
+	while (len > 0) {
+		chunk = (len > max) ? max : len;
+
+		ret = write_register(reg, buf, chunk);
+		if (ret) {
+			return ret;
+		}
+
+		reg += chunk;
+		buf += chunk;
+		len -= chunk;
+	}
+
+	return 0;
+}
+
+#if ANALOG_RTC_BUS_STATS
+void RTCCore::get_bus_stats(rtc_bus_stats_t &stats)
+{
+	stats = m_bus_stats;
+}
+
+void RTCCore::reset_bus_stats(void)
+{
+	RTC_BUS_STATS_RESET(m_bus_stats);
+}
+#endif
+
+RTCTransport *RTCCore::get_transport(void)
+{
+	return m_bus;
+}
+
+void RTCCore::set_rollover_check(bool enable)
+{
+	m_rollover_check = enable;
+}
+
+void RTCCore::get_time_read_stats(rtc_time_read_stats_t &stats)
+{
+	stats = m_time_read_stats;
+}
+
+void RTCCore::reset_time_read_stats(void)
+{
+	memset(&m_time_read_stats, 0, sizeof(m_time_read_stats));
+}
+
+void RTCCore::decode_time(const uint8_t *regs, struct tm *time)
+{
+	rtc_bcd_time_t bin;
+
+	rtc_bcd_decode_time(regs, &bin);
+
+	/* tm_sec seconds [0,61] */
+	time->tm_sec = bin.sec;
+	/* tm_min minutes [0,59] */
+	time->tm_min = bin.min;
+	/* tm_hour hour [0,23] */
+	time->tm_hour = bin.hour;
+	/* tm_wday day of week [0,6] (Sunday = 0) */
+	time->tm_wday = bin.wday - 1;
+	/* tm_mday day of month [1,31] */
+	time->tm_mday = bin.mday;
+	/* tm_mon month of year [0,11] */
+	time->tm_mon = bin.mon - 1;
+	/* tm_year years since 1900 */
+	time->tm_year = bin.year + 100;
+	/* tm_yday day of year [0,365] */
+	time->tm_yday = rtc_yday(time->tm_year + 1900, bin.mon, bin.mday);
+	/* tm_isdst daylight savings flag */
+	time->tm_isdst = 0; /* UTC, RTCTimeZone gives local time */
+}
+
+int RTCCore::encode_time(const struct tm *time, uint8_t *regs)
+{
+	/*********************************************************
+	 * +----------+------+---------------------------+-------+
+	 * | Member   | Type | Meaning                   | Range |
+	 * +----------+------+---------------------------+-------+
+	 * | tm_sec   | int  | seconds after the minute  | 0-61* |
+	 * | tm_min   | int  | minutes after the hour    | 0-59  |
+	 * | tm_hour  | int  | hours since midnight      | 0-23  |
+	 * | tm_mday  | int  | day of the month          | 1-31  |
+	 * | tm_mon   | int  | months since January      | 0-11  |
+	 * | tm_year  | int  | years since 1900          |       |
+	 * | tm_wday  | int  | days since Sunday         | 0-6   |
+	 * | tm_yday  | int  | days since January 1      | 0-365 |
+	 * | tm_isdst | int  | Daylight Saving Time flag |       |
+	 * +----------+------+---------------------------+-------+
+	 * * tm_sec is generally 0-59. The extra range is to accommodate for leap
+	 *   seconds in certain systems.
+	 *********************************************************/
+	regs[0] = rtc_bin2bcd(time->tm_sec);
+	regs[1] = rtc_bin2bcd(time->tm_min);
+	regs[2] = rtc_bin2bcd(time->tm_hour);
+	regs[3] = rtc_bin2bcd(time->tm_wday + 1);
+	regs[4] = rtc_bin2bcd(time->tm_mday);
+	regs[5] = rtc_bin2bcd(time->tm_mon + 1);
+
+	if (time->tm_year >= 200) {
+		regs[5] |= MONTH_CENTURY;
+		regs[6] = rtc_bin2bcd(time->tm_year - 200);
+	} else if (time->tm_year >= 100) {
+		regs[6] = rtc_bin2bcd(time->tm_year - 100);
+	} else {
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Alarm time registers, the mask bits are or'ed in by the callers
+ */
+static void encode_alarm_time(const struct tm *alarm_time, bool dy_dt, uint8_t *regs)
+{
+	regs[REG_SEC] = rtc_bin2bcd(alarm_time->tm_sec);
+	regs[REG_MIN] = rtc_bin2bcd(alarm_time->tm_min);
+	regs[REG_HRS] = rtc_bin2bcd(alarm_time->tm_hour);
+
+	if (dy_dt) {
+		/* Day match, the day register counts 1 to 7 as the time registers do */
+		regs[REG_DAY_DATE] = rtc_bin2bcd(alarm_time->tm_wday + 1) | ALARM_DY_DT;
+	} else {
+		/* Date match */
+		regs[REG_DAY_DATE] = rtc_bin2bcd(alarm_time->tm_mday);
+	}
+}
+
+static void decode_alarm_time(const uint8_t *regs, struct tm *alarm_time)
+{
+	alarm_time->tm_sec = rtc_bcd2bin(regs[REG_SEC] & 0x7F);
+	alarm_time->tm_min = rtc_bcd2bin(regs[REG_MIN] & 0x7F);
+	alarm_time->tm_hour = rtc_bcd2bin(regs[REG_HRS] & 0x3F);
+
+	if (regs[REG_DAY_DATE] & ALARM_DY_DT) { /* day */
+		alarm_time->tm_wday = rtc_bcd2bin(regs[REG_DAY_DATE] & 0x0F) - 1;
+	} else { /* date */
+		alarm_time->tm_mday = rtc_bcd2bin(regs[REG_DAY_DATE] & 0x3F);
+	}
+}
+
+int RTCCore::encode_alarm(bool alarm1, const struct tm *alarm_time, int period, uint8_t *regs)
+{
+	/* Number of AxMn bits cleared, from seconds up */
+	uint8_t match;
+
+	if (!alarm1 && (period == RTC_ALARM_PERIOD_EVERYSECOND)) {
+		return -1; /* Alarm2 does not support "once per second" alarm */
+	}
+
+	switch (period) {
+		case RTC_ALARM_PERIOD_EVERYSECOND:	match = 0; break;
+		case RTC_ALARM_PERIOD_EVERYMINUTE:	match = 1; break;
+		case RTC_ALARM_PERIOD_HOURLY:		match = 2; break;
+		case RTC_ALARM_PERIOD_DAILY:		match = 3; break;
+		case RTC_ALARM_PERIOD_WEEKLY:
+		case RTC_ALARM_PERIOD_MONTHLY:		match = 4; break;
+		default:
+			return -1;
+	}
+
+	encode_alarm_time(alarm_time, period != RTC_ALARM_PERIOD_MONTHLY, regs);
+
+	for (uint8_t i = match; i < RTC_CORE_ALARM_LEN; i++) {
+		regs[i] |= ALARM_MASK;
+	}
+
+	return 0;
+}
+
+int RTCCore::decode_alarm(bool alarm1, const uint8_t *regs, struct tm *alarm_time)
+{
+	int period;
+
+	decode_alarm_time(regs, alarm_time);
+
+	period = alarm1 ? RTC_ALARM_PERIOD_EVERYSECOND : RTC_ALARM_PERIOD_EVERYMINUTE;
+
+	if (alarm1 && !(regs[REG_SEC] & ALARM_MASK)) period = RTC_ALARM_PERIOD_EVERYMINUTE;
+	if (!(regs[REG_MIN] & ALARM_MASK)) period = RTC_ALARM_PERIOD_HOURLY;
+	if (!(regs[REG_HRS] & ALARM_MASK)) period = RTC_ALARM_PERIOD_DAILY;
+	if (!(regs[REG_DAY_DATE] & ALARM_MASK)) period = RTC_ALARM_PERIOD_WEEKLY;
+	if (!(regs[REG_DAY_DATE] & ALARM_DY_DT)) period = RTC_ALARM_PERIOD_MONTHLY;
+
+	return period;
+}
+
+int RTCCore::encode_alarm_ext(bool alarm1, const struct tm *alarm_time, int period, uint8_t *regs)
+{
+	/* Number of AxMn bits set on sec/min/hrs/day_date, from seconds up */
+	uint8_t mask;
+	uint8_t mon = 0;
+
+	if (!alarm1) {
+		switch (period) {
+			case RTC_ALARM_PERIOD_EVERYSECOND:
+			case RTC_ALARM_PERIOD_ONETIME:
+			case RTC_ALARM_PERIOD_YEARLY:
+				return -1; // not support for alarm 2
+		}
+	}
+
+	switch (period) {
+		case RTC_ALARM_PERIOD_ONETIME:		mask = 0; break;
+		case RTC_ALARM_PERIOD_YEARLY:		mask = 0; mon = ALARM_MON_M6; break;
+		case RTC_ALARM_PERIOD_MONTHLY:
+		case RTC_ALARM_PERIOD_WEEKLY:		mask = 0; mon = ALARM_MON_M5 | ALARM_MON_M6; break;
+		case RTC_ALARM_PERIOD_DAILY:		mask = 1; mon = ALARM_MON_M5 | ALARM_MON_M6; break;
+		case RTC_ALARM_PERIOD_HOURLY:		mask = 2; mon = ALARM_MON_M5 | ALARM_MON_M6; break;
+		case RTC_ALARM_PERIOD_EVERYMINUTE:	mask = 3; mon = ALARM_MON_M5 | ALARM_MON_M6; break;
+		case RTC_ALARM_PERIOD_EVERYSECOND:	mask = 4; mon = ALARM_MON_M5 | ALARM_MON_M6; break;
+		default:
+			return -1;
+	}
+
+	encode_alarm_time(alarm_time, period == RTC_ALARM_PERIOD_WEEKLY, regs);
+
+	for (uint8_t i = 0; i < mask; i++) {
+		regs[REG_DAY_DATE - i] |= ALARM_MASK;
+	}
+
+	regs[REG_MON] = rtc_bin2bcd(alarm_time->tm_mon + 1) | mon;
+
+	if (alarm_time->tm_year >= 200) {
+		regs[REG_YEAR] = rtc_bin2bcd(alarm_time->tm_year - 200);
+	} else if (alarm_time->tm_year >= 100) {
+		regs[REG_YEAR] = rtc_bin2bcd(alarm_time->tm_year - 100);
+	} else {
+		return -1;
+	}
+
+	return 0;
+}
+
+int RTCCore::decode_alarm_ext(bool alarm1, const uint8_t *regs, struct tm *alarm_time)
+{
+	int alarm;
+
+	decode_alarm_time(regs, alarm_time);
+
+	if (alarm1) {
+		alarm_time->tm_mon = rtc_bcd2bin(regs[REG_MON] & 0x1F) - 1;
+		alarm_time->tm_year = rtc_bcd2bin(regs[REG_YEAR]) + 100;	/* XXX no century bit */
+
+		alarm = (regs[REG_SEC] >> 7) | ((regs[REG_MIN] >> 7) << 1)
+				| ((regs[REG_HRS] >> 7) << 2) | ((regs[REG_DAY_DATE] >> 7) << 3)
+				| ((regs[REG_MON] >> 7) << 4) | (((regs[REG_MON] >> 6) & 1) << 5)
+				| (((regs[REG_DAY_DATE] >> 6) & 1) << 6);
+
+		switch (alarm) {
+			case 0b1111111:
+			case 0b0111111:
+				return RTC_ALARM_PERIOD_EVERYSECOND;
+			case 0b1111110:
+			case 0b0111110:
+				return RTC_ALARM_PERIOD_EVERYMINUTE;
+			case 0b1111100:
+			case 0b0111100:
+				return RTC_ALARM_PERIOD_HOURLY;
+			case 0b0111000:
+			case 0b1111000:
+				return RTC_ALARM_PERIOD_DAILY;
+			case 0b0110000:
+				return RTC_ALARM_PERIOD_MONTHLY;
+			case 0b0100000:
+				return RTC_ALARM_PERIOD_YEARLY;
+			case 0b0000000:
+				return RTC_ALARM_PERIOD_ONETIME;
+			case 0b1110000:
+				return RTC_ALARM_PERIOD_WEEKLY;
+		}
+	} else {
+		alarm = (regs[REG_MIN] >> 7) | ((regs[REG_HRS] >> 7) << 1)
+				| ((regs[REG_DAY_DATE] >> 7) << 2)
+				| (((regs[REG_DAY_DATE] >> 6) & 1) << 3);
+
+		switch (alarm) {
+			case 0b1111:
+			case 0b0111:
+				return RTC_ALARM_PERIOD_EVERYMINUTE;
+			case 0b1110:
+			case 0b0110:
+				return RTC_ALARM_PERIOD_HOURLY;
+			case 0b1100:
+			case 0b0100:
+				return RTC_ALARM_PERIOD_DAILY;
+			case 0b0000:
+				return RTC_ALARM_PERIOD_MONTHLY;
+			case 0b1000:
+				return RTC_ALARM_PERIOD_WEEKLY;
+		}
+	}
+
+	return -1;
+}
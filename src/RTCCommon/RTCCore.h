@@ -0,0 +1,448 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#ifndef _RTC_CORE_H_
+#define _RTC_CORE_H_
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <time.h>
+#include <RTCCommon/RTCBusStats.h>
+#include <RTCCommon/RTCTime.h>
+#include <RTCCommon/RTCTransport.h>
+
+/*
+ * Code shared by the MAX31328, MAX31329, MAX31341, MAX31342 and MAX31343
+ * drivers.
+ *
+ * RTCCore is a plain class: the bus access and the BCD time/alarm codecs
+ * are compiled once and shared by every driver linked into an image.
+ * RTCCoreT adds the get/set time and alarm sequences on top of it. It is
+ * parameterised with the driver (CRTP), so register access goes through
+ * the driver's own read_register()/write_register(), and with a register
+ * map policy of the part. Both are inline and only a few instructions long.
+ */
+
+/**
+* @brief	Length of the seconds to year time block
+*/
+#define RTC_CORE_TIME_LEN		7
+
+/**
+* @brief	Length of an alarm block: seconds, minutes, hours and day/date
+*/
+#define RTC_CORE_ALARM_LEN		4
+
+/**
+* @brief	Length of an alarm block with month and year, RTCCore::encode_alarm_ext()
+*/
+#define RTC_CORE_ALARM_EXT_LEN	6
+
+/**
+* @brief	Alarm periods, the drivers' alarm_period_t values must match
+*/
+typedef enum {
+	RTC_ALARM_PERIOD_EVERYSECOND,	/**< Once per second */
+	RTC_ALARM_PERIOD_EVERYMINUTE,	/**< Second match / Once per minute */
+	RTC_ALARM_PERIOD_HOURLY,		/**< Second and Minute match */
+	RTC_ALARM_PERIOD_DAILY,			/**< Hour, Minute and Second match */
+	RTC_ALARM_PERIOD_WEEKLY,		/**< Day and Time match */
+	RTC_ALARM_PERIOD_MONTHLY,		/**< Date and Time match */
+	RTC_ALARM_PERIOD_YEARLY,		/**< Month, Date and Time match, extended alarms only */
+	RTC_ALARM_PERIOD_ONETIME		/**< Year, Month, Date and Time match, extended alarms only */
+} rtc_alarm_period_t;
+
+/**
+* @brief	Counters of the rollover-checked time read, RTCCore::set_rollover_check()
+*/
+typedef struct {
+	uint32_t reads;		/**< Time block reads */
+	uint32_t checks;	/**< Reads that saw 59 seconds and read the seconds register again */
+	uint32_t rereads;	/**< Checks that saw the second change and read the block again */
+} rtc_time_read_stats_t;
+
+class RTCCore
+{
+public:
+	/**
+	* @brief        Read one or more registers
+	*
+	* @param[in]    reg Starting register address
+	* @param[out]   buf Buffer to store the register values
+	* @param[in]    len Number of registers to read
+	*
+	* @returns      0 on success, -1 on failure
+	*/
+	int read_register(uint8_t reg, uint8_t *buf, uint8_t len=1);
+
+	/**
+	* @brief        Write one or more registers
+	*
+	* @param[in]    reg Starting register address
+	* @param[in]    buf Register values to write
+	* @param[in]    len Number of registers to write
+	*
+	* @returns      0 on success, rtc_bus_err_t on failure
+	*/
+	int write_register(uint8_t reg, const uint8_t *buf, uint8_t len=1);
+
+#if ANALOG_RTC_BUS_STATS
+	/**
+	* @brief        Get bus counters accumulated by read_register()/write_register()
+	*
+	* @param[out]   stats Counters
+	*/
+	void get_bus_stats(rtc_bus_stats_t &stats);
+
+	/**
+	* @brief        Clear bus counters
+	*/
+	void reset_bus_stats(void);
+#endif
+
+	/**
+	* @brief        Transport the driver talks through, to set its recovery policy
+	*/
+	RTCTransport *get_transport(void);
+
+	/**
+	* @brief        Make get_time()/get_epoch() safe against a second that ticks during the read
+	*
+	* @details      On a part without a read latch (MAX31328, MAX31329) the
+	*               burst read of the time block can see the seconds before a
+	*               tick and the minutes after it, so 59 s of one minute are
+	*               returned with the next minute. Only a tick from 59 carries
+	*               past the seconds register, so the check costs nothing
+	*               unless the seconds read are 59. Then the seconds register
+	*               is read again and, if it has moved on, the block as well.
+	*               On by default on parts without a read latch, off on the
+	*               others.
+	*
+	* @param[in]    enable true to check
+	*/
+	void set_rollover_check(bool enable);
+
+	/**
+	* @brief        Get the counters of the checked read
+	*/
+	void get_time_read_stats(rtc_time_read_stats_t &stats);
+
+	/**
+	* @brief        Clear the counters of the checked read
+	*/
+	void reset_time_read_stats(void);
+
+	/**
+	* @brief	Decode a seconds to year time block
+	*
+	* @details	A 12 hour mode hours register, bit 6 set, is converted to 24 hours.
+	*
+	* @param[in]	regs	RTC_CORE_TIME_LEN registers
+	* @param[out]	time	Decoded time, tm_isdst is zero
+	*/
+	static void decode_time(const uint8_t *regs, struct tm *time);
+
+	/**
+	* @brief	Encode a seconds to year time block in 24 hour mode
+	*
+	* @param[in]	time	Time to encode, tm_year from 100 up to 299
+	* @param[out]	regs	RTC_CORE_TIME_LEN registers
+	*
+	* @returns	0 on success, -1 if the year is out of range
+	*/
+	static int encode_time(const struct tm *time, uint8_t *regs);
+
+	/**
+	* @brief	Encode a seconds, minutes, hours, day/date alarm (MAX31328, MAX31341, MAX31342)
+	*
+	* @details	Alarm 2 has no seconds register, regs[0] is not used then.
+	*
+	* @param[in]	alarm1		true for alarm 1, false for alarm 2
+	* @param[in]	alarm_time	Alarm time
+	* @param[in]	period		rtc_alarm_period_t, EVERYSECOND up to MONTHLY
+	* @param[out]	regs		RTC_CORE_ALARM_LEN registers
+	*
+	* @returns	0 on success, -1 if the period is not supported
+	*/
+	static int encode_alarm(bool alarm1, const struct tm *alarm_time, int period, uint8_t *regs);
+
+	/**
+	* @brief	Decode an alarm encoded by encode_alarm()
+	*
+	* @returns	rtc_alarm_period_t of the mask bits
+	*/
+	static int decode_alarm(bool alarm1, const uint8_t *regs, struct tm *alarm_time);
+
+	/**
+	* @brief	Encode an alarm that also has month and year registers (MAX31329, MAX31343)
+	*
+	* @details	Alarm 2 has minutes, hours and day/date only, it uses regs[1] to regs[3].
+	*
+	* @param[in]	alarm1		true for alarm 1, false for alarm 2
+	* @param[in]	alarm_time	Alarm time
+	* @param[in]	period		rtc_alarm_period_t
+	* @param[out]	regs		RTC_CORE_ALARM_EXT_LEN registers
+	*
+	* @returns	0 on success, -1 if the period or the year is not supported
+	*/
+	static int encode_alarm_ext(bool alarm1, const struct tm *alarm_time, int period, uint8_t *regs);
+
+	/**
+	* @brief	Decode an alarm encoded by encode_alarm_ext()
+	*
+	* @details	Month and year are only filled in for alarm 1.
+	*
+	* @returns	rtc_alarm_period_t of the mask bits, -1 if they match none
+	*/
+	static int decode_alarm_ext(bool alarm1, const uint8_t *regs, struct tm *alarm_time);
+
+protected:
+	RTCCore(TwoWire *i2c, uint8_t i2c_addr);
+	RTCCore(RTCTransport *bus, uint8_t i2c_addr);
+
+	/**
+	* @brief	Read registers in as many transfers as the transport's read limit needs
+	*
+	* @details	RTCCore::read_register() is used for each transfer, not the driver's own.
+	*
+	* @returns	0 on success, the error of the first failed transfer
+	*/
+	int read_burst(uint8_t reg, uint8_t *buf, int len);
+
+	/**
+	* @brief	Write registers in as many transfers as the transport's write limit needs
+	*
+	* @details	RTCCore::write_register() is used for each transfer, not the driver's own.
+	*
+	* @returns	0 on success, the error of the first failed transfer
+	*/
+	int write_burst(uint8_t reg, const uint8_t *buf, int len);
+
+	RTCWireTransport m_wire;
+	RTCTransport *m_bus;
+	uint8_t  m_slave_addr;
+	bool m_rollover_check;
+	rtc_time_read_stats_t m_time_read_stats;
+#if ANALOG_RTC_BUS_STATS
+	rtc_bus_stats_t m_bus_stats;
+#endif
+};
+
+/**
+* @brief	Time and alarm sequences of a driver
+*
+* @details	Derived is the driver. Its read_register()/write_register() are
+*			used for all accesses and read_alarm_enable() may be provided to
+*			read the alarm interrupt enable register another way, e.g. from
+*			a cache. Regs is the register map policy of the part:
+*
+*			  time			first register of the time block
+*			  alarm1		first register of alarm 1
+*			  alarm2		first register of alarm 2, minutes
+*			  alarm_en		register holding the alarm 1 (bit 0) and alarm 2 (bit 1) enables
+*			  alarm_ext		true if the alarms have month and year registers
+*			  time_latch	true if a burst read of the time block is latched,
+*							false to check reads for a rollover by default
+*			  status_rc		true if reading the status register clears the alarm flags
+*/
+template <class Derived, class Regs>
+class RTCCoreT : public RTCCore
+{
+protected:
+	RTCCoreT(TwoWire *i2c, uint8_t i2c_addr) : RTCCore(i2c, i2c_addr)
+	{
+		m_rollover_check = !Regs::time_latch;
+	}
+	RTCCoreT(RTCTransport *bus, uint8_t i2c_addr) : RTCCore(bus, i2c_addr)
+	{
+		m_rollover_check = !Regs::time_latch;
+	}
+
+	int core_read_time(uint8_t *regs)
+	{
+		int ret;
+		uint8_t sec;
+
+		ret = derived().read_register(Regs::time, regs, RTC_CORE_TIME_LEN);
+		if (ret || !m_rollover_check) {
+			return ret;
+		}
+
+		m_time_read_stats.reads++;
+
+		/* Any other tick during the read only changed the seconds, read first */
+		if ((regs[0] & 0x7F) != 0x59) {
+			return 0;
+		}
+
+		m_time_read_stats.checks++;
+		ret = derived().read_register(Regs::time, &sec, 1);
+		if (ret || (sec == regs[0])) {
+			return ret;
+		}
+
+		/* Ticked, during the read or after it: right after a tick the next one is a second away */
+		m_time_read_stats.rereads++;
+		return derived().read_register(Regs::time, regs, RTC_CORE_TIME_LEN);
+	}
+
+	int core_get_time(struct tm *time)
+	{
+		int ret;
+		uint8_t regs[RTC_CORE_TIME_LEN];
+
+		if (time == NULL) {
+			return -1;
+		}
+
+		ret = core_read_time(regs);
+		if (ret) {
+			return ret;
+		}
+
+		decode_time(regs, time);
+
+		return ret;
+	}
+
+	int core_set_time(const struct tm *time)
+	{
+		uint8_t regs[RTC_CORE_TIME_LEN];
+
+		if ((time == NULL) || encode_time(time, regs)) {
+			return -1;
+		}
+
+		return derived().write_register(Regs::time, regs, sizeof(regs));
+	}
+
+	int core_get_epoch(rtc_epoch_t *epoch)
+	{
+		int ret;
+		uint8_t regs[RTC_CORE_TIME_LEN];
+
+		if (epoch == NULL) {
+			return -1;
+		}
+
+		ret = core_read_time(regs);
+		if (ret) {
+			return ret;
+		}
+
+		return rtc_time_regs_to_epoch(regs, epoch);
+	}
+
+	int core_set_epoch(rtc_epoch_t epoch)
+	{
+		uint8_t regs[RTC_CORE_TIME_LEN];
+
+		if (rtc_epoch_to_time_regs(epoch, regs)) {
+			return -1;
+		}
+
+		return derived().write_register(Regs::time, regs, sizeof(regs));
+	}
+
+	int core_set_alarm(bool alarm1, const struct tm *alarm_time, int period)
+	{
+		int ret;
+		uint8_t regs[RTC_CORE_ALARM_EXT_LEN];
+
+		if (alarm_time == NULL) {
+			return -1;
+		}
+
+		if (Regs::alarm_ext) {
+			ret = encode_alarm_ext(alarm1, alarm_time, period, regs);
+		} else {
+			ret = encode_alarm(alarm1, alarm_time, period, regs);
+		}
+		if (ret) {
+			return ret;
+		}
+
+		if (alarm1) {
+			return derived().write_register(Regs::alarm1, regs,
+				Regs::alarm_ext ? RTC_CORE_ALARM_EXT_LEN : RTC_CORE_ALARM_LEN);
+		}
+		/* Alarm 2 starts from the minutes register */
+		return derived().write_register(Regs::alarm2, &regs[1], RTC_CORE_ALARM_LEN - 1);
+	}
+
+	template <class Period>
+	int core_get_alarm(bool alarm1, struct tm *alarm_time, Period *period, bool *is_enabled)
+	{
+		int ret;
+		int found;
+		uint8_t val8;
+		uint8_t regs[RTC_CORE_ALARM_EXT_LEN] = {0};
+
+		if (alarm1) {
+			ret = derived().read_register(Regs::alarm1, regs,
+				Regs::alarm_ext ? RTC_CORE_ALARM_EXT_LEN : RTC_CORE_ALARM_LEN);
+		} else {
+			ret = derived().read_register(Regs::alarm2, &regs[1], RTC_CORE_ALARM_LEN - 1);
+		}
+		if (ret) {
+			return ret;
+		}
+
+		if (Regs::alarm_ext) {
+			found = decode_alarm_ext(alarm1, regs, alarm_time);
+		} else {
+			found = decode_alarm(alarm1, regs, alarm_time);
+		}
+		if (found >= 0) {
+			*period = (Period)found;
+		}
+
+		ret = derived().read_alarm_enable(&val8);
+		if (ret) {
+			return ret;
+		}
+
+		*is_enabled = (val8 & (alarm1 ? 0x01 : 0x02)) != 0;
+
+		return ret;
+	}
+
+	int read_alarm_enable(uint8_t *val)
+	{
+		return derived().read_register(Regs::alarm_en, val);
+	}
+
+private:
+	Derived &derived(void) { return *static_cast<Derived *>(this); }
+};
+
+#endif /* _RTC_CORE_H_ */
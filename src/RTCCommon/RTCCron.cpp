@@ -0,0 +1,508 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#include <RTCCommon/RTCCron.h>
+#include <RTCCommon/RTCCore.h>
+
+#define SEC_ALL			0x0FFFFFFFFFFFFFFFULL	/* 0 to 59 */
+#define HOUR_ALL		0x00FFFFFFUL			/* 0 to 23 */
+#define MDAY_ALL		0xFFFFFFFEUL			/* 1 to 31 */
+#define MON_ALL			0x1FFE					/* 1 to 12 */
+#define WDAY_ALL		0x7F					/* 0 to 6 */
+
+#define SECS_PER_DAY	86400UL
+
+/* Last year whose times rtc_epoch_t holds */
+#if ANALOG_RTC_EPOCH_64
+#define YEAR_MAX		2199
+#else
+#define YEAR_MAX		2105
+#endif
+
+static const char *const mon_names[] = {
+	"jan", "feb", "mar", "apr", "may", "jun", "jul", "aug", "sep", "oct", "nov", "dec"
+};
+
+static const char *const wday_names[] = {
+	"sun", "mon", "tue", "wed", "thu", "fri", "sat"
+};
+
+static const struct {
+	const char *name;
+	const char *spec;
+} macros[] = {
+	{ "@yearly",	"0 0 1 1 *" },
+	{ "@annually",	"0 0 1 1 *" },
+	{ "@monthly",	"0 0 1 * *" },
+	{ "@weekly",	"0 0 * * 0" },
+	{ "@daily",		"0 0 * * *" },
+	{ "@midnight",	"0 0 * * *" },
+	{ "@hourly",	"0 * * * *" },
+};
+
+static const uint8_t days_in_month[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+static bool is_space(char c)
+{
+	return (c == ' ') || (c == '\t');
+}
+
+static char to_lower(char c)
+{
+	return ((c >= 'A') && (c <= 'Z')) ? (char)(c - 'A' + 'a') : c;
+}
+
+/* A number, or a three letter name that stands for names_base + its index */
+static int parse_value(const char **p, const char *const *names, uint8_t num_names, uint8_t names_base)
+{
+	const char *s = *p;
+	int val = 0;
+
+	if ((*s >= '0') && (*s <= '9')) {
+		while ((*s >= '0') && (*s <= '9')) {
+			val = val * 10 + (*s++ - '0');
+			if (val > 99) {
+				return -1;
+			}
+		}
+		*p = s;
+		return val;
+	}
+
+	for (uint8_t i = 0; i < num_names; i++) {
+		if ((to_lower(s[0]) == names[i][0]) && (to_lower(s[1]) == names[i][1]) &&
+			(to_lower(s[2]) == names[i][2])) {
+			*p = s + 3;
+			return names_base + i;
+		}
+	}
+
+	return -1;
+}
+
+static int parse_field(const char **p, uint8_t lo, uint8_t hi, const char *const *names,
+	uint8_t num_names, uint8_t names_base, uint64_t *mask, bool *any)
+{
+	const char *s = *p;
+	int a, b, step;
+
+	*mask = 0;
+	*any = (s[0] == '*') && ((s[1] == '\0') || is_space(s[1]));
+
+	for (;;) {
+		if (*s == '*') {
+			a = lo;
+			b = hi;
+			s++;
+		} else {
+			a = parse_value(&s, names, num_names, names_base);
+			if (a < 0) {
+				return -1;
+			}
+			b = a;
+			if (*s == '-') {
+				s++;
+				b = parse_value(&s, names, num_names, names_base);
+				if (b < 0) {
+					return -1;
+				}
+			} else if (*s == '/') {
+				b = hi;
+			}
+		}
+
+		step = 1;
+		if (*s == '/') {
+			s++;
+			step = parse_value(&s, NULL, 0, 0);
+			if (step <= 0) {
+				return -1;
+			}
+		}
+
+		if ((a < lo) || (b > hi) || (a > b)) {
+			return -1;
+		}
+
+		for (int v = a; v <= b; v += step) {
+			*mask |= 1ULL << v;
+		}
+
+		if (*s != ',') {
+			break;
+		}
+		s++;
+	}
+
+	if ((*s != '\0') && !is_space(*s)) {
+		return -1;
+	}
+
+	*p = s;
+
+	return 0;
+}
+
+int rtc_cron_parse(const char *spec, rtc_cron_t *cron)
+{
+	/* Fields of a six field spec, the five field one starts at minutes */
+	static const struct {
+		uint8_t lo;
+		uint8_t hi;
+	} limits[6] = { { 0, 59 }, { 0, 59 }, { 0, 23 }, { 1, 31 }, { 1, 12 }, { 0, 7 } };
+	uint64_t masks[6];
+	bool any[6];
+	const char *p;
+	uint8_t fields = 0;
+	uint8_t first;
+
+	if ((spec == NULL) || (cron == NULL)) {
+		return -1;
+	}
+
+	while (is_space(*spec)) {
+		spec++;
+	}
+
+	if (*spec == '@') {
+		for (uint8_t i = 0; i < sizeof(macros) / sizeof(macros[0]); i++) {
+			if (strcmp(spec, macros[i].name) == 0) {
+				return rtc_cron_parse(macros[i].spec, cron);
+			}
+		}
+		return -1;
+	}
+
+	/* Count the fields first, the seconds are there only with six */
+	for (p = spec; *p; ) {
+		fields++;
+		while (*p && !is_space(*p)) {
+			p++;
+		}
+		while (is_space(*p)) {
+			p++;
+		}
+	}
+	if ((fields != 5) && (fields != 6)) {
+		return -1;
+	}
+
+	first = 6 - fields;
+	masks[0] = 1;	/* Second 0 */
+	any[0] = false;
+
+	for (p = spec; first < 6; first++) {
+		if (parse_field(&p, limits[first].lo, limits[first].hi,
+				(first == 4) ? mon_names : (first == 5) ? wday_names : NULL,
+				(first == 4) ? 12 : (first == 5) ? 7 : 0, (first == 4) ? 1 : 0,
+				&masks[first], &any[first])) {
+			return -1;
+		}
+		while (is_space(*p)) {
+			p++;
+		}
+	}
+
+	cron->sec = masks[0];
+	cron->min = masks[1];
+	cron->hour = (uint32_t)masks[2];
+	cron->mday = (uint32_t)masks[3];
+	cron->mon = (uint16_t)masks[4];
+	/* Weekday 7 is Sunday */
+	cron->wday = (uint8_t)((masks[5] | (masks[5] >> 7)) & WDAY_ALL);
+	cron->flags = (any[3] ? RTC_CRON_MDAY_ANY : 0) | (any[5] ? RTC_CRON_WDAY_ANY : 0);
+
+	return 0;
+}
+
+static bool day_matches(const rtc_cron_t *cron, int mday, int wday)
+{
+	bool mday_ok = (cron->mday >> mday) & 1;
+	bool wday_ok = (cron->wday >> wday) & 1;
+
+	if (cron->flags & RTC_CRON_MDAY_ANY) {
+		return wday_ok;
+	}
+	if (cron->flags & RTC_CRON_WDAY_ANY) {
+		return mday_ok;
+	}
+
+	return mday_ok || wday_ok;
+}
+
+bool rtc_cron_match(const rtc_cron_t *cron, const struct tm *time)
+{
+	return ((cron->sec >> time->tm_sec) & 1) &&
+		   ((cron->min >> time->tm_min) & 1) &&
+		   ((cron->hour >> time->tm_hour) & 1) &&
+		   ((cron->mon >> (time->tm_mon + 1)) & 1) &&
+		   day_matches(cron, time->tm_mday, time->tm_wday);
+}
+
+/* Lowest set bit at or above from, -1 if none */
+static int next_bit(uint64_t mask, int from)
+{
+	if (from > 63) {
+		return -1;
+	}
+
+	mask >>= from;
+	if (mask == 0) {
+		return -1;
+	}
+
+	return from + __builtin_ctzll(mask);
+}
+
+static uint8_t month_days(int year, int mon)
+{
+	bool leap = ((year % 4) == 0) && (((year % 100) != 0) || ((year % 400) == 0));
+
+	return days_in_month[mon - 1] + ((mon == 2) && leap);
+}
+
+/* Dates of a month that match the schedule, bit n for date n */
+static uint32_t day_mask(const rtc_cron_t *cron, int year, int mon)
+{
+	struct tm first;
+	uint32_t valid;
+	uint32_t week;
+	uint32_t wdays;
+	uint8_t wday1;
+
+	memset(&first, 0, sizeof(first));
+	first.tm_year = year - 1900;
+	first.tm_mon = mon - 1;
+	first.tm_mday = 1;
+	/* 1970-01-01 was a Thursday */
+	wday1 = (uint8_t)((rtc_tm_to_epoch(&first) / SECS_PER_DAY + 4) % 7);
+
+	valid = ((1UL << month_days(year, mon)) - 1) << 1;
+
+	/* Bit k of week is the weekday of date k + 1, repeated over the month */
+	week = ((cron->wday >> wday1) | (cron->wday << (7 - wday1))) & WDAY_ALL;
+	wdays = (week | (week << 7) | (week << 14) | (week << 21) | (week << 28)) << 1;
+
+	if (cron->flags & RTC_CRON_MDAY_ANY) {
+		return wdays & valid;
+	}
+	if (cron->flags & RTC_CRON_WDAY_ANY) {
+		return cron->mday & valid;
+	}
+
+	return (cron->mday | wdays) & valid;
+}
+
+int rtc_cron_next(const rtc_cron_t *cron, rtc_epoch_t after, rtc_epoch_t *next)
+{
+	struct tm t;
+	int year, mon, mday, hour, min, sec;
+	int b;
+
+	rtc_epoch_to_tm(after + 1, &t);
+	year = t.tm_year + 1900;
+	mon = t.tm_mon + 1;
+	mday = t.tm_mday;
+	hour = t.tm_hour;
+	min = t.tm_min;
+	sec = t.tm_sec;
+
+	/*
+	 * Take each field to its next set bit, from the month down. A field
+	 * with none left carries into the one above and clears the ones below,
+	 * which then start from their first set bit.
+	 */
+	for (;;) {
+		if (year > YEAR_MAX) {
+			return -1;
+		}
+
+		b = next_bit(cron->mon, mon);
+		if (b < 0) {
+			year++;
+			mon = 1;
+			mday = 1;
+			hour = min = sec = 0;
+			continue;
+		}
+		if (b != mon) {
+			mon = b;
+			mday = 1;
+			hour = min = sec = 0;
+		}
+
+		b = next_bit(day_mask(cron, year, mon), mday);
+		if (b < 0) {
+			mon++;
+			mday = 1;
+			hour = min = sec = 0;
+			continue;
+		}
+		if (b != mday) {
+			mday = b;
+			hour = min = sec = 0;
+		}
+
+		b = next_bit(cron->hour, hour);
+		if (b < 0) {
+			mday++;
+			hour = min = sec = 0;
+			continue;
+		}
+		if (b != hour) {
+			hour = b;
+			min = sec = 0;
+		}
+
+		b = next_bit(cron->min, min);
+		if (b < 0) {
+			hour++;
+			min = sec = 0;
+			continue;
+		}
+		if (b != min) {
+			min = b;
+			sec = 0;
+		}
+
+		b = next_bit(cron->sec, sec);
+		if (b < 0) {
+			min++;
+			sec = 0;
+			continue;
+		}
+		sec = b;
+		break;
+	}
+
+	t.tm_year = year - 1900;
+	t.tm_mon = mon - 1;
+	t.tm_mday = mday;
+	t.tm_hour = hour;
+	t.tm_min = min;
+	t.tm_sec = sec;
+	*next = rtc_tm_to_epoch(&t);
+
+	return 0;
+}
+
+/* Value of a field with one bit set, -1 otherwise */
+static int single(uint64_t mask)
+{
+	if ((mask == 0) || (mask & (mask - 1))) {
+		return -1;
+	}
+
+	return __builtin_ctzll(mask);
+}
+
+int rtc_cron_to_alarm(const rtc_cron_t *cron, struct tm *time, int *period)
+{
+	bool all_days;
+	int sec, min, hour, mday, wday, mon;
+
+	if (cron->flags & RTC_CRON_MDAY_ANY) {
+		all_days = (cron->wday == WDAY_ALL);
+	} else if (cron->flags & RTC_CRON_WDAY_ANY) {
+		all_days = (cron->mday == MDAY_ALL);
+	} else {
+		all_days = (cron->mday == MDAY_ALL) || (cron->wday == WDAY_ALL);
+	}
+
+	memset(time, 0, sizeof(*time));
+	time->tm_mday = 1;
+	/* The extended alarms also write a year, keep it in range */
+	time->tm_year = 100;
+
+	sec = single(cron->sec);
+	min = single(cron->min);
+	hour = single(cron->hour);
+	mday = single(cron->mday);
+	wday = single(cron->wday);
+	mon = single(cron->mon);
+
+	if (cron->sec == SEC_ALL) {
+		*period = RTC_ALARM_PERIOD_EVERYSECOND;
+		return ((cron->min == SEC_ALL) && (cron->hour == HOUR_ALL) && all_days &&
+				(cron->mon == MON_ALL)) ? 0 : -1;
+	}
+	if (sec < 0) {
+		return -1;
+	}
+	time->tm_sec = sec;
+
+	if (cron->min == SEC_ALL) {
+		*period = RTC_ALARM_PERIOD_EVERYMINUTE;
+		return ((cron->hour == HOUR_ALL) && all_days && (cron->mon == MON_ALL)) ? 0 : -1;
+	}
+	if (min < 0) {
+		return -1;
+	}
+	time->tm_min = min;
+
+	if (cron->hour == HOUR_ALL) {
+		*period = RTC_ALARM_PERIOD_HOURLY;
+		return (all_days && (cron->mon == MON_ALL)) ? 0 : -1;
+	}
+	if (hour < 0) {
+		return -1;
+	}
+	time->tm_hour = hour;
+
+	if (all_days) {
+		*period = RTC_ALARM_PERIOD_DAILY;
+		return (cron->mon == MON_ALL) ? 0 : -1;
+	}
+
+	if ((cron->flags & RTC_CRON_MDAY_ANY) && (wday >= 0)) {
+		time->tm_wday = wday;
+		*period = RTC_ALARM_PERIOD_WEEKLY;
+		return (cron->mon == MON_ALL) ? 0 : -1;
+	}
+
+	if (!(cron->flags & RTC_CRON_WDAY_ANY) || (mday < 0)) {
+		return -1;
+	}
+	time->tm_mday = mday;
+
+	if (cron->mon == MON_ALL) {
+		*period = RTC_ALARM_PERIOD_MONTHLY;
+		return 0;
+	}
+	if (mon < 0) {
+		return -1;
+	}
+	time->tm_mon = mon - 1;
+	*period = RTC_ALARM_PERIOD_YEARLY;
+
+	return 0;
+}
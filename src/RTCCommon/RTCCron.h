@@ -0,0 +1,136 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#ifndef _RTC_CRON_H_
+#define _RTC_CRON_H_
+
+#include <Arduino.h>
+#include <time.h>
+#include <RTCCommon/RTCTime.h>
+
+/*
+ * Cron-style schedules.
+ *
+ * rtc_cron_parse() compiles a spec into one bit mask per field:
+ *
+ *	[sec] min hour mday mon wday
+ *
+ * Five fields are the usual crontab line and run at second 0, a sixth
+ * field in front gives the seconds. Each field takes '*', numbers, ranges
+ * "a-b", lists "a,b,c" and steps "/n" after '*', a range or a start value
+ * ("a/n" runs to the end of the field). Months and weekdays also take
+ * their English three letter names, and weekday 7 is Sunday as 0.
+ * "@yearly", "@annually", "@monthly", "@weekly", "@daily", "@midnight"
+ * and "@hourly" stand for their usual specs. As in cron, when both mday
+ * and wday are restricted a day matches if either does.
+ *
+ * rtc_cron_to_alarm() finds the schedules a hardware alarm matches by
+ * itself: one value in each field from the seconds up to some point and
+ * '*' above it. set_alarm() then encodes them in the alarm mask bits
+ * (AxMn, DY/DT) and the RTC fires with no MCU work at all.
+ *
+ * Any other schedule runs as a series of one-shot alarms, and
+ * rtc_cron_next() gives the next one. It moves to the next set bit of
+ * each field, month first, with bit operations, so the cost depends on
+ * the number of fields, not on the distance to the next fire: there is no
+ * minute by minute scan. RTCAlarmScheduler::add_cron() does both, it puts
+ * a schedule on ALARM2 when the hardware can run it and re-arms ALARM1 for
+ * the rest.
+ */
+
+/**
+* @brief	rtc_cron_t::flags, the mday field is '*'
+*/
+#define RTC_CRON_MDAY_ANY	0x01
+
+/**
+* @brief	rtc_cron_t::flags, the wday field is '*'
+*/
+#define RTC_CRON_WDAY_ANY	0x02
+
+/**
+* @brief	Compiled cron schedule, bit n of a field set if value n matches
+*/
+typedef struct {
+	uint64_t	sec;	/**< Seconds 0 to 59 */
+	uint64_t	min;	/**< Minutes 0 to 59 */
+	uint32_t	hour;	/**< Hours 0 to 23 */
+	uint32_t	mday;	/**< Dates 1 to 31 */
+	uint16_t	mon;	/**< Months 1 to 12 */
+	uint8_t		wday;	/**< Weekdays 0 (Sunday) to 6 */
+	uint8_t		flags;	/**< RTC_CRON_MDAY_ANY, RTC_CRON_WDAY_ANY */
+} rtc_cron_t;
+
+/**
+* @brief	Compile a cron spec
+*
+* @param[in]	spec	e.g. "30 2 * * 1-5", "0 0/15 * * * *", "@daily"
+* @param[out]	cron	Compiled schedule
+*
+* @returns	0 on success, -1 on a syntax error or a value out of range
+*/
+int rtc_cron_parse(const char *spec, rtc_cron_t *cron);
+
+/**
+* @brief	Whether a time matches the schedule
+*
+* @param[in]	time	UTC time, tm_wday included
+*/
+bool rtc_cron_match(const rtc_cron_t *cron, const struct tm *time);
+
+/**
+* @brief	First time after a given one that matches the schedule
+*
+* @param[in]	after	Unix seconds, the result is later
+* @param[out]	next	Unix seconds
+*
+* @returns	0 on success, -1 if nothing matches before the end of rtc_epoch_t or 2199
+*/
+int rtc_cron_next(const rtc_cron_t *cron, rtc_epoch_t after, rtc_epoch_t *next);
+
+/**
+* @brief	Hardware alarm that fires exactly on the schedule
+*
+* @details	EVERYSECOND and the month match (YEARLY) need alarm 1, and
+*			YEARLY also month alarm registers (MAX31329, MAX31343,
+*			MAX3133X): set_alarm() fails where the part cannot take it, and
+*			the schedule then has to run from rtc_cron_next(). Alarm 2 has
+*			no seconds register and only takes schedules at second 0.
+*
+* @param[out]	time	Alarm time for set_alarm(), the unused fields 0 or 1
+* @param[out]	period	rtc_alarm_period_t, cast to the driver's alarm_period_t
+*
+* @returns	0 on success, -1 if no alarm period matches the schedule
+*/
+int rtc_cron_to_alarm(const rtc_cron_t *cron, struct tm *time, int *period);
+
+#endif /* _RTC_CRON_H_ */
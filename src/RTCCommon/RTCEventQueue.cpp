@@ -0,0 +1,191 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#include <RTCCommon/RTCEventQueue.h>
+
+#define MS_PER_SEC		1000UL
+#define FRAC_PER_SEC	128UL
+
+RTCEventQueue::RTCEventQueue(rtc_event_t *slots, uint8_t capacity)
+{
+	m_slots = slots;
+	m_mask = capacity - 1;
+	m_head = 0;
+	m_tail = 0;
+	m_anchor.sec = 0;
+	m_anchor.frac = 0;
+	m_anchor_ms = 0;
+	m_anchored = false;
+	m_cb = NULL;
+	m_cb_arg = NULL;
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+void RTCEventQueue::stamp(rtc_time_hr_t *time)
+{
+	uint32_t elapsed;
+	uint32_t frac;
+
+	if (!m_anchored) {
+		time->sec = 0;
+		time->frac = 0;
+		return;
+	}
+
+	/* 32-bit only, cheap enough for an interrupt on 8-bit MCUs */
+	elapsed = millis() - m_anchor_ms;
+	time->sec = m_anchor.sec + elapsed / MS_PER_SEC;
+	frac = m_anchor.frac + (elapsed % MS_PER_SEC) * FRAC_PER_SEC / MS_PER_SEC;
+	if (frac >= FRAC_PER_SEC) {
+		time->sec++;
+		frac -= FRAC_PER_SEC;
+	}
+	time->frac = (uint8_t)frac;
+}
+
+bool RTCEventQueue::push(uint8_t source)
+{
+	uint8_t head = __atomic_load_n(&m_head, __ATOMIC_RELAXED);
+	uint8_t tail = __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE);
+	uint8_t used = head - tail;
+	rtc_event_t *event;
+
+	if (used > m_mask) {
+		m_stats.overflows++;
+		return false;
+	}
+
+	event = &m_slots[head & m_mask];
+	event->source = source;
+	event->status = 0;
+	stamp(&event->time);
+
+	/* The slot is complete before service() can see it */
+	__atomic_store_n(&m_head, (uint8_t)(head + 1), __ATOMIC_RELEASE);
+
+	m_stats.pushed++;
+	if (used + 1 > m_stats.high_water) {
+		m_stats.high_water = used + 1;
+	}
+
+	return true;
+}
+
+uint8_t RTCEventQueue::count(void) const
+{
+	return __atomic_load_n(&m_head, __ATOMIC_ACQUIRE) - __atomic_load_n(&m_tail, __ATOMIC_RELAXED);
+}
+
+int RTCEventQueue::service(uint16_t *delivered)
+{
+	int ret;
+	uint8_t head;
+	uint8_t tail;
+	uint8_t status;
+	uint16_t n = 0;
+	rtc_time_hr_t now;
+	rtc_event_t event;
+
+	if (delivered) {
+		*delivered = 0;
+	}
+
+	if (!pending()) {
+		return 0;
+	}
+
+	/*
+	 * Taken before the status read: an event pushed during the reads is for
+	 * a flag that may have risen after them, it stays queued for the next
+	 * read. Its INT edge does not come again while the flag is set.
+	 */
+	head = __atomic_load_n(&m_head, __ATOMIC_ACQUIRE);
+	tail = m_tail;
+
+	ret = read_status(&status);
+	if (ret) {
+		m_stats.errors++;
+		return ret;
+	}
+	m_stats.status_reads++;
+
+	ret = read_rtc(&now);
+	if (ret) {
+		/* The events keep the old time base, or none */
+		m_stats.errors++;
+	} else {
+		noInterrupts();
+		m_anchor = now;
+		m_anchor_ms = millis();
+		m_anchored = true;
+		interrupts();
+	}
+
+	while (tail != head) {
+		event = m_slots[tail & m_mask];
+		tail++;
+		__atomic_store_n(&m_tail, tail, __ATOMIC_RELEASE);
+
+		event.status = status;
+		if ((event.time.sec == 0) && (ret == 0)) {
+			/* Pushed before the first time base */
+			event.time = now;
+		}
+
+		m_stats.delivered++;
+		n++;
+
+		if (m_cb) {
+			m_cb(&event, m_cb_arg);
+		}
+	}
+
+	if (delivered) {
+		*delivered = n;
+	}
+
+	return 0;
+}
+
+void RTCEventQueue::get_stats(rtc_event_stats_t &stats)
+{
+	noInterrupts();
+	stats = m_stats;
+	interrupts();
+}
+
+void RTCEventQueue::reset_stats(void)
+{
+	noInterrupts();
+	memset(&m_stats, 0, sizeof(m_stats));
+	interrupts();
+}
@@ -0,0 +1,277 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#ifndef _RTC_EVENT_QUEUE_H_
+#define _RTC_EVENT_QUEUE_H_
+
+#include <Arduino.h>
+#include <RTCCommon/RTCCore.h>
+#include <RTCCommon/RTCTime.h>
+
+/*
+ * Interrupt events passed from the RTC pin interrupt to the main loop.
+ *
+ * The queue is a single producer, single consumer ring of fixed capacity.
+ * push() is the producer and is meant to be the whole pin interrupt
+ * handler: it takes a slot, stamps it and publishes it, with no bus access
+ * and no lock. service() is the consumer and runs from the main loop: it
+ * reads the status register once for everything queued, which also clears
+ * the flags, and passes every event to the callback with that status.
+ *
+ * The interrupt cannot read the RTC, so push() stamps the event from the
+ * RTC time read by the last service() plus the millis() elapsed since,
+ * to 1/128 s. The time read by service() has 1/128 s on MAX3133X and whole
+ * seconds on the other parts, so the stamps are within a second on those.
+ * Events pushed before the first service() get the time it reads.
+ *
+ * A full ring drops the event and counts an overflow. The flags are not
+ * lost: they stay set in the part and are in the status of the events
+ * that are delivered. Only the stamp of the dropped edge is lost.
+ *
+ * The head and tail indexes are single bytes, read and written with
+ * acquire/release ordering, so the ring needs no interrupt locking on 8-bit
+ * MCUs and is also safe between two threads on Linux.
+ *
+ * RTCEventQueue holds the logic and is compiled once. RTCEventQueueT binds
+ * it to any driver of the library and provides the storage:
+ *
+ *	MAX31343 rtc(&Wire);
+ *	RTCEventQueueT<MAX31343, 16> events(&rtc);
+ *
+ *	void rtc_isr(void) { events.push(); }
+ *
+ *	attachInterrupt(digitalPinToInterrupt(INT_PIN), rtc_isr, FALLING);
+ *	events.set_callback(on_event, NULL);
+ *
+ *	if (events.pending()) events.service();
+ *
+ * On MAX3133X, use either the queue or interrupt_attach(), both read and
+ * clear STATUS.
+ */
+
+/**
+* @brief	Source of push() when none is given, the INT pin
+*/
+#define RTC_EVENT_SRC_INT		0
+
+/**
+* @brief	Most events a queue can hold
+*/
+#define RTC_EVENT_MAX			128
+
+/**
+* @brief	Interrupt event
+*/
+typedef struct {
+	uint8_t			source;		/**< Source given to push(), which pin or line */
+	uint8_t			status;		/**< Status register read by service(), raw */
+	rtc_time_hr_t	time;		/**< When push() ran */
+} rtc_event_t;
+
+/**
+* @brief	Event callback, run from service()
+*
+* @param[in]	event	Event, valid during the call
+* @param[in]	arg		Pointer given to set_callback()
+*/
+typedef void (*rtc_event_cb_t)(const rtc_event_t *event, void *arg);
+
+/**
+* @brief	Event queue counters
+*/
+typedef struct {
+	uint32_t pushed;		/**< Events queued by push() */
+	uint32_t overflows;		/**< Events dropped by push(), the ring was full */
+	uint32_t delivered;		/**< Events passed on by service() */
+	uint32_t status_reads;	/**< Status reads by service() */
+	uint32_t errors;		/**< Failed RTC accesses */
+	uint8_t  high_water;	/**< Most events queued at once */
+} rtc_event_stats_t;
+
+class RTCEventQueue
+{
+public:
+	virtual ~RTCEventQueue() {}
+
+	/**
+	* @brief	Set the callback service() passes the events to
+	*/
+	void set_callback(rtc_event_cb_t cb, void *arg) { m_cb = cb; m_cb_arg = arg; }
+
+	/**
+	* @brief	Queue an event, the pin interrupt handler
+	*
+	* @param[in]	source	Which pin or line, passed on in the event
+	*
+	* @returns	true if queued, false if the ring was full
+	*/
+	bool push(uint8_t source = RTC_EVENT_SRC_INT);
+
+	/**
+	* @brief	Read the status once and pass every queued event on
+	*
+	* @details	Does nothing if no event is queued. Only the events queued
+	*			before the status read are passed on, the ones pushed during it
+	*			wait for the next call and its status read. The events are
+	*			released before their callback runs, so a callback never holds
+	*			up push().
+	*
+	* @param[out]	delivered	Number of events passed on, can be NULL
+	*
+	* @returns	0 on success, the driver's error code if the status read
+	*			failed, the events then stay queued
+	*/
+	int service(uint16_t *delivered = NULL);
+
+	/**
+	* @brief	Number of events queued
+	*/
+	uint8_t count(void) const;
+
+	/**
+	* @brief	Whether service() has work
+	*/
+	bool pending(void) const { return count() != 0; }
+
+	/**
+	* @brief	Get counters.
+	*/
+	void get_stats(rtc_event_stats_t &stats);
+
+	/**
+	* @brief	Clear counters.
+	*/
+	void reset_stats(void);
+
+protected:
+	/**
+	* @param[in]	slots		capacity slots
+	* @param[in]	capacity	Number of events, a power of two up to RTC_EVENT_MAX
+	*/
+	RTCEventQueue(rtc_event_t *slots, uint8_t capacity);
+
+	/** @brief	Read and clear the status register, raw */
+	virtual int read_status(uint8_t *status) = 0;
+
+	/** @brief	Read the RTC time, to 1/128 s where the part has it */
+	virtual int read_rtc(rtc_time_hr_t *time) = 0;
+
+private:
+	void stamp(rtc_time_hr_t *time);
+
+	rtc_event_t *m_slots;
+	uint8_t m_mask;
+	uint8_t m_head;			/* Written by push() only */
+	uint8_t m_tail;			/* Written by service() only */
+
+	/* Time base of the stamps, written with interrupts off */
+	rtc_time_hr_t m_anchor;
+	uint32_t m_anchor_ms;
+	bool m_anchored;
+
+	rtc_event_cb_t m_cb;
+	void *m_cb_arg;
+
+	/* pushed, overflows and high_water are written by push() only */
+	rtc_event_stats_t m_stats;
+};
+
+/**
+* @brief	Status read of the drivers on RTCCore, the flags cleared
+*
+* @details	Parts that do not clear the alarm flags on the status read, see
+*			status_rc of the register map, get them cleared with a write, only
+*			the flags seen.
+*/
+template <class Derived, class Regs>
+int rtc_event_read_status(RTCCoreT<Derived, Regs> *core, uint8_t *status)
+{
+	int ret;
+	uint8_t flags;
+	Derived *rtc = static_cast<Derived *>(core);
+	typename Derived::reg_status_t stat;
+
+	stat.raw = 0;
+	ret = rtc->get_status(stat);
+	if (ret) {
+		return ret;
+	}
+
+	*status = stat.raw;
+	flags = stat.raw & (Derived::INTR_ID_ALARM1 | Derived::INTR_ID_ALARM2);
+	if (Regs::status_rc || (flags == 0)) {
+		return 0;
+	}
+
+	return rtc->irq_clear_flag((typename Derived::intr_id_t)flags);
+}
+
+/**
+* @brief	Time read of the drivers on RTCCore, whole seconds
+*/
+template <class Derived, class Regs>
+int rtc_event_read_time(RTCCoreT<Derived, Regs> *core, rtc_time_hr_t *time)
+{
+	time->frac = 0;
+	return static_cast<Derived *>(core)->get_epoch(&time->sec);
+}
+
+/**
+* @brief	Event queue with room for N events over any driver of the library
+*
+* @details	The driver is reached through rtc_event_read_status() and
+*			rtc_event_read_time(), defined above for the drivers on RTCCore
+*			and in MAX3133X.h for MAX3133X.
+*/
+template <class RTC, uint8_t N>
+class RTCEventQueueT : public RTCEventQueue
+{
+	static_assert((N != 0) && ((N & (N - 1)) == 0) && (N <= RTC_EVENT_MAX),
+		"N must be a power of two, RTC_EVENT_MAX at most");
+
+public:
+	/**
+	* @param[in]	rtc		Driver, begin() already called
+	*/
+	explicit RTCEventQueueT(RTC *rtc) : RTCEventQueue(m_slots, N), m_rtc(rtc) {}
+
+protected:
+	int read_status(uint8_t *status) { return rtc_event_read_status(m_rtc, status); }
+
+	int read_rtc(rtc_time_hr_t *time) { return rtc_event_read_time(m_rtc, time); }
+
+private:
+	RTC *m_rtc;
+	rtc_event_t m_slots[N];
+};
+
+#endif /* _RTC_EVENT_QUEUE_H_ */
@@ -0,0 +1,162 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#include <RTCCommon/RTCLinuxI2C.h>
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <errno.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+RTCLinuxI2C::RTCLinuxI2C(const char *dev) : m_dev(dev), m_fd(-1)
+{
+}
+
+RTCLinuxI2C::~RTCLinuxI2C()
+{
+	end();
+}
+
+void RTCLinuxI2C::begin(void)
+{
+	if (m_fd < 0 && m_dev != NULL) {
+		m_fd = open(m_dev, O_RDWR);
+	}
+}
+
+void RTCLinuxI2C::end(void)
+{
+	if (m_fd >= 0) {
+		close(m_fd);
+		m_fd = -1;
+	}
+}
+
+int RTCLinuxI2C::transfer(struct i2c_msg *msgs, int num)
+{
+	struct i2c_rdwr_ioctl_data data;
+
+	if (m_fd < 0) {
+		return -EBADF;
+	}
+
+	data.msgs = msgs;
+	data.nmsgs = num;
+
+	if (ioctl(m_fd, I2C_RDWR, &data) < 0) {
+		return -errno;
+	}
+
+	return 0;
+}
+
+/*
+ * Adapter drivers do not agree on the errno of an address NACK; most use
+ * ENXIO, some EREMOTEIO or EIO.
+ */
+static int errno_to_bus_err(int err)
+{
+	switch (-err) {
+	case ENXIO:
+	case EREMOTEIO:
+		return RTC_BUS_ERR_ADDR_NACK;
+	case EMSGSIZE:
+	case EINVAL:
+		return RTC_BUS_ERR_DATA_TOO_LONG;
+	default:
+		return RTC_BUS_ERR_OTHER;
+	}
+}
+
+int RTCLinuxI2C::write_read(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t len)
+{
+	int ret;
+	struct i2c_msg msgs[2];
+
+	msgs[0].addr  = addr;
+	msgs[0].flags = 0;
+	msgs[0].len   = 1;
+	msgs[0].buf   = &reg;
+
+	msgs[1].addr  = addr;
+	msgs[1].flags = I2C_M_RD;
+	msgs[1].len   = len;
+	msgs[1].buf   = buf;
+
+	ret = transfer(msgs, 2);
+	if (ret != 0) {
+		return errno_to_bus_err(ret);
+	}
+
+	return 0;
+}
+
+int RTCLinuxI2C::write(uint8_t addr, uint8_t reg, const uint8_t *buf, uint8_t len)
+{
+	int ret;
+	uint8_t frame[1 + 255];
+	struct i2c_msg msg;
+
+	/* Register address and data must go out in one message, without a restart */
+	frame[0] = reg;
+	memcpy(&frame[1], buf, len);
+
+	msg.addr  = addr;
+	msg.flags = 0;
+	msg.len   = 1 + len;
+	msg.buf   = frame;
+
+	ret = transfer(&msg, 1);
+	if (ret != 0) {
+		return errno_to_bus_err(ret);
+	}
+
+	return 0;
+}
+
+/* i2c_msg lengths go up to 8192; the drivers' uint8_t length is the limit */
+uint8_t RTCLinuxI2C::max_read(void)
+{
+	return 255;
+}
+
+uint8_t RTCLinuxI2C::max_write(void)
+{
+	return 255;
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,94 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#ifndef _RTC_LINUX_I2C_H_
+#define _RTC_LINUX_I2C_H_
+
+/*
+ * RTCTransport for Linux i2c-dev (/dev/i2c-N), e.g. on a Raspberry Pi or
+ * against the i2c-stub kernel module. Only built for Linux hosts, never for
+ * an Arduino core.
+ */
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <RTCCommon/RTCTransport.h>
+
+struct i2c_msg;
+
+/**
+* @brief	RTCTransport on top of the Linux I2C_RDWR ioctl
+*
+* @details	A register read is a single ioctl carrying the address write and
+*			the data read, joined by a repeated start.
+*/
+class RTCLinuxI2C : public RTCTransport
+{
+public:
+	/**
+	* @param[in]	dev	i2c-dev node, e.g. "/dev/i2c-1". The string must outlive the object.
+	*/
+	RTCLinuxI2C(const char *dev);
+	virtual ~RTCLinuxI2C();
+
+	/**
+	* @brief	Open the device node if it is not open yet.
+	*/
+	void begin(void);
+
+	/**
+	* @brief	Close the device node.
+	*/
+	void end(void);
+
+	int write_read(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t len);
+	int write(uint8_t addr, uint8_t reg, const uint8_t *buf, uint8_t len);
+	uint8_t max_read(void);
+	uint8_t max_write(void);
+
+protected:
+	/**
+	* @brief	Issue one I2C_RDWR transaction.
+	*
+	* @details	Override to run the backend against an in-process fake.
+	*
+	* @returns	0 on success, -errno on failure.
+	*/
+	virtual int transfer(struct i2c_msg *msgs, int num);
+
+private:
+	const char *m_dev;
+	int m_fd;
+};
+
+#endif /* __linux__ */
+
+#endif /* _RTC_LINUX_I2C_H_ */
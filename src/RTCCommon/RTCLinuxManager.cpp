@@ -0,0 +1,197 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#include <RTCCommon/RTCLinuxManager.h>
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <time.h>
+#include <system_error>
+
+/* Wall time, micros() can be a simulated clock */
+static uint64_t monotonic_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+RTCLinuxManager::RTCLinuxManager()
+{
+	m_buses = 0;
+	m_started = false;
+	m_generation = 0;
+	m_pending = 0;
+	m_stop = false;
+	m_out = NULL;
+	m_t0_us = 0;
+	m_last_us = 0;
+}
+
+RTCLinuxManager::~RTCLinuxManager()
+{
+	end();
+}
+
+int RTCLinuxManager::add_bus(void)
+{
+	if (m_started) {
+		return -1;
+	}
+
+	return m_buses++;
+}
+
+int RTCLinuxManager::add(int bus, void *rtc, read_fn_t read)
+{
+	device_t dev;
+
+	if (m_started || (bus < 0) || (bus >= m_buses)) {
+		return -1;
+	}
+
+	dev.bus = bus;
+	dev.rtc = rtc;
+	dev.read = read;
+	m_devices.push_back(dev);
+
+	return m_devices.size() - 1;
+}
+
+int RTCLinuxManager::begin(void)
+{
+	if (m_started) {
+		return 0;
+	}
+
+	m_stop = false;
+	m_started = true;
+
+	for (int bus = 0; bus < m_buses; bus++) {
+		try {
+			m_workers.push_back(std::thread(&RTCLinuxManager::worker, this, bus, m_generation));
+		} catch (const std::system_error &) {
+			end();
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+void RTCLinuxManager::end(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_stop = true;
+	}
+	m_start.notify_all();
+
+	for (size_t i = 0; i < m_workers.size(); i++) {
+		m_workers[i].join();
+	}
+
+	m_workers.clear();
+	m_started = false;
+}
+
+int RTCLinuxManager::snapshot(rtc_manager_reading_t *readings, size_t count)
+{
+	std::unique_lock<std::mutex> lock(m_lock);
+
+	if (!m_started || (count < m_devices.size())) {
+		return -1;
+	}
+
+	m_out = readings;
+	m_pending = m_workers.size();
+	m_t0_us = monotonic_us();
+	m_generation++;
+	m_start.notify_all();
+
+	while (m_pending > 0) {
+		m_done.wait(lock);
+	}
+
+	m_last_us = monotonic_us() - m_t0_us;
+
+	for (size_t i = 0; i < m_devices.size(); i++) {
+		if (readings[i].ret) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+void RTCLinuxManager::worker(int bus, uint32_t seen)
+{
+	std::unique_lock<std::mutex> lock(m_lock);
+	rtc_manager_reading_t *out;
+	uint64_t t0_us;
+	uint64_t start_us;
+
+	for (;;) {
+		while (!m_stop && (m_generation == seen)) {
+			m_start.wait(lock);
+		}
+		if (m_stop) {
+			break;
+		}
+
+		seen = m_generation;
+		out = m_out;
+		t0_us = m_t0_us;
+		lock.unlock();
+
+		/* The device list does not change while the workers run */
+		for (size_t i = 0; i < m_devices.size(); i++) {
+			if (m_devices[i].bus != bus) {
+				continue;
+			}
+
+			start_us = monotonic_us();
+			out[i].ret = m_devices[i].read(m_devices[i].rtc, &out[i].time);
+			out[i].start_us = start_us - t0_us;
+			out[i].latency_us = monotonic_us() - start_us;
+		}
+
+		lock.lock();
+		if (--m_pending == 0) {
+			m_done.notify_one();
+		}
+	}
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,205 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#ifndef _RTC_LINUX_MANAGER_H_
+#define _RTC_LINUX_MANAGER_H_
+
+/*
+ * Snapshot of many RTCs on several Linux I2C buses, one worker thread per
+ * bus. Only built for Linux hosts, never for an Arduino core.
+ *
+ * Transfers on one bus are serial whatever the software does, so the
+ * manager runs one worker per physical bus and the buses in parallel.
+ * The channels of an I2C mux are separate i2c-dev adapters
+ * (i2c-mux-pca954x) but one physical bus: put the devices behind all the
+ * channels of a mux on the same manager bus, so its worker serializes
+ * them and the kernel never has to.
+ *
+ *	RTCLinuxI2C ch0("/dev/i2c-10"), ch1("/dev/i2c-11"), bus2("/dev/i2c-2");
+ *	MAX31343 a(&ch0), b(&ch1), c(&bus2);
+ *
+ *	RTCLinuxManager mgr;
+ *	int mux = mgr.add_bus();
+ *	int direct = mgr.add_bus();
+ *
+ *	mgr.add_device(mux, &a);
+ *	mgr.add_device(mux, &b);
+ *	mgr.add_device(direct, &c);
+ *	mgr.begin();
+ *
+ *	rtc_manager_reading_t readings[3];
+ *	mgr.snapshot(readings, 3);
+ *
+ * All workers start a snapshot together and snapshot() returns once all
+ * of them are done, so the readings of one call come from one pass over
+ * every device. Each one carries when its read started relative to the
+ * snapshot and how long it took, to line the clocks up.
+ *
+ * The manager does not own the drivers or transports. Call the drivers'
+ * begin() before begin() here and do not use them from other threads
+ * while the manager runs.
+ */
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <Arduino.h>
+#include <RTCCommon/RTCTime.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+* @brief	One device's result in a snapshot
+*/
+typedef struct {
+	rtc_time_hr_t	time;		/**< Time read, frac 0 for a device added with add_device() */
+	int				ret;		/**< Driver result, 0 on success */
+	uint32_t		start_us;	/**< Start of the read, from the start of the snapshot */
+	uint32_t		latency_us;	/**< Duration of the read */
+} rtc_manager_reading_t;
+
+class RTCLinuxManager
+{
+public:
+	RTCLinuxManager();
+	~RTCLinuxManager();
+
+	/**
+	* @brief	Add a bus, i.e. a worker
+	*
+	* @returns	Bus index for add_device(), -1 once begin() has been called
+	*/
+	int add_bus(void);
+
+	/**
+	* @brief	Add a device read with get_epoch()
+	*
+	* @param[in]	bus		Index from add_bus()
+	* @param[in]	rtc		Driver, any part
+	*
+	* @returns	Index of the device's reading, -1 on a bad bus or once begin() has been called
+	*/
+	template <class RTC>
+	int add_device(int bus, RTC *rtc)
+	{
+		return add(bus, rtc, &read_epoch<RTC>);
+	}
+
+	/**
+	* @brief	Add a device read with get_time_hr(), to 1/128 s (MAX3133X)
+	*
+	* @returns	See add_device()
+	*/
+	template <class RTC>
+	int add_device_hr(int bus, RTC *rtc)
+	{
+		return add(bus, rtc, &read_hr<RTC>);
+	}
+
+	/**
+	* @brief	Start the workers
+	*
+	* @returns	0 on success, -1 if a thread could not be started
+	*/
+	int begin(void);
+
+	/**
+	* @brief	Stop the workers. Devices and buses can be added again after.
+	*/
+	void end(void);
+
+	/**
+	* @brief	Read every device once, the buses in parallel
+	*
+	* @param[out]	readings	One reading per device, in add_device() order
+	* @param[in]	count		Size of readings, at least num_devices()
+	*
+	* @returns	0 if every read succeeded, -1 if one failed (see ret of each reading)
+	*			or the manager is not started or readings is too short
+	*/
+	int snapshot(rtc_manager_reading_t *readings, size_t count);
+
+	/**
+	* @brief	Number of devices added
+	*/
+	size_t num_devices(void) const { return m_devices.size(); }
+
+	/**
+	* @brief	Wall time of the last snapshot, in microseconds
+	*/
+	uint32_t last_snapshot_us(void) const { return m_last_us; }
+
+private:
+	typedef int (*read_fn_t)(void *rtc, rtc_time_hr_t *time);
+
+	typedef struct {
+		int			bus;
+		void		*rtc;
+		read_fn_t	read;
+	} device_t;
+
+	template <class RTC>
+	static int read_epoch(void *rtc, rtc_time_hr_t *time)
+	{
+		time->frac = 0;
+		return static_cast<RTC *>(rtc)->get_epoch(&time->sec);
+	}
+
+	template <class RTC>
+	static int read_hr(void *rtc, rtc_time_hr_t *time)
+	{
+		return static_cast<RTC *>(rtc)->get_time_hr(time);
+	}
+
+	int add(int bus, void *rtc, read_fn_t read);
+	void worker(int bus, uint32_t seen);
+
+	std::vector<device_t> m_devices;
+	std::vector<std::thread> m_workers;
+	int m_buses;
+	bool m_started;
+
+	/* Snapshot hand-off, under m_lock */
+	std::mutex m_lock;
+	std::condition_variable m_start;
+	std::condition_variable m_done;
+	uint32_t m_generation;
+	int m_pending;
+	bool m_stop;
+	rtc_manager_reading_t *m_out;
+	uint64_t m_t0_us;
+	uint32_t m_last_us;
+};
+
+#endif /* __linux__ */
+
+#endif /* _RTC_LINUX_MANAGER_H_ */
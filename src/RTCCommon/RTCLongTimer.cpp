@@ -0,0 +1,193 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#include <RTCCommon/RTCLongTimer.h>
+
+#define MS_PER_SEC		1000UL
+#define US_PER_SEC		1000000UL
+#define NUM_FREQS		4
+
+/* Ticks per second of timer_freq_t 0 to 3, the same on every part */
+static const uint16_t timer_hz[NUM_FREQS] = { 1024, 256, 64, 16 };
+
+RTCLongTimer::RTCLongTimer(uint16_t max_count)
+{
+	m_max_count = max_count;
+	m_freq = 0;
+	m_ticks = 0;
+	m_final = 0;
+	m_tifs_left = 0;
+	m_pending = false;
+	m_cb = NULL;
+	m_cb_arg = NULL;
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+int RTCLongTimer::start(uint32_t duration_ms, uint32_t resolution_ms, rtc_long_timer_cb_t cb, void *arg)
+{
+	int ret;
+	uint64_t periods;
+	uint16_t first;
+	uint8_t freq;
+
+	/* Coarsest first, the tick in us is 10^6 / hz */
+	for (freq = NUM_FREQS - 1; freq > 0; freq--) {
+		if ((uint64_t)US_PER_SEC <= (uint64_t)resolution_ms * MS_PER_SEC * timer_hz[freq]) {
+			break;
+		}
+	}
+
+	m_tifs_left = 0;
+	m_pending = false;
+	m_freq = freq;
+	m_cb = cb;
+	m_cb_arg = arg;
+
+	m_ticks = ((uint64_t)duration_ms * timer_hz[freq] + MS_PER_SEC / 2) / MS_PER_SEC;
+	if (m_ticks == 0) {
+		m_ticks = 1;
+	}
+
+	periods = m_ticks / m_max_count;
+	m_final = m_ticks % m_max_count;
+
+	/* A countdown shorter than one period is the partial period alone, one-shot */
+	first = periods ? m_max_count : m_final;
+
+	ret = timer_load(first, periods != 0, freq);
+	if (ret) {
+		m_stats.errors++;
+		return ret;
+	}
+
+	if (periods == 0) {
+		m_tifs_left = 1;
+	} else {
+		m_tifs_left = (uint32_t)periods + (m_final ? 1 : 0);
+	}
+
+	/* The first period is already the last full one */
+	if ((m_tifs_left == 2) && m_final) {
+		ret = timer_reload(m_final);
+		if (ret) {
+			m_stats.errors++;
+			return ret;
+		}
+		m_stats.reloads++;
+	}
+
+	return 0;
+}
+
+int RTCLongTimer::stop(void)
+{
+	int ret;
+
+	m_tifs_left = 0;
+	m_pending = false;
+
+	ret = timer_halt();
+	if (ret) {
+		m_stats.errors++;
+	}
+
+	return ret;
+}
+
+int RTCLongTimer::service(void)
+{
+	int ret;
+	uint8_t status;
+
+	m_pending = false;
+
+	ret = read_status(&status);
+	if (ret) {
+		m_stats.errors++;
+		return ret;
+	}
+
+	if (!(status & RTC_LONG_TIMER_TIF)) {
+		return 0;
+	}
+
+	return tif();
+}
+
+int RTCLongTimer::tif(void)
+{
+	int ret;
+
+	if (m_tifs_left == 0) {
+		return 0;
+	}
+
+	m_stats.tifs++;
+	m_tifs_left--;
+
+	if (m_tifs_left == 0) {
+		m_stats.expired++;
+
+		/* Repeat mode would run the partial period again */
+		ret = timer_halt();
+		if (ret) {
+			m_stats.errors++;
+		}
+
+		if (m_cb) {
+			m_cb(m_cb_arg);
+		}
+		return ret;
+	}
+
+	/* The period now running is the last full one, the hardware loads the partial count next */
+	if ((m_tifs_left == 2) && m_final) {
+		ret = timer_reload(m_final);
+		if (ret) {
+			m_stats.errors++;
+			return ret;
+		}
+		m_stats.reloads++;
+	}
+
+	return 0;
+}
+
+void RTCLongTimer::get_stats(rtc_long_timer_stats_t &stats)
+{
+	stats = m_stats;
+}
+
+void RTCLongTimer::reset_stats(void)
+{
+	memset(&m_stats, 0, sizeof(m_stats));
+}
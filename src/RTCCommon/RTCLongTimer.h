@@ -0,0 +1,248 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#ifndef _RTC_LONG_TIMER_H_
+#define _RTC_LONG_TIMER_H_
+
+#include <Arduino.h>
+#include <RTCCommon/RTCEventQueue.h>
+
+/*
+ * Countdowns of any 32-bit length on the 8-bit hardware timers.
+ *
+ * start() takes a duration and the resolution the caller needs, both in
+ * milliseconds. It picks the coarsest timer frequency whose tick is not
+ * longer than the resolution, 16, 64, 256 or 1024 Hz, and rounds the
+ * duration to whole ticks. The coarsest tick gives the longest hardware
+ * period, 255 ticks or 15.9 s at 16 Hz, so the fewest wakes.
+ *
+ * The ticks are split into full periods of the largest count and a
+ * final partial period. The timer runs in repeat mode and reloads itself
+ * at every expiry, so the MCU only wakes to count the TIF interrupts.
+ * While the last full period runs, the partial count is written to the
+ * timer initial value and the hardware loads it at the next expiry. No
+ * period is ever started from software after start(), so the service
+ * latency never adds up: the countdown ends exactly the rounded number of
+ * ticks after start().
+ *
+ * Each TIF must be serviced within one hardware period, 15.9 s at 16 Hz,
+ * 249 ms at 1024 Hz: two expiries set one flag and would count once.
+ *
+ * Call irq() from the pin interrupt handler and service() from the main
+ * loop when pending() says so. service() reads the status register, which
+ * clears the other flags as well. Where something else reads the status,
+ * the MAX3133X dispatcher or RTCEventQueue, call tif() for each TIF it
+ * sees instead.
+ *
+ * RTCLongTimer holds the logic and is compiled once. RTCLongTimerT binds
+ * it to a driver with timer_init(), timer_reload(), timer_start() and
+ * timer_stop(): MAX31329, MAX31341, MAX31342, MAX31343, MAX31331,
+ * MAX31334 and MAX31335. MAX_COUNT is the largest timer count, 255, or
+ * 65535 for the 16-bit timer of MAX31334:
+ *
+ *	MAX31343 rtc(&Wire);
+ *	RTCLongTimerT<MAX31343> timeout(&rtc);
+ *
+ *	void rtc_isr(void) { timeout.irq(); }
+ *
+ *	timeout.start(2UL * 3600 * 1000, 1000, on_timeout, NULL);
+ *
+ *	if (timeout.pending()) timeout.service();
+ */
+
+/**
+* @brief	TIF, bit 2 of the status register on every part with a timer
+*/
+#define RTC_LONG_TIMER_TIF		0x04
+
+/**
+* @brief	Expiry callback, run from service() or tif()
+*
+* @param[in]	arg		Pointer given to start()
+*/
+typedef void (*rtc_long_timer_cb_t)(void *arg);
+
+/**
+* @brief	Long timer counters
+*/
+typedef struct {
+	uint32_t tifs;		/**< Timer interrupts counted, MCU wakes */
+	uint32_t reloads;	/**< Partial counts written to a running timer */
+	uint32_t expired;	/**< Countdowns run to the end */
+	uint32_t errors;	/**< Failed RTC accesses */
+} rtc_long_timer_stats_t;
+
+class RTCLongTimer
+{
+public:
+	virtual ~RTCLongTimer() {}
+
+	/**
+	* @brief	Start a countdown, a running one is replaced
+	*
+	* @param[in]	duration_ms		Length, rounded to whole ticks, at least one tick
+	* @param[in]	resolution_ms	Longest tick accepted, 0 for the finest
+	* @param[in]	cb				Callback, run at the end
+	* @param[in]	arg				Passed to the callback
+	*
+	* @returns	0 on success, the driver's error code on failure
+	*/
+	int start(uint32_t duration_ms, uint32_t resolution_ms, rtc_long_timer_cb_t cb, void *arg);
+
+	/**
+	* @brief	Stop the countdown, the callback is not run
+	*
+	* @returns	0 on success, the driver's error code on failure
+	*/
+	int stop(void);
+
+	/**
+	* @brief	Note the RTC interrupt, safe to call from an interrupt handler
+	*/
+	void irq(void) { m_pending = true; }
+
+	/**
+	* @brief	Whether service() has work
+	*/
+	bool pending(void) const { return m_pending; }
+
+	/**
+	* @brief	Read and clear the status, count a TIF if set
+	*
+	* @returns	0 on success, the driver's error code on failure
+	*/
+	int service(void);
+
+	/**
+	* @brief	Count a TIF read and cleared by the caller
+	*
+	* @returns	0 on success, the driver's error code on failure
+	*/
+	int tif(void);
+
+	/**
+	* @brief	Whether a countdown runs
+	*/
+	bool running(void) const { return m_tifs_left != 0; }
+
+	/**
+	* @brief	Timer frequency of the countdown, a timer_freq_t
+	*/
+	uint8_t freq(void) const { return m_freq; }
+
+	/**
+	* @brief	Length of the countdown in timer ticks
+	*/
+	uint64_t ticks(void) const { return m_ticks; }
+
+	/**
+	* @brief	Timer interrupts left until the end
+	*/
+	uint32_t tifs_left(void) const { return m_tifs_left; }
+
+	/**
+	* @brief	Get counters.
+	*/
+	void get_stats(rtc_long_timer_stats_t &stats);
+
+	/**
+	* @brief	Clear counters.
+	*/
+	void reset_stats(void);
+
+protected:
+	/**
+	* @param[in]	max_count	Largest timer count
+	*/
+	explicit RTCLongTimer(uint16_t max_count);
+
+	/** @brief	Driver timer_init() then timer_start() */
+	virtual int timer_load(uint16_t count, bool repeat, uint8_t freq) = 0;
+
+	/** @brief	Driver timer_reload() */
+	virtual int timer_reload(uint16_t count) = 0;
+
+	/** @brief	Driver timer_stop() */
+	virtual int timer_halt(void) = 0;
+
+	/** @brief	Read and clear the status register, raw */
+	virtual int read_status(uint8_t *status) = 0;
+
+private:
+	uint16_t m_max_count;
+	uint8_t m_freq;
+	uint64_t m_ticks;
+	uint16_t m_final;		/* Count of the partial period, 0 if none */
+	uint32_t m_tifs_left;	/* 0 when stopped */
+	volatile bool m_pending;
+
+	rtc_long_timer_cb_t m_cb;
+	void *m_cb_arg;
+	rtc_long_timer_stats_t m_stats;
+};
+
+/**
+* @brief	Long timer over MAX31329, MAX31341, MAX31342, MAX31343 or MAX3133X
+*/
+template <class RTC, uint16_t MAX_COUNT = 255>
+class RTCLongTimerT : public RTCLongTimer
+{
+public:
+	/**
+	* @param[in]	rtc		Driver, begin() already called
+	*/
+	explicit RTCLongTimerT(RTC *rtc) : RTCLongTimer(MAX_COUNT), m_rtc(rtc) {}
+
+protected:
+	int timer_load(uint16_t count, bool repeat, uint8_t freq)
+	{
+		int ret;
+
+		ret = m_rtc->timer_init(count, repeat, (typename RTC::timer_freq_t)freq);
+		if (ret) {
+			return ret;
+		}
+
+		return m_rtc->timer_start();
+	}
+
+	int timer_reload(uint16_t count) { return m_rtc->timer_reload(count); }
+
+	int timer_halt(void) { return m_rtc->timer_stop(); }
+
+	int read_status(uint8_t *status) { return rtc_event_read_status(m_rtc, status); }
+
+private:
+	RTC *m_rtc;
+};
+
+#endif /* _RTC_LONG_TIMER_H_ */
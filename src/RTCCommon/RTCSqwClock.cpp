@@ -0,0 +1,160 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#include <RTCCommon/RTCSqwClock.h>
+
+#define US_PER_SEC			1000000UL
+
+/* A sync read must not come close to the next edge, which it could miss */
+#define SYNC_WINDOW_US		900000UL
+
+/* An edge this late means SQW stopped or edges were lost */
+#define EDGE_OVERDUE_US		1500000UL
+
+RTCSqwClock::RTCSqwClock()
+{
+	m_edges = 0;
+	m_edge_us = 0;
+	m_base = 0;
+	m_synced = false;
+	reset_stats();
+}
+
+void RTCSqwClock::edge(void)
+{
+	m_edge_us = micros();
+	m_edges = m_edges + 1;
+}
+
+int RTCSqwClock::get_epoch_ms(rtc_epoch_t *epoch, uint16_t *ms)
+{
+	uint32_t edges;
+	uint32_t edge_us;
+	uint32_t elapsed;
+	rtc_epoch_t now;
+	int ret;
+
+	noInterrupts();
+	edges = m_edges;
+	edge_us = m_edge_us;
+	interrupts();
+
+	elapsed = micros() - edge_us;
+
+	if (m_synced && (elapsed >= EDGE_OVERDUE_US)) {
+		m_synced = false;
+		m_stats.lost++;
+	}
+
+	if (m_synced) {
+		/* Past a full second, the next edge is late but not lost yet */
+		*epoch = m_base + edges + elapsed / US_PER_SEC;
+		*ms = (elapsed / 1000) % 1000;
+		return 0;
+	}
+
+	if (!edges || (elapsed >= SYNC_WINDOW_US)) {
+		return read(epoch, ms);
+	}
+
+	/* Well inside the second that began at the last edge */
+	ret = read_rtc(&now);
+	if (ret) {
+		m_stats.errors++;
+		return ret;
+	}
+
+	noInterrupts();
+	if (m_edges != edges) {
+		/* An edge came in during the read, it is not known which second was read */
+		interrupts();
+		*epoch = now;
+		*ms = 0;
+		return 0;
+	}
+	interrupts();
+
+	m_base = now - edges;
+	m_synced = true;
+	m_stats.syncs++;
+
+	*epoch = now;
+	*ms = (micros() - edge_us) / 1000;
+
+	return 0;
+}
+
+int RTCSqwClock::get_time_ms(struct tm *time, uint16_t *ms)
+{
+	int ret;
+	rtc_epoch_t epoch;
+
+	ret = get_epoch_ms(&epoch, ms);
+	if (ret) {
+		return ret;
+	}
+
+	rtc_epoch_to_tm(epoch, time);
+
+	return 0;
+}
+
+void RTCSqwClock::invalidate(void)
+{
+	m_synced = false;
+}
+
+void RTCSqwClock::get_stats(rtc_sqw_clock_stats_t &stats)
+{
+	stats = m_stats;
+}
+
+void RTCSqwClock::reset_stats(void)
+{
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+int RTCSqwClock::read(rtc_epoch_t *epoch, uint16_t *ms)
+{
+	int ret;
+
+	m_stats.reads++;
+
+	ret = read_rtc(epoch);
+	if (ret) {
+		m_stats.errors++;
+		return ret;
+	}
+	*ms = 0;
+
+	return 0;
+}
@@ -0,0 +1,168 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#ifndef _RTC_SQW_CLOCK_H_
+#define _RTC_SQW_CLOCK_H_
+
+#include <Arduino.h>
+#include <time.h>
+#include <RTCCommon/RTCTime.h>
+
+/*
+ * Millisecond time from the 1 Hz square wave output.
+ *
+ * Wire SQW to an interrupt pin and call edge() from its handler, on the
+ * edge at which the seconds register counts (the falling edge on
+ * MAX31328). edge() latches micros() and counts the edge. After one RTC
+ * read has tied the edge count to the RTC seconds, get_epoch_ms() needs
+ * no bus access at all: the seconds are the RTC seconds of the last edge
+ * and the milliseconds are the micros() elapsed since it. This gives
+ * sub-second time on parts without a 1/128 s register.
+ *
+ * The RTC is read again only when the edges stop: an edge overdue by
+ * half a second drops the sync, calls read the RTC with ms 0 until the
+ * edges are back, and the first call after an edge syncs again.
+ *
+ * RTCSqwClockT binds the clock to a driver that has get_epoch() and
+ * set_square_wave_frequency(), e.g. MAX31328 or MAX31343:
+ *
+ *	MAX31328 rtc(&Wire);
+ *	RTCSqwClockT<MAX31328> clock(&rtc);
+ *
+ *	void sqw_isr(void) { clock.edge(); }
+ *
+ *	attachInterrupt(digitalPinToInterrupt(SQW_PIN), sqw_isr, FALLING);
+ *	clock.begin();
+ */
+
+/**
+* @brief	SQW clock counters
+*/
+typedef struct {
+	uint32_t syncs;		/**< RTC reads that tied the edge count to the RTC */
+	uint32_t reads;		/**< RTC reads made because the clock was not synced */
+	uint32_t lost;		/**< Syncs dropped because an edge was overdue */
+	uint32_t errors;	/**< Failed RTC reads */
+} rtc_sqw_clock_stats_t;
+
+class RTCSqwClock
+{
+public:
+	virtual ~RTCSqwClock() {}
+
+	/**
+	* @brief	Note an SQW edge, call it from the interrupt handler
+	*/
+	void edge(void);
+
+	/**
+	* @brief	Get the time as Unix seconds and milliseconds
+	*
+	* @param[out]	epoch	Seconds since 1970-01-01 00:00:00
+	* @param[out]	ms		Milliseconds into the second, 0 while the clock is not synced
+	*
+	* @returns	0 on success, the driver's error code if an RTC read failed
+	*/
+	int get_epoch_ms(rtc_epoch_t *epoch, uint16_t *ms);
+
+	/**
+	* @brief	Get the time and milliseconds, see get_epoch_ms()
+	*/
+	int get_time_ms(struct tm *time, uint16_t *ms);
+
+	/**
+	* @brief	Drop the sync, e.g. after the RTC has been set. The next call after an edge syncs again.
+	*/
+	void invalidate(void);
+
+	/**
+	* @brief	Whether milliseconds are served from the edges
+	*/
+	bool is_synced(void) const { return m_synced; }
+
+	/**
+	* @brief	Get counters.
+	*/
+	void get_stats(rtc_sqw_clock_stats_t &stats);
+
+	/**
+	* @brief	Clear counters.
+	*/
+	void reset_stats(void);
+
+protected:
+	RTCSqwClock();
+
+	/** @brief	Driver get_epoch() */
+	virtual int read_rtc(rtc_epoch_t *epoch) = 0;
+
+private:
+	int read(rtc_epoch_t *epoch, uint16_t *ms);
+
+	volatile uint32_t m_edges;		/* Edges since construction */
+	volatile uint32_t m_edge_us;	/* micros() of the last edge */
+	rtc_epoch_t m_base;				/* RTC seconds at edge count 0 */
+	bool m_synced;
+	rtc_sqw_clock_stats_t m_stats;
+};
+
+/**
+* @brief	SQW clock over a driver with get_epoch() and a 1 Hz SQW_OUT_FREQ_1HZ output
+*/
+template <class RTC>
+class RTCSqwClockT : public RTCSqwClock
+{
+public:
+	/**
+	* @param[in]	rtc		Driver, begin() already called
+	*/
+	explicit RTCSqwClockT(RTC *rtc) : m_rtc(rtc) {}
+
+	/**
+	* @brief	Set the SQW output to 1 Hz. Attach the interrupt handler before.
+	*
+	* @returns	The driver's set_square_wave_frequency() result
+	*/
+	int begin(void)
+	{
+		invalidate();
+		return m_rtc->set_square_wave_frequency(RTC::SQW_OUT_FREQ_1HZ);
+	}
+
+protected:
+	int read_rtc(rtc_epoch_t *epoch) { return m_rtc->get_epoch(epoch); }
+
+private:
+	RTC *m_rtc;
+};
+
+#endif /* _RTC_SQW_CLOCK_H_ */
@@ -0,0 +1,306 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#include <RTCCommon/RTCTime.h>
+
+#define SECS_PER_DAY		86400UL
+
+/* First day of the range of the parts, 2000-01-01 */
+#define DAYS_Y2K			10957L
+
+/* First day after the range of the parts, 2200-01-01 */
+#define DAYS_END			84006L
+
+/* Days before the first of each month in a non-leap year */
+static const uint16_t days_before_month[12] = {
+	0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334
+};
+
+static bool is_leap(int16_t year)
+{
+	return ((year % 4) == 0) && (((year % 100) != 0) || ((year % 400) == 0));
+}
+
+int32_t rtc_days_from_civil(int16_t year, uint8_t mon, uint8_t mday)
+{
+	int16_t y = year - (mon <= 2);
+	int16_t era = ((y >= 0) ? y : y - 399) / 400;
+	uint16_t yoe = (uint16_t)(y - era * 400);							/* [0, 399] */
+	uint16_t doy = (153 * (mon + ((mon > 2) ? -3 : 9)) + 2) / 5 + mday - 1;	/* [0, 365] */
+	uint32_t doe = (uint32_t)yoe * 365 + yoe / 4 - yoe / 100 + doy;		/* [0, 146096] */
+
+	return (int32_t)era * 146097 + (int32_t)doe - 719468;
+}
+
+void rtc_civil_from_days(int32_t days, int16_t *year, uint8_t *mon, uint8_t *mday)
+{
+	int32_t z = days + 719468;
+	int32_t era = ((z >= 0) ? z : z - 146096) / 146097;
+	uint32_t doe = (uint32_t)(z - era * 146097);							/* [0, 146096] */
+	uint16_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;	/* [0, 399] */
+	uint16_t doy = doe - (365UL * yoe + yoe / 4 - yoe / 100);				/* [0, 365] */
+	uint8_t mp = (5 * doy + 2) / 153;										/* [0, 11] */
+
+	*mday = doy - (153 * mp + 2) / 5 + 1;
+	*mon = (mp < 10) ? mp + 3 : mp - 9;
+	*year = (int16_t)(yoe + era * 400) + (*mon <= 2);
+}
+
+uint16_t rtc_yday(int16_t year, uint8_t mon, uint8_t mday)
+{
+	uint16_t yday;
+
+	if ((mon < 1) || (mon > 12) || (mday < 1)) {
+		return 0;
+	}
+
+	yday = days_before_month[mon - 1] + mday - 1;
+	if ((mon > 2) && is_leap(year)) {
+		yday++;
+	}
+
+	return yday;
+}
+
+uint8_t rtc_hours_from_reg(uint8_t reg)
+{
+	return rtc_bcd_hours(reg);
+}
+
+int rtc_time_regs_to_epoch(const uint8_t *regs, rtc_epoch_t *epoch)
+{
+	rtc_bcd_time_t bin;
+	int32_t days;
+	uint32_t secs;
+
+	rtc_bcd_decode_time(regs, &bin);
+	days = rtc_days_from_civil(2000 + bin.year, bin.mon, bin.mday);
+	secs = (uint32_t)bin.hour * 3600 + (uint16_t)bin.min * 60 + bin.sec;
+
+#if !ANALOG_RTC_EPOCH_64
+	/* 2106-02-07 is the last day that fits in 32 bits */
+	if (days > 49710L || ((days == 49710L) && (secs > 23295UL))) {
+		return -1;
+	}
+#endif
+
+	*epoch = (rtc_epoch_t)days * SECS_PER_DAY + secs;
+
+	return 0;
+}
+
+int rtc_epoch_to_time_regs(rtc_epoch_t epoch, uint8_t *regs)
+{
+	int32_t days;
+	uint32_t secs;
+	int16_t year;
+	uint8_t mon;
+	uint8_t mday;
+
+	if (epoch < (rtc_epoch_t)RTC_EPOCH_Y2K) {
+		return -1;
+	}
+
+	days = (int32_t)(epoch / SECS_PER_DAY);
+	secs = (uint32_t)(epoch - (rtc_epoch_t)days * SECS_PER_DAY);
+
+	if (days >= DAYS_END) {
+		return -1;
+	}
+
+	rtc_civil_from_days(days, &year, &mon, &mday);
+
+	regs[0] = rtc_bin2bcd(secs % 60);
+	regs[1] = rtc_bin2bcd((secs / 60) % 60);
+	regs[2] = rtc_bin2bcd(secs / 3600);
+	/* 1970-01-01 was a Thursday, the register counts Sunday as 1 */
+	regs[3] = (days + 4) % 7 + 1;
+	regs[4] = rtc_bin2bcd(mday);
+	regs[5] = rtc_bin2bcd(mon);
+	if (year >= 2100) {
+		regs[5] |= 0x80;
+		year -= 100;
+	}
+	regs[6] = rtc_bin2bcd(year - 2000);
+
+	return 0;
+}
+
+/* Days from 1970-01-01 and seconds into the day of a time register block */
+static void time_regs_split(const uint8_t *regs, int32_t *days, int32_t *secs)
+{
+	rtc_bcd_time_t bin;
+
+	rtc_bcd_decode_time(regs, &bin);
+	*days = rtc_days_from_civil(2000 + bin.year, bin.mon, bin.mday);
+	*secs = (int32_t)bin.hour * 3600 + (uint16_t)bin.min * 60 + bin.sec;
+}
+
+/* Write the date registers, day of week included, of a day count */
+static int time_regs_set_date(uint8_t *regs, int32_t days)
+{
+	int16_t year;
+	uint8_t mon;
+	uint8_t mday;
+
+	if ((days < DAYS_Y2K) || (days >= DAYS_END)) {
+		return -1;
+	}
+
+	rtc_civil_from_days(days, &year, &mon, &mday);
+
+	regs[3] = (days + 4) % 7 + 1;
+	regs[4] = rtc_bin2bcd(mday);
+	regs[5] = rtc_bin2bcd(mon);
+	if (year >= 2100) {
+		regs[5] |= 0x80;
+		year -= 100;
+	}
+	regs[6] = rtc_bin2bcd(year - 2000);
+
+	return 0;
+}
+
+int rtc_time_regs_add(uint8_t *regs, int32_t secs)
+{
+	int32_t days;
+	int32_t day_secs;
+	int32_t shift;
+
+	time_regs_split(regs, &days, &day_secs);
+
+	/* Whole days first so that the sum cannot overflow */
+	shift = secs / (int32_t)SECS_PER_DAY;
+	day_secs += secs - shift * (int32_t)SECS_PER_DAY;
+	if (day_secs < 0) {
+		day_secs += (int32_t)SECS_PER_DAY;
+		shift--;
+	} else if (day_secs >= (int32_t)SECS_PER_DAY) {
+		day_secs -= (int32_t)SECS_PER_DAY;
+		shift++;
+	}
+
+	if (shift && time_regs_set_date(regs, days + shift)) {
+		return -1;
+	}
+
+	regs[0] = rtc_bin2bcd(day_secs % 60);
+	regs[1] = rtc_bin2bcd((day_secs / 60) % 60);
+	regs[2] = rtc_bin2bcd(day_secs / 3600);
+
+	return 0;
+}
+
+int rtc_time_regs_add_days(uint8_t *regs, int32_t days)
+{
+	int32_t now;
+	int32_t day_secs;
+
+	time_regs_split(regs, &now, &day_secs);
+
+	if (time_regs_set_date(regs, now + days)) {
+		return -1;
+	}
+
+	/* 24 hour mode, as the other writers */
+	regs[2] = rtc_bin2bcd(day_secs / 3600);
+
+	return 0;
+}
+
+int rtc_time_regs_cmp(const uint8_t *a, const uint8_t *b)
+{
+	int32_t days_a;
+	int32_t days_b;
+	int32_t secs_a;
+	int32_t secs_b;
+
+	time_regs_split(a, &days_a, &secs_a);
+	time_regs_split(b, &days_b, &secs_b);
+
+	if (days_a != days_b) {
+		return (days_a > days_b) ? 1 : -1;
+	}
+
+	return (secs_a > secs_b) - (secs_a < secs_b);
+}
+
+int32_t rtc_time_regs_diff(const uint8_t *a, const uint8_t *b)
+{
+	int32_t days_a;
+	int32_t days_b;
+	int32_t secs_a;
+	int32_t secs_b;
+
+	time_regs_split(a, &days_a, &secs_a);
+	time_regs_split(b, &days_b, &secs_b);
+
+	return (days_a - days_b) * (int32_t)SECS_PER_DAY + (secs_a - secs_b);
+}
+
+void rtc_time_regs_to_alarm(const uint8_t *regs, uint8_t *alarm)
+{
+	alarm[0] = regs[0] & 0x7F;
+	alarm[1] = regs[1] & 0x7F;
+	alarm[2] = rtc_bin2bcd(rtc_bcd_hours(regs[2]));
+	alarm[3] = regs[4] & 0x3F;
+	alarm[4] = regs[5] & 0x1F;
+	alarm[5] = regs[6];
+}
+
+void rtc_epoch_to_tm(rtc_epoch_t epoch, struct tm *time)
+{
+	int32_t days = (int32_t)(epoch / SECS_PER_DAY);
+	uint32_t secs = (uint32_t)(epoch - (rtc_epoch_t)days * SECS_PER_DAY);
+	int16_t year;
+	uint8_t mon;
+	uint8_t mday;
+
+	rtc_civil_from_days(days, &year, &mon, &mday);
+
+	time->tm_sec = secs % 60;
+	time->tm_min = (secs / 60) % 60;
+	time->tm_hour = secs / 3600;
+	time->tm_mday = mday;
+	time->tm_mon = mon - 1;
+	time->tm_year = year - 1900;
+	time->tm_wday = (days + 4) % 7;
+	time->tm_yday = rtc_yday(year, mon, mday);
+	time->tm_isdst = 0;
+}
+
+rtc_epoch_t rtc_tm_to_epoch(const struct tm *time)
+{
+	int32_t days = rtc_days_from_civil(time->tm_year + 1900, time->tm_mon + 1, time->tm_mday);
+
+	return (rtc_epoch_t)days * SECS_PER_DAY + time->tm_hour * 3600L + time->tm_min * 60 + time->tm_sec;
+}
@@ -0,0 +1,249 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#ifndef _RTC_TIME_H_
+#define _RTC_TIME_H_
+
+#include <Arduino.h>
+#include <time.h>
+#include <RTCCommon/RTCBcd.h>
+
+/*
+ * Calendar helpers shared by the drivers.
+ *
+ * The functions work on the seconds to year register block that every
+ * part in the library has: seconds, minutes, hours, day of week, date,
+ * month with the century bit, year. They go straight from BCD to Unix
+ * seconds and back with days_from_civil()/civil_from_days() (H. Hinnant),
+ * so a caller that wants a timestamp does not pay for struct tm and
+ * mktime(). Years 2000 to 2199 are covered.
+ *
+ * rtc_epoch_t is 32 bits unsigned by default, which is cheap on 8-bit
+ * targets and reaches February 2106. Set ANALOG_RTC_EPOCH_64 to 1 for the
+ * whole library, e.g. -DANALOG_RTC_EPOCH_64=1, to get 64-bit signed
+ * seconds and the full range of the parts.
+ */
+#ifndef ANALOG_RTC_EPOCH_64
+#define ANALOG_RTC_EPOCH_64	0
+#endif
+
+#if ANALOG_RTC_EPOCH_64
+typedef int64_t rtc_epoch_t;
+#else
+typedef uint32_t rtc_epoch_t;
+#endif
+
+/**
+* @brief	Seconds from 1970-01-01 to 2000-01-01, the lowest time the parts hold
+*/
+#define RTC_EPOCH_Y2K		946684800UL
+
+/**
+* @brief	Sub-second ticks per second of the parts that count them (MAX3133X)
+*/
+#define RTC_HR_TICKS_PER_SEC	128
+
+/**
+* @brief	Time to 1/128 s: Unix seconds and the sub-second count, as the parts hold it
+*
+* @details	The fraction is kept as read, so no resolution is lost and no
+*			division is needed until the caller converts it. The conversions
+*			below are integer only and can be used in interrupt handlers.
+*/
+typedef struct {
+	rtc_epoch_t	sec;	/**< Unix seconds */
+	uint8_t		frac;	/**< 1/128 s into the second, 0 to 127 */
+} rtc_time_hr_t;
+
+/**
+* @brief	Milliseconds, 0 to 992, of a 1/128 s fraction, rounded down
+*/
+static inline uint16_t rtc_hr_frac_to_ms(uint8_t frac)
+{
+	/* 1000 / 128 = 125 / 16 */
+	return ((uint16_t)frac * 125) >> 4;
+}
+
+/**
+* @brief	Microseconds, 0 to 992187, of a 1/128 s fraction, rounded down
+*/
+static inline uint32_t rtc_hr_frac_to_us(uint8_t frac)
+{
+	/* 1000000 / 128 = 15625 / 2 */
+	return ((uint32_t)frac * 15625) >> 1;
+}
+
+/**
+* @brief	Milliseconds since 1970-01-01 of a 1/128 s time
+*/
+static inline uint64_t rtc_hr_to_ms(const rtc_time_hr_t *time)
+{
+	return (uint64_t)time->sec * 1000 + rtc_hr_frac_to_ms(time->frac);
+}
+
+/**
+* @brief	Microseconds since 1970-01-01 of a 1/128 s time
+*/
+static inline uint64_t rtc_hr_to_us(const rtc_time_hr_t *time)
+{
+	return (uint64_t)time->sec * 1000000 + rtc_hr_frac_to_us(time->frac);
+}
+
+/**
+* @brief	Days from 1970-01-01 to a date of the proleptic Gregorian calendar
+*
+* @param[in]	year	Full year, e.g. 2024
+* @param[in]	mon		Month, 1 to 12
+* @param[in]	mday	Day of month, 1 to 31
+*/
+int32_t rtc_days_from_civil(int16_t year, uint8_t mon, uint8_t mday);
+
+/**
+* @brief	Date of a day count from 1970-01-01, inverse of rtc_days_from_civil()
+*/
+void rtc_civil_from_days(int32_t days, int16_t *year, uint8_t *mon, uint8_t *mday);
+
+/**
+* @brief	Day of year, 0 to 365, as in tm_yday
+*
+* @details	0 for a month or day of month out of range, as read from a
+*			register block that was never written.
+*
+* @param[in]	year	Full year
+* @param[in]	mon		Month, 1 to 12
+* @param[in]	mday	Day of month, 1 to 31
+*/
+uint16_t rtc_yday(int16_t year, uint8_t mon, uint8_t mday);
+
+/**
+* @brief	Hours, 0 to 23, of an hours register in 12 (bit 6 set, bit 5 PM) or 24 hour mode
+*/
+uint8_t rtc_hours_from_reg(uint8_t reg);
+
+/**
+* @brief	Unix seconds of a seconds to year register block
+*
+* @param[in]	regs	7 registers, seconds first
+* @param[out]	epoch	Unix seconds
+*
+* @returns	0 on success, -1 if the time does not fit in rtc_epoch_t
+*/
+int rtc_time_regs_to_epoch(const uint8_t *regs, rtc_epoch_t *epoch);
+
+/**
+* @brief	Seconds to year register block, in 24 hour mode, of Unix seconds
+*
+* @param[in]	epoch	Unix seconds from 2000-01-01 to the end of 2199
+* @param[out]	regs	7 registers, seconds first
+*
+* @returns	0 on success, -1 if the time is out of the range of the parts
+*/
+int rtc_epoch_to_time_regs(rtc_epoch_t epoch, uint8_t *regs);
+
+/*
+ * Arithmetic on the seconds to year register block, in place and without
+ * struct tm. The blocks of every part have that layout: pass
+ * &regs.seconds_reg.raw for a max3133x_rtc_time_regs_t, the start of the
+ * struct for the drivers' rtc_time_regs_t. Hours are read in 12 or 24 hour
+ * mode; a block that is written is in 24 hour mode. Only the time of day
+ * is touched when the result stays on the same date.
+ */
+
+/**
+* @brief	Add seconds, negative to subtract, to a time register block
+*
+* @param[in,out]	regs	7 registers, seconds first
+* @param[in]		secs	Seconds to add
+*
+* @returns	0 on success, -1 if the result is out of 2000 to 2199, regs left as is
+*/
+int rtc_time_regs_add(uint8_t *regs, int32_t secs);
+
+/**
+* @brief	Add minutes, negative to subtract, see rtc_time_regs_add()
+*/
+static inline int rtc_time_regs_add_minutes(uint8_t *regs, int16_t mins)
+{
+	return rtc_time_regs_add(regs, (int32_t)mins * 60);
+}
+
+/**
+* @brief	Add days, negative to subtract, to a time register block; the time of day is kept
+*
+* @returns	0 on success, -1 if the result is out of 2000 to 2199, regs left as is
+*/
+int rtc_time_regs_add_days(uint8_t *regs, int32_t days);
+
+/**
+* @brief	Order of two time register blocks
+*
+* @returns	Negative if a is earlier than b, 0 if equal, positive if later
+*/
+int rtc_time_regs_cmp(const uint8_t *a, const uint8_t *b);
+
+/**
+* @brief	Seconds from b to a, negative if a is earlier
+*
+* @details	The result holds for times less than 68 years apart.
+*/
+int32_t rtc_time_regs_diff(const uint8_t *a, const uint8_t *b);
+
+/**
+* @brief	Alarm 1 registers matching a time register block once
+*
+* @details	Seconds, minutes, hours in 24 hour mode, date, month and year
+*			with every mask bit clear. That is the one-time alarm on parts
+*			with month and year alarm registers (MAX31329, MAX31343,
+*			MAX3133X); on MAX31328/MAX31341/MAX31342, which take the first
+*			4 registers, it matches the date and time every month.
+*
+* @param[in]	regs	7 time registers, seconds first
+* @param[out]	alarm	6 alarm registers, seconds first
+*/
+void rtc_time_regs_to_alarm(const uint8_t *regs, uint8_t *alarm);
+
+/**
+* @brief	struct tm of Unix seconds, as gmtime() without the C library
+*
+* @param[in]	epoch	Unix seconds
+* @param[out]	time	Broken down time, tm_wday and tm_yday included, tm_isdst 0
+*/
+void rtc_epoch_to_tm(rtc_epoch_t epoch, struct tm *time);
+
+/**
+* @brief	Unix seconds of a struct tm taken as UTC, as timegm() without the C library
+*
+* @param[in]	time	Broken down time, fields in range: it is not normalized as by mktime(). tm_wday, tm_yday and tm_isdst are not used.
+*/
+rtc_epoch_t rtc_tm_to_epoch(const struct tm *time);
+
+#endif /* _RTC_TIME_H_ */
@@ -0,0 +1,253 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#include <RTCCommon/RTCTimeCache.h>
+
+static const rtc_time_cache_cfg_t default_cfg = RTC_TIME_CACHE_CFG_DEFAULT;
+
+RTCTimeCache::RTCTimeCache()
+{
+	m_anchor_epoch = 0;
+	m_anchor_ms = 0;
+	m_read_ms = 0;
+	m_valid = false;
+	m_locked = false;
+	m_edge_pending = false;
+	m_edge_ms = 0;
+	set_config(default_cfg);
+	reset_stats();
+}
+
+void RTCTimeCache::set_config(const rtc_time_cache_cfg_t &cfg)
+{
+	uint64_t window;
+
+	m_period_ms = cfg.period_ms;
+	m_drift_window_ms = 0;
+
+	if (cfg.max_drift_ms && cfg.mcu_ppm) {
+		window = (uint64_t)cfg.max_drift_ms * 1000000UL / cfg.mcu_ppm;
+		/* Elapsed times are compared as signed 32-bit too */
+		m_drift_window_ms = (window > 0x7FFFFFFFUL) ? 0x7FFFFFFFUL : (uint32_t)window;
+	}
+}
+
+int RTCTimeCache::get_epoch(rtc_epoch_t *epoch)
+{
+	uint32_t now;
+
+	take_edge();
+	now = millis();
+
+	if (!m_valid) {
+		return resync(RESYNC_NONE, epoch);
+	}
+	if (m_period_ms && ((now - m_read_ms) >= m_period_ms)) {
+		return resync(RESYNC_PERIOD, epoch);
+	}
+	if (m_drift_window_ms && (since_anchor(now) >= m_drift_window_ms)) {
+		return resync(RESYNC_DRIFT, epoch);
+	}
+
+	m_stats.hits++;
+	*epoch = m_anchor_epoch + since_anchor(now) / 1000;
+
+	return 0;
+}
+
+int RTCTimeCache::get_time(struct tm *time)
+{
+	int ret;
+	rtc_epoch_t epoch;
+
+	ret = get_epoch(&epoch);
+	if (ret) {
+		return ret;
+	}
+
+	rtc_epoch_to_tm(epoch, time);
+
+	return 0;
+}
+
+int RTCTimeCache::set_epoch(rtc_epoch_t epoch)
+{
+	int ret;
+
+	ret = write_rtc(epoch);
+	if (ret) {
+		return ret;
+	}
+
+	m_anchor_epoch = epoch;
+	m_anchor_ms = millis();
+	m_read_ms = m_anchor_ms;
+	m_valid = true;
+	m_locked = false;
+
+	return 0;
+}
+
+void RTCTimeCache::sqw_edge(void)
+{
+	m_edge_ms = millis();
+	m_edge_pending = true;
+}
+
+void RTCTimeCache::invalidate(void)
+{
+	m_valid = false;
+	m_locked = false;
+}
+
+void RTCTimeCache::get_stats(rtc_time_cache_stats_t &stats)
+{
+	stats = m_stats;
+}
+
+void RTCTimeCache::reset_stats(void)
+{
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+uint32_t RTCTimeCache::since_anchor(uint32_t now)
+{
+	int32_t elapsed = (int32_t)(now - m_anchor_ms);
+
+	/* An anchor on an edge is rounded up and can be 1 ms ahead of millis() */
+	return (elapsed > 0) ? (uint32_t)elapsed : 0;
+}
+
+void RTCTimeCache::take_edge(void)
+{
+	uint32_t edge_ms;
+	int32_t dt;
+	int32_t ticks;
+	int32_t err;
+	bool pending;
+
+	noInterrupts();
+	pending = m_edge_pending;
+	edge_ms = m_edge_ms;
+	m_edge_pending = false;
+	interrupts();
+
+	if (!pending || !m_valid) {
+		return;
+	}
+
+	/* millis() truncates, so the edge was up to 1 ms before edge_ms + 1 and never after it */
+	edge_ms++;
+	dt = (int32_t)(edge_ms - m_anchor_ms);
+
+	/* Too far from the anchor to count the seconds in between reliably */
+	if (m_drift_window_ms && (dt >= (int32_t)m_drift_window_ms)) {
+		return;
+	}
+
+	if (m_locked) {
+		ticks = ((dt >= 0) ? dt + 500 : dt - 500) / 1000;
+		if (ticks <= 0) {
+			return;
+		}
+
+		err = dt - ticks * 1000;
+		if (err < 0) {
+			err = -err;
+		}
+		if (err > m_stats.max_edge_err_ms) {
+			m_stats.max_edge_err_ms = err;
+		}
+	} else if (dt > 0) {
+		/* The read saw a second that had begun before it, the first edge after it starts the next one */
+		ticks = (dt - 1) / 1000 + 1;
+	} else if (dt > -1000) {
+		/* The edge started the second that the read saw */
+		ticks = 0;
+	} else {
+		return;
+	}
+
+	m_anchor_epoch += ticks;
+	m_anchor_ms = edge_ms;
+	m_locked = true;
+	m_stats.resyncs_edge++;
+}
+
+int RTCTimeCache::resync(resync_t reason, rtc_epoch_t *epoch)
+{
+	int ret;
+	uint32_t t;
+	rtc_epoch_t now;
+	rtc_epoch_t predicted;
+	bool matched;
+
+	m_stats.misses++;
+
+	t = millis();
+	ret = read_rtc(&now);
+	if (ret) {
+		m_stats.errors++;
+		return ret;
+	}
+
+	if (reason == RESYNC_PERIOD) {
+		m_stats.resyncs_period++;
+	} else if (reason == RESYNC_DRIFT) {
+		m_stats.resyncs_drift++;
+	}
+
+	if (m_valid) {
+		/* The anchor may be up to one second behind, or one edge behind a read that straddles it */
+		predicted = m_anchor_epoch + since_anchor(t) / 1000;
+		matched = (now == predicted) || (now == predicted + 1);
+		if (!matched) {
+			m_stats.corrections++;
+		}
+
+		/* A read cannot improve on an anchor locked to an edge, serve what the anchor gives to stay monotonic */
+		if (matched && m_locked && (reason != RESYNC_DRIFT)) {
+			m_read_ms = t;
+			*epoch = predicted;
+			return 0;
+		}
+	}
+
+	m_anchor_epoch = now;
+	m_anchor_ms = t;
+	m_read_ms = t;
+	m_valid = true;
+	m_locked = false;
+	*epoch = now;
+
+	return 0;
+}
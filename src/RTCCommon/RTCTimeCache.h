@@ -0,0 +1,205 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#ifndef _RTC_TIME_CACHE_H_
+#define _RTC_TIME_CACHE_H_
+
+#include <Arduino.h>
+#include <time.h>
+#include <RTCCommon/RTCTime.h>
+
+/*
+ * Time served from the MCU clock between RTC reads.
+ *
+ * The cache reads the RTC once, notes millis() at the read and then
+ * answers get_epoch()/get_time() by adding the elapsed MCU time, with no
+ * bus access. It reads the RTC again when the configured period has
+ * passed, when the worst case drift of the MCU clock could have reached
+ * max_drift_ms, after invalidate(), and after a failed read.
+ *
+ * An RTC read only gives the time to the second, so after a read the
+ * served time lags the RTC by up to one second. Calling sqw_edge() from
+ * the interrupt of the 1 Hz square wave output, on the edge at which the
+ * seconds register counts, removes the lag: each edge moves the anchor to
+ * an exact second boundary without a bus access, which also resets the
+ * drift budget. With the edges coming in, the RTC is only read at the
+ * configured period, as a check.
+ *
+ * RTCTimeCache holds the logic and is compiled once. RTCTimeCacheT binds
+ * it to a driver, e.g.
+ *
+ *	MAX31343 rtc(&Wire);
+ *	RTCTimeCacheT<MAX31343> clock(&rtc);
+ */
+
+/**
+* @brief	Resync policy of a time cache
+*
+* @details	The drift budget is spent after max_drift_ms * 10^6 / mcu_ppm ms
+*			since the last anchor. 0 in period_ms, max_drift_ms or mcu_ppm
+*			disables that resync.
+*/
+typedef struct {
+	uint32_t	period_ms;		/**< RTC read at least this often */
+	uint16_t	max_drift_ms;	/**< Largest extrapolation error allowed */
+	uint16_t	mcu_ppm;		/**< Worst case error of the MCU clock against the RTC */
+} rtc_time_cache_cfg_t;
+
+/**
+* @brief	Default policy: read every 10 minutes, 10 ms drift at 100 ppm (every 100 s without SQW)
+*/
+#define RTC_TIME_CACHE_CFG_DEFAULT	{ 600000UL, 10, 100 }
+
+/**
+* @brief	Time cache counters
+*/
+typedef struct {
+	uint32_t hits;				/**< Calls served from the MCU clock */
+	uint32_t misses;			/**< Calls that read the RTC */
+	uint32_t resyncs_period;	/**< Reads because period_ms had passed */
+	uint32_t resyncs_drift;		/**< Reads because the drift budget was spent */
+	uint32_t resyncs_edge;		/**< Anchors moved to a SQW edge, no bus access */
+	uint32_t corrections;		/**< Reads that did not match the served time */
+	uint32_t errors;			/**< Failed reads */
+	uint16_t max_edge_err_ms;	/**< Largest distance of a SQW edge from its predicted time */
+} rtc_time_cache_stats_t;
+
+class RTCTimeCache
+{
+public:
+	virtual ~RTCTimeCache() {}
+
+	/**
+	* @brief	Set the resync policy
+	*/
+	void set_config(const rtc_time_cache_cfg_t &cfg);
+
+	/**
+	* @brief	Get the time as Unix seconds, from the MCU clock or the RTC
+	*
+	* @param[out]	epoch	Seconds since 1970-01-01 00:00:00
+	*
+	* @returns	0 on success, the driver's error code if an RTC read failed
+	*/
+	int get_epoch(rtc_epoch_t *epoch);
+
+	/**
+	* @brief	Get the time, from the MCU clock or the RTC
+	*
+	* @param[out]	time	Time, tm_wday and tm_yday included
+	*
+	* @returns	0 on success, the driver's error code if an RTC read failed
+	*/
+	int get_time(struct tm *time);
+
+	/**
+	* @brief	Set the RTC and anchor the cache to the new time
+	*
+	* @returns	The driver's set_epoch() result
+	*/
+	int set_epoch(rtc_epoch_t epoch);
+
+	/**
+	* @brief	Note a 1 Hz SQW edge, safe to call from an interrupt handler
+	*/
+	void sqw_edge(void);
+
+	/**
+	* @brief	Forget the anchor, the next call reads the RTC
+	*
+	* @details	Call it after the RTC has been set other than through set_epoch().
+	*/
+	void invalidate(void);
+
+	/**
+	* @brief	Get counters.
+	*/
+	void get_stats(rtc_time_cache_stats_t &stats);
+
+	/**
+	* @brief	Clear counters.
+	*/
+	void reset_stats(void);
+
+protected:
+	RTCTimeCache();
+
+	/** @brief	Driver get_epoch() */
+	virtual int read_rtc(rtc_epoch_t *epoch) = 0;
+
+	/** @brief	Driver set_epoch() */
+	virtual int write_rtc(rtc_epoch_t epoch) = 0;
+
+private:
+	typedef enum {
+		RESYNC_NONE,
+		RESYNC_PERIOD,
+		RESYNC_DRIFT,
+	} resync_t;
+
+	uint32_t since_anchor(uint32_t now);
+	void take_edge(void);
+	int resync(resync_t reason, rtc_epoch_t *epoch);
+
+	uint32_t m_period_ms;
+	uint32_t m_drift_window_ms;
+	rtc_epoch_t m_anchor_epoch;		/* RTC seconds at m_anchor_ms */
+	uint32_t m_anchor_ms;			/* millis() of the anchor */
+	uint32_t m_read_ms;				/* millis() of the last RTC read */
+	bool m_valid;
+	bool m_locked;					/* m_anchor_ms is a second boundary */
+	volatile bool m_edge_pending;
+	volatile uint32_t m_edge_ms;
+	rtc_time_cache_stats_t m_stats;
+};
+
+/**
+* @brief	Time cache over a driver with get_epoch() and set_epoch()
+*/
+template <class RTC>
+class RTCTimeCacheT : public RTCTimeCache
+{
+public:
+	/**
+	* @param[in]	rtc		Driver, begin() already called
+	*/
+	explicit RTCTimeCacheT(RTC *rtc) : m_rtc(rtc) {}
+
+protected:
+	int read_rtc(rtc_epoch_t *epoch) { return m_rtc->get_epoch(epoch); }
+	int write_rtc(rtc_epoch_t epoch) { return m_rtc->set_epoch(epoch); }
+
+private:
+	RTC *m_rtc;
+};
+
+#endif /* _RTC_TIME_CACHE_H_ */
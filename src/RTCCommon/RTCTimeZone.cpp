@@ -0,0 +1,299 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#include <RTCCommon/RTCTimeZone.h>
+
+#define SECS_PER_DAY		86400L
+
+#if ANALOG_RTC_EPOCH_64
+#define RTC_EPOCH_MIN		INT64_MIN
+#define RTC_EPOCH_MAX		INT64_MAX
+#else
+#define RTC_EPOCH_MIN		0
+#define RTC_EPOCH_MAX		UINT32_MAX
+#endif
+
+/* UTC seconds of a DST change in a year, offset_min the local offset it is given in */
+static int64_t change_to_utc(int16_t year, const rtc_tz_change_t *change, int16_t offset_min)
+{
+	int32_t first;
+	int32_t next;
+	int32_t day;
+
+	first = rtc_days_from_civil(year, change->mon, 1);
+	if (change->mon == 12) {
+		next = rtc_days_from_civil(year + 1, 1, 1);
+	} else {
+		next = rtc_days_from_civil(year, change->mon + 1, 1);
+	}
+
+	/* First such weekday of the month, 1970-01-01 was a Thursday, then the week */
+	day = first + (change->wday + 7 - (first % 7 + 11) % 7) % 7 + (change->week - 1) * 7;
+	while (day >= next) {
+		day -= 7;
+	}
+
+	return (int64_t)day * SECS_PER_DAY + ((int32_t)change->min - offset_min) * 60;
+}
+
+/* Name, alphabetic or in <>. Returns the end, NULL if there is none. */
+static const char *parse_name(const char *p)
+{
+	const char *start = p;
+
+	if (*p == '<') {
+		while (*p && (*p != '>')) {
+			p++;
+		}
+		return (*p == '>') ? p + 1 : NULL;
+	}
+
+	while (((*p >= 'A') && (*p <= 'Z')) || ((*p >= 'a') && (*p <= 'z'))) {
+		p++;
+	}
+
+	return (p - start >= 3) ? p : NULL;
+}
+
+static int parse_number(const char **p, int max)
+{
+	int val = -1;
+
+	while ((**p >= '0') && (**p <= '9')) {
+		val = ((val < 0) ? 0 : val * 10) + (**p - '0');
+		if (val > max) {
+			return -1;
+		}
+		(*p)++;
+	}
+
+	return val;
+}
+
+/* [+-]hh[:mm[:ss]] in minutes, seconds dropped. Returns the end, NULL on error. */
+static const char *parse_time(const char *p, int max_hours, int16_t *min)
+{
+	int sign = 1;
+	int hh;
+	int mm = 0;
+
+	if ((*p == '+') || (*p == '-')) {
+		sign = (*p == '-') ? -1 : 1;
+		p++;
+	}
+
+	hh = parse_number(&p, max_hours);
+	if (hh < 0) {
+		return NULL;
+	}
+
+	if (*p == ':') {
+		p++;
+		mm = parse_number(&p, 59);
+		if (mm < 0) {
+			return NULL;
+		}
+		if (*p == ':') {
+			p++;
+			if (parse_number(&p, 59) < 0) {
+				return NULL;
+			}
+		}
+	}
+
+	*min = sign * (hh * 60 + mm);
+
+	return p;
+}
+
+/* ,Mm.w.d[/time] */
+static const char *parse_change(const char *p, rtc_tz_change_t *change)
+{
+	int mon;
+	int week;
+	int wday;
+
+	if ((p[0] != ',') || (p[1] != 'M')) {
+		return NULL;
+	}
+	p += 2;
+
+	mon = parse_number(&p, 12);
+	if ((mon < 1) || (*p++ != '.')) {
+		return NULL;
+	}
+	week = parse_number(&p, 5);
+	if ((week < 1) || (*p++ != '.')) {
+		return NULL;
+	}
+	wday = parse_number(&p, 6);
+	if (wday < 0) {
+		return NULL;
+	}
+
+	change->mon = mon;
+	change->week = week;
+	change->wday = wday;
+	change->min = 120;
+
+	if (*p == '/') {
+		p = parse_time(p + 1, 167, &change->min);
+	}
+
+	return p;
+}
+
+int rtc_tz_parse(const char *tz, rtc_tz_rule_t *rule)
+{
+	rtc_tz_rule_t parsed = RTC_TZ_FIXED(0);
+	const char *p = tz;
+	int16_t std_west;
+	int16_t dst_west;
+
+	/* std offset, POSIX offsets are west of UTC */
+	p = parse_name(p);
+	if (p) {
+		p = parse_time(p, 24, &std_west);
+	}
+	if (!p) {
+		return -1;
+	}
+	parsed.std_offset = -std_west;
+
+	if (*p) {
+		/* dst [offset], an hour ahead by default */
+		p = parse_name(p);
+		if (!p) {
+			return -1;
+		}
+		dst_west = std_west - 60;
+		if (*p && (*p != ',')) {
+			p = parse_time(p, 24, &dst_west);
+			if (!p) {
+				return -1;
+			}
+		}
+		parsed.dst_shift = std_west - dst_west;
+
+		/* Both changes, there are no default rules */
+		p = parse_change(p, &parsed.dst_start);
+		if (p) {
+			p = parse_change(p, &parsed.dst_end);
+		}
+		if (!p || *p || !parsed.dst_shift) {
+			return -1;
+		}
+	}
+
+	*rule = parsed;
+
+	return 0;
+}
+
+RTCTimeZone::RTCTimeZone(const rtc_tz_rule_t &rule)
+{
+	set_rule(rule);
+}
+
+void RTCTimeZone::set_rule(const rtc_tz_rule_t &rule)
+{
+	m_rule = rule;
+
+	/* Empty interval, the next call computes it */
+	m_from = 0;
+	m_until = 0;
+	m_offset = 0;
+	m_dst = false;
+}
+
+void RTCTimeZone::update(rtc_epoch_t utc)
+{
+	int64_t now = utc;
+	int64_t from = RTC_EPOCH_MIN;
+	int64_t until = RTC_EPOCH_MAX;
+	int64_t change[2];
+	int16_t year;
+	uint8_t mon;
+	uint8_t mday;
+
+	m_dst = false;
+
+	if (m_rule.dst_shift) {
+		rtc_civil_from_days((int32_t)(now / SECS_PER_DAY), &year, &mon, &mday);
+
+		/* The changes around now are within the year before and after */
+		for (int16_t y = year - 1; y <= year + 1; y++) {
+			change[0] = change_to_utc(y, &m_rule.dst_end, m_rule.std_offset + m_rule.dst_shift);
+			change[1] = change_to_utc(y, &m_rule.dst_start, m_rule.std_offset);
+
+			for (int i = 0; i < 2; i++) {
+				if (change[i] <= now) {
+					if (change[i] > from) {
+						from = change[i];
+						m_dst = (i == 1);
+					}
+				} else if (change[i] < until) {
+					until = change[i];
+				}
+			}
+		}
+	}
+
+	m_from = (from > RTC_EPOCH_MIN) ? (rtc_epoch_t)from : RTC_EPOCH_MIN;
+	m_until = (until < RTC_EPOCH_MAX) ? (rtc_epoch_t)until : RTC_EPOCH_MAX;
+	m_offset = (int32_t)(m_rule.std_offset + (m_dst ? m_rule.dst_shift : 0)) * 60;
+}
+
+rtc_epoch_t RTCTimeZone::to_utc(rtc_epoch_t local)
+{
+	rtc_epoch_t utc;
+
+	/*
+	 * Taken as standard time first, then with the offset of the interval
+	 * that lands in. In a skipped hour that is DST and the second try
+	 * lands back in standard time, which is kept.
+	 */
+	utc = local - (int32_t)m_rule.std_offset * 60;
+	to_local(utc);
+	utc = local - m_offset;
+	to_local(utc);
+
+	return local - m_offset;
+}
+
+void RTCTimeZone::localtime(rtc_epoch_t utc, struct tm *time)
+{
+	bool dst;
+
+	rtc_epoch_to_tm(to_local(utc, &dst), time);
+	time->tm_isdst = dst ? 1 : 0;
+}
@@ -0,0 +1,243 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#ifndef _RTC_TIME_ZONE_H_
+#define _RTC_TIME_ZONE_H_
+
+#include <Arduino.h>
+#include <time.h>
+#include <RTCCommon/RTCTime.h>
+
+/*
+ * Local time from the UTC the RTC holds, without tzset()/localtime().
+ *
+ * A zone is a rtc_tz_rule_t: the standard offset and, for zones with
+ * DST, the shift and the two yearly changes in the POSIX TZ "Mm.w.d/time"
+ * form. The RTC_TZ_* rules below are constant initializers: a rule is
+ * 16 bytes of flash and takes no parsing. rtc_tz_parse() reads the same
+ * subset of a POSIX TZ string at run time.
+ *
+ * RTCTimeZone keeps the offset in force and the UTC interval it holds
+ * for, up to the next DST change. Converting a time inside that interval
+ * is two compares and an add. Only a time outside it, once per DST change
+ * for a clock going forward, computes the changes of the year again.
+ *
+ * get_time()/set_time() go through any clock with get_epoch() and
+ * set_epoch(): the drivers, RTCTimeCache.
+ *
+ *	static const rtc_tz_rule_t berlin = RTC_TZ_EU_CENTRAL;
+ *	RTCTimeZone tz(berlin);
+ *
+ *	tz.get_time(rtc, &local);
+ *
+ * An RTCTimeZone is not safe to share between an interrupt handler and
+ * the main loop.
+ */
+
+/**
+* @brief	A yearly DST change, POSIX Mm.w.d/time
+*/
+typedef struct {
+	uint8_t		mon;	/**< Month, 1 to 12 */
+	uint8_t		week;	/**< Week of the month, 1 to 4, 5 for the last */
+	uint8_t		wday;	/**< Day of week, 0 Sunday to 6 */
+	int16_t		min;	/**< Local time of the change, minutes from midnight, may be negative or past 24 h */
+} rtc_tz_change_t;
+
+/**
+* @brief	Time zone rule
+*
+* @details	dst_start is in local standard time and dst_end in local DST,
+*			as in POSIX. dst_start after dst_end in the year is a southern
+*			hemisphere zone.
+*/
+typedef struct {
+	int16_t			std_offset;	/**< Standard time, minutes east of UTC */
+	int16_t			dst_shift;	/**< Minutes DST adds, 0 for a zone without DST */
+	rtc_tz_change_t	dst_start;	/**< Change to DST */
+	rtc_tz_change_t	dst_end;	/**< Change back to standard time */
+} rtc_tz_rule_t;
+
+/**
+* @brief	Rule of a zone without DST, offset in minutes east of UTC
+*/
+#define RTC_TZ_FIXED(offset)	{ (offset), 0, { 0, 0, 0, 0 }, { 0, 0, 0, 0 } }
+
+/**
+* @brief	Rule of a zone with DST, offsets in minutes, changes as month, week, day of week, minutes
+*/
+#define RTC_TZ_DST(offset, shift, s_mon, s_week, s_wday, s_min, e_mon, e_week, e_wday, e_min) \
+	{ (offset), (shift), { (s_mon), (s_week), (s_wday), (s_min) }, { (e_mon), (e_week), (e_wday), (e_min) } }
+
+/*
+ * Common zones, POSIX TZ string in the comment. Declare them const, e.g.
+ * static const rtc_tz_rule_t tz_rule = RTC_TZ_US_EASTERN;
+ */
+#define RTC_TZ_UTC			RTC_TZ_FIXED(0)										/* UTC0 */
+#define RTC_TZ_US_HAWAII	RTC_TZ_FIXED(-600)									/* HST10 */
+#define RTC_TZ_US_ALASKA	RTC_TZ_DST(-540, 60, 3, 2, 0, 120, 11, 1, 0, 120)	/* AKST9AKDT,M3.2.0,M11.1.0 */
+#define RTC_TZ_US_PACIFIC	RTC_TZ_DST(-480, 60, 3, 2, 0, 120, 11, 1, 0, 120)	/* PST8PDT,M3.2.0,M11.1.0 */
+#define RTC_TZ_US_MOUNTAIN	RTC_TZ_DST(-420, 60, 3, 2, 0, 120, 11, 1, 0, 120)	/* MST7MDT,M3.2.0,M11.1.0 */
+#define RTC_TZ_US_ARIZONA	RTC_TZ_FIXED(-420)									/* MST7 */
+#define RTC_TZ_US_CENTRAL	RTC_TZ_DST(-360, 60, 3, 2, 0, 120, 11, 1, 0, 120)	/* CST6CDT,M3.2.0,M11.1.0 */
+#define RTC_TZ_US_EASTERN	RTC_TZ_DST(-300, 60, 3, 2, 0, 120, 11, 1, 0, 120)	/* EST5EDT,M3.2.0,M11.1.0 */
+#define RTC_TZ_EU_WESTERN	RTC_TZ_DST(0, 60, 3, 5, 0, 60, 10, 5, 0, 120)		/* GMT0BST,M3.5.0/1,M10.5.0 */
+#define RTC_TZ_EU_CENTRAL	RTC_TZ_DST(60, 60, 3, 5, 0, 120, 10, 5, 0, 180)		/* CET-1CEST,M3.5.0,M10.5.0/3 */
+#define RTC_TZ_EU_EASTERN	RTC_TZ_DST(120, 60, 3, 5, 0, 180, 10, 5, 0, 240)	/* EET-2EEST,M3.5.0/3,M10.5.0/4 */
+#define RTC_TZ_INDIA		RTC_TZ_FIXED(330)									/* IST-5:30 */
+#define RTC_TZ_CHINA		RTC_TZ_FIXED(480)									/* CST-8 */
+#define RTC_TZ_JAPAN		RTC_TZ_FIXED(540)									/* JST-9 */
+#define RTC_TZ_AU_EASTERN	RTC_TZ_DST(600, 60, 10, 1, 0, 120, 4, 1, 0, 180)	/* AEST-10AEDT,M10.1.0,M4.1.0/3 */
+
+/**
+* @brief	Read a rule from a POSIX TZ string
+*
+* @details	The subset read is std offset [dst [offset] ,Mm.w.d[/time],Mm.w.d[/time]],
+*			names alphabetic or in <>, offsets and times as [+-]hh[:mm[:ss]],
+*			seconds ignored. The Jn and n day forms are not supported.
+*
+* @param[in]	tz		POSIX TZ string, e.g. "CET-1CEST,M3.5.0,M10.5.0/3"
+* @param[out]	rule	Rule, left as is on error
+*
+* @returns	0 on success, -1 if the string is not in the subset
+*/
+int rtc_tz_parse(const char *tz, rtc_tz_rule_t *rule);
+
+class RTCTimeZone
+{
+public:
+	/**
+	* @param[in]	rule	Zone rule, e.g. RTC_TZ_EU_CENTRAL
+	*/
+	explicit RTCTimeZone(const rtc_tz_rule_t &rule);
+
+	/**
+	* @brief	Change the zone
+	*/
+	void set_rule(const rtc_tz_rule_t &rule);
+
+	/**
+	* @brief	Get the zone rule
+	*/
+	const rtc_tz_rule_t &get_rule(void) const { return m_rule; }
+
+	/**
+	* @brief	Local time of a UTC time, both as seconds since 1970-01-01 00:00:00
+	*
+	* @param[in]	utc		UTC seconds
+	* @param[out]	isdst	Whether DST is in force, may be NULL
+	*/
+	rtc_epoch_t to_local(rtc_epoch_t utc, bool *isdst = NULL)
+	{
+		if ((utc >= m_until) || (utc < m_from)) {
+			update(utc);
+		}
+
+		if (isdst) {
+			*isdst = m_dst;
+		}
+
+		return utc + m_offset;
+	}
+
+	/**
+	* @brief	UTC time of a local time, inverse of to_local()
+	*
+	* @details	A local time skipped or repeated by a DST change is taken
+	*			as standard time.
+	*/
+	rtc_epoch_t to_utc(rtc_epoch_t local);
+
+	/**
+	* @brief	Broken down local time of a UTC time, as localtime()
+	*
+	* @param[in]	utc		UTC seconds
+	* @param[out]	time	Local time, tm_wday, tm_yday and tm_isdst included
+	*/
+	void localtime(rtc_epoch_t utc, struct tm *time);
+
+	/**
+	* @brief	UTC seconds of the next DST change after the last converted time
+	*
+	* @returns	The change, the largest rtc_epoch_t for a zone without DST
+	*/
+	rtc_epoch_t next_change(void) const { return m_until; }
+
+	/**
+	* @brief	Get the local time from a clock with get_epoch(): a driver, RTCTimeCache
+	*
+	* @param[in]	clock	Clock holding UTC
+	* @param[out]	time	Local time, tm_wday, tm_yday and tm_isdst included
+	*
+	* @returns	0 on success, the clock's get_epoch() error otherwise
+	*/
+	template <class CLOCK>
+	int get_time(CLOCK &clock, struct tm *time)
+	{
+		rtc_epoch_t utc;
+		int ret;
+
+		ret = clock.get_epoch(&utc);
+		if (ret) {
+			return ret;
+		}
+
+		localtime(utc, time);
+
+		return 0;
+	}
+
+	/**
+	* @brief	Set a clock with set_epoch() to a local time
+	*
+	* @param[in]	clock	Clock holding UTC
+	* @param[in]	time	Local time, tm_isdst, tm_wday and tm_yday are not used
+	*
+	* @returns	The clock's set_epoch() result
+	*/
+	template <class CLOCK>
+	int set_time(CLOCK &clock, const struct tm *time)
+	{
+		return clock.set_epoch(to_utc(rtc_tm_to_epoch(time)));
+	}
+
+private:
+	void update(rtc_epoch_t utc);
+
+	rtc_tz_rule_t m_rule;
+	rtc_epoch_t m_from;		/* UTC interval m_offset holds for */
+	rtc_epoch_t m_until;
+	int32_t m_offset;		/* Seconds added to UTC */
+	bool m_dst;
+};
+
+#endif /* _RTC_TIME_ZONE_H_ */
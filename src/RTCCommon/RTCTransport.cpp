@@ -0,0 +1,260 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#include <RTCCommon/RTCTransport.h>
+
+/* Half an SCL period at 100kHz */
+#define UNSTICK_HALF_PERIOD_US	5
+
+static const rtc_bus_recovery_t default_recovery = RTC_BUS_RECOVERY_DEFAULT;
+
+RTCTransport::RTCTransport()
+{
+	m_recovery = default_recovery;
+	m_failed_calls = 0;
+	reset_recovery_stats();
+}
+
+void RTCTransport::set_recovery(const rtc_bus_recovery_t &policy)
+{
+	m_recovery = policy;
+	m_failed_calls = 0;
+}
+
+void RTCTransport::get_recovery_stats(rtc_bus_recovery_stats_t &stats)
+{
+	stats = m_recovery_stats;
+}
+
+void RTCTransport::reset_recovery_stats(void)
+{
+	memset(&m_recovery_stats, 0, sizeof(m_recovery_stats));
+}
+
+/*
+ * Called after attempt number 'attempt' failed. Waits and returns true if
+ * another attempt is allowed.
+ */
+bool RTCTransport::retry(uint8_t attempt)
+{
+	uint8_t shift;
+	uint32_t wait_us;
+
+	if (attempt >= m_recovery.retries) {
+		return false;
+	}
+
+	m_recovery_stats.retries++;
+	flush();
+
+	/* 32-bit on every core, delayMicroseconds() only for the sub-millisecond rest */
+	shift = (attempt < RTC_BUS_BACKOFF_MAX_SHIFT) ? attempt : RTC_BUS_BACKOFF_MAX_SHIFT;
+	wait_us = (uint32_t)m_recovery.backoff_us << shift;
+	delay(wait_us / 1000);
+	delayMicroseconds(wait_us % 1000);
+	return true;
+}
+
+/*
+ * Called once per read_register()/write_register() with the final result.
+ * Escalates to unstick and re-init on consecutive failed calls.
+ */
+int RTCTransport::settle(int ret, uint8_t attempts)
+{
+	if (ret == 0) {
+		if (attempts > 0) {
+			m_recovery_stats.recovered++;
+		}
+		m_failed_calls = 0;
+		return 0;
+	}
+
+	m_recovery_stats.failures++;
+	if (m_failed_calls < 0xFF) {
+		m_failed_calls++;
+	}
+
+	if (m_recovery.unstick_after && m_failed_calls >= m_recovery.unstick_after &&
+		m_recovery.scl_pin >= 0 && m_recovery.sda_pin >= 0) {
+		if (unstick(m_recovery.scl_pin, m_recovery.sda_pin)) {
+			m_recovery_stats.unsticks++;
+		}
+	}
+
+	if (m_recovery.reinit_after && m_failed_calls >= m_recovery.reinit_after) {
+		m_recovery_stats.reinits++;
+		m_failed_calls = 0;
+		begin();
+	}
+
+	return ret;
+}
+
+int RTCTransport::read_register(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t len)
+{
+	int ret;
+	uint8_t attempt = 0;
+
+	while ((ret = write_read(addr, reg, buf, len)) != 0 && retry(attempt)) {
+		attempt++;
+	}
+
+	return settle(ret, attempt);
+}
+
+int RTCTransport::write_register(uint8_t addr, uint8_t reg, const uint8_t *buf, uint8_t len)
+{
+	int ret;
+	uint8_t attempt = 0;
+
+	while ((ret = write(addr, reg, buf, len)) != 0 && retry(attempt)) {
+		attempt++;
+	}
+
+	return settle(ret, attempt);
+}
+
+void RTCWireTransport::begin(void)
+{
+	m_i2c->begin();
+}
+
+void RTCWireTransport::flush(void)
+{
+	m_i2c->flush();
+}
+
+int RTCWireTransport::write_read(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t len)
+{
+	int ret;
+	uint8_t counter = 0;
+
+	m_i2c->beginTransmission(addr);
+	if (m_i2c->write(reg) != 1) {
+		return RTC_BUS_ERR_DATA_TOO_LONG;
+	}
+
+	/* Repeated start: the bus is not released between address and data phase */
+	ret = m_i2c->endTransmission(false);
+	if (ret != 0) {
+		return ret;
+	}
+
+	m_i2c->requestFrom(addr, len);
+
+	while (m_i2c->available()) { // slave may send less than requested
+		uint8_t data = m_i2c->read();
+		if (counter < len) {
+			buf[counter++] = data;
+		}
+	}
+
+	return (counter == len) ? 0 : RTC_BUS_ERR_SHORT_READ;
+}
+
+int RTCWireTransport::write(uint8_t addr, uint8_t reg, const uint8_t *buf, uint8_t len)
+{
+	m_i2c->beginTransmission(addr);
+	if (m_i2c->write(reg) != 1 || m_i2c->write(buf, len) != len) {
+		return RTC_BUS_ERR_DATA_TOO_LONG;
+	}
+
+	return m_i2c->endTransmission();
+}
+
+uint8_t RTCWireTransport::max_read(void)
+{
+	return RTC_WIRE_BUFFER_LENGTH;
+}
+
+uint8_t RTCWireTransport::max_write(void)
+{
+	/* One buffer byte goes to the register address */
+	return RTC_WIRE_BUFFER_LENGTH - 1;
+}
+
+/*
+ * TwoWire::end() is not in the Wire API of every core, older AVR and some
+ * third-party cores lack it. It is called where it exists, chosen at
+ * compile time, and skipped elsewhere.
+ */
+template <class W>
+static auto wire_end(W *i2c, int) -> decltype(i2c->end(), void())
+{
+	i2c->end();
+}
+
+template <class W>
+static void wire_end(W *i2c, long)
+{
+	(void)i2c;
+}
+
+/*
+ * The pins are taken from the Wire peripheral, driven open-drain (low or
+ * released to the pull-up) and handed back with begin(). Without end() the
+ * peripheral is left on: where it keeps the pins, as the AVR TWI does, the
+ * pulses do not reach the bus and a stuck SDA is reported as not released.
+ */
+bool RTCWireTransport::unstick(uint8_t scl_pin, uint8_t sda_pin)
+{
+	bool released;
+
+	wire_end(m_i2c, 0);
+
+	pinMode(sda_pin, INPUT_PULLUP);
+	pinMode(scl_pin, INPUT_PULLUP);
+
+	/* A target stuck mid-byte lets go of SDA within 9 clocks */
+	for (int i = 0; i < 9 && digitalRead(sda_pin) == LOW; i++) {
+		digitalWrite(scl_pin, LOW);
+		pinMode(scl_pin, OUTPUT);
+		delayMicroseconds(UNSTICK_HALF_PERIOD_US);
+		pinMode(scl_pin, INPUT_PULLUP);
+		delayMicroseconds(UNSTICK_HALF_PERIOD_US);
+	}
+
+	released = (digitalRead(sda_pin) == HIGH);
+
+	/* STOP: SDA rises while SCL is high */
+	if (released) {
+		digitalWrite(sda_pin, LOW);
+		pinMode(sda_pin, OUTPUT);
+		delayMicroseconds(UNSTICK_HALF_PERIOD_US);
+		pinMode(sda_pin, INPUT_PULLUP);
+		delayMicroseconds(UNSTICK_HALF_PERIOD_US);
+	}
+
+	m_i2c->begin();
+
+	return released;
+}
@@ -0,0 +1,226 @@
+/*******************************************************************************
+* Copyright(C) Analog Devices Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files(the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Analog Devices Inc.
+* shall not be used except as stated in the Analog Devices Inc.
+* Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Analog Devices Inc.retains all ownership rights.
+********************************************************************************
+*/
+
+#ifndef _RTC_TRANSPORT_H_
+#define _RTC_TRANSPORT_H_
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <RTCCommon/RTCBusStats.h>
+
+/**
+* @brief	Doublings of the retry backoff, later retries wait as long as this one
+*/
+#define RTC_BUS_BACKOFF_MAX_SHIFT	15
+
+/**
+* @brief	Error recovery policy of a transport
+*
+* @details	A failed transfer is retried up to 'retries' times, waiting
+*			backoff_us before the first retry and twice as long before each
+*			following one. A call that still fails counts as a failed call.
+*			After unstick_after consecutive failed calls SCL is pulsed to free
+*			a target holding SDA low, after reinit_after the bus is
+*			reinitialized with begin(). 0 disables a stage.
+*
+*			The doubling stops after RTC_BUS_BACKOFF_MAX_SHIFT retries, so one
+*			wait is at most backoff_us << 15, about 36 minutes for the largest
+*			backoff_us.
+*
+* @note		The unstick releases the pins with TwoWire::end() on the cores
+*			that have it. On a core without it the pins stay with the Wire
+*			peripheral and the unstick may not free the bus.
+*/
+typedef struct {
+	uint8_t		retries;		/**< Retries of a failed transfer */
+	uint16_t	backoff_us;		/**< Wait before the first retry, doubled for each next one */
+	uint8_t		unstick_after;	/**< Consecutive failed calls before an SCL unstick */
+	uint8_t		reinit_after;	/**< Consecutive failed calls before begin() */
+	int8_t		scl_pin;		/**< SCL pin for the unstick, -1 if not available */
+	int8_t		sda_pin;		/**< SDA pin for the unstick, -1 if not available */
+} rtc_bus_recovery_t;
+
+/**
+* @brief	Default policy: two quick retries, re-init after three failed calls, no unstick
+*/
+#define RTC_BUS_RECOVERY_DEFAULT	{ 2, 100, 0, 3, -1, -1 }
+
+/**
+* @brief	Counters of each recovery stage
+*/
+typedef struct {
+	uint32_t retries;		/**< Transfers retried */
+	uint32_t recovered;		/**< Calls that succeeded after one or more retries */
+	uint32_t failures;		/**< Calls that failed after all retries */
+	uint32_t unsticks;		/**< SCL unsticks that released SDA */
+	uint32_t reinits;		/**< begin() calls made by the policy */
+} rtc_bus_recovery_stats_t;
+
+/*
+ * Bus access used by the drivers' read_register()/write_register().
+ *
+ * A transport moves register data for one 7-bit address at a time. The
+ * drivers call read_register()/write_register(), which apply the recovery
+ * policy around the write_read()/write() primitives a backend implements.
+ * All of them return 0 on success or one of rtc_bus_err_t, so the codes
+ * match Wire endTransmission() plus RTC_BUS_ERR_SHORT_READ.
+ */
+class RTCTransport
+{
+public:
+	RTCTransport();
+	virtual ~RTCTransport() {}
+
+	/**
+	* @brief	write_read() under the recovery policy.
+	*/
+	int read_register(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t len);
+
+	/**
+	* @brief	write() under the recovery policy.
+	*/
+	int write_register(uint8_t addr, uint8_t reg, const uint8_t *buf, uint8_t len);
+
+	/**
+	* @brief	Set the recovery policy, shared by every device on this transport.
+	*/
+	void set_recovery(const rtc_bus_recovery_t &policy);
+
+	/**
+	* @brief	Get recovery counters.
+	*/
+	void get_recovery_stats(rtc_bus_recovery_stats_t &stats);
+
+	/**
+	* @brief	Clear recovery counters.
+	*/
+	void reset_recovery_stats(void);
+
+	/**
+	* @brief	(Re)initialize the bus. Called by the drivers' begin() and after bus errors.
+	*/
+	virtual void begin(void) = 0;
+
+	/**
+	* @brief	Drop any partial transfer state after an error.
+	*/
+	virtual void flush(void) {}
+
+	/**
+	* @brief	Write the register address, then read len bytes after a repeated start.
+	*
+	* @param[in]	addr	7-bit slave address.
+	* @param[in]	reg		Register address.
+	* @param[out]	buf		Received data.
+	* @param[in]	len		Number of bytes to read, at most max_read().
+	*
+	* @returns	0 on success, rtc_bus_err_t on failure.
+	*/
+	virtual int write_read(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t len) = 0;
+
+	/**
+	* @brief	Write the register address followed by len data bytes.
+	*
+	* @param[in]	addr	7-bit slave address.
+	* @param[in]	reg		Register address.
+	* @param[in]	buf		Data to write.
+	* @param[in]	len		Number of bytes to write, at most max_write().
+	*
+	* @returns	0 on success, rtc_bus_err_t on failure.
+	*/
+	virtual int write(uint8_t addr, uint8_t reg, const uint8_t *buf, uint8_t len) = 0;
+
+	/**
+	* @brief	Largest number of bytes one write_read() can return.
+	*/
+	virtual uint8_t max_read(void) = 0;
+
+	/**
+	* @brief	Largest number of data bytes, register address excluded, one write() can send.
+	*/
+	virtual uint8_t max_write(void) = 0;
+
+protected:
+	/**
+	* @brief	Clock SCL until the target releases SDA, then send a STOP.
+	*
+	* @returns	true if SDA is released, false if it is still low or the backend cannot do it.
+	*/
+	virtual bool unstick(uint8_t scl_pin, uint8_t sda_pin) { (void)scl_pin; (void)sda_pin; return false; }
+
+private:
+	bool retry(uint8_t attempt);
+	int settle(int ret, uint8_t attempts);
+
+	rtc_bus_recovery_t m_recovery;
+	rtc_bus_recovery_stats_t m_recovery_stats;
+	uint8_t m_failed_calls;
+};
+
+/*
+ * Wire buffer size. The name differs between cores; AVR, megaAVR and SAMD
+ * use 32 bytes, ESP32 and ESP8266 128.
+ */
+#if defined(BUFFER_LENGTH)
+#define RTC_WIRE_BUFFER_LENGTH	BUFFER_LENGTH
+#elif defined(I2C_BUFFER_LENGTH)
+#define RTC_WIRE_BUFFER_LENGTH	I2C_BUFFER_LENGTH
+#else
+#define RTC_WIRE_BUFFER_LENGTH	32
+#endif
+
+/**
+* @brief	RTCTransport on top of an Arduino TwoWire instance
+*
+* @details	A register read is endTransmission(false) followed by requestFrom(),
+*			so it takes two calls into the Wire library.
+*/
+class RTCWireTransport : public RTCTransport
+{
+public:
+	RTCWireTransport(TwoWire *i2c = NULL) : m_i2c(i2c) {}
+
+	void begin(void);
+	void flush(void);
+	int write_read(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t len);
+	int write(uint8_t addr, uint8_t reg, const uint8_t *buf, uint8_t len);
+	uint8_t max_read(void);
+	uint8_t max_write(void);
+
+protected:
+	bool unstick(uint8_t scl_pin, uint8_t sda_pin);
+
+private:
+	TwoWire *m_i2c;
+};
+
+#endif /* _RTC_TRANSPORT_H_ */